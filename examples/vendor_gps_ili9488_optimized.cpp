@@ -5,9 +5,11 @@
  * 功能说明：
  * - 使用LC76G I2C适配器接收GPS模块数据
  * - 在ILI9488显示屏上显示GPS信息 (480x320横屏布局)
- * - 双栏布局：左侧GPS信息，右侧卫星信号
+ * - 双栏布局：左侧GPS信息，右侧卫星天空图、轨迹地图或历史曲线（短按切换，地图长按缩放）
  * - 支持坐标转换（WGS84 -> 百度/谷歌坐标）
  * - 实时更新GPS状态
+ * - 日志文件可通过USB串口下载 (host/tools/log_fetch)
+ * - 每个历元输出二进制定位遥测 (host/tools/telemetry_rx)
  * 
  * 硬件连接：
  * - GPS模块：I2C1连接 (SDA: GPIO2, SCL: GPIO3)
@@ -27,14 +29,56 @@
 #include "pico_ili9488_gfx.hpp"
 #include "ili9488_colors.hpp"
 #include "ili9488_font.hpp"
+#include "ili9488_track_view.hpp"
+#include "ili9488_tile_map.hpp"
+#include "ili9488_sky_plot.hpp"
+#include "ili9488_strip_chart.hpp"
 #include "pin_config.hpp"
 
 extern "C" {
 #include "gps/lc76g_i2c_adaptor.h"
 }
 
-// GPS SD卡日志记录器
+// GPS启动状态持久化 (热/温启动)
+#include "gps/gps_warm_start.h"
+
+// GPS辅助数据(EPO)注入 (冷启动时从SD卡读取)
+#include "gps/gps_assist.h"
+
+// GPS显示预测器 (定位之间按帧率外推位置/速度/航向)
+#include "gps/gps_predictor.h"
+
+// 定位质量门限 (拒绝的历元不记录、不进入轨迹和地图)
+#include "gps/gps_quality.h"
+
+// 行程统计 (里程、运动时间、平均/最高速度)
+#include "gps/gps_trip.h"
+
+// 地理围栏 (SD卡围栏文件，进出事件写入日志)
+#include "gps/gps_geofence.h"
+
+// 轨迹存储 (地图视图的数据源)
+#include "gps/gps_track.h"
+#include "gps/gps_sky.h"
+
+// 总线捕获 (LC76G_BUS_CAPTURE构建选项)
+#include "debug/bus_capture.h"
+
+// XIP缓存命中统计
+#include "debug/xip_stats.h"
+
+// GPS SD卡日志记录器 (刷新控制器统计写入耗时和数据风险窗口)
 #include "gps/gps_logger.hpp"
+#include "gps/gps_flush.h"
+
+// 日志文件USB下载 (主机端host/tools/log_fetch)
+#include "gps/gps_log_transfer.h"
+
+// 实时定位遥测
+#include "gps/gps_telemetry.h"
+
+// 按键/摇杆输入事件
+#include "input/input_events.h"
 
 // 使用C++命名空间
 using namespace ili9488;
@@ -46,8 +90,9 @@ using namespace pico_ili9488_gfx;
 
 // GPS SD卡日志记录器函数声明
 static bool initialize_sd_logger();
-static void process_gps_logging(const LC76G_GPS_Data& gps_data);
-static void check_log_flush();
+static void process_gps_logging(const gps_fix_t& fix);
+static void process_geofence_events(const gps_fix_t& fix);
+static void check_log_flush(uint32_t slack_us);
 static std::string get_sd_logger_stats();
 
 // =============================================================================
@@ -93,14 +138,52 @@ static std::string get_sd_logger_stats();
 #define GPS_LINE_HEIGHT     22
 #define GPS_INFO_WIDTH      (LEFT_PANEL_WIDTH - 2 * MARGIN_X)
 
-// 右侧面板 (卫星信号)
+// 右侧面板 (卫星天空图)
 #define SIGNAL_START_Y      (MAIN_AREA_Y + MARGIN_Y + 5)
 #define SIGNAL_AREA_WIDTH   (RIGHT_PANEL_WIDTH - 2 * MARGIN_X)
 #define SIGNAL_AREA_HEIGHT  180
 
+// 卫星天空图（标题下方）与右侧图例
+#define SKY_PLOT_X          (LEFT_PANEL_WIDTH + 6)
+#define SKY_PLOT_Y          (SIGNAL_START_Y + 20)
+#define SKY_PLOT_SIZE       156
+#define SKY_LEGEND_X        (SKY_PLOT_X + SKY_PLOT_SIZE + 8)
+
+// 右侧面板下方 (行程统计)
+#define TRIP_START_Y        (MAIN_AREA_Y + 197)
+#define TRIP_LINE_HEIGHT    17
+
+// 右侧面板上方 (轨迹地图，与卫星信号二选一)
+#define MAP_VIEW_X          (LEFT_PANEL_WIDTH + 1)
+#define MAP_VIEW_Y          (MAIN_AREA_Y + 1)
+#define MAP_VIEW_WIDTH      (RIGHT_PANEL_WIDTH - 1)
+#define MAP_VIEW_HEIGHT     (TRIP_START_Y - MAIN_AREA_Y - 4)
+
+// 历史曲线 (与地图共用右侧区域，速度/海拔/平均信噪比三条)
+#define CHART_COUNT         3
+#define CHART_X             (MAP_VIEW_X + 3)
+#define CHART_WIDTH         232
+#define CHART_LABEL_HEIGHT  16
+#define CHART_HEIGHT        44
+#define CHART_BLOCK_HEIGHT  (CHART_LABEL_HEIGHT + CHART_HEIGHT + 4)
+#define CHART_SAMPLES_PER_COLUMN 2   // 每次读取GPS一个样本，约2秒×2×228列≈15分钟
+
 // GPS数据更新间隔
 #define GPS_UPDATE_INTERVAL 2000  // 增加到2秒，给GPS更多时间处理
 #define DISPLAY_REFRESH_INTERVAL 500
+#define DISPLAY_FRAME_INTERVAL   33    // 位置/速度/航向按约30fps刷新
+
+// 每个历元（RMC+GGA）通过USB串口输出二进制定位记录 (host/tools/telemetry_rx接收)
+// 串口监视器中会夹杂少量不可见字符，不需要时设为0
+#define TELEMETRY_ENABLED 1
+// 遥测开启时读空模块缓冲的间隔，不大于定位间隔（每次读取约40ms总线时间，10Hz输出时设为100）
+#define TELEMETRY_POLL_INTERVAL 200
+
+// 启动时在串口打印NMEA校验和/分帧的周期数（SysTick计时，约几毫秒）
+#define NMEA_BENCH_ON_BOOT 0
+
+// 每次GPS读取/每帧渲染统计XIP缓存未命中和耗时，随GPS健康信息定期打印
+#define XIP_STATS_ENABLED 1
 
 // GPS状态跟踪变量
 static bool gps_was_valid = false;
@@ -115,13 +198,38 @@ static uint32_t consecutive_failures = 0;
 // 显示驱动实例
 static ILI9488Driver* driver = nullptr;
 static PicoILI9488GFX<ILI9488Driver>* gfx = nullptr;
+static TrackView* track_view = nullptr;
+static TileMap* tile_map = nullptr;
+static SkyPlot* sky_plot = nullptr;
+static StripChart* charts[CHART_COUNT] = {nullptr};
+
+// 历史曲线：标签、单位、颜色和纵轴
+static const struct {
+    const char* label;
+    const char* unit;
+    uint32_t color;
+    float min_value;
+    float max_value;
+    float range_step;
+} kCharts[CHART_COUNT] = {
+    {"Speed", "km/h", COLOR_CYAN, 0.0f, 60.0f, 20.0f},
+    {"Alt", "m", COLOR_ORANGE, 0.0f, 100.0f, 50.0f},
+    {"SNR", "dB", COLOR_GREEN, 0.0f, 50.0f, 0.0f},
+};
 
-// GPS数据缓存
-static LC76G_GPS_Data current_gps_data;
-static LC76G_GPS_Data previous_gps_data;
+// 右侧面板显示内容
+enum class RightPanelView { Satellite, Map, Charts };
+static RightPanelView right_view = RightPanelView::Satellite;
+
+// GPS数据缓存（32字节定点记录，逐历元比较和复制）
+static gps_fix_t current_fix;
+static uint8_t current_fix_class = GPS_QUALITY_REJECT;
 static bool gps_data_updated = false;
 static uint32_t last_gps_update = 0;
 
+// 显示用的平滑状态
+static gps_predictor_state_t display_state;
+
 // GPS调试和统计信息
 static uint32_t packet_count = 0;
 static uint32_t valid_fix_count = 0;
@@ -184,18 +292,55 @@ void fill_screen(uint32_t color) {
 // GPS数据处理函数
 // =============================================================================
 
+/**
+ * @brief 历元钩子：一次读取中的每个历元都发出一帧遥测
+ *
+ * 延迟从上一次读空模块缓冲的时刻算起，包含历元在模块缓冲中等待读取的时间。
+ */
+static void send_epoch_telemetry(const gps_fix_t *fix, uint32_t since_us, void *ctx) {
+    (void)ctx;
+    gps_telemetry_send_fix(fix, since_us);
+}
+
+// 最近一次送入下游的历元的收到时刻（遥测轮询读到的历元在下一次GPS更新中处理）
+static uint32_t processed_rx_us = 0;
+
+/**
+ * @brief 遥测轮询：读空模块缓冲，新历元由历元钩子发出
+ */
+static void poll_telemetry() {
+    gps_fix_t fix;
+    BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_GPS_READ);
+    if (XIP_STATS_ENABLED) {
+        xip_stats_begin(XIP_STAGE_GPS_READ);
+    }
+    lc76g_read_fix(&fix);
+    if (XIP_STATS_ENABLED) {
+        xip_stats_end(XIP_STAGE_GPS_READ);
+    }
+    BUS_CAPTURE_STAGE_END(BUS_STAGE_GPS_READ);
+}
+
 void update_gps_data() {
     // 尝试多次获取GPS数据，提高成功率
-    LC76G_GPS_Data new_data;
+    gps_fix_t new_fix;
     bool got_data = false;
     
     for (int retry = 0; retry < 3; retry++) {
-        lc76g_read_gps_data(&new_data);
+        BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_GPS_READ);
+        if (XIP_STATS_ENABLED) {
+            xip_stats_begin(XIP_STAGE_GPS_READ);
+        }
+        lc76g_read_fix(&new_fix);
+        if (XIP_STATS_ENABLED) {
+            xip_stats_end(XIP_STAGE_GPS_READ);
+        }
+        BUS_CAPTURE_STAGE_END(BUS_STAGE_GPS_READ);
         
-        // 检查是否获得有效数据
-        if (new_data.Status == 1 && 
-            fabs(new_data.Lat) > 0.0001 && 
-            fabs(new_data.Lon) > 0.0001) {
+        // 检查是否获得有效数据（坐标离原点超过1e-4度）
+        if (gps_fix_is_valid(&new_fix) &&
+            abs(new_fix.lat_e7) > 1000 &&
+            abs(new_fix.lon_e7) > 1000) {
             got_data = true;
             break;
         }
@@ -206,8 +351,13 @@ void update_gps_data() {
         }
     }
     
-    // 保存之前的数据
-    memcpy(&previous_gps_data, &current_gps_data, sizeof(LC76G_GPS_Data));
+    // 只有收到新数据时才送入依赖时间的下游（质量门限、行程、预测器），以收到数据的时刻作为定位时刻；
+    // lc76g_read_fix在没有新NMEA时返回上一次的定位，收到时刻不变，与上一次处理的历元比较
+    // （遥测轮询已读出的历元也算新数据）。收到时刻为32位微秒（约71分钟回绕），按与当前时刻之差换算
+    uint32_t rx_us = lc76g_get_rx_time_us();
+    bool new_data = rx_us != processed_rx_us;
+    processed_rx_us = rx_us;
+    uint32_t fix_ms = to_ms_since_boot(get_absolute_time()) - (time_us_32() - rx_us) / 1000u;
     
     // 增加数据包计数
     packet_count++;
@@ -215,32 +365,33 @@ void update_gps_data() {
     // 详细日志打印（减少日志频率，避免刷屏）
     if (packet_count % 5 == 0 || got_data) {  // 每5次或成功时打印
         printf("[GPS调试] 数据包 #%lu (重试: %s)\n", packet_count, got_data ? "成功" : "失败");
-        printf("[GPS调试] 状态: %d, 纬度: %.6f, 经度: %.6f\n", 
-               new_data.Status, new_data.Lat, new_data.Lon);
-        printf("[GPS调试] 速度: %.2f, 航向: %.2f\n", 
-               new_data.Speed, new_data.Course);
-        printf("[GPS调试] 时间: %02d:%02d:%02d (UTC), 日期: %s\n",
-               new_data.Time_H, new_data.Time_M, new_data.Time_S,
-               new_data.Date);
+        uint32_t utc_s = new_fix.utc_ms / 1000;
+        printf("[GPS调试] 状态: %d, 纬度: %.6f, 经度: %.6f\n",
+               gps_fix_is_valid(&new_fix), new_fix.lat_e7 * 1e-7, new_fix.lon_e7 * 1e-7);
+        printf("[GPS调试] 速度: %.2f, 航向: %.2f\n",
+               gps_fix_speed_kmh(&new_fix), new_fix.course_cdeg * 0.01);
+        printf("[GPS调试] 时间: %02lu:%02lu:%02lu (UTC), 日期: %04u-%02u-%02u\n",
+               utc_s / 3600, utc_s / 60 % 60, utc_s % 60,
+               1980 + (new_fix.utc_date >> 9), (new_fix.utc_date >> 5) & 0x0F, new_fix.utc_date & 0x1F);
     }
     
     // 检查是否获得有效时间数据
-    bool got_time_data = (new_data.Time_H > 0 || new_data.Time_M > 0 || new_data.Time_S > 0);
+    bool got_time_data = (new_fix.flags & GPS_FIX_HAS_TIME) != 0;
     bool got_valid_data = false;
     
     if (got_time_data) {
         // 检查数据是否有效
-        if (new_data.Status == 1) {
-            if (fabs(new_data.Lat) > 0.0001 && fabs(new_data.Lon) > 0.0001) {
+        if (gps_fix_is_valid(&new_fix)) {
+            if (abs(new_fix.lat_e7) > 1000 && abs(new_fix.lon_e7) > 1000) {
                 got_valid_data = true;
                 valid_fix_count++;
                 printf("[GPS调试] 获得有效定位数据！\n");
             } else {
-                printf("[GPS调试] 状态有效但坐标无效 (Lat:%.6f, Lon:%.6f)\n", 
-                       new_data.Lat, new_data.Lon);
+                printf("[GPS调试] 状态有效但坐标无效 (Lat:%.6f, Lon:%.6f)\n",
+                       new_fix.lat_e7 * 1e-7, new_fix.lon_e7 * 1e-7);
             }
         } else {
-            printf("[GPS调试] GPS状态无效 (Status=%d)\n", new_data.Status);
+            printf("[GPS调试] GPS状态无效 (质量=%d)\n", new_fix.quality);
         }
     } else {
         printf("[GPS调试] 未获得时间数据\n");
@@ -266,9 +417,53 @@ void update_gps_data() {
     
     gps_was_valid = gps_is_valid;
     
+    // 定位质量分级：拒绝的历元对下游按无效定位处理。每个历元只分级一次，
+    // 没有新数据时沿用上一次的分级，统计中的比例按历元而不是按读取次数计算
+    uint8_t reasons = 0;
+    uint8_t fix_class = new_data ? gps_quality_classify(&new_fix, fix_ms, &reasons) : current_fix_class;
+    bool accepted = got_valid_data && fix_class != GPS_QUALITY_REJECT;
+    if (new_data && got_valid_data && !accepted) {
+        printf("[定位质量] 拒绝本次定位 (原因: 0x%02X, 卫星: %u, HDOP: %.2f, PDOP: %.2f)\n",
+               reasons, new_fix.satellites, new_fix.hdop_c * 0.01, new_fix.pdop_c * 0.01);
+    } else if (new_data && fix_class == GPS_QUALITY_DEGRADED) {
+        printf("[定位质量] 降级定位 (原因: 0x%02X)\n", reasons);
+    }
+    gps_fix_t gated_fix = new_fix;
+    if (!accepted) {
+        gated_fix.flags &= (uint8_t)~GPS_FIX_VALID;
+    }
+    
+    // 行程统计：失锁时也要调用以结束当前连续段；重复的旧定位不计入
+    if (new_data) {
+        gps_trip_update(&gated_fix, fix_ms);
+    }
+    
+    // 记录最后定位位置，首次定位时统计TTFF；预测器只接收新的历元，
+    // 否则同一位置带着新时刻送入会使外推来回跳动，偏差和定位时长统计失真
+    if (accepted && new_data) {
+        gps_warm_start_update(&new_fix);
+        gps_track_update(&new_fix);
+        gps_predictor_update(&new_fix, fix_ms);
+        
+        gps_predictor_stats_t pred_stats;
+        gps_predictor_get_stats(&pred_stats);
+        printf("[GPS调试] 外推偏差: %.1f m (不外推: %.1f m)\n",
+               pred_stats.mean_error_m, pred_stats.mean_hold_error_m);
+    }
+    
+    // 历史曲线只记录样本，绘制在显示刷新中（视图隐藏时也记录）
+    if (charts[0]) {
+        if (accepted) {
+            charts[0]->push(gps_fix_speed_kmh(&new_fix));
+            charts[1]->push(new_fix.alt_cm * 0.01f);
+        }
+        charts[2]->push(gps_sky_mean_snr());
+    }
+    
     // 检查是否有新的定位数据或时间数据
-    if (got_time_data || memcmp(&new_data, &current_gps_data, sizeof(LC76G_GPS_Data)) != 0) {
-        memcpy(&current_gps_data, &new_data, sizeof(LC76G_GPS_Data));
+    if (got_time_data || memcmp(&new_fix, &current_fix, sizeof(gps_fix_t)) != 0) {
+        current_fix = new_fix;
+        current_fix_class = fix_class;
         gps_data_updated = true;
         last_gps_update = to_ms_since_boot(get_absolute_time());
         
@@ -308,8 +503,9 @@ void draw_header() {
 
 /**
  * @brief 绘制左侧GPS信息面板
+ * @param motion_only 只刷新位置/速度/航向（显示帧之间调用）
  */
-void draw_gps_info_panel() {
+void draw_gps_info_panel(bool motion_only = false) {
     static char prev_lat[32] = {0};
     static char prev_lon[32] = {0};
     static char prev_alt[32] = {0};
@@ -326,29 +522,38 @@ void draw_gps_info_panel() {
     char new_lat[32], new_lon[32], new_alt[32], new_speed[32], new_course[32];
     char new_satellites[16], new_hdop[16], new_status[64];
     
-    // 格式化新数据
-    char lat_dir = (current_gps_data.Lat >= 0) ? 'N' : 'S';
-    char lon_dir = (current_gps_data.Lon >= 0) ? 'E' : 'W';
-    
-    snprintf(new_lat, sizeof(new_lat), "%.6f %c", fabs(current_gps_data.Lat), lat_dir);
-    snprintf(new_lon, sizeof(new_lon), "%.6f %c", fabs(current_gps_data.Lon), lon_dir);
-    snprintf(new_alt, sizeof(new_alt), "%.1f m", current_gps_data.Altitude);
-    snprintf(new_speed, sizeof(new_speed), "%.1f km/h", current_gps_data.Speed);
-    snprintf(new_course, sizeof(new_course), "%.1f°", current_gps_data.Course);
-    
-    int satellites = (current_gps_data.Status == 1) ? 8 + (rand() % 4) : 0;
-    float hdop = (current_gps_data.Status == 1) ? 0.8f + (rand() % 20) / 10.0f : 0.0f;
-    snprintf(new_satellites, sizeof(new_satellites), "%d", satellites);
-    snprintf(new_hdop, sizeof(new_hdop), "%.1f", hdop);
+    // 格式化新数据：定位有效时位置/速度/航向取预测器的平滑值
+    const bool fixed = gps_fix_is_valid(&current_fix);
+    bool use_predicted = gps_predictor_sample(to_ms_since_boot(get_absolute_time()), &display_state) && fixed;
+    double lat = use_predicted ? display_state.lat : current_fix.lat_e7 * 1e-7;
+    double lon = use_predicted ? display_state.lon : current_fix.lon_e7 * 1e-7;
+    double speed = use_predicted ? display_state.speed_kmh : gps_fix_speed_kmh(&current_fix);
+    double course = use_predicted ? display_state.course_deg : current_fix.course_cdeg * 0.01;
+    char lat_dir = (lat >= 0) ? 'N' : 'S';
+    char lon_dir = (lon >= 0) ? 'E' : 'W';
+    
+    snprintf(new_lat, sizeof(new_lat), "%.6f %c", fabs(lat), lat_dir);
+    snprintf(new_lon, sizeof(new_lon), "%.6f %c", fabs(lon), lon_dir);
+    snprintf(new_alt, sizeof(new_alt), "%.1f m", current_fix.alt_cm * 0.01);
+    snprintf(new_speed, sizeof(new_speed), "%.1f km/h", speed);
+    snprintf(new_course, sizeof(new_course), "%.1f°", course);
+    
+    if (motion_only) {
+        strcpy(new_satellites, prev_satellites);
+        strcpy(new_hdop, prev_hdop);
+    } else {
+        snprintf(new_satellites, sizeof(new_satellites), "%u", fixed ? current_fix.satellites : 0u);
+        snprintf(new_hdop, sizeof(new_hdop), "%.1f", fixed ? current_fix.hdop_c * 0.01 : 0.0);
+    }
     
-    if (current_gps_data.Status == 1) {
+    if (fixed) {
         strcpy(new_status, "Fixed");
     } else {
         strcpy(new_status, "None");
     }
     
     // 检查状态变化
-    bool fix_state_changed = (prev_fix_state != (current_gps_data.Status == 1));
+    bool fix_state_changed = (prev_fix_state != fixed);
     
     // 绘制标签和数据
     const char* labels[] = {
@@ -375,10 +580,15 @@ void draw_gps_info_panel() {
     uint32_t colors[] = {
         COLOR_WHITE, COLOR_WHITE, COLOR_WHITE, COLOR_WHITE,
         COLOR_WHITE, COLOR_GREEN, COLOR_WHITE, 
-        (uint32_t)((current_gps_data.Status == 1) ? COLOR_GREEN : COLOR_RED)
+        (uint32_t)(fixed ? COLOR_GREEN : COLOR_RED)
     };
     
     for (int i = 0; i < 8; i++) {
+        if (motion_only && strcmp(values[i], prev_values[i]) == 0) {
+            y += GPS_LINE_HEIGHT;
+            continue;
+        }
+        
         // 绘制标签 (横屏优化位置)
         draw_string(MARGIN_X, y, labels[i], COLOR_LIGHT_GRAY, COLOR_BLACK);
         
@@ -395,82 +605,244 @@ void draw_gps_info_panel() {
     }
     
     // 更新定位状态跟踪变量
-    prev_fix_state = (current_gps_data.Status == 1);
+    prev_fix_state = fixed;
 }
 
 /**
- * @brief 绘制右侧卫星信号面板
+ * @brief 绘制天空图图例（与SkyPlot::snrColor阈值一致）
  */
-void draw_satellite_panel() {
-    uint16_t panel_x = LEFT_PANEL_WIDTH + PANEL_SPACING;
-    uint16_t panel_y = SIGNAL_START_Y;
-    
-    // 标题 (横屏优化)
-    draw_string(panel_x + MARGIN_X, panel_y, "Satellite Signal", COLOR_WHITE, COLOR_BLACK);
-    panel_y += 22;
-    
-    // 信号强度条参数 (横屏优化)
-    const uint16_t bar_width = 18;
-    const uint16_t bar_spacing = 22;
-    const uint16_t max_bar_height = 100;
-    const uint16_t base_y = panel_y + max_bar_height;
-    const uint16_t start_x = panel_x + MARGIN_X;
-    
-    // 绘制信号强度条
-    for (int i = 0; i < 8; i++) {
-        uint16_t x = start_x + i * bar_spacing;
-        
-        // 模拟信号强度
-        uint8_t signal_strength = 0;
-        if (current_gps_data.Status == 1 && i < 8) {
-            signal_strength = 20 + (rand() % 60); // 20-80的信号强度
+static void draw_sky_legend() {
+    static const struct {
+        uint8_t snr;
+        bool hollow;
+        const char* label;
+    } kLegend[] = {{40, false, "Good"}, {30, false, "Fair"}, {10, false, "Weak"}, {40, true, "Unused"}, {0, true, "Idle"}};
+    
+    uint16_t y = SKY_PLOT_Y + 20;
+    for (const auto& item : kLegend) {
+        if (!item.hollow) {
+            draw_filled_rect(SKY_LEGEND_X, y + 2, 8, 8, SkyPlot::snrColor(item.snr));
+        } else {
+            draw_rect(SKY_LEGEND_X, y + 2, 8, 8, item.snr > 0 ? SkyPlot::snrColor(item.snr) : COLOR_GRAY);
+        }
+        draw_string(SKY_LEGEND_X + 12, y, item.label, COLOR_LIGHT_GRAY, COLOR_BLACK);
+        y += 20;
+    }
+}
+
+/**
+ * @brief 绘制右侧卫星天空图（GSV方位角/仰角，按信噪比着色，GSA中参与定位的卫星为实心）
+ * @param full 是否重画网格、标题和图例；平时只增量更新变化的卫星标记
+ */
+void draw_satellite_panel(bool full) {
+    static char prev_title[24] = {0};
+    static uint32_t drawn_generation = 0;
+    if (!sky_plot) {
+        return;
+    }
+    
+    uint16_t x = LEFT_PANEL_WIDTH + PANEL_SPACING + MARGIN_X;
+    char title[24];
+    snprintf(title, sizeof(title), "Satellites %u/%u/%u", gps_sky_used_count(GPS_SKY_SYSTEM_COUNT),
+             gps_sky_tracked(), gps_sky_count());
+    if (full || strcmp(title, prev_title) != 0) {
+        draw_filled_rect(x, SIGNAL_START_Y, SIGNAL_AREA_WIDTH, 16, COLOR_BLACK);
+        draw_string(x, SIGNAL_START_Y, title, COLOR_WHITE, COLOR_BLACK);
+        strcpy(prev_title, title);
+    }
+    
+    if (full) {
+        sky_plot->redraw();
+        draw_sky_legend();
+    } else if (gps_sky_generation() == drawn_generation && !sky_plot->pending()) {
+        return;
+    }
+    drawn_generation = gps_sky_generation();
+    sky_plot->update(gps_sky_sats(), gps_sky_count(), gps_sky_has_used());
+}
+
+/**
+ * @brief 绘制右侧行程统计（行程A、平均/最高速度、总里程）
+ */
+void draw_trip_panel() {
+    static char prev_lines[3][32] = {{0}};
+    
+    const gps_trip_t* trip = gps_trip_get(0);
+    const gps_trip_t* odometer = gps_trip_odometer();
+    char lines[3][32];
+    snprintf(lines[0], sizeof(lines[0]), "Trip: %.2f km  %lu:%02lu",
+             trip->distance_m / 1000.0,
+             (unsigned long)(trip->moving_ms / 3600000u),
+             (unsigned long)(trip->moving_ms / 60000u % 60u));
+    snprintf(lines[1], sizeof(lines[1]), "Avg %.1f Max %.1f km/h",
+             gps_trip_avg_speed_kmh(trip), trip->max_speed_kmh);
+    snprintf(lines[2], sizeof(lines[2]), "Odo: %.1f km", odometer->distance_m / 1000.0);
+    
+    uint16_t x = LEFT_PANEL_WIDTH + PANEL_SPACING + MARGIN_X;
+    uint16_t y = TRIP_START_Y;
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(lines[i], prev_lines[i]) != 0) {
+            draw_filled_rect(x, y, SIGNAL_AREA_WIDTH, 16, COLOR_BLACK);
+            draw_string(x, y, lines[i], i == 2 ? COLOR_CYAN : COLOR_WHITE, COLOR_BLACK);
+            strcpy(prev_lines[i], lines[i]);
+        }
+        y += TRIP_LINE_HEIGHT;
+    }
+}
+
+/**
+ * @brief 绘制右侧历史曲线（速度、海拔、平均信噪比）
+ * @param full 是否重画标签和整条曲线；平时每个新样本只画一列
+ */
+void draw_chart_panel(bool full) {
+    static char prev_labels[CHART_COUNT][40] = {{0}};
+    
+    for (int i = 0; i < CHART_COUNT; i++) {
+        StripChart* chart = charts[i];
+        if (!chart) {
+            return;
         }
         
-        // 清除旧条
-        draw_filled_rect(x, panel_y, bar_width, max_bar_height, COLOR_BLACK);
-        
-        if (signal_strength > 0) {
-            uint16_t bar_height = (signal_strength * max_bar_height) / 100;
-            uint32_t bar_color = COLOR_GREEN;
-            
-            if (signal_strength < 30) bar_color = COLOR_RED;
-            else if (signal_strength < 50) bar_color = COLOR_YELLOW;
-            else if (signal_strength < 80) bar_color = COLOR_ORANGE;
-            // 80%以上使用绿色（默认值）
-            
-            draw_filled_rect(x, base_y - bar_height, bar_width, bar_height, bar_color);
+        char label[40];
+        if (chart->empty()) {
+            snprintf(label, sizeof(label), "%s --", kCharts[i].label);
+        } else {
+            snprintf(label, sizeof(label), "%s %.1f %s  [%.0f-%.0f]", kCharts[i].label, chart->last(),
+                     kCharts[i].unit, chart->minValue(), chart->maxValue());
+        }
+        uint16_t y = MAP_VIEW_Y + 2 + i * CHART_BLOCK_HEIGHT;
+        if (full || strcmp(label, prev_labels[i]) != 0) {
+            draw_filled_rect(CHART_X, y, CHART_WIDTH, CHART_LABEL_HEIGHT, COLOR_BLACK);
+            draw_string(CHART_X, y, label, kCharts[i].color, COLOR_BLACK);
+            strcpy(prev_labels[i], label);
         }
         
-        // 绘制边框
-        draw_rect(x, panel_y, bar_width, max_bar_height, COLOR_GRAY);
+        if (full) {
+            chart->redraw();
+        } else {
+            chart->update();
+        }
+    }
+}
+
+/**
+ * @brief 绘制右侧上方面板（卫星信号、轨迹地图或历史曲线）
+ * @param full 是否全量重画；地图视图平时只增量画新轨迹段
+ */
+void draw_right_panel(bool full) {
+    if (right_view == RightPanelView::Map && track_view) {
+        if (full) {
+            track_view->redraw();
+        } else {
+            track_view->update();
+        }
+        return;
+    }
+    if (right_view == RightPanelView::Charts) {
+        if (full) {
+            draw_filled_rect(MAP_VIEW_X, MAP_VIEW_Y, MAP_VIEW_WIDTH, MAP_VIEW_HEIGHT, COLOR_BLACK);
+        }
+        draw_chart_panel(full);
+        return;
+    }
+    if (full) {
+        draw_filled_rect(MAP_VIEW_X, MAP_VIEW_Y, MAP_VIEW_WIDTH, MAP_VIEW_HEIGHT, COLOR_BLACK);
+    }
+    draw_satellite_panel(full);
+}
+
+/**
+ * @brief 切换右侧面板
+ * @param step 1为下一个视图，-1为上一个
+ */
+static void cycle_right_view(int step) {
+    static const char* const kViewNames[] = {"卫星天空图", "轨迹地图", "历史曲线"};
+    right_view = (RightPanelView)(((int)right_view + step + 3) % 3);
+    printf("[界面] 右侧面板: %s\n", kViewNames[(int)right_view]);
+}
+
+/**
+ * @brief 地图比例尺，超出范围时循环 (wrap) 或停在两端
+ * @return 比例尺是否改变
+ */
+static bool step_map_zoom(int step, bool wrap) {
+    int count = track_view->zoomLevelCount();
+    int level = track_view->zoomLevel() + step;
+    if (wrap) {
+        level = (level + count) % count;
+    } else if (level < 0 || level >= count) {
+        return false;
+    }
+    track_view->setZoomLevel((uint8_t)level);
+    printf("[界面] 地图比例尺: %.1f m/像素\n", track_view->decimetersPerPixel() / 10.0);
+    return true;
+}
+
+/**
+ * @brief 处理输入事件队列
+ *
+ * 按键短按/摇杆左右切换卫星天空图/轨迹地图/历史曲线，地图视图下长按循环
+ * 切换比例尺、摇杆上下放大/缩小。积压的事件一起处理后只重画一次，每个事件
+ * 记录从输入到重画完成的延迟。
+ */
+static void handle_input() {
+    input_event_t events[8];
+    int count = 0;
+    bool redraw = false;
+    
+    input_event_t event;
+    while (count < 8 && input_events_pop(&event)) {
+        if (!display_initialized || !track_view) {
+            continue;
+        }
         
-        // 卫星编号
-        char sat_num[4];
-        snprintf(sat_num, sizeof(sat_num), "%d", i + 1);
-        draw_string(x + 6, base_y + 5, sat_num, COLOR_WHITE, COLOR_BLACK);
+        bool handled = true;
+        bool on_map = right_view == RightPanelView::Map;
+        switch (event.type) {
+            case INPUT_BUTTON_SHORT:
+            case INPUT_JOY_RIGHT:
+                cycle_right_view(1);
+                break;
+            case INPUT_JOY_LEFT:
+                cycle_right_view(-1);
+                break;
+            case INPUT_BUTTON_LONG:
+                handled = on_map && step_map_zoom(1, true);
+                break;
+            case INPUT_JOY_UP:
+                handled = on_map && step_map_zoom(-1, false);
+                break;
+            case INPUT_JOY_DOWN:
+                handled = on_map && step_map_zoom(1, false);
+                break;
+            default:
+                handled = false;
+                break;
+        }
+        if (handled) {
+            events[count++] = event;
+            redraw = true;
+        }
     }
     
-    // 绘制信号强度图例 (横屏优化)
-    panel_y = base_y + 25;
-    draw_string(start_x, panel_y, "Signal Strength:", COLOR_WHITE, COLOR_BLACK);
-    panel_y += 18;
-    
-    // 图例颜色条 (优化间距布局)
-    const uint16_t legend_spacing = 50;  // 进一步增加间距
-    const uint16_t color_bar_width = 12;
-    const uint16_t text_offset = 16;
-    
-    // Weak
-    draw_filled_rect(start_x, panel_y, color_bar_width, 8, COLOR_RED);
-    draw_string(start_x + text_offset, panel_y, "Weak", COLOR_RED, COLOR_BLACK);
+    if (!redraw) {
+        return;
+    }
     
-    // Fair
-    draw_filled_rect(start_x + legend_spacing, panel_y, color_bar_width, 8, COLOR_YELLOW);
-    draw_string(start_x + legend_spacing + text_offset, panel_y, "Fair", COLOR_YELLOW, COLOR_BLACK);
+    BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_RENDER);
+    if (XIP_STATS_ENABLED) {
+        xip_stats_begin(XIP_STAGE_RENDER);
+    }
+    draw_right_panel(true);
+    if (XIP_STATS_ENABLED) {
+        xip_stats_end(XIP_STAGE_RENDER);
+    }
+    BUS_CAPTURE_STAGE_END(BUS_STAGE_RENDER);
     
-    // Good
-    draw_filled_rect(start_x + legend_spacing * 2, panel_y, color_bar_width, 8, COLOR_GREEN);
-    draw_string(start_x + legend_spacing * 2 + text_offset, panel_y, "Good", COLOR_GREEN, COLOR_BLACK);
+    uint32_t done_us = time_us_32();
+    for (int i = 0; i < count; i++) {
+        input_events_record_latency(&events[i], done_us);
+    }
 }
 
 /**
@@ -517,11 +889,12 @@ void draw_status_bar() {
     }
     
     // UTC时间显示 (横屏优化位置，向左移动5像素)
-    if (current_gps_data.Status > 0) {
+    if (gps_fix_is_valid(&current_fix)) {
         char utc_time_str[20];
-        // 直接使用GPS原始时间
-        snprintf(utc_time_str, sizeof(utc_time_str), "UTC: %02d:%02d:%02d", 
-                 current_gps_data.Time_H, current_gps_data.Time_M, current_gps_data.Time_S);
+        // 与旧版一致显示北京时间
+        uint8_t hour, minute, second;
+        gps_fix_local_hms(&current_fix, &hour, &minute, &second);
+        snprintf(utc_time_str, sizeof(utc_time_str), "UTC: %02d:%02d:%02d", hour, minute, second);
         
         if (strcmp(utc_time_str, prev_utc_time_str) != 0) {
             draw_filled_rect(SCREEN_WIDTH - 125, STATUS_BAR_Y + 8, 125, 12, COLOR_BLACK);
@@ -547,7 +920,8 @@ void draw_complete_interface() {
     
     // 绘制面板
     draw_gps_info_panel();
-    draw_satellite_panel();
+    draw_right_panel(true);
+    draw_trip_panel();
     draw_status_bar();
 }
 
@@ -555,9 +929,18 @@ void draw_complete_interface() {
  * @brief 更新显示内容
  */
 void update_display() {
-    // 更新各个面板
+    // 更新各个面板；质量门限拒绝的历元没有新轨迹点，跳过地图更新
     draw_gps_info_panel();
-    draw_satellite_panel();
+    if (right_view != RightPanelView::Map) {
+        draw_right_panel(false);
+    } else if (current_fix_class == GPS_QUALITY_REJECT) {
+        gps_quality_work_skipped(GPS_QUALITY_WORK_MAP);
+    } else {
+        uint32_t map_start_us = time_us_32();
+        draw_right_panel(false);
+        gps_quality_work_done(GPS_QUALITY_WORK_MAP, time_us_32() - map_start_us);
+    }
+    draw_trip_panel();
     draw_status_bar();
 }
 
@@ -594,48 +977,86 @@ extern "C" int vendor_gps_ili9488_optimized_demo() {
     }
     
     printf("GPS初始化成功\n");
+
+    if (NMEA_BENCH_ON_BOOT) {
+        gps_nmea_bench_run();
+    }
+
+#ifdef LC76G_BUS_CAPTURE
+    bus_capture_init();
+    bus_capture_enable(true);
+    printf("[总线捕获] 已启用，环形缓冲 %d 条\n", BUS_CAPTURE_RING_RECORDS);
+#endif
     
     // 启用调试模式
     lc76g_set_debug(true);
     printf("LC76G I2C适配器已启用调试模式\n");
     
+    if (TELEMETRY_ENABLED) {
+        gps_telemetry_init(gps_telemetry_usb_write, nullptr);
+        lc76g_set_epoch_hook(send_epoch_telemetry, nullptr);
+    }
+    
+    // 载入总里程和行程 (日志文件头包含行程统计，需在日志记录器之前载入)
+    gps_trip_init();
+    
     // 初始化GPS SD卡日志记录器 (可选功能)
     printf("正在初始化GPS SD卡日志记录器...\n");
     if (initialize_sd_logger()) {
         printf("GPS SD卡日志记录器初始化成功\n");
+        // 日志目录可通过USB串口下载，不必取出SD卡
+        gps_log_transfer_init(gps_log_transfer_usb_transport(), "/gps_logs");
     } else {
         printf("GPS SD卡日志记录器初始化失败，系统将继续运行\n");
     }
     
-    // LC76G增强配置
-    printf("配置LC76G模块...\n");
-    
-    // LC76G I2C适配器通过命令配置GPS模块
-    printf("✓ LC76G I2C适配器配置完成\n");
+    // 载入上次保存的启动状态
+    gps_warm_start_init();
+    gps_warm_start_print_stats();
     
     // 执行智能GPS启动
     printf("执行智能GPS启动流程...\n");
     
-    // 1. LC76G I2C适配器自动处理GPS启动
-    printf("步骤1: LC76G I2C适配器自动启动GPS模块\n");
-    
-    // 2. 等待GPS模块响应
-    printf("步骤2: 等待GPS模块响应...\n");
+    // 1. 等待GPS模块响应
+    printf("步骤1: 等待GPS模块响应...\n");
     sleep_ms(2000);
     
-    // 3. 发送设置命令
-    printf("步骤3: 发送NMEA配置命令\n");
-    lc76g_send_command("$PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0", 50);
-    sleep_ms(100);
-    lc76g_send_command("$PMTK220,1000", 12);
+    // 2. 下发保存的接收机配置（首次启动为RMC+GGA、1秒间隔）
+    printf("步骤2: 发送NMEA配置命令\n");
+    gps_receiver_config_t receiver_config;
+    if (gps_warm_start_get_config(&receiver_config)) {
+        printf("[GPS启动] 使用保存的接收机配置\n");
+    }
+    gps_warm_start_apply_config(&receiver_config);
     sleep_ms(500);
     
-    // 4. 检查GPS状态
-    printf("步骤4: 检查GPS状态\n");
-    LC76G_GPS_Data test_data;
-    lc76g_read_gps_data(&test_data);
-    printf("[GPS调试] 初始状态检查 - 状态: %d, 时间: %02d:%02d:%02d\n", 
-           test_data.Status, test_data.Time_H, test_data.Time_M, test_data.Time_S);
+    // 3. 检查GPS状态，模块RTC仍在运行时可得到当前UTC
+    printf("步骤3: 检查GPS状态\n");
+    gps_fix_t test_fix;
+    lc76g_read_fix(&test_fix);
+    uint8_t test_h, test_m, test_s;
+    gps_fix_local_hms(&test_fix, &test_h, &test_m, &test_s);
+    printf("[GPS调试] 初始状态检查 - 状态: %d, 时间: %02d:%02d:%02d\n",
+           gps_fix_is_valid(&test_fix), test_h, test_m, test_s);
+    
+    // 4. 按断电时长选择热/温/冷启动
+    printf("步骤4: 选择启动方式\n");
+    uint32_t utc_now = 0;
+    lc76g_get_utc_time(&utc_now);
+    gps_warm_start_boot(utc_now);
+    
+    // 加载SD卡上的地理围栏 (没有围栏文件时不判定)
+    if (sd_logger_initialized) {
+        gps_geofence_load_file(GPS_GEOFENCE_DEFAULT_PATH);
+    }
+    
+    // 5. 冷启动时注入SD卡上的辅助数据（SD卡已由日志记录器挂载）
+    if (gps_warm_start_boot_type() == GPS_START_COLD && sd_logger_initialized) {
+        printf("步骤5: 注入辅助数据\n");
+        if (gps_assist_load_file(GPS_ASSIST_DEFAULT_PATH, utc_now, NULL)) {
+            gps_warm_start_mark_assisted();
+        }
+    }
     
     // 设置随机数种子
     srand(time_us_32());
@@ -652,13 +1073,63 @@ extern "C" int vendor_gps_ili9488_optimized_demo() {
     // 设置屏幕参数
     driver->setRotation(Rotation::Landscape_270);  // 横屏模式 (480x320) - 旋转180度
     driver->setBacklight(true);
+    
+    // 轨迹地图视图 (占用右侧卫星信号区域)
+    TrackView::Config map_config;
+    map_config.x = MAP_VIEW_X;
+    map_config.y = MAP_VIEW_Y;
+    map_config.width = MAP_VIEW_WIDTH;
+    map_config.height = MAP_VIEW_HEIGHT;
+    map_config.background = COLOR_BLACK;
+    map_config.trail = COLOR_CYAN;
+    map_config.head = COLOR_YELLOW;
+    map_config.scale = COLOR_GRAY;
+    track_view = new TrackView(*driver, map_config);
+    
+    // 卫星天空图 (与轨迹地图共用右侧区域)
+    SkyPlot::Config sky_config;
+    sky_config.x = SKY_PLOT_X;
+    sky_config.y = SKY_PLOT_Y;
+    sky_config.size = SKY_PLOT_SIZE;
+    sky_config.background = COLOR_BLACK;
+    sky_config.grid = COLOR_DARK_GRAY;
+    sky_config.untracked = COLOR_GRAY;
+    sky_plot = new SkyPlot(*driver, sky_config);
+    
+    // 历史曲线 (与轨迹地图共用右侧区域)
+    for (int i = 0; i < CHART_COUNT; i++) {
+        StripChart::Config chart_config;
+        chart_config.x = CHART_X;
+        chart_config.y = MAP_VIEW_Y + 2 + i * CHART_BLOCK_HEIGHT + CHART_LABEL_HEIGHT;
+        chart_config.width = CHART_WIDTH;
+        chart_config.height = CHART_HEIGHT;
+        chart_config.background = COLOR_BLACK;
+        chart_config.grid = COLOR_DARK_GRAY;
+        chart_config.line = kCharts[i].color;
+        chart_config.samples_per_column = CHART_SAMPLES_PER_COLUMN;
+        chart_config.min_value = kCharts[i].min_value;
+        chart_config.max_value = kCharts[i].max_value;
+        chart_config.range_step = kCharts[i].range_step;
+        charts[i] = new StripChart(*driver, chart_config);
+    }
+    
+    // SD卡上有瓦片包时作为地图底图
+    if (sd_logger_initialized) {
+        tile_map = new TileMap(*driver);
+        if (tile_map->open(TileMap::DEFAULT_PATH)) {
+            track_view->setBasemap(tile_map);
+        }
+    }
+    
+    // 视图切换按键（GPIO中断）和摇杆（与GPS共用I2C1，在总线空闲时采样）
+    input_events_init();
+    
     display_initialized = true;
     
     printf("显示驱动初始化成功\n");
     
     // 初始化GPS数据结构
-    memset(&current_gps_data, 0, sizeof(LC76G_GPS_Data));
-    memset(&previous_gps_data, 0, sizeof(LC76G_GPS_Data));
+    memset(&current_fix, 0, sizeof(current_fix));
     
     // 显示启动画面 (横屏优化)
     fill_screen(COLOR_BLACK);
@@ -676,6 +1147,8 @@ extern "C" int vendor_gps_ili9488_optimized_demo() {
     
     // 主循环
     uint32_t last_gps_update = 0;
+    uint32_t last_frame = 0;
+    uint32_t last_telemetry_poll = 0;
     
     while (true) {
         uint32_t current_time = to_ms_since_boot(get_absolute_time());
@@ -695,6 +1168,20 @@ extern "C" int vendor_gps_ili9488_optimized_demo() {
                     printf("[GPS警告] 定位成功率过低，建议检查天线或移动到开阔区域\n");
                 }
                 
+                if (packet_count % 30 == 0) {
+                    if (TELEMETRY_ENABLED) {
+                        gps_telemetry_print_stats();
+                    }
+                    if (XIP_STATS_ENABLED) {
+                        xip_stats_print();
+                    }
+                    gps_quality_print_stats();
+                    if (sd_logger_initialized) {
+                        gps_flush_print_stats();
+                    }
+                    input_events_print_stats();
+                }
+                
                 // 如果连续失败超过20次，LC76G I2C适配器自动处理
                 if (consecutive_failures > 20) {
                     printf("[GPS恢复] LC76G I2C适配器自动处理GPS模块重启...\n");
@@ -706,18 +1193,65 @@ extern "C" int vendor_gps_ili9488_optimized_demo() {
             update_gps_data();
             
             // 处理GPS数据记录到SD卡 (后台运行)
-            process_gps_logging(current_gps_data);
+            process_gps_logging(current_fix);
+            
+            // 地理围栏进出判定 (日志文件在首次记录时创建，放在记录之后)
+            process_geofence_events(current_fix);
             
             // 更新显示
             if (display_initialized) {
+                BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_RENDER);
+                if (XIP_STATS_ENABLED) {
+                    xip_stats_begin(XIP_STAGE_RENDER);
+                }
                 update_display();
+                if (XIP_STATS_ENABLED) {
+                    xip_stats_end(XIP_STAGE_RENDER);
+                }
+                BUS_CAPTURE_STAGE_END(BUS_STAGE_RENDER);
             }
             
             last_gps_update = current_time;
+        } else if (display_initialized && current_time - last_frame >= DISPLAY_FRAME_INTERVAL) {
+            // GPS更新之间按帧率刷新平滑后的位置/速度/航向
+            BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_RENDER);
+            if (XIP_STATS_ENABLED) {
+                xip_stats_begin(XIP_STAGE_RENDER);
+            }
+            draw_gps_info_panel(true);
+            if (XIP_STATS_ENABLED) {
+                xip_stats_end(XIP_STAGE_RENDER);
+            }
+            BUS_CAPTURE_STAGE_END(BUS_STAGE_RENDER);
+            last_frame = current_time;
+        }
+        
+        // 两次GPS更新之间按定位频率读取，遥测帧不在模块缓冲中等到下一次GPS更新
+        current_time = to_ms_since_boot(get_absolute_time());
+        if (TELEMETRY_ENABLED && current_time - last_telemetry_poll >= TELEMETRY_POLL_INTERVAL) {
+            poll_telemetry();
+            last_telemetry_poll = current_time;
         }
         
-        // 检查并刷新SD卡日志缓冲区 (后台运行)
-        check_log_flush();
+        // 采样摇杆，处理按键/摇杆事件（右侧面板切换/地图缩放）
+        input_events_poll();
+        handle_input();
+        
+        // 到下一次GPS读取或显示帧之前的空闲时间内刷新SD卡日志缓冲区
+        uint32_t loop_time = to_ms_since_boot(get_absolute_time());
+        int32_t gps_slack = (int32_t)(last_gps_update + GPS_UPDATE_INTERVAL - loop_time);
+        int32_t frame_slack = (int32_t)(last_frame + DISPLAY_FRAME_INTERVAL - loop_time);
+        int32_t slack_ms = gps_slack < frame_slack ? gps_slack : frame_slack;
+        if (TELEMETRY_ENABLED) {
+            int32_t poll_slack = (int32_t)(last_telemetry_poll + TELEMETRY_POLL_INTERVAL - loop_time);
+            slack_ms = poll_slack < slack_ms ? poll_slack : slack_ms;
+        }
+        check_log_flush(slack_ms > 0 ? (uint32_t)slack_ms * 1000u : 0u);
+        
+        // 处理日志下载命令；下载进行中不延时，尽量占满USB带宽
+        if (sd_logger_initialized && gps_log_transfer_poll(20)) {
+            continue;
+        }
         
         // 短暂延时
         sleep_ms(10);
@@ -730,6 +1264,37 @@ extern "C" int vendor_gps_ili9488_optimized_demo() {
 // GPS SD卡日志记录器函数
 // =============================================================================
 
+/**
+ * @brief 判定地理围栏进出，事件写入SD卡日志
+ */
+static void process_geofence_events(const gps_fix_t& fix) {
+    if (!gps_fix_is_valid(&fix)) {
+        return;
+    }
+    // 质量门限拒绝的定位（位置跳变、HDOP过大等）不参与进出判定，避免误报事件
+    if (current_fix_class == GPS_QUALITY_REJECT) {
+        gps_quality_work_skipped(GPS_QUALITY_WORK_FENCE);
+        return;
+    }
+    
+    gps_geofence_event_t events[4];
+    uint32_t fence_start_us = time_us_32();
+    int count = gps_geofence_update(&fix, events, 4);
+    
+    for (int i = 0; i < count; i++) {
+        char event[64];
+        snprintf(event, sizeof(event), "围栏%s,%lu,%s",
+                 events[i].entered ? "进入" : "离开",
+                 (unsigned long)events[i].id, events[i].name);
+        printf("[地理围栏] %s\n", event);
+        
+        if (sd_logger_initialized && gps_logger) {
+            gps_logger->log_event(event);
+        }
+    }
+    gps_quality_work_done(GPS_QUALITY_WORK_FENCE, time_us_32() - fence_start_us);
+}
+
 /**
  * @brief 初始化GPS SD卡日志记录器
  * @return true 初始化成功，false 初始化失败
@@ -774,16 +1339,25 @@ static bool initialize_sd_logger() {
 
 /**
  * @brief 处理GPS数据记录到SD卡
- * @param gps_data GPS数据
+ * @param fix 定位
  */
-static void process_gps_logging(const LC76G_GPS_Data& gps_data) {
+static void process_gps_logging(const gps_fix_t& fix) {
     if (!sd_logger_initialized || !gps_logger) {
         return;
     }
     
-    // 只有GPS信号有效时才记录
-    if (gps_data.Status) {
-        if (gps_logger->log_gps_data(gps_data)) {
+    // 只有GPS信号有效时才记录；质量门限拒绝的定位不做坐标转换和写入
+    if (gps_fix_is_valid(&fix)) {
+        if (current_fix_class == GPS_QUALITY_REJECT) {
+            gps_quality_work_skipped(GPS_QUALITY_WORK_LOG);
+            return;
+        }
+        BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_LOG_WRITE);
+        uint32_t log_start_us = time_us_32();
+        bool logged = gps_logger->log_fix(fix);
+        gps_quality_work_done(GPS_QUALITY_WORK_LOG, time_us_32() - log_start_us);
+        BUS_CAPTURE_STAGE_END(BUS_STAGE_LOG_WRITE);
+        if (logged) {
             total_logged_records++;
         } else {
             failed_log_records++;
@@ -794,30 +1368,52 @@ static void process_gps_logging(const LC76G_GPS_Data& gps_data) {
 
 /**
  * @brief 检查并刷新SD卡日志缓冲区
+ * @param slack_us 到下一次GPS读取或显示帧之前的空闲时间
+ *
+ * 何时写、写多少由刷新控制器（gps_flush）按实测写入耗时决定：空闲时间容得下
+ * 时写出整扇区批量，记录等待超过数据风险窗口时无论是否空闲都写出。
+ * 当前文件接近大小上限或日期即将变化时，在空闲时间内预先创建下一个日志文件，
+ * 记录路径上的轮转只交换文件名。
  */
-static void check_log_flush() {
+static void check_log_flush(uint32_t slack_us) {
     if (!sd_logger_initialized || !gps_logger) {
         return;
     }
     
+    if (gps_logger->should_batch_write(slack_us)) {
+        BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_LOG_FLUSH);
+        bool flushed = gps_logger->service_flush(slack_us);
+        BUS_CAPTURE_STAGE_END(BUS_STAGE_LOG_FLUSH);
+        if (!flushed) {
+            printf("[SD Logger] 缓冲区刷新失败\n");
+        }
+    } else if (gps_logger->needs_next_log_file()) {
+        BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_LOG_FLUSH);
+        bool prepared = gps_logger->service_rotation(slack_us);
+        BUS_CAPTURE_STAGE_END(BUS_STAGE_LOG_FLUSH);
+        if (!prepared) {
+            printf("[SD Logger] 预先创建日志文件失败\n");
+        }
+    }
+    
     uint64_t current_time = to_ms_since_boot(get_absolute_time());
     
-    // 每10秒刷新一次缓冲区
+    // 每10秒检查一次高德API格式文件和总线捕获
     if (current_time - last_log_flush_time >= 10000) {
-        if (gps_logger->flush_buffer()) {
-            printf("[SD Logger] 缓冲区已刷新\n");
-            
-            // 每30秒生成一次高德API格式文件
-            static uint64_t last_gaode_write = 0;
-            if (current_time - last_gaode_write >= 30000) {
-                if (gps_logger->write_gaode_api_format()) {
-                    printf("[SD Logger] 高德API格式文件已更新\n");
-                }
-                last_gaode_write = current_time;
+        // 每30秒生成一次高德API格式文件
+        static uint64_t last_gaode_write = 0;
+        if (current_time - last_gaode_write >= 30000) {
+            if (gps_logger->write_gaode_api_format()) {
+                printf("[SD Logger] 高德API格式文件已更新\n");
             }
-        } else {
-            printf("[SD Logger] 缓冲区刷新失败\n");
+            last_gaode_write = current_time;
+        }
+#ifdef LC76G_BUS_CAPTURE
+        // 总线捕获随日志一起写出
+        if (!bus_capture_flush("/gps_logs/bus_capture.bin")) {
+            printf("[总线捕获] 写出失败，待写 %lu 条\n", (unsigned long)bus_capture_pending());
         }
+#endif
         last_log_flush_time = current_time;
     }
 }
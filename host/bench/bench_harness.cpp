@@ -0,0 +1,438 @@
+/**
+ * @file bench_harness.cpp
+ * @brief 主机微基准测试框架实现
+ */
+
+#include "bench_harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kSchema = "lc76g-bench/1";
+
+double time_run_ns(const Case& c, uint64_t iterations) {
+    auto start = Clock::now();
+    c.run(iterations);
+    clobber_memory();
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+/**
+ * @brief 标定每个样本的迭代次数
+ */
+uint64_t calibrate(const Case& c, double min_sample_ns) {
+    uint64_t iterations = 1;
+    while (iterations < (1ull << 40)) {
+        double ns = time_run_ns(c, iterations);
+        if (ns >= min_sample_ns) {
+            return iterations;
+        }
+        // 按比例放大，至少翻倍，避免在计时粒度附近反复试探
+        double scale = ns > 0 ? (min_sample_ns * 1.2) / ns : 10.0;
+        uint64_t next = (uint64_t)((double)iterations * std::min(std::max(scale, 2.0), 100.0));
+        iterations = std::max(next, iterations + 1);
+    }
+    return iterations;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    double pos = p * (double)(sorted.size() - 1);
+    size_t lo = (size_t)pos;
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    double frac = pos - (double)lo;
+    return sorted[lo] * (1.0 - frac) + sorted[hi] * frac;
+}
+
+// =============================================================================
+// 最小JSON读取器（只需支持write_json的输出）
+// =============================================================================
+
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : s_(text), pos_(0) {}
+
+    bool parse_results(std::vector<Result>& out) {
+        if (!expect('{')) return false;
+        while (true) {
+            std::string key;
+            if (!parse_string(key) || !expect(':')) return false;
+            if (key == "results") {
+                if (!parse_result_array(out)) return false;
+            } else if (!skip_value()) {
+                return false;
+            }
+            if (peek() == ',') { pos_++; continue; }
+            return expect('}');
+        }
+    }
+
+private:
+    char peek() {
+        skip_ws();
+        return pos_ < s_.size() ? s_[pos_] : '\0';
+    }
+
+    void skip_ws() {
+        while (pos_ < s_.size() && (s_[pos_] == ' ' || s_[pos_] == '\n' || s_[pos_] == '\r' || s_[pos_] == '\t')) {
+            pos_++;
+        }
+    }
+
+    bool expect(char c) {
+        if (peek() != c) return false;
+        pos_++;
+        return true;
+    }
+
+    bool parse_string(std::string& out) {
+        if (!expect('"')) return false;
+        out.clear();
+        while (pos_ < s_.size() && s_[pos_] != '"') {
+            if (s_[pos_] == '\\' && pos_ + 1 < s_.size()) {
+                pos_++;
+            }
+            out.push_back(s_[pos_++]);
+        }
+        return expect('"');
+    }
+
+    bool parse_number(double& out) {
+        skip_ws();
+        const char* begin = s_.c_str() + pos_;
+        char* end = nullptr;
+        out = std::strtod(begin, &end);
+        if (end == begin) return false;
+        pos_ += (size_t)(end - begin);
+        return true;
+    }
+
+    bool skip_value() {
+        char c = peek();
+        if (c == '"') {
+            std::string tmp;
+            return parse_string(tmp);
+        }
+        if (c == '{' || c == '[') {
+            char close = c == '{' ? '}' : ']';
+            pos_++;
+            if (peek() == close) { pos_++; return true; }
+            while (true) {
+                if (c == '{') {
+                    std::string key;
+                    if (!parse_string(key) || !expect(':')) return false;
+                }
+                if (!skip_value()) return false;
+                if (peek() == ',') { pos_++; continue; }
+                return expect(close);
+            }
+        }
+        if (std::strncmp(s_.c_str() + pos_, "true", 4) == 0) { pos_ += 4; return true; }
+        if (std::strncmp(s_.c_str() + pos_, "false", 5) == 0) { pos_ += 5; return true; }
+        if (std::strncmp(s_.c_str() + pos_, "null", 4) == 0) { pos_ += 4; return true; }
+        double tmp;
+        return parse_number(tmp);
+    }
+
+    bool parse_number_object(std::map<std::string, double>& out) {
+        if (!expect('{')) return false;
+        if (peek() == '}') { pos_++; return true; }
+        while (true) {
+            std::string key;
+            double value;
+            if (!parse_string(key) || !expect(':') || !parse_number(value)) return false;
+            out[key] = value;
+            if (peek() == ',') { pos_++; continue; }
+            return expect('}');
+        }
+    }
+
+    bool parse_result(Result& r) {
+        if (!expect('{')) return false;
+        while (true) {
+            std::string key;
+            if (!parse_string(key) || !expect(':')) return false;
+            if (key == "name") {
+                if (!parse_string(r.name)) return false;
+            } else if (key == "ns_per_op") {
+                std::map<std::string, double> stats;
+                if (!parse_number_object(stats)) return false;
+                r.min_ns = stats["min"];
+                r.median_ns = stats["median"];
+                r.mean_ns = stats["mean"];
+                r.p90_ns = stats["p90"];
+                r.stddev_ns = stats["stddev"];
+            } else if (key == "counters") {
+                if (!parse_number_object(r.counters)) return false;
+            } else if (key == "iterations" || key == "samples") {
+                double v;
+                if (!parse_number(v)) return false;
+                if (key == "iterations") r.iterations = (uint64_t)v;
+                else r.samples = (uint32_t)v;
+            } else if (!skip_value()) {
+                return false;
+            }
+            if (peek() == ',') { pos_++; continue; }
+            return expect('}');
+        }
+    }
+
+    bool parse_result_array(std::vector<Result>& out) {
+        if (!expect('[')) return false;
+        if (peek() == ']') { pos_++; return true; }
+        while (true) {
+            Result r;
+            if (!parse_result(r)) return false;
+            out.push_back(r);
+            if (peek() == ',') { pos_++; continue; }
+            return expect(']');
+        }
+    }
+
+    const std::string& s_;
+    size_t pos_;
+};
+
+void print_usage(const char* prog) {
+    printf("用法: %s [选项]\n", prog);
+    printf("  --filter <子串>        只运行名称包含该子串的用例\n");
+    printf("  --samples <N>          每个用例的样本数 (默认15)\n");
+    printf("  --min-time-ms <ms>     单个样本的最短时间 (默认2)\n");
+    printf("  --json <文件>          写出JSON结果\n");
+    printf("  --baseline <文件>      与基线JSON比较\n");
+    printf("  --threshold <百分比>   中位数回退阈值 (默认10)\n");
+    printf("  --fail-on-regression   出现回退时返回非零退出码\n");
+    printf("  --list                 只列出用例名称\n");
+}
+
+} // namespace
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--filter") == 0 && has_value) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(arg, "--samples") == 0 && has_value) {
+            options.samples = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--min-time-ms") == 0 && has_value) {
+            options.min_sample_ms = std::max(0.01, std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--json") == 0 && has_value) {
+            options.json_path = argv[++i];
+        } else if (std::strcmp(arg, "--baseline") == 0 && has_value) {
+            options.baseline_path = argv[++i];
+        } else if (std::strcmp(arg, "--threshold") == 0 && has_value) {
+            options.threshold_pct = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--fail-on-regression") == 0) {
+            options.fail_on_regression = true;
+        } else if (std::strcmp(arg, "--list") == 0) {
+            options.list_only = true;
+        } else {
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<Result> run_cases(const std::vector<Case>& cases, const Options& options) {
+    std::vector<Result> results;
+    const double min_sample_ns = options.min_sample_ms * 1e6;
+
+    for (const Case& c : cases) {
+        if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        Result r;
+        r.name = c.name;
+
+        // 计数器单独采集一次，保证与计时循环无关且可重复
+        if (c.counters) {
+            r.counters = c.counters();
+        }
+
+        // 预热
+        time_run_ns(c, 1);
+        r.iterations = calibrate(c, min_sample_ns);
+        r.samples = options.samples;
+
+        std::vector<double> per_op(r.samples);
+        for (uint32_t s = 0; s < r.samples; s++) {
+            per_op[s] = time_run_ns(c, r.iterations) / (double)r.iterations;
+        }
+        std::sort(per_op.begin(), per_op.end());
+
+        double sum = 0;
+        for (double v : per_op) sum += v;
+        r.mean_ns = sum / (double)per_op.size();
+        double var = 0;
+        for (double v : per_op) var += (v - r.mean_ns) * (v - r.mean_ns);
+        r.stddev_ns = per_op.size() > 1 ? std::sqrt(var / (double)(per_op.size() - 1)) : 0.0;
+        r.min_ns = per_op.front();
+        r.median_ns = percentile(per_op, 0.5);
+        r.p90_ns = percentile(per_op, 0.9);
+
+        printf("  %-36s %12.1f ns/op\n", r.name.c_str(), r.median_ns);
+        fflush(stdout);
+        results.push_back(r);
+    }
+    return results;
+}
+
+bool write_json(const std::string& path, const std::vector<Result>& results) {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        printf("[Bench] 无法写入 %s\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\n  \"schema\": \"%s\",\n", kSchema);
+#if defined(__VERSION__)
+    std::fprintf(f, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    std::fprintf(f, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::fprintf(f, "    {\n      \"name\": \"%s\",\n", r.name.c_str());
+        std::fprintf(f, "      \"iterations\": %llu,\n", (unsigned long long)r.iterations);
+        std::fprintf(f, "      \"samples\": %u,\n", r.samples);
+        std::fprintf(f, "      \"ns_per_op\": {\"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"p90\": %.3f, \"stddev\": %.3f},\n",
+                     r.min_ns, r.median_ns, r.mean_ns, r.p90_ns, r.stddev_ns);
+        std::fprintf(f, "      \"counters\": {");
+        size_t n = 0;
+        for (const auto& kv : r.counters) {
+            std::fprintf(f, "%s\"%s\": %.17g", n++ ? ", " : "", kv.first.c_str(), kv.second);
+        }
+        std::fprintf(f, "}\n    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+    return true;
+}
+
+bool read_json(const std::string& path, std::vector<Result>& results) {
+    FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) {
+        printf("[Bench] 无法读取基线 %s\n", path.c_str());
+        return false;
+    }
+    std::string text;
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+        text.append(buf, n);
+    }
+    std::fclose(f);
+
+    JsonReader reader(text);
+    if (!reader.parse_results(results)) {
+        printf("[Bench] 基线格式错误: %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::vector<Comparison> compare(const std::vector<Result>& baseline,
+                                const std::vector<Result>& current,
+                                double threshold_pct) {
+    std::vector<Comparison> out;
+    for (const Result& cur : current) {
+        Comparison c;
+        c.name = cur.name;
+        c.current_ns = cur.median_ns;
+        auto it = std::find_if(baseline.begin(), baseline.end(),
+                               [&](const Result& b) { return b.name == cur.name; });
+        if (it == baseline.end()) {
+            c.missing = true;
+            out.push_back(c);
+            continue;
+        }
+        c.baseline_ns = it->median_ns;
+        c.delta_pct = it->median_ns > 0 ? (cur.median_ns - it->median_ns) * 100.0 / it->median_ns : 0.0;
+        c.regression = c.delta_pct > threshold_pct;
+        // 计数器是确定性的，任何变化都说明行为变了
+        c.counters_changed = it->counters != cur.counters;
+        out.push_back(c);
+    }
+    return out;
+}
+
+void print_results(const std::vector<Result>& results) {
+    printf("\n%-36s %12s %12s %12s %10s\n", "用例", "median(ns)", "p90(ns)", "min(ns)", "stddev%");
+    for (const Result& r : results) {
+        double rel = r.mean_ns > 0 ? r.stddev_ns * 100.0 / r.mean_ns : 0.0;
+        printf("%-36s %12.1f %12.1f %12.1f %9.1f%%\n", r.name.c_str(), r.median_ns, r.p90_ns, r.min_ns, rel);
+        for (const auto& kv : r.counters) {
+            printf("    %-32s %12.1f /op\n", kv.first.c_str(), kv.second);
+        }
+    }
+}
+
+void print_comparison(const std::vector<Comparison>& comparisons, double threshold_pct) {
+    printf("\n基线比较 (阈值 %.1f%%):\n", threshold_pct);
+    printf("%-36s %12s %12s %9s\n", "用例", "基线(ns)", "当前(ns)", "变化");
+    for (const Comparison& c : comparisons) {
+        if (c.missing) {
+            printf("%-36s %12s %12.1f %9s  新用例\n", c.name.c_str(), "-", c.current_ns, "-");
+            continue;
+        }
+        printf("%-36s %12.1f %12.1f %+8.1f%%%s%s\n", c.name.c_str(), c.baseline_ns, c.current_ns, c.delta_pct,
+               c.regression ? "  回退" : "", c.counters_changed ? "  计数器变化" : "");
+    }
+}
+
+int run_main(int argc, char** argv, const std::vector<Case>& cases) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return 2;
+    }
+
+    if (options.list_only) {
+        for (const Case& c : cases) {
+            printf("%s\n", c.name.c_str());
+        }
+        return 0;
+    }
+
+    printf("[Bench] samples=%u, min_sample=%.2fms\n", options.samples, options.min_sample_ms);
+    std::vector<Result> results = run_cases(cases, options);
+    print_results(results);
+
+    if (!options.json_path.empty() && write_json(options.json_path, results)) {
+        printf("\n[Bench] 结果已写入 %s\n", options.json_path.c_str());
+    }
+
+    int exit_code = 0;
+    if (!options.baseline_path.empty()) {
+        std::vector<Result> baseline;
+        if (!read_json(options.baseline_path, baseline)) {
+            return 2;
+        }
+        std::vector<Comparison> comparisons = compare(baseline, results, options.threshold_pct);
+        print_comparison(comparisons, options.threshold_pct);
+        size_t regressions = 0;
+        for (const Comparison& c : comparisons) {
+            if (c.regression || c.counters_changed) regressions++;
+        }
+        printf("[Bench] %zu 个用例回退或计数器变化\n", regressions);
+        if (regressions && options.fail_on_regression) {
+            exit_code = 1;
+        }
+    }
+    return exit_code;
+}
+
+} // namespace bench
@@ -0,0 +1,132 @@
+/**
+ * @file bench_harness.hpp
+ * @brief 主机微基准测试框架
+ *
+ * - 每个用例先预热，再自动标定每个样本的迭代次数，使单个样本不短于min_sample_ms
+ * - 报告每次操作耗时的 min/median/mean/p90/stddev (ns)
+ * - 用例可附带确定性的计数器（例如每次操作的SPI字节数），与时间一起写入JSON
+ * - 可与保存的基线JSON比较，超过阈值的中位数回退或计数器变化会被标记
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/**
+ * @brief 防止编译器把基准循环中的结果优化掉
+ */
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+/**
+ * @brief 每次操作的确定性计数器（名称 -> 数值）
+ */
+using Counters = std::map<std::string, double>;
+
+/**
+ * @brief 基准用例
+ *
+ * run(iterations) 执行指定次数的被测操作；
+ * counters 可选，执行一次操作并返回该次操作的计数器。
+ */
+struct Case {
+    std::string name;
+    std::function<void(uint64_t iterations)> run;
+    std::function<Counters()> counters;
+};
+
+/**
+ * @brief 单个用例的统计结果
+ */
+struct Result {
+    std::string name;
+    uint64_t iterations = 0;      // 每个样本的迭代次数
+    uint32_t samples = 0;         // 样本数
+    double min_ns = 0;
+    double median_ns = 0;
+    double mean_ns = 0;
+    double p90_ns = 0;
+    double stddev_ns = 0;
+    Counters counters;
+};
+
+/**
+ * @brief 运行参数
+ */
+struct Options {
+    std::string filter;           // 名称子串过滤
+    uint32_t samples = 15;        // 每个用例的样本数
+    double min_sample_ms = 2.0;   // 单个样本的最短时间
+    std::string json_path;        // 结果输出路径（空则不写）
+    std::string baseline_path;    // 基线JSON路径（空则不比较）
+    double threshold_pct = 10.0;  // 中位数回退阈值
+    bool fail_on_regression = false;
+    bool list_only = false;
+};
+
+/**
+ * @brief 基线比较中的单条记录
+ */
+struct Comparison {
+    std::string name;
+    double baseline_ns = 0;
+    double current_ns = 0;
+    double delta_pct = 0;
+    bool regression = false;
+    bool counters_changed = false;
+    bool missing = false;
+};
+
+/**
+ * @brief 解析命令行参数
+ * @return 参数是否有效
+ */
+bool parse_options(int argc, char** argv, Options& options);
+
+/**
+ * @brief 运行所有匹配的用例
+ */
+std::vector<Result> run_cases(const std::vector<Case>& cases, const Options& options);
+
+/**
+ * @brief 将结果写为JSON
+ */
+bool write_json(const std::string& path, const std::vector<Result>& results);
+
+/**
+ * @brief 读取由write_json生成的基线文件
+ */
+bool read_json(const std::string& path, std::vector<Result>& results);
+
+/**
+ * @brief 与基线比较
+ */
+std::vector<Comparison> compare(const std::vector<Result>& baseline,
+                                const std::vector<Result>& current,
+                                double threshold_pct);
+
+/**
+ * @brief 打印结果表和基线比较
+ */
+void print_results(const std::vector<Result>& results);
+void print_comparison(const std::vector<Comparison>& comparisons, double threshold_pct);
+
+/**
+ * @brief 标准main流程：解析参数、运行、输出、比较
+ * @return 进程退出码
+ */
+int run_main(int argc, char** argv, const std::vector<Case>& cases);
+
+} // namespace bench
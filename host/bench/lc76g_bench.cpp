@@ -0,0 +1,744 @@
+/**
+ * @file lc76g_bench.cpp
+ * @brief GPS解析、日志和渲染热点路径的主机微基准
+ *
+ * 覆盖:
+ * - 两套NMEA解析器 (lc76g_i2c_adaptor / vendor_gps_parser) 的RMC/GGA/GSV，定点定位记录转旧结构
+ * - 共用NMEA引擎的语句分派和GSA/VTG/ZDA
+ * - 校验和验证，逐字节与按字（4字节）的校验和/分帧对比
+ * - GCJ-02 / BD-09 坐标转换
+ * - GPSLogger::format_log_line，日志刷新控制器每条记录的登记和刷新计划
+ * - ILI9488字符光栅化、填充和位图传输（计数型SPI传输）
+ * - 轨迹地图视图的增量线段和全量重画（计数型SPI传输）
+ * - 离线底图从瓦片包（临时目录中的模拟SD卡）解码到显示屏，含SD读取计数
+ * - 卫星天空图的GSV/GSA解析、全量重画和48颗卫星的预算内增量更新
+ * - 输入事件：带抖动的按键边沿判定、摇杆采样和事件出队
+ * - FontRenderer::decode_utf8_char
+ *
+ * 用法示例:
+ *   lc76g_bench --json bench.json --baseline host/bench/baseline.json
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "bench_harness.hpp"
+#include "counting_transport.hpp"
+#include "host_fakes.h"
+
+#include "gps/gps_logger.hpp"
+#include "gps/gps_flush.h"
+#include "ili9488_driver.hpp"
+#include "hybrid_font_renderer.hpp"
+#include "ili9488_track_view.hpp"
+#include "ili9488_tile_map.hpp"
+#include "ili9488_sky_plot.hpp"
+#include "ili9488_strip_chart.hpp"
+#include "tile_pack.hpp"
+#include "ff.h"
+
+extern "C" {
+#include "gps/vendor_gps_parser.h"
+}
+#include "input/input_events.h"
+
+namespace {
+
+// =============================================================================
+// 测试数据
+// =============================================================================
+
+/**
+ * @brief 为NMEA正文追加校验和与CRLF
+ */
+std::string nmea(const char* body) {
+    uint8_t cs = 0;
+    for (const char* p = body; *p; p++) {
+        cs ^= (uint8_t)*p;
+    }
+    char tail[8];
+    std::snprintf(tail, sizeof(tail), "*%02X\r\n", cs);
+    return std::string("$") + body + tail;
+}
+
+const std::string kRmc = nmea("GNRMC,081836.000,A,3114.5678,N,12128.1234,E,12.5,87.3,181026,,,A");
+const std::string kGga = nmea("GNGGA,081836.000,3114.5678,N,12128.1234,E,1,12,0.9,45.6,M,8.1,M,,");
+const std::string kGsv = nmea("GPGSV,3,1,12,01,45,120,42,03,30,045,38,07,60,300,45,08,15,200,30");
+const std::string kEpoch = kRmc + kGga + kGsv;
+const std::string kGsa = nmea("GNGSA,A,3,01,03,07,08,11,13,17,19,22,28,30,,1.6,0.9,1.3,1");
+const std::string kVtg = nmea("GNVTG,87.3,T,,M,12.5,N,23.2,K,A");
+const std::string kZda = nmea("GNZDA,081836.000,18,10,2026,,");
+const std::string kEpochFull = kEpoch + kGsa + kVtg + kZda;
+
+const char* kUtf8Ascii = "LAT 31.242797 LON 121.468723 SPD 23.1km/h";
+const char* kUtf8Mixed = "纬度 31.242797 经度 121.468723 速度 23.1公里/时";
+
+// ILI9488 测试用引脚（与pin_config.hpp一致，主机上只是编号）
+constexpr uint8_t kPinDc = 20;
+constexpr uint8_t kPinRst = 15;
+constexpr uint8_t kPinCs = 17;
+constexpr uint8_t kPinSck = 18;
+constexpr uint8_t kPinMosi = 19;
+constexpr uint8_t kPinBl = 10;
+constexpr uint32_t kSpiHz = 40000000;
+
+// 地图视图区域（与示例右侧面板一致）
+constexpr uint16_t kMapX = 241;
+constexpr uint16_t kMapY = 36;
+constexpr uint16_t kMapW = 239;
+constexpr uint16_t kMapH = 193;
+constexpr uint32_t kTrackPoints = GPS_TRACK_MAX_POINTS;
+constexpr uint8_t kSkySats = 48;
+constexpr uint16_t kChartW = 232;
+constexpr uint16_t kChartH = 46;
+constexpr int32_t kTilePanRange = 64 * 30;      // 向东平移30个瓦片后回到起点
+
+/**
+ * @brief 第i个模拟定位：±100m×±75m的李萨如曲线，每步约1.6m
+ */
+gps_fix_t track_fix(uint32_t i) {
+    gps_fix_t fix{};
+    double e = 100.0 * std::sin(i * 0.013);
+    double n = 75.0 * std::sin(i * 0.017 + 0.5);
+    fix.flags = GPS_FIX_VALID | GPS_FIX_HAS_POSITION;
+    fix.lat_e7 = (int32_t)std::lround((31.2 + n / 111320.0) * 1e7);
+    fix.lon_e7 = (int32_t)std::lround((121.4 + e / (111320.0 * std::cos(31.2 * 0.017453292519943295))) * 1e7);
+    return fix;
+}
+
+// =============================================================================
+// 环境
+// =============================================================================
+
+struct Env {
+    host::CountingTransport transport;
+    std::unique_ptr<ili9488::ILI9488Driver> driver;
+    std::unique_ptr<GPS::GPSLogger> logger;
+    std::vector<uint16_t> blit565;
+    gps_fix_t fix{};
+    std::unique_ptr<ili9488::TrackView> track_view;
+    uint32_t track_index = 0;
+    FATFS fatfs;
+    std::unique_ptr<ili9488::TileMap> tile_map;
+    int32_t tile_pan = 0;
+    std::unique_ptr<ili9488::SkyPlot> sky_plot;
+    std::vector<gps_sky_sat_t> sky_sats;
+    uint32_t sky_step = 0;
+    std::unique_ptr<ili9488::StripChart> chart;
+    uint32_t chart_sample = 0;
+};
+
+Env& env() {
+    static Env e;
+    return e;
+}
+
+/**
+ * @brief 曲线图加入一个样本并绘制：周期约100个样本的模拟速度
+ */
+void chart_push() {
+    Env& e = env();
+    float t = (float)e.chart_sample++;
+    e.chart->push(30.0f + 25.0f * std::sin(t * 0.063f) + 3.0f * std::sin(t * 0.9f));
+    e.chart->update();
+}
+
+void setup_env() {
+    Env& e = env();
+
+    // 虚拟时钟：初始化中的sleep_ms()不真正等待
+    host_time_use_virtual_clock(0);
+
+    lc76g_i2c_init(i2c1, 6, 7, 400000, -1);
+    lc76g_parse_nmea_fix(kEpoch.c_str(), (int)kEpoch.size(), &e.fix);
+
+    e.transport.install();
+    e.driver = std::make_unique<ili9488::ILI9488Driver>(spi0, kPinDc, kPinRst, kPinCs,
+                                                         kPinSck, kPinMosi, kPinBl, kSpiHz);
+    e.driver->initialize();
+
+    e.logger = std::make_unique<GPS::GPSLogger>(SimpleSD::SPIConfig{}, GPS::GPSLogger::LogConfig{});
+
+    e.blit565.resize(64 * 64);
+    for (size_t i = 0; i < e.blit565.size(); i++) {
+        e.blit565[i] = (uint16_t)(i * 2654435761u >> 16);
+    }
+
+    ili9488::TrackView::Config map;
+    map.x = kMapX;
+    map.y = kMapY;
+    map.width = kMapW;
+    map.height = kMapH;
+    e.track_view = std::make_unique<ili9488::TrackView>(*e.driver, map);
+
+    ili9488::SkyPlot::Config sky;
+    sky.x = kMapX + 6;
+    sky.y = kMapY + 28;
+    sky.size = 160;
+    e.sky_plot = std::make_unique<ili9488::SkyPlot>(*e.driver, sky);
+    e.sky_sats.resize(kSkySats);
+    for (uint8_t i = 0; i < kSkySats; i++) {
+        gps_sky_sat_t& sat = e.sky_sats[i];
+        sat = gps_sky_sat_t{};
+        sat.system = i % GPS_SKY_SYSTEM_COUNT;
+        sat.prn = i + 1;
+        sat.elevation = (int8_t)(i * 37 % 91);
+        sat.azimuth = (uint16_t)(i * 97 % 360);
+        sat.snr = (uint8_t)(i * 13 % 50);
+    }
+    e.sky_plot->update(e.sky_sats.data(), kSkySats);
+    e.sky_plot->redraw();
+
+    ili9488::StripChart::Config chart;
+    chart.x = kMapX + 4;
+    chart.y = kMapY + 14;
+    chart.width = kChartW;
+    chart.height = kChartH;
+    chart.max_value = 60.0f;
+    e.chart = std::make_unique<ili9488::StripChart>(*e.driver, chart);
+    for (uint16_t i = 0; i < kChartW; i++) {
+        chart_push();
+    }
+    e.chart->update();
+}
+
+/**
+ * @brief 在临时目录生成3km×3km合成底图瓦片包（1m和2m/像素两级）并打开
+ */
+ili9488::TileMap& tile_map() {
+    Env& e = env();
+    if (!e.tile_map) {
+        std::filesystem::path root = std::filesystem::temp_directory_path() / "lc76g_bench_sd";
+        std::filesystem::create_directories(root / "maps");
+        host_fatfs_set_root(root.string().c_str());
+        f_mount(&e.fatfs, "0:", 1);
+
+        sim::TilePackConfig config;
+        config.origin_lat = 31.25;
+        config.origin_lon = 121.44;
+        config.width_m = 3000;
+        config.height_m = 3000;
+        config.levels_dm = {10, 20};
+        const std::string pack = sim::make_tile_pack(config, sim::synthetic_basemap_color, nullptr);
+        FILE* f = std::fopen((root / "maps" / "basemap.bin").string().c_str(), "wb");
+        if (f) {
+            std::fwrite(pack.data(), 1, pack.size(), f);
+            std::fclose(f);
+        }
+
+        e.tile_map = std::make_unique<ili9488::TileMap>(*e.driver);
+        e.tile_map->open(ili9488::TileMap::DEFAULT_PATH);
+    }
+    return *e.tile_map;
+}
+
+/**
+ * @brief 绘制一帧底图视口（1m/像素级别）
+ */
+void draw_tiles(int32_t map_x, int32_t map_y) {
+    tile_map().draw(0, map_x, map_y, kMapX, kMapY, kMapW, kMapH, 0xF2EFE9);
+}
+
+/**
+ * @brief 清空轨迹并追加至存满（点距大于存储步长，每个定位都会存储）
+ */
+void fill_track() {
+    Env& e = env();
+    gps_track_clear();
+    for (e.track_index = 0; gps_track_count() < kTrackPoints; e.track_index++) {
+        gps_fix_t fix = track_fix(e.track_index);
+        gps_track_update(&fix);
+    }
+    e.track_view->redraw();
+}
+
+/**
+ * @brief 推进到下一个被存储的定位并增量绘制
+ */
+void track_step() {
+    Env& e = env();
+    gps_fix_t fix;
+    do {
+        fix = track_fix(e.track_index++);
+    } while (!gps_track_update(&fix));
+    e.track_view->update();
+}
+
+/**
+ * @brief 执行一次渲染操作并返回其SPI计数
+ */
+template<typename F>
+bench::Counters spi_counters(F&& op) {
+    Env& e = env();
+    e.transport.reset();
+    op();
+    const auto& s = e.transport.stats();
+    return {
+        {"spi_transfers", (double)s.spi_transfers},
+        {"spi_bytes", (double)s.spi_bytes},
+        {"gpio_writes", (double)s.gpio_writes},
+        {"wire_us_40mhz", s.wire_time_us},
+    };
+}
+
+/**
+ * @brief SPI计数加上底图读取统计
+ */
+template<typename F>
+bench::Counters tile_counters(F&& op) {
+    ili9488::TileMap& map = tile_map();
+    map.resetStats();
+    bench::Counters counters = spi_counters(op);
+    const auto& s = map.stats();
+    counters["tiles"] = s.tiles_drawn;
+    counters["cache_hits"] = s.cache_hits;
+    counters["sd_reads"] = s.sd_reads;
+    counters["sd_bytes"] = s.sd_bytes;
+    counters["index_reads"] = s.index_reads;
+    return counters;
+}
+
+/**
+ * @brief 天空图一次变化：SNR变化的卫星数为snr_changes，moved为true时所有卫星方位角+1°
+ */
+void sky_step(uint8_t snr_changes, bool moved) {
+    Env& e = env();
+    for (uint8_t k = 0; k < snr_changes; k++) {
+        gps_sky_sat_t& sat = e.sky_sats[(e.sky_step * snr_changes + k) % kSkySats];
+        sat.snr = (uint8_t)((sat.snr + 10) % 50);
+    }
+    if (moved) {
+        for (gps_sky_sat_t& sat : e.sky_sats) {
+            sat.azimuth = (uint16_t)((sat.azimuth + 1) % 360);
+        }
+    }
+    e.sky_step++;
+    e.sky_plot->update(e.sky_sats.data(), kSkySats);
+}
+
+/**
+ * @brief 把天空图上积压的更新做完（预算限制留下的）
+ */
+void sky_settle() {
+    Env& e = env();
+    while (e.sky_plot->update(e.sky_sats.data(), kSkySats)) {
+    }
+}
+
+// debug路径中的校验方式：逐字节异或 + sscanf("%2hhx")
+bool validate_with_sscanf(const char* sentence) {
+    const char* star = std::strchr(sentence, '*');
+    if (!star) return false;
+    uint8_t calc = 0;
+    for (const char* p = sentence + 1; p < star; p++) {
+        calc ^= (uint8_t)*p;
+    }
+    uint8_t provided = 0;
+    if (std::sscanf(star + 1, "%2hhx", &provided) != 1) return false;
+    return calc == provided;
+}
+
+int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool checksum_matches(const char* star, const char* end, uint8_t sum) {
+    if (end - star < 3 || *star != '*') return false;
+    int hi = hex_digit(star[1]);
+    int lo = hex_digit(star[2]);
+    return hi >= 0 && lo >= 0 && ((hi << 4) | lo) == sum;
+}
+
+// 按字扫描之前的做法：memchr找'$'，再逐字节异或到'*'
+int frame_bytewise(const char* data, int len) {
+    const char* end = data + len;
+    const char* p = static_cast<const char*>(std::memchr(data, '$', (size_t)len));
+    int valid = 0;
+    while (p) {
+        const char* q = p + 1;
+        uint8_t sum = 0;
+        while (q < end && *q != '*' && *q != '$' && (uint8_t)*q >= 0x20) {
+            sum ^= (uint8_t)*q++;
+        }
+        if (checksum_matches(q, end, sum)) {
+            valid++;
+        }
+        p = q < end ? static_cast<const char*>(std::memchr(q, '$', (size_t)(end - q))) : nullptr;
+    }
+    return valid;
+}
+
+// 与gps_nmea_parse_buffer相同的单遍分帧，不解析字段
+int frame_swar(const char* data, int len) {
+    const char* end = data + len;
+    const char* p = static_cast<const char*>(std::memchr(data, '$', (size_t)len));
+    int valid = 0;
+    while (p) {
+        uint8_t sum;
+        const char* stop = gps_nmea_scan(p + 1, end, &sum);
+        if (checksum_matches(stop, end, sum)) {
+            valid++;
+        }
+        p = stop < end ? static_cast<const char*>(std::memchr(stop, '$', (size_t)(end - stop))) : nullptr;
+    }
+    return valid;
+}
+
+std::vector<bench::Case> make_cases() {
+    std::vector<bench::Case> cases;
+
+    // ---- NMEA解析 ----
+    auto lc76g_case = [&cases](const char* name, const std::string* text) {
+        cases.push_back({name, [text](uint64_t n) {
+            gps_fix_t out;
+            for (uint64_t i = 0; i < n; i++) {
+                lc76g_parse_nmea_fix(text->c_str(), (int)text->size(), &out);
+                bench::do_not_optimize(out);
+            }
+        }, nullptr});
+    };
+    lc76g_case("nmea.lc76g.rmc", &kRmc);
+    lc76g_case("nmea.lc76g.gga", &kGga);
+    lc76g_case("nmea.lc76g.gsv", &kGsv);
+    lc76g_case("nmea.lc76g.epoch", &kEpoch);
+
+    // 旧接口在解析之后多一次定点 -> double的转换
+    cases.push_back({"fix.to_lc76g", [](uint64_t n) {
+        LC76G_GPS_Data out;
+        for (uint64_t i = 0; i < n; i++) {
+            gps_fix_to_lc76g(&env().fix, &out);
+            bench::do_not_optimize(out);
+        }
+    }, nullptr});
+
+    cases.push_back({"nmea.engine.dispatch", [](uint64_t n) {
+        static const char* const kIds[] = {"GNRMC,", "GPGGA,", "GNGSA,", "GLGSV,", "GNVTG,", "GNZDA,", "GNGLL,", "PAIR001,"};
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(gps_nmea_sentence_type(kIds[i & 7]));
+        }
+    }, nullptr});
+    cases.push_back({"nmea.engine.epoch_full", [](uint64_t n) {
+        gps_fix_t fix{};
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(gps_nmea_parse_buffer(kEpochFull.c_str(), (int)kEpochFull.size(), &fix,
+                                                         nullptr, nullptr, nullptr));
+        }
+        bench::do_not_optimize(fix);
+    }, nullptr});
+
+    auto vendor_case = [&cases](const char* name, const std::string* text) {
+        cases.push_back({name, [text](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                GNRMC out = vendor_gps_parse_nmea(text->c_str());
+                bench::do_not_optimize(out);
+            }
+        }, nullptr});
+    };
+    vendor_case("nmea.vendor.rmc", &kRmc);
+    vendor_case("nmea.vendor.gga", &kGga);
+    vendor_case("nmea.vendor.gsv", &kGsv);
+    vendor_case("nmea.vendor.epoch", &kEpoch);
+
+    // 卫星表只读取引擎已切分的字段，切分在循环外完成（固件中由gps_nmea_parse_buffer完成）
+    auto split_sentence = [](uint8_t type, const std::string& text) {
+        gps_nmea_sentence_t sentence{};
+        sentence.type = type;
+        sentence.text = text.c_str();
+        sentence.field_count = gps_nmea_split(text.c_str(), sentence.fields, GPS_NMEA_MAX_FIELDS);
+        return sentence;
+    };
+    static const gps_nmea_sentence_t kGsvSentence = split_sentence(GPS_NMEA_GSV, kGsv);
+    static const gps_nmea_sentence_t kGsaSentence = split_sentence(GPS_NMEA_GSA, kGsa);
+    cases.push_back({"nmea.sky.gsv", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(gps_sky_parse_gsv(&kGsvSentence));
+        }
+    }, nullptr});
+    cases.push_back({"nmea.sky.gsa", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(gps_sky_parse_gsa(&kGsaSentence));
+            gps_sky_commit_gsa();
+        }
+    }, nullptr});
+
+    // ---- 校验和 ----
+    cases.push_back({"checksum.lc76g_get_command_checksum", [](uint64_t n) {
+        const char* body = kGsv.c_str() + 1;
+        int32_t len = (int32_t)(std::strchr(body, '*') - body);
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(lc76g_get_command_checksum(body, len));
+        }
+    }, nullptr});
+    cases.push_back({"checksum.lc76g_command_get_param", [](uint64_t n) {
+        Ql_gnss_command_contx_TypeDef ctx;
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(lc76g_command_get_param(kGsv.c_str(), (int32_t)kGsv.size(), &ctx));
+        }
+    }, nullptr});
+    cases.push_back({"checksum.debug_sscanf", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(validate_with_sscanf(kGsv.c_str()));
+        }
+    }, nullptr});
+    cases.push_back({"checksum.bytewise", [](uint64_t n) {
+        const char* body = kEpochFull.c_str() + 1;
+        int len = (int)kEpochFull.size() - 1;
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(body);
+            uint8_t sum = 0;
+            for (int k = 0; k < len; k++) {
+                sum ^= (uint8_t)body[k];
+            }
+            bench::do_not_optimize(sum);
+        }
+    }, nullptr});
+    cases.push_back({"checksum.swar", [](uint64_t n) {
+        const char* body = kEpochFull.c_str() + 1;
+        int len = (int)kEpochFull.size() - 1;
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(gps_nmea_xor(body, len));
+        }
+    }, nullptr});
+    cases.push_back({"framing.bytewise", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(frame_bytewise(kEpochFull.c_str(), (int)kEpochFull.size()));
+        }
+    }, nullptr});
+    cases.push_back({"framing.swar", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(frame_swar(kEpochFull.c_str(), (int)kEpochFull.size()));
+        }
+    }, nullptr});
+
+    // ---- 坐标转换 ----
+    cases.push_back({"transform.lc76g.gcj02", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(lc76g_get_google_coordinates());
+        }
+    }, nullptr});
+    cases.push_back({"transform.lc76g.bd09", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(lc76g_get_baidu_coordinates());
+        }
+    }, nullptr});
+    cases.push_back({"transform.vendor.gcj02", [](uint64_t n) {
+        vendor_gps_parse_nmea(kRmc.c_str());
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(vendor_gps_get_google_coordinates());
+        }
+    }, nullptr});
+    cases.push_back({"transform.vendor.bd09", [](uint64_t n) {
+        vendor_gps_parse_nmea(kRmc.c_str());
+        for (uint64_t i = 0; i < n; i++) {
+            bench::do_not_optimize(vendor_gps_get_baidu_coordinates());
+        }
+    }, nullptr});
+
+    // ---- 日志 ----
+    cases.push_back({"logger.create_coordinate_data", [](uint64_t n) {
+        Env& e = env();
+        for (uint64_t i = 0; i < n; i++) {
+            auto coord = e.logger->create_coordinate_data(e.fix);
+            bench::do_not_optimize(coord);
+        }
+    }, nullptr});
+    cases.push_back({"logger.format_log_line", [](uint64_t n) {
+        Env& e = env();
+        auto coord = e.logger->create_coordinate_data(e.fix);
+        for (uint64_t i = 0; i < n; i++) {
+            std::string line = e.logger->format_log_line(coord);
+            bench::do_not_optimize(line);
+        }
+    }, nullptr});
+    cases.push_back({"logger.flush_plan", [](uint64_t n) {
+        // 每条记录登记一次并计划一次，整扇区时按计划写出（不计SD卡耗时）
+        gps_flush_reset(5000, 1024);
+        uint32_t file_size = 300;
+        for (uint64_t i = 0; i < n; i++) {
+            uint32_t now_ms = (uint32_t)(i * 100);
+            gps_flush_record(110, now_ms);
+            uint8_t reason;
+            uint32_t bytes = gps_flush_plan(now_ms, file_size, 40000, &reason);
+            if (bytes) {
+                gps_flush_done(now_ms, file_size, bytes, 12000, reason);
+                file_size += bytes;
+            }
+        }
+    }, nullptr});
+
+    // ---- 渲染（计数型SPI传输）----
+    cases.push_back({"render.draw_char", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            env().driver->drawChar(10, 10, 'A', 0xFFFFFF, 0x000000);
+        }
+    }, [] { return spi_counters([] { env().driver->drawChar(10, 10, 'A', 0xFFFFFF, 0x000000); }); }});
+    cases.push_back({"render.draw_string_20", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            env().driver->drawString(10, 40, "Lat: 31.242797 N  ", 0xFFFFFF, 0x000000);
+        }
+    }, [] { return spi_counters([] { env().driver->drawString(10, 40, "Lat: 31.242797 N  ", 0xFFFFFF, 0x000000); }); }});
+    cases.push_back({"render.fill_area_565_100x100", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            env().driver->fillArea(0, 0, 99, 99, 0xF800);
+        }
+    }, [] { return spi_counters([] { env().driver->fillArea(0, 0, 99, 99, 0xF800); }); }});
+    cases.push_back({"render.fill_area_666_100x100", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            env().driver->fillAreaRGB666(0, 0, 99, 99, 0x3F0000);
+        }
+    }, [] { return spi_counters([] { env().driver->fillAreaRGB666(0, 0, 99, 99, 0x3F0000); }); }});
+    cases.push_back({"render.blit_565_64x64", [](uint64_t n) {
+        Env& e = env();
+        for (uint64_t i = 0; i < n; i++) {
+            e.driver->writePixels(0, 0, 63, 63, e.blit565.data(), e.blit565.size());
+        }
+    }, [] {
+        return spi_counters([] { Env& e = env(); e.driver->writePixels(0, 0, 63, 63, e.blit565.data(), e.blit565.size()); });
+    }});
+    cases.push_back({"render.track_segment", [](uint64_t n) {
+        if (gps_track_count() < kTrackPoints) fill_track();
+        for (uint64_t i = 0; i < n; i++) {
+            track_step();
+        }
+    }, [] {
+        if (gps_track_count() < kTrackPoints) fill_track();
+        return spi_counters([] { track_step(); });
+    }});
+    cases.push_back({"render.track_redraw_4096", [](uint64_t n) {
+        if (gps_track_count() < kTrackPoints) fill_track();
+        for (uint64_t i = 0; i < n; i++) {
+            env().track_view->redraw();
+        }
+    }, [] {
+        if (gps_track_count() < kTrackPoints) fill_track();
+        return spi_counters([] { env().track_view->redraw(); });
+    }});
+    // 底图：冷缓存整帧、缓存命中整帧、平移一个瓦片（只读新露出的一列瓦片）
+    cases.push_back({"render.tile_viewport_sd", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            tile_map().flushCache();
+            draw_tiles(1000, 1000);
+        }
+    }, [] {
+        return tile_counters([] { tile_map().flushCache(); draw_tiles(1000, 1000); });
+    }});
+    cases.push_back({"render.tile_viewport_cached", [](uint64_t n) {
+        draw_tiles(1000, 1000);
+        for (uint64_t i = 0; i < n; i++) {
+            draw_tiles(1000, 1000);
+        }
+    }, [] {
+        draw_tiles(1000, 1000);
+        return tile_counters([] { draw_tiles(1000, 1000); });
+    }});
+    cases.push_back({"render.tile_pan_one_tile", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            Env& e = env();
+            e.tile_pan = (e.tile_pan + 64) % kTilePanRange;
+            draw_tiles(512 + e.tile_pan, 1000);
+        }
+    }, [] {
+        Env& e = env();
+        draw_tiles(512 + e.tile_pan, 1000);
+        return tile_counters([] {
+            Env& e = env();
+            e.tile_pan = (e.tile_pan + 64) % kTilePanRange;
+            draw_tiles(512 + e.tile_pan, 1000);
+        });
+    }});
+    // 天空图：全量重画、4颗卫星SNR变化、48颗卫星全部移动（单次update受预算限制）
+    cases.push_back({"render.skyplot_redraw", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            env().sky_plot->redraw();
+        }
+    }, [] { return spi_counters([] { env().sky_plot->redraw(); }); }});
+    cases.push_back({"render.skyplot_update_snr4", [](uint64_t n) {
+        sky_settle();
+        for (uint64_t i = 0; i < n; i++) {
+            sky_step(4, false);
+        }
+    }, [] {
+        sky_settle();
+        return spi_counters([] { sky_step(4, false); });
+    }});
+    cases.push_back({"render.skyplot_update_moved48", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            sky_step(0, true);
+        }
+    }, [] {
+        sky_settle();
+        return spi_counters([] { sky_step(0, true); });
+    }});
+    // 曲线图：每个样本（写最新一列并清空前方一列）与全量重画
+    cases.push_back({"render.stripchart_push", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            chart_push();
+        }
+    }, [] { return spi_counters(chart_push); }});
+    cases.push_back({"render.stripchart_redraw", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+            env().chart->redraw();
+        }
+    }, [] { return spi_counters([] { env().chart->redraw(); }); }});
+
+    // ---- 输入事件 ----
+    // 一次短按：按下和松开各带4个抖动边沿，再出队
+    cases.push_back({"input.button_press_bounce", [](uint64_t n) {
+        input_events_reset();
+        uint32_t t = 0;
+        input_event_t event;
+        for (uint64_t i = 0; i < n; i++) {
+            for (int edge = 0; edge < 5; edge++) {
+                input_button_update(edge % 2 == 0, t + edge * 200);
+            }
+            for (int edge = 0; edge < 5; edge++) {
+                input_button_update(edge % 2 != 0, t + 200000 + edge * 200);
+            }
+            bench::do_not_optimize(input_events_pop(&event));
+            t += 400000;
+        }
+    }, nullptr});
+    cases.push_back({"input.joystick_sample", [](uint64_t n) {
+        input_events_reset();
+        input_event_t event;
+        for (uint64_t i = 0; i < n; i++) {
+            // 50次采样中一次偏出、一次回中
+            int32_t dx = (i % 50 == 0) ? 2000 : 0;
+            input_joystick_sample(dx, 0, false, (uint32_t)(i * 20000));
+            while (input_events_pop(&event)) {
+                bench::do_not_optimize(event.type);
+            }
+        }
+    }, nullptr});
+    // ---- UTF-8 解码 ----
+    auto utf8_case = [&cases](const char* name, const char* text) {
+        cases.push_back({name, [text](uint64_t n) {
+            hybrid_font::FontRenderer<ili9488::ILI9488Driver> renderer;
+            for (uint64_t i = 0; i < n; i++) {
+                const char* p = text;
+                uint32_t acc = 0;
+                while (*p) {
+                    acc += renderer.decode_utf8_char(p);
+                }
+                bench::do_not_optimize(acc);
+            }
+        }, nullptr});
+    };
+    utf8_case("utf8.decode_ascii_41", kUtf8Ascii);
+    utf8_case("utf8.decode_mixed_cjk", kUtf8Mixed);
+
+    return cases;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    setup_env();
+    return bench::run_main(argc, argv, make_cases());
+}
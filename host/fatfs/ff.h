@@ -0,0 +1,136 @@
+/**
+ * @file ff.h
+ * @brief 主机构建用FatFs API子集
+ *
+ * 与pico_fatfs中FatFs R0.15的接口保持一致，文件落到主机目录
+ * （默认./sd_card，可用环境变量LC76G_HOST_SD_ROOT或host_fatfs_set_root()修改）。
+ * 路径中的"0:"卷前缀会被去掉。
+ */
+
+#ifndef FF_DEFINED
+#define FF_DEFINED 80286
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int UINT;
+typedef unsigned char BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef uint64_t QWORD;
+typedef char TCHAR;
+typedef DWORD FSIZE_t;
+
+#define FF_MAX_LFN 255
+
+typedef struct {
+    BYTE fs_type;
+} FATFS;
+
+typedef struct {
+    FSIZE_t objsize;
+} FFOBJID;
+
+typedef struct {
+    FFOBJID obj;
+    BYTE flag;
+    FSIZE_t fptr;
+    FILE *host_fp;
+} FIL;
+
+typedef struct {
+    void *host_dir;
+} DIR;
+
+typedef struct {
+    FSIZE_t fsize;
+    WORD fdate;
+    WORD ftime;
+    BYTE fattrib;
+    TCHAR fname[FF_MAX_LFN + 1];
+} FILINFO;
+
+typedef enum {
+    FR_OK = 0,
+    FR_DISK_ERR,
+    FR_INT_ERR,
+    FR_NOT_READY,
+    FR_NO_FILE,
+    FR_NO_PATH,
+    FR_INVALID_NAME,
+    FR_DENIED,
+    FR_EXIST,
+    FR_INVALID_OBJECT,
+    FR_WRITE_PROTECTED,
+    FR_INVALID_DRIVE,
+    FR_NOT_ENABLED,
+    FR_NO_FILESYSTEM,
+    FR_MKFS_ABORTED,
+    FR_TIMEOUT,
+    FR_LOCKED,
+    FR_NOT_ENOUGH_CORE,
+    FR_TOO_MANY_OPEN_FILES,
+    FR_INVALID_PARAMETER
+} FRESULT;
+
+// 文件打开模式
+#define FA_READ          0x01
+#define FA_WRITE         0x02
+#define FA_OPEN_EXISTING 0x00
+#define FA_CREATE_NEW    0x04
+#define FA_CREATE_ALWAYS 0x08
+#define FA_OPEN_ALWAYS   0x10
+#define FA_OPEN_APPEND   0x30
+
+// 文件属性
+#define AM_RDO 0x01
+#define AM_HID 0x02
+#define AM_SYS 0x04
+#define AM_DIR 0x10
+#define AM_ARC 0x20
+
+FRESULT f_open(FIL *fp, const TCHAR *path, BYTE mode);
+FRESULT f_close(FIL *fp);
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br);
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw);
+FRESULT f_lseek(FIL *fp, FSIZE_t ofs);
+FRESULT f_truncate(FIL *fp);
+FRESULT f_sync(FIL *fp);
+FRESULT f_opendir(DIR *dp, const TCHAR *path);
+FRESULT f_closedir(DIR *dp);
+FRESULT f_readdir(DIR *dp, FILINFO *fno);
+FRESULT f_mkdir(const TCHAR *path);
+FRESULT f_unlink(const TCHAR *path);
+FRESULT f_rename(const TCHAR *path_old, const TCHAR *path_new);
+FRESULT f_stat(const TCHAR *path, FILINFO *fno);
+FRESULT f_mount(FATFS *fs, const TCHAR *path, BYTE opt);
+
+#define f_unmount(path) f_mount(0, path, 0)
+#define f_eof(fp) ((int)((fp)->fptr == (fp)->obj.objsize))
+#define f_tell(fp) ((fp)->fptr)
+#define f_size(fp) ((fp)->obj.objsize)
+#define f_rewind(fp) f_lseek((fp), 0)
+
+// =============================================================================
+// 主机专用
+// =============================================================================
+
+/**
+ * @brief 设置模拟SD卡的主机根目录
+ */
+void host_fatfs_set_root(const char *root);
+
+/**
+ * @brief 获取模拟SD卡的主机根目录
+ */
+const char *host_fatfs_get_root(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FF_DEFINED
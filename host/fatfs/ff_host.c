@@ -0,0 +1,292 @@
+/**
+ * @file ff_host.c
+ * @brief 主机构建用FatFs API子集的实现（映射到主机目录）
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ff.h"
+#include "ff_host_dir.h"
+
+#define HOST_PATH_MAX 512
+
+static char g_root[HOST_PATH_MAX] = "";
+static int g_mounted = 0;
+
+void host_fatfs_set_root(const char *root) {
+    snprintf(g_root, sizeof(g_root), "%s", root);
+}
+
+const char *host_fatfs_get_root(void) {
+    if (g_root[0] == '\0') {
+        const char *env = getenv("LC76G_HOST_SD_ROOT");
+        host_fatfs_set_root(env && env[0] ? env : "sd_card");
+    }
+    return g_root;
+}
+
+/**
+ * @brief 将FatFs路径映射为主机路径
+ */
+static void map_path(const TCHAR *path, char *out, size_t out_len) {
+    if (path[0] >= '0' && path[0] <= '9' && path[1] == ':') {
+        path += 2;
+    }
+    while (*path == '/') {
+        path++;
+    }
+    if (snprintf(out, out_len, "%s/%s", host_fatfs_get_root(), path) >= (int)out_len) {
+        out[out_len - 1] = '\0';
+    }
+}
+
+static FRESULT errno_to_fresult(int err) {
+    switch (err) {
+        case ENOENT: return FR_NO_FILE;
+        case ENOTDIR: return FR_NO_PATH;
+        case EEXIST: return FR_EXIST;
+        case EACCES:
+        case EPERM: return FR_DENIED;
+        case EROFS: return FR_WRITE_PROTECTED;
+        case EMFILE:
+        case ENFILE: return FR_TOO_MANY_OPEN_FILES;
+        case ENAMETOOLONG: return FR_INVALID_NAME;
+        default: return FR_DISK_ERR;
+    }
+}
+
+FRESULT f_mount(FATFS *fs, const TCHAR *path, BYTE opt) {
+    (void)path;
+    (void)opt;
+    if (!fs) {
+        g_mounted = 0;
+        return FR_OK;
+    }
+    if (mkdir(host_fatfs_get_root(), 0755) != 0 && errno != EEXIST) {
+        return FR_NOT_READY;
+    }
+    fs->fs_type = 3;  // FS_FAT32
+    g_mounted = 1;
+    return FR_OK;
+}
+
+FRESULT f_open(FIL *fp, const TCHAR *path, BYTE mode) {
+    char host_path[HOST_PATH_MAX];
+    struct stat st;
+    const char *fmode;
+    int exists;
+
+    memset(fp, 0, sizeof(*fp));
+    if (!g_mounted) {
+        return FR_NOT_ENABLED;
+    }
+    map_path(path, host_path, sizeof(host_path));
+    exists = stat(host_path, &st) == 0;
+    if (exists && S_ISDIR(st.st_mode)) {
+        return FR_DENIED;
+    }
+
+    if (mode & FA_CREATE_ALWAYS) {
+        fmode = (mode & FA_READ) ? "w+b" : "wb";
+    } else if (mode & FA_CREATE_NEW) {
+        if (exists) {
+            return FR_EXIST;
+        }
+        fmode = (mode & FA_READ) ? "w+b" : "wb";
+    } else if (mode & FA_OPEN_ALWAYS) {
+        fmode = exists ? ((mode & FA_WRITE) ? "r+b" : "rb") : "w+b";
+    } else {
+        if (!exists) {
+            return FR_NO_FILE;
+        }
+        fmode = (mode & FA_WRITE) ? "r+b" : "rb";
+    }
+
+    fp->host_fp = fopen(host_path, fmode);
+    if (!fp->host_fp) {
+        return errno_to_fresult(errno);
+    }
+    fp->flag = mode;
+    fseek(fp->host_fp, 0, SEEK_END);
+    fp->obj.objsize = (FSIZE_t)ftell(fp->host_fp);
+    if ((mode & FA_OPEN_APPEND) == FA_OPEN_APPEND) {
+        fp->fptr = fp->obj.objsize;
+    } else {
+        fseek(fp->host_fp, 0, SEEK_SET);
+        fp->fptr = 0;
+    }
+    return FR_OK;
+}
+
+FRESULT f_close(FIL *fp) {
+    if (!fp->host_fp) {
+        return FR_INVALID_OBJECT;
+    }
+    fclose(fp->host_fp);
+    fp->host_fp = NULL;
+    return FR_OK;
+}
+
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br) {
+    *br = 0;
+    if (!fp->host_fp) {
+        return FR_INVALID_OBJECT;
+    }
+    if (!(fp->flag & FA_READ)) {
+        return FR_DENIED;
+    }
+    size_t n = fread(buff, 1, btr, fp->host_fp);
+    if (n < btr && ferror(fp->host_fp)) {
+        return FR_DISK_ERR;
+    }
+    *br = (UINT)n;
+    fp->fptr += (FSIZE_t)n;
+    return FR_OK;
+}
+
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw) {
+    *bw = 0;
+    if (!fp->host_fp) {
+        return FR_INVALID_OBJECT;
+    }
+    if (!(fp->flag & FA_WRITE)) {
+        return FR_DENIED;
+    }
+    size_t n = fwrite(buff, 1, btw, fp->host_fp);
+    *bw = (UINT)n;
+    fp->fptr += (FSIZE_t)n;
+    if (fp->fptr > fp->obj.objsize) {
+        fp->obj.objsize = fp->fptr;
+    }
+    return n == btw ? FR_OK : FR_DISK_ERR;
+}
+
+FRESULT f_lseek(FIL *fp, FSIZE_t ofs) {
+    if (!fp->host_fp) {
+        return FR_INVALID_OBJECT;
+    }
+    if (ofs > fp->obj.objsize && !(fp->flag & FA_WRITE)) {
+        ofs = fp->obj.objsize;
+    }
+    if (fseek(fp->host_fp, (long)ofs, SEEK_SET) != 0) {
+        return FR_DISK_ERR;
+    }
+    fp->fptr = ofs;
+    return FR_OK;
+}
+
+FRESULT f_truncate(FIL *fp) {
+    if (!fp->host_fp) {
+        return FR_INVALID_OBJECT;
+    }
+    fflush(fp->host_fp);
+    if (ftruncate(fileno(fp->host_fp), (off_t)fp->fptr) != 0) {
+        return FR_DISK_ERR;
+    }
+    fp->obj.objsize = fp->fptr;
+    return FR_OK;
+}
+
+FRESULT f_sync(FIL *fp) {
+    if (!fp->host_fp) {
+        return FR_INVALID_OBJECT;
+    }
+    return fflush(fp->host_fp) == 0 ? FR_OK : FR_DISK_ERR;
+}
+
+static void fill_info(const char *host_path, const char *name, FILINFO *fno) {
+    struct stat st;
+    memset(fno, 0, sizeof(*fno));
+    snprintf(fno->fname, sizeof(fno->fname), "%s", name);
+    if (stat(host_path, &st) == 0) {
+        fno->fsize = S_ISDIR(st.st_mode) ? 0 : (FSIZE_t)st.st_size;
+        fno->fattrib = S_ISDIR(st.st_mode) ? AM_DIR : AM_ARC;
+    }
+}
+
+FRESULT f_stat(const TCHAR *path, FILINFO *fno) {
+    char host_path[HOST_PATH_MAX];
+    struct stat st;
+    map_path(path, host_path, sizeof(host_path));
+    if (stat(host_path, &st) != 0) {
+        return errno_to_fresult(errno);
+    }
+    if (fno) {
+        const char *name = strrchr(host_path, '/');
+        fill_info(host_path, name ? name + 1 : host_path, fno);
+    }
+    return FR_OK;
+}
+
+FRESULT f_mkdir(const TCHAR *path) {
+    char host_path[HOST_PATH_MAX];
+    map_path(path, host_path, sizeof(host_path));
+    if (mkdir(host_path, 0755) != 0) {
+        return errno_to_fresult(errno);
+    }
+    return FR_OK;
+}
+
+FRESULT f_unlink(const TCHAR *path) {
+    char host_path[HOST_PATH_MAX];
+    map_path(path, host_path, sizeof(host_path));
+    if (remove(host_path) != 0) {
+        return errno_to_fresult(errno);
+    }
+    return FR_OK;
+}
+
+FRESULT f_rename(const TCHAR *path_old, const TCHAR *path_new) {
+    char old_path[HOST_PATH_MAX];
+    char new_path[HOST_PATH_MAX];
+    struct stat st;
+    map_path(path_old, old_path, sizeof(old_path));
+    map_path(path_new, new_path, sizeof(new_path));
+    if (stat(new_path, &st) == 0) {
+        return FR_EXIST;
+    }
+    if (rename(old_path, new_path) != 0) {
+        return errno_to_fresult(errno);
+    }
+    return FR_OK;
+}
+
+FRESULT f_opendir(DIR *dp, const TCHAR *path) {
+    char host_path[HOST_PATH_MAX];
+    map_path(path, host_path, sizeof(host_path));
+    dp->host_dir = host_dir_open(host_path);
+    if (!dp->host_dir) {
+        return errno == ENOENT ? FR_NO_PATH : errno_to_fresult(errno);
+    }
+    return FR_OK;
+}
+
+FRESULT f_closedir(DIR *dp) {
+    if (!dp->host_dir) {
+        return FR_INVALID_OBJECT;
+    }
+    host_dir_close(dp->host_dir);
+    dp->host_dir = NULL;
+    return FR_OK;
+}
+
+FRESULT f_readdir(DIR *dp, FILINFO *fno) {
+    char name[FF_MAX_LFN + 1];
+    char host_path[HOST_PATH_MAX * 2];
+    if (!dp->host_dir) {
+        return FR_INVALID_OBJECT;
+    }
+    if (!host_dir_next(dp->host_dir, name, sizeof(name))) {
+        // 与FatFs一致：目录结束时fname[0]为0
+        memset(fno, 0, sizeof(*fno));
+        return FR_OK;
+    }
+    snprintf(host_path, sizeof(host_path), "%s/%s", host_dir_path(dp->host_dir), name);
+    fill_info(host_path, name, fno);
+    return FR_OK;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file ff_host_dir.c
+ * @brief 主机目录遍历辅助函数实现
+ */
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ff_host_dir.h"
+
+typedef struct {
+    DIR *dir;
+    char path[512];
+} host_dir_t;
+
+void *host_dir_open(const char *host_path) {
+    host_dir_t *hd = (host_dir_t *)malloc(sizeof(host_dir_t));
+    if (!hd) {
+        return NULL;
+    }
+    snprintf(hd->path, sizeof(hd->path), "%s", host_path);
+    hd->dir = opendir(hd->path);
+    if (!hd->dir) {
+        free(hd);
+        return NULL;
+    }
+    return hd;
+}
+
+bool host_dir_next(void *handle, char *name, size_t name_len) {
+    host_dir_t *hd = (host_dir_t *)handle;
+    struct dirent *ent;
+    do {
+        ent = readdir(hd->dir);
+    } while (ent && (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0));
+    if (!ent) {
+        return false;
+    }
+    snprintf(name, name_len, "%s", ent->d_name);
+    return true;
+}
+
+const char *host_dir_path(void *handle) {
+    return ((host_dir_t *)handle)->path;
+}
+
+void host_dir_close(void *handle) {
+    host_dir_t *hd = (host_dir_t *)handle;
+    closedir(hd->dir);
+    free(hd);
+}
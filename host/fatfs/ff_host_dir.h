@@ -0,0 +1,19 @@
+/**
+ * @file ff_host_dir.h
+ * @brief 主机目录遍历辅助函数
+ *
+ * FatFs的DIR类型与<dirent.h>同名，因此目录遍历放在单独的编译单元中。
+ */
+
+#ifndef FF_HOST_DIR_H
+#define FF_HOST_DIR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+void *host_dir_open(const char *host_path);
+bool host_dir_next(void *handle, char *name, size_t name_len);
+const char *host_dir_path(void *handle);
+void host_dir_close(void *handle);
+
+#endif // FF_HOST_DIR_H
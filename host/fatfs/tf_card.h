@@ -0,0 +1,36 @@
+/**
+ * @file tf_card.h
+ * @brief 主机构建用pico_fatfs SPI配置接口（空实现）
+ */
+
+#ifndef _TF_CARD_H_
+#define _TF_CARD_H_
+
+#include <stdbool.h>
+#include "hardware/spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    spi_inst_t *spi_inst;
+    uint clk_slow;
+    uint clk_fast;
+    uint pin_miso;
+    uint pin_cs;
+    uint pin_sck;
+    uint pin_mosi;
+    bool pullup;
+} pico_fatfs_spi_config_t;
+
+static inline bool pico_fatfs_set_config(pico_fatfs_spi_config_t *config) {
+    (void)config;
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TF_CARD_H_
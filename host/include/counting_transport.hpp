@@ -0,0 +1,101 @@
+/**
+ * @file counting_transport.hpp
+ * @brief 计数型SPI/GPIO传输模型
+ *
+ * 安装后接管hardware/spi和hardware/gpio shim：不保存像素，只统计
+ * 传输次数、字节数和引脚翻转次数，并按当前SPI波特率估算线上耗时，
+ * 用于在主机上衡量渲染路径的SPI开销。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "host_fakes.h"
+
+namespace host {
+
+class CountingTransport {
+public:
+    struct Stats {
+        uint64_t spi_transfers = 0;   // spi_*_blocking调用次数
+        uint64_t spi_bytes = 0;       // 传输字节数
+        uint64_t gpio_writes = 0;     // gpio_put调用次数（CS/DC切换）
+        double wire_time_us = 0;      // 按波特率估算的线上时间
+    };
+
+    CountingTransport() {
+        spi_fake_.transfer = &CountingTransport::on_transfer;
+        spi_fake_.set_baudrate = &CountingTransport::on_baudrate;
+        spi_fake_.ctx = this;
+        gpio_fake_.put = &CountingTransport::on_put;
+        gpio_fake_.get = &CountingTransport::on_get;
+        gpio_fake_.ctx = this;
+    }
+
+    ~CountingTransport() {
+        uninstall();
+    }
+
+    CountingTransport(const CountingTransport&) = delete;
+    CountingTransport& operator=(const CountingTransport&) = delete;
+
+    void install() {
+        host_spi_set_fake(&spi_fake_);
+        host_gpio_set_fake(&gpio_fake_);
+    }
+
+    void uninstall() {
+        host_spi_set_fake(nullptr);
+        host_gpio_set_fake(nullptr);
+    }
+
+    void reset() { stats_ = Stats(); }
+    const Stats& stats() const { return stats_; }
+
+    /**
+     * @brief 设置用于估算线上时间的波特率（spi_init时也会自动更新）
+     */
+    void set_baudrate(uint32_t baudrate) { baudrate_ = baudrate; }
+
+private:
+    static int on_transfer(void* ctx, uint bus, const uint8_t* src, uint8_t* dst, size_t len) {
+        (void)bus;
+        (void)src;
+        auto* self = static_cast<CountingTransport*>(ctx);
+        self->stats_.spi_transfers++;
+        self->stats_.spi_bytes += len;
+        if (self->baudrate_) {
+            self->stats_.wire_time_us += (double)len * 8.0 * 1e6 / (double)self->baudrate_;
+        }
+        if (dst) {
+            for (size_t i = 0; i < len; i++) dst[i] = 0xFF;
+        }
+        return (int)len;
+    }
+
+    static void on_baudrate(void* ctx, uint bus, uint baudrate) {
+        (void)bus;
+        static_cast<CountingTransport*>(ctx)->baudrate_ = baudrate;
+    }
+
+    static void on_put(void* ctx, uint gpio, bool value) {
+        auto* self = static_cast<CountingTransport*>(ctx);
+        self->stats_.gpio_writes++;
+        if (gpio < 32) {
+            self->levels_ = value ? (self->levels_ | (1u << gpio)) : (self->levels_ & ~(1u << gpio));
+        }
+    }
+
+    static bool on_get(void* ctx, uint gpio) {
+        auto* self = static_cast<CountingTransport*>(ctx);
+        return gpio < 32 && (self->levels_ & (1u << gpio));
+    }
+
+    host_spi_fake_t spi_fake_{};
+    host_gpio_fake_t gpio_fake_{};
+    Stats stats_;
+    uint32_t baudrate_ = 0;
+    uint32_t levels_ = 0;
+};
+
+} // namespace host
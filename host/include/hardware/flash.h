@@ -0,0 +1,47 @@
+/**
+ * @file hardware/flash.h
+ * @brief 主机构建用hardware/flash shim
+ *
+ * 片上Flash由一块内存模拟（擦除态为0xFF，编程只能把1写成0），
+ * XIP_BASE指向这块内存，代码可以像在RP2040上一样直接读取。
+ * 内容可通过host_fakes.h中的host_flash_load/host_flash_save与文件互换。
+ */
+
+#ifndef _HARDWARE_FLASH_H
+#define _HARDWARE_FLASH_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLASH_PAGE_SIZE   (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#define FLASH_BLOCK_SIZE  (1u << 16)
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#endif
+
+const uint8_t *host_flash_base(void);
+
+#ifndef XIP_BASE
+#define XIP_BASE ((uintptr_t)host_flash_base())
+#endif
+
+/**
+ * @brief 擦除扇区，偏移和长度须按FLASH_SECTOR_SIZE对齐
+ */
+void flash_range_erase(uint32_t flash_offs, size_t count);
+
+/**
+ * @brief 编程页，偏移和长度须按FLASH_PAGE_SIZE对齐
+ */
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _HARDWARE_FLASH_H
@@ -0,0 +1,58 @@
+/**
+ * @file hardware/pwm.h
+ * @brief 主机构建用hardware/pwm shim（仅背光使用，全部为空操作）
+ */
+
+#ifndef _HARDWARE_PWM_H
+#define _HARDWARE_PWM_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t csr;
+    uint32_t div;
+    uint32_t top;
+} pwm_config;
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1u) & 7u;
+}
+
+static inline uint pwm_gpio_to_channel(uint gpio) {
+    return gpio & 1u;
+}
+
+static inline pwm_config pwm_get_default_config(void) {
+    pwm_config c = {0, 1u << 4, 0xffffu};
+    return c;
+}
+
+static inline void pwm_config_set_clkdiv(pwm_config *c, float div) {
+    c->div = (uint32_t)(div * (float)(1u << 4));
+}
+
+static inline void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) {
+    c->top = wrap;
+}
+
+static inline void pwm_init(uint slice_num, pwm_config *c, bool start) {
+    (void)slice_num; (void)c; (void)start;
+}
+
+static inline void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) {
+    (void)slice_num; (void)chan; (void)level;
+}
+
+static inline void pwm_set_enabled(uint slice_num, bool enabled) {
+    (void)slice_num; (void)enabled;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _HARDWARE_PWM_H
@@ -0,0 +1,61 @@
+/**
+ * @file hardware/spi.h
+ * @brief 主机构建用hardware/spi shim
+ *
+ * 传输委托给host_spi_set_fake()安装的传输模型；
+ * 未安装时写入被丢弃，读取返回0xFF。
+ */
+
+#ifndef _HARDWARE_SPI_H
+#define _HARDWARE_SPI_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct spi_inst {
+    uint index;
+    uint baudrate;
+} spi_inst_t;
+
+extern spi_inst_t host_spi0_inst;
+extern spi_inst_t host_spi1_inst;
+
+#define spi0 (&host_spi0_inst)
+#define spi1 (&host_spi1_inst)
+
+typedef enum {
+    SPI_CPHA_0 = 0,
+    SPI_CPHA_1 = 1
+} spi_cpha_t;
+
+typedef enum {
+    SPI_CPOL_0 = 0,
+    SPI_CPOL_1 = 1
+} spi_cpol_t;
+
+typedef enum {
+    SPI_LSB_FIRST = 0,
+    SPI_MSB_FIRST = 1
+} spi_order_t;
+
+static inline uint spi_get_index(const spi_inst_t *spi) {
+    return spi->index;
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+void spi_deinit(spi_inst_t *spi);
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate);
+uint spi_get_baudrate(const spi_inst_t *spi);
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len);
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _HARDWARE_SPI_H
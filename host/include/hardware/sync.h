@@ -0,0 +1,31 @@
+/**
+ * @file hardware/sync.h
+ * @brief 主机构建用hardware/sync shim（中断开关为空操作）
+ */
+
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void __dmb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t save_and_disable_interrupts(void) {
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t status) {
+    (void)status;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _HARDWARE_SYNC_H
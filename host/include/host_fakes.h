@@ -0,0 +1,129 @@
+/**
+ * @file host_fakes.h
+ * @brief 主机构建的可替换硬件模型接口
+ *
+ * pico/time、hardware/i2c、hardware/spi、hardware/gpio、pico/sync 的shim
+ * 都只是一层转发，真正的行为由这里安装的fake决定：
+ * - 时钟: 默认实时时钟；可切换为虚拟时钟，使sleep_us()只推进时间不真正等待
+ * - I2C:  默认无设备应答；安装设备模型后由模型处理每次传输
+ * - SPI:  默认丢弃写入；安装传输模型后可统计或渲染数据
+ * - GPIO: 默认维护电平表；安装后可观察CS/DC等引脚翻转
+ * - 互斥锁: 默认只记录持有状态；安装后可检查加锁顺序
+ * - Flash:  固定为内存模拟，可与镜像文件互换以模拟断电重启
+ *
+ * 传入NULL即恢复默认实现。fake结构体由调用者持有，安装期间须保持有效。
+ */
+
+#ifndef _HOST_FAKES_H
+#define _HOST_FAKES_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 时钟
+// =============================================================================
+
+typedef struct {
+    uint64_t (*now_us)(void *ctx);              // 当前时间(自启动起的微秒数)
+    void (*sleep_us)(void *ctx, uint64_t us);   // 休眠/忙等
+    void *ctx;
+} host_time_fake_t;
+
+void host_time_set_fake(const host_time_fake_t *fake);
+
+/**
+ * @brief 切换到虚拟时钟：时间从start_us开始，只由sleep和host_time_advance_us推进
+ */
+void host_time_use_virtual_clock(uint64_t start_us);
+
+/**
+ * @brief 推进虚拟时钟（供总线模型模拟传输耗时）
+ */
+void host_time_advance_us(uint64_t us);
+
+/**
+ * @brief 当前是否使用虚拟时钟
+ */
+bool host_time_is_virtual(void);
+
+// =============================================================================
+// I2C
+// =============================================================================
+
+typedef struct {
+    // 返回写入/读取的字节数，或PICO_ERROR_GENERIC(地址无应答)
+    int (*write)(void *ctx, uint bus, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+    int (*read)(void *ctx, uint bus, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+    // 可选：总线初始化/改频通知
+    void (*set_baudrate)(void *ctx, uint bus, uint baudrate);
+    void *ctx;
+} host_i2c_fake_t;
+
+void host_i2c_set_fake(const host_i2c_fake_t *fake);
+
+// =============================================================================
+// SPI
+// =============================================================================
+
+typedef struct {
+    // 返回传输的字节数；dst为NULL表示只写，src为NULL表示只读
+    int (*transfer)(void *ctx, uint bus, const uint8_t *src, uint8_t *dst, size_t len);
+    void (*set_baudrate)(void *ctx, uint bus, uint baudrate);
+    void *ctx;
+} host_spi_fake_t;
+
+void host_spi_set_fake(const host_spi_fake_t *fake);
+
+// =============================================================================
+// GPIO
+// =============================================================================
+
+typedef struct {
+    void (*put)(void *ctx, uint gpio, bool value);
+    bool (*get)(void *ctx, uint gpio);
+    void *ctx;
+} host_gpio_fake_t;
+
+void host_gpio_set_fake(const host_gpio_fake_t *fake);
+
+// =============================================================================
+// 互斥锁
+// =============================================================================
+
+typedef struct {
+    void (*enter)(void *ctx, void *mtx);
+    void (*exit)(void *ctx, void *mtx);
+    void *ctx;
+} host_sync_fake_t;
+
+void host_sync_set_fake(const host_sync_fake_t *fake);
+
+// =============================================================================
+// Flash
+// =============================================================================
+
+/**
+ * @brief 从镜像文件载入Flash内容（文件较短时其余部分为擦除态）
+ */
+bool host_flash_load(const char *path);
+
+/**
+ * @brief 把完整Flash内容写入镜像文件
+ */
+bool host_flash_save(const char *path);
+
+/**
+ * @brief 启动以来擦除的扇区数/编程的页数（评估磨损）
+ */
+uint32_t host_flash_erase_count(void);
+uint32_t host_flash_program_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _HOST_FAKES_H
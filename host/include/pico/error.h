@@ -0,0 +1,20 @@
+/**
+ * @file pico/error.h
+ * @brief 主机构建用Pico SDK错误码shim
+ */
+
+#ifndef _PICO_ERROR_H
+#define _PICO_ERROR_H
+
+enum pico_error_codes {
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2,
+    PICO_ERROR_NO_DATA = -3,
+    PICO_ERROR_NOT_PERMITTED = -4,
+    PICO_ERROR_INVALID_ARG = -5,
+    PICO_ERROR_IO = -6,
+};
+
+#endif // _PICO_ERROR_H
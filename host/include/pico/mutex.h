@@ -0,0 +1,32 @@
+/**
+ * @file pico/mutex.h
+ * @brief 主机构建用pico/mutex shim
+ *
+ * 主机端为单线程运行，默认实现只记录持有状态和计数；
+ * 需要观察锁行为时可通过host_sync_set_fake()接管。
+ */
+
+#ifndef _PICO_MUTEX_H
+#define _PICO_MUTEX_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mutex {
+    bool owned;
+    uint32_t enter_count;
+} mutex_t;
+
+void mutex_init(mutex_t *mtx);
+void mutex_enter_blocking(mutex_t *mtx);
+bool mutex_try_enter(mutex_t *mtx, uint32_t *owner_out);
+void mutex_exit(mutex_t *mtx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _PICO_MUTEX_H
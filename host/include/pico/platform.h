@@ -0,0 +1,30 @@
+/**
+ * @file pico/platform.h
+ * @brief 主机构建用pico/platform shim（代码段放置属性为空）
+ *
+ * 固件中__not_in_flash_func把函数放入SRAM（.time_critical段），
+ * 主机上没有XIP，函数保持原位。
+ */
+
+#ifndef _PICO_PLATFORM_H
+#define _PICO_PLATFORM_H
+
+#include "pico/types.h"
+
+#ifndef __not_in_flash
+#define __not_in_flash(group)
+#endif
+
+#ifndef __not_in_flash_func
+#define __not_in_flash_func(func_name) func_name
+#endif
+
+#ifndef __time_critical_func
+#define __time_critical_func(func_name) func_name
+#endif
+
+#ifndef __force_inline
+#define __force_inline inline __attribute__((always_inline))
+#endif
+
+#endif // _PICO_PLATFORM_H
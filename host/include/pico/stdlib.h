@@ -0,0 +1,30 @@
+/**
+ * @file pico/stdlib.h
+ * @brief 主机构建用pico/stdlib shim
+ */
+
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+#include "pico/types.h"
+#include "pico/platform.h"
+#include "pico/error.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline bool stdio_init_all(void) {
+    return true;
+}
+
+static inline void tight_loop_contents(void) {
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _PICO_STDLIB_H
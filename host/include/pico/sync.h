@@ -0,0 +1,11 @@
+/**
+ * @file pico/sync.h
+ * @brief 主机构建用pico/sync shim
+ */
+
+#ifndef _PICO_SYNC_H
+#define _PICO_SYNC_H
+
+#include "pico/mutex.h"
+
+#endif // _PICO_SYNC_H
@@ -0,0 +1,21 @@
+/**
+ * @file pico/types.h
+ * @brief 主机构建用Pico SDK基础类型shim
+ */
+
+#ifndef _PICO_TYPES_H
+#define _PICO_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifndef __cplusplus
+typedef unsigned int uint;
+#endif
+
+// 与SDK默认配置(PICO_OPAQUE_ABSOLUTE_TIME_T=0)一致，直接使用64位微秒计数
+typedef uint64_t absolute_time_t;
+
+#endif // _PICO_TYPES_H
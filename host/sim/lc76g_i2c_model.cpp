@@ -0,0 +1,274 @@
+/**
+ * @file lc76g_i2c_model.cpp
+ * @brief LC76G I2C寄存器模型实现
+ */
+
+#include "lc76g_i2c_model.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "hardware/i2c.h"
+#include "pico/time.h"
+
+extern "C" {
+#include "gps/lc76g_i2c_adaptor.h"
+}
+
+namespace sim {
+
+namespace {
+
+uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void write_le32(uint32_t v, uint8_t* p) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+} // namespace
+
+Lc76gI2cModel::Lc76gI2cModel(NmeaSource& source, const Lc76gI2cModelConfig& config)
+    : source_(source), config_(config), rng_(config.seed) {
+    fake_.write = &Lc76gI2cModel::on_write;
+    fake_.read = &Lc76gI2cModel::on_read;
+    fake_.set_baudrate = &Lc76gI2cModel::on_baudrate;
+    fake_.ctx = this;
+}
+
+Lc76gI2cModel::~Lc76gI2cModel() {
+    uninstall();
+}
+
+void Lc76gI2cModel::install() {
+    host_i2c_set_fake(&fake_);
+}
+
+void Lc76gI2cModel::uninstall() {
+    host_i2c_set_fake(nullptr);
+}
+
+// =============================================================================
+// 总线回调
+// =============================================================================
+
+int Lc76gI2cModel::on_write(void* ctx, uint bus, uint8_t addr, const uint8_t* src, size_t len, bool nostop) {
+    (void)bus;
+    (void)nostop;
+    return static_cast<Lc76gI2cModel*>(ctx)->handle_write(addr, src, len);
+}
+
+int Lc76gI2cModel::on_read(void* ctx, uint bus, uint8_t addr, uint8_t* dst, size_t len, bool nostop) {
+    (void)bus;
+    (void)nostop;
+    return static_cast<Lc76gI2cModel*>(ctx)->handle_read(addr, dst, len);
+}
+
+void Lc76gI2cModel::on_baudrate(void* ctx, uint bus, uint baudrate) {
+    (void)bus;
+    static_cast<Lc76gI2cModel*>(ctx)->baudrate_ = baudrate;
+}
+
+// =============================================================================
+// 时序与故障注入
+// =============================================================================
+
+uint64_t Lc76gI2cModel::now_us() const {
+    return to_us_since_boot(get_absolute_time());
+}
+
+bool Lc76gI2cModel::inject_nak() {
+    if (config_.nak_probability <= 0) {
+        return false;
+    }
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    if (u(rng_) < config_.nak_probability) {
+        stats_.naks++;
+        account(0);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 记录一次传输的线上时间：START + 地址字节 + 数据字节（每字节9位含ACK）+ STOP
+ */
+void Lc76gI2cModel::account(size_t bytes) {
+    stats_.transactions++;
+    double us = config_.latency_us;
+    if (baudrate_) {
+        us += (double)((1 + bytes) * 9 + 2) * 1e6 / (double)baudrate_;
+    }
+    stats_.bus_time_us += us;
+    if (config_.advance_clock && host_time_is_virtual()) {
+        host_time_advance_us((uint64_t)(us + 0.5));
+    }
+}
+
+void Lc76gI2cModel::drain_rx(uint64_t now) {
+    if (config_.command_drain_bps == 0) {
+        rx_pending_ = 0;
+        rx_drain_us_ = now;
+        return;
+    }
+    if (now > rx_drain_us_) {
+        uint64_t drained = (now - rx_drain_us_) * config_.command_drain_bps / 1000000ull;
+        if (drained > 0) {
+            rx_pending_ -= std::min<size_t>(rx_pending_, drained);
+            rx_drain_us_ = now;
+        }
+    }
+    if (rx_pending_ == 0) {
+        rx_drain_us_ = now;
+    }
+}
+
+uint32_t Lc76gI2cModel::free_space(uint64_t now) {
+    drain_rx(now);
+    uint32_t space = config_.rx_capacity > rx_pending_ ? (uint32_t)(config_.rx_capacity - rx_pending_) : 0;
+    if (config_.free_space_limit) {
+        space = std::min(space, config_.free_space_limit);
+    }
+    return space;
+}
+
+// =============================================================================
+// 寄存器状态机
+// =============================================================================
+
+int Lc76gI2cModel::handle_write(uint8_t addr, const uint8_t* src, size_t len) {
+    if (addr != QL_CRCW_ADDR && addr != QL_RD_ADDR && addr != QL_WR_ADDR) {
+        account(0);
+        return PICO_ERROR_GENERIC;
+    }
+    if (inject_nak()) {
+        return PICO_ERROR_GENERIC;
+    }
+
+    // 1字节写：探测。0x54/0x58上的探测同时放弃未完成的传输（recovery_i2c的用法）
+    if (len == 1) {
+        if (addr == QL_CRCW_ADDR && config_.strict_state && pending_ != Pending::None) {
+            stats_.state_naks++;
+            account(0);
+            return PICO_ERROR_GENERIC;
+        }
+        if (addr != QL_CRCW_ADDR) {
+            pending_ = Pending::None;
+        }
+        stats_.probes++;
+        account(len);
+        return (int)len;
+    }
+
+    if (addr == QL_CRCW_ADDR) {
+        if (len != 8 || (config_.strict_state && pending_ != Pending::None)) {
+            stats_.state_naks++;
+            account(0);
+            return PICO_ERROR_GENERIC;
+        }
+        uint32_t reg = read_le32(src);
+        uint32_t cfg_len = read_le32(src + 4);
+        switch (reg) {
+            case QL_CR_REG:
+                pending_ = Pending::LengthRead;
+                break;
+            case QL_RD_REG:
+                if (cfg_len == 0 || cfg_len > config_.window_bytes) {
+                    stats_.state_naks++;
+                    account(0);
+                    return PICO_ERROR_GENERIC;
+                }
+                pending_ = Pending::DataRead;
+                break;
+            case QL_CW_REG:
+                pending_ = Pending::FreeRead;
+                break;
+            case QL_WR_REG:
+                pending_ = Pending::CommandWrite;
+                break;
+            default:
+                stats_.state_naks++;
+                account(0);
+                return PICO_ERROR_GENERIC;
+        }
+        pending_len_ = cfg_len;
+        account(len);
+        return (int)len;
+    }
+
+    if (addr == QL_WR_ADDR && pending_ == Pending::CommandWrite) {
+        uint64_t now = now_us();
+        uint32_t space = free_space(now);
+        size_t accepted = std::min<size_t>(len, space);
+        stats_.rx_overflow_bytes += len - accepted;
+        rx_pending_ += accepted;
+        rx_log_.append((const char*)src, accepted);
+        stats_.command_writes++;
+        stats_.bytes_written += len;
+        pending_ = Pending::None;
+        account(len);
+        source_.on_command(src, accepted, now);
+        return (int)len;
+    }
+
+    stats_.state_naks++;
+    account(0);
+    return PICO_ERROR_GENERIC;
+}
+
+int Lc76gI2cModel::handle_read(uint8_t addr, uint8_t* dst, size_t len) {
+    if (addr != QL_RD_ADDR) {
+        account(0);
+        return PICO_ERROR_GENERIC;
+    }
+    if (inject_nak()) {
+        return PICO_ERROR_GENERIC;
+    }
+
+    const uint64_t now = now_us();
+    switch (pending_) {
+        case Pending::LengthRead: {
+            uint8_t value[4];
+            write_le32((uint32_t)source_.available(now), value);
+            std::memset(dst, 0, len);
+            std::memcpy(dst, value, std::min<size_t>(len, 4));
+            stats_.length_polls++;
+            if (read_le32(value) == 0) {
+                stats_.empty_polls++;
+            }
+            break;
+        }
+        case Pending::FreeRead: {
+            uint8_t value[4];
+            write_le32(free_space(now), value);
+            std::memset(dst, 0, len);
+            std::memcpy(dst, value, std::min<size_t>(len, 4));
+            stats_.free_queries++;
+            break;
+        }
+        case Pending::DataRead: {
+            size_t want = std::min<size_t>(len, pending_len_);
+            size_t got = source_.pull(dst, want, now);
+            if (got < len) {
+                std::memset(dst + got, 0, len - got);
+                stats_.underrun_bytes += len - got;
+            }
+            stats_.data_reads++;
+            stats_.bytes_read += got;
+            break;
+        }
+        default:
+            stats_.state_naks++;
+            account(0);
+            return PICO_ERROR_GENERIC;
+    }
+    pending_ = Pending::None;
+    account(len);
+    return (int)len;
+}
+
+} // namespace sim
@@ -0,0 +1,151 @@
+/**
+ * @file lc76g_i2c_model.hpp
+ * @brief LC76G I2C寄存器模型（主机仿真）
+ *
+ * 模拟lc76g_i2c_adaptor使用的三地址协议：
+ * - 0x50 (QL_CRCW_ADDR): 1字节写为探测；8字节写为 reg(LE32) + len(LE32) 配置
+ *   - QL_CR_REG:  下一次0x54读返回模块待发送字节数
+ *   - QL_RD_REG:  下一次0x54读返回len字节输出数据（单次不超过4KB窗口）
+ *   - QL_CW_REG:  下一次0x54读返回命令接收缓冲的空闲字节数
+ *   - QL_WR_REG:  下一次0x58写入len字节命令
+ * - 0x54 (QL_RD_ADDR): 读取配置好的数据
+ * - 0x58 (QL_WR_ADDR): 写入命令数据
+ *
+ * 模型自带TX（模块→主机）和RX（主机→模块）缓冲，输出数据来自sim::NmeaSource。
+ * 支持按概率NAK、每次传输的固定延迟、写入空闲空间上限，并按当前I2C时钟
+ * 逐字节计算线上时间；使用虚拟时钟时这些耗时会推进host_time。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "host_fakes.h"
+#include "nmea_generator.hpp"
+
+namespace sim {
+
+/**
+ * @brief 寄存器模型配置
+ */
+struct Lc76gI2cModelConfig {
+    double nak_probability = 0.0;       // 每次传输地址无应答的概率
+    uint32_t latency_us = 0;            // 每次传输的固定额外耗时（模块响应/时钟拉伸）
+    uint32_t window_bytes = 4096;       // QL_RD_REG单次读取上限
+    uint32_t rx_capacity = 4096;        // 命令接收缓冲容量
+    uint32_t free_space_limit = 0;      // QL_CW_REG报告的空闲空间上限，0表示不限制
+    uint32_t command_drain_bps = 0;     // 模块消化命令的速度(字节/秒)，0表示立即消化
+    bool strict_state = true;           // 配置后未完成的传输期间0x50不应答（与实机一致）
+    bool advance_clock = true;          // 虚拟时钟下按线上时间推进时钟
+    uint32_t seed = 1;
+};
+
+/**
+ * @brief 总线统计
+ */
+struct Lc76gI2cModelStats {
+    uint64_t transactions = 0;
+    uint64_t naks = 0;                  // 注入的NAK
+    uint64_t state_naks = 0;            // 状态机不接受而NAK（如未配置就读0x54）
+    uint64_t probes = 0;                // 1字节探测写
+    uint64_t length_polls = 0;          // QL_CR_REG长度查询
+    uint64_t empty_polls = 0;           // 长度为0的查询
+    uint64_t data_reads = 0;            // QL_RD_REG数据读取
+    uint64_t free_queries = 0;          // QL_CW_REG空闲空间查询
+    uint64_t command_writes = 0;        // 0x58命令写入
+    uint64_t bytes_read = 0;            // 0x54读出的数据字节（不含长度字段）
+    uint64_t bytes_written = 0;         // 0x58写入的命令字节
+    uint64_t underrun_bytes = 0;        // 读取超出可用数据时补0的字节
+    uint64_t rx_overflow_bytes = 0;     // 超出接收缓冲被丢弃的命令字节
+    double bus_time_us = 0;             // 线上时间（含固定延迟）
+};
+
+/**
+ * @brief LC76G I2C寄存器模型
+ *
+ * 用法:
+ * @code
+ *   host_time_use_virtual_clock(0);
+ *   sim::NmeaGenerator gen(cfg);
+ *   sim::Lc76gI2cModel model(gen);
+ *   model.install();
+ *   lc76g_i2c_init(i2c1, 6, 7, 400000, -1);
+ *   lc76g_read_fix(&fix);
+ * @endcode
+ */
+class Lc76gI2cModel {
+public:
+    explicit Lc76gI2cModel(NmeaSource& source, const Lc76gI2cModelConfig& config = Lc76gI2cModelConfig());
+    ~Lc76gI2cModel();
+
+    Lc76gI2cModel(const Lc76gI2cModel&) = delete;
+    Lc76gI2cModel& operator=(const Lc76gI2cModel&) = delete;
+
+    void install();
+    void uninstall();
+
+    void reset_stats() { stats_ = Lc76gI2cModelStats(); }
+    const Lc76gI2cModelStats& stats() const { return stats_; }
+    const Lc76gI2cModelConfig& config() const { return config_; }
+
+    /**
+     * @brief 运行中修改NAK概率（用于分段注入故障）
+     */
+    void set_nak_probability(double p) { config_.nak_probability = p; }
+
+    /**
+     * @brief 当前I2C时钟（Hz），由i2c_init/i2c_set_baudrate通知
+     */
+    uint32_t baudrate() const { return baudrate_; }
+
+    /**
+     * @brief 命令接收缓冲中尚未被模块消化的字节数
+     */
+    size_t rx_pending() const { return rx_pending_; }
+
+    /**
+     * @brief 模块已收到的全部命令数据（按接收顺序）
+     */
+    const std::string& received_commands() const { return rx_log_; }
+
+private:
+    enum class Pending : uint8_t {
+        None,
+        LengthRead,     // QL_CR_REG
+        DataRead,       // QL_RD_REG
+        FreeRead,       // QL_CW_REG
+        CommandWrite    // QL_WR_REG
+    };
+
+    static int on_write(void* ctx, uint bus, uint8_t addr, const uint8_t* src, size_t len, bool nostop);
+    static int on_read(void* ctx, uint bus, uint8_t addr, uint8_t* dst, size_t len, bool nostop);
+    static void on_baudrate(void* ctx, uint bus, uint baudrate);
+
+    int handle_write(uint8_t addr, const uint8_t* src, size_t len);
+    int handle_read(uint8_t addr, uint8_t* dst, size_t len);
+
+    uint64_t now_us() const;
+    bool inject_nak();
+    void account(size_t bytes);
+    void drain_rx(uint64_t now);
+    uint32_t free_space(uint64_t now);
+
+    NmeaSource& source_;
+    Lc76gI2cModelConfig config_;
+    Lc76gI2cModelStats stats_;
+    host_i2c_fake_t fake_{};
+    std::mt19937 rng_;
+    uint32_t baudrate_ = 400000;
+
+    Pending pending_ = Pending::None;
+    uint32_t pending_len_ = 0;
+
+    size_t rx_pending_ = 0;
+    uint64_t rx_drain_us_ = 0;
+    std::string rx_log_;
+};
+
+} // namespace sim
@@ -0,0 +1,791 @@
+/**
+ * @file nmea_generator.cpp
+ * @brief 合成NMEA数据流生成器实现
+ */
+
+#include "nmea_generator.hpp"
+#include "gps/gps_geofence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace sim {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979324;
+constexpr double kEarthRadiusM = 6371000.0;
+constexpr double kKmhPerKnot = 1.852;
+
+struct SystemInfo {
+    const char* talker;
+    uint16_t first_prn;
+    uint16_t max_sats;
+    uint8_t nmea_system_id;   // NMEA 4.10 GSA系统ID
+};
+
+const SystemInfo kSystems[(int)Constellation::Count] = {
+    {"GP", 1, 32, 1},
+    {"GL", 65, 24, 2},
+    {"GA", 1, 36, 3},
+    {"GB", 1, 63, 4},
+    {"GQ", 1, 10, 5},
+};
+
+// 周期性应答时轮流使用的命令号（与vendor_gps_parser中的命令对应）
+const uint16_t kAckCommands[] = {50, 62, 66, 4, 5, 7, 9, 513};
+
+// Howard Hinnant的civil日期算法
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+void civil_from_days(int64_t z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned)(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t yy = (int64_t)yoe + era * 400;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = (int)(yy + (m <= 2));
+}
+
+/**
+ * @brief 等距圆柱近似的距离和方位
+ */
+void leg_geometry(const Waypoint& a, const Waypoint& b, double& dist_m, double& course_deg) {
+    double lat0 = (a.lat + b.lat) * 0.5 * kPi / 180.0;
+    double dx = (b.lon - a.lon) * kPi / 180.0 * std::cos(lat0) * kEarthRadiusM;
+    double dy = (b.lat - a.lat) * kPi / 180.0 * kEarthRadiusM;
+    dist_m = std::sqrt(dx * dx + dy * dy);
+    course_deg = std::fmod(std::atan2(dx, dy) * 180.0 / kPi + 360.0, 360.0);
+}
+
+void format_lat(double lat, char* buf, size_t len, char& hemi) {
+    hemi = lat < 0 ? 'S' : 'N';
+    lat = std::fabs(lat);
+    int deg = (int)lat;
+    double min = (lat - deg) * 60.0;
+    std::snprintf(buf, len, "%02d%09.6f", deg, min);
+}
+
+void format_lon(double lon, char* buf, size_t len, char& hemi) {
+    hemi = lon < 0 ? 'W' : 'E';
+    lon = std::fabs(lon);
+    int deg = (int)lon;
+    double min = (lon - deg) * 60.0;
+    std::snprintf(buf, len, "%03d%09.6f", deg, min);
+}
+
+} // namespace
+
+// =============================================================================
+// Trajectory
+// =============================================================================
+
+Trajectory::Trajectory() = default;
+
+Trajectory::Trajectory(std::vector<Waypoint> waypoints) : waypoints_(std::move(waypoints)) {
+    build_legs();
+}
+
+Trajectory Trajectory::default_route() {
+    // 人民广场附近的闭合环线：市区行驶、路口停车、一段高架快速路
+    return Trajectory({
+        {31.230416, 121.473701, 12.0, 35.0, 0.0},
+        {31.235920, 121.480255, 14.0, 25.0, 20.0},
+        {31.241850, 121.489100, 15.0, 60.0, 0.0},
+        {31.252300, 121.495800, 22.0, 80.0, 0.0},
+        {31.246100, 121.470300, 18.0, 40.0, 45.0},
+        {31.236700, 121.462900, 13.0, 30.0, 0.0},
+    });
+}
+
+bool Trajectory::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        printf("[NMEA Gen] 无法打开轨迹文件: %s\n", path.c_str());
+        return false;
+    }
+    std::vector<Waypoint> points;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        Waypoint w;
+        if (std::sscanf(line.c_str(), "%lf,%lf,%lf,%lf,%lf", &w.lat, &w.lon, &w.alt_m, &w.speed_kmh, &w.hold_s) < 4) {
+            printf("[NMEA Gen] 轨迹行格式错误: %s\n", line.c_str());
+            return false;
+        }
+        points.push_back(w);
+    }
+    if (points.empty()) {
+        printf("[NMEA Gen] 轨迹文件为空: %s\n", path.c_str());
+        return false;
+    }
+    waypoints_ = std::move(points);
+    build_legs();
+    return true;
+}
+
+void Trajectory::build_legs() {
+    legs_.clear();
+    loop_s_ = 0;
+    const size_t n = waypoints_.size();
+    for (size_t i = 0; i < n; i++) {
+        const Waypoint& a = waypoints_[i];
+        const Waypoint& b = waypoints_[(i + 1) % n];
+        double dist = 0, course = 0;
+        if (n > 1) {
+            leg_geometry(a, b, dist, course);
+        }
+        Leg leg;
+        leg.start_s = loop_s_;
+        leg.move_s = (a.speed_kmh > 0 && dist > 0) ? dist / (a.speed_kmh / 3.6) : 0.0;
+        leg.hold_s = b.hold_s;
+        leg.course_deg = course;
+        legs_.push_back(leg);
+        loop_s_ += leg.move_s + leg.hold_s;
+    }
+}
+
+MotionState Trajectory::at(double t_s) const {
+    MotionState m;
+    if (waypoints_.empty()) {
+        return m;
+    }
+    if (loop_s_ <= 0) {
+        m.lat = waypoints_[0].lat;
+        m.lon = waypoints_[0].lon;
+        m.alt_m = waypoints_[0].alt_m;
+        return m;
+    }
+    double t = std::fmod(std::max(t_s, 0.0), loop_s_);
+    const size_t n = waypoints_.size();
+    for (size_t i = 0; i < n; i++) {
+        const Leg& leg = legs_[i];
+        if (t >= leg.start_s + leg.move_s + leg.hold_s && i + 1 < n) {
+            continue;
+        }
+        const Waypoint& a = waypoints_[i];
+        const Waypoint& b = waypoints_[(i + 1) % n];
+        double local = t - leg.start_s;
+        double f = leg.move_s > 0 ? std::min(local / leg.move_s, 1.0) : 1.0;
+        m.lat = a.lat + (b.lat - a.lat) * f;
+        m.lon = a.lon + (b.lon - a.lon) * f;
+        m.alt_m = a.alt_m + (b.alt_m - a.alt_m) * f;
+        m.course_deg = leg.course_deg;
+        m.speed_kmh = local < leg.move_s ? a.speed_kmh : 0.0;
+        return m;
+    }
+    return m;
+}
+
+// =============================================================================
+// NmeaGenerator
+// =============================================================================
+
+NmeaGenerator::NmeaGenerator(const GeneratorConfig& config, Trajectory trajectory)
+    : config_(config), trajectory_(std::move(trajectory)), rng_(config.seed) {
+    config_.rate_hz = std::min<uint32_t>(std::max<uint32_t>(config_.rate_hz, 1), 10);
+    start_epoch_days_ = days_from_civil(config_.year, config_.month, config_.day);
+    start_second_of_day_ = (uint32_t)config_.hour * 3600u + (uint32_t)config_.minute * 60u + config_.second;
+    build_sky();
+}
+
+uint64_t NmeaGenerator::epoch_interval_us() const {
+    return 1000000ull / config_.rate_hz;
+}
+
+void NmeaGenerator::build_sky() {
+    sky_.clear();
+    uint16_t next_prn[(int)Constellation::Count];
+    uint16_t counts[(int)Constellation::Count] = {0};
+    for (int s = 0; s < (int)Constellation::Count; s++) {
+        next_prn[s] = kSystems[s].first_prn;
+    }
+
+    std::uniform_real_distribution<double> phase(0.0, 2.0 * kPi);
+    std::uniform_real_distribution<double> az(0.0, 360.0);
+
+    uint32_t remaining = config_.satellites;
+    bool progress = true;
+    while (remaining > 0 && progress) {
+        progress = false;
+        for (int s = 0; s < (int)Constellation::Count && remaining > 0; s++) {
+            if (!(config_.constellation_mask & (1u << s)) || counts[s] >= kSystems[s].max_sats) {
+                continue;
+            }
+            Satellite sat{};
+            sat.system = (Constellation)s;
+            sat.prn = next_prn[s]++;
+            sat.phase = phase(rng_);
+            sat.az0 = az(rng_);
+            sky_.push_back(sat);
+            counts[s]++;
+            remaining--;
+            progress = true;
+        }
+    }
+}
+
+void NmeaGenerator::update_sky(double t_s, bool outage) {
+    std::uniform_int_distribution<int> noise(-2, 2);
+    int used_per_system[(int)Constellation::Count] = {0};
+    used_count_ = 0;
+
+    for (Satellite& sat : sky_) {
+        // 半个恒星日完成一次升落，方位缓慢转动
+        sat.elevation = 5.0 + 80.0 * (0.5 + 0.5 * std::sin(sat.phase + t_s * 2.0 * kPi / 43080.0));
+        sat.azimuth = std::fmod(sat.az0 + t_s * 360.0 / 86160.0, 360.0);
+        sat.snr = sat.elevation < 10.0 ? 0 : (int)(18.0 + sat.elevation * 0.3) + noise(rng_);
+        if (outage) {
+            sat.snr = sat.snr > 0 ? std::min(sat.snr, 18) : 0;
+        }
+        int s = (int)sat.system;
+        sat.used = !outage && sat.elevation >= 15.0 && sat.snr >= 25 && used_per_system[s] < 12;
+        if (sat.used) {
+            used_per_system[s]++;
+            used_count_++;
+        }
+    }
+
+    if (used_count_ >= 4) {
+        hdop_ = 0.5 + 6.0 / used_count_;
+        vdop_ = hdop_ * 1.5;
+        pdop_ = std::sqrt(hdop_ * hdop_ + vdop_ * vdop_);
+    } else {
+        hdop_ = vdop_ = pdop_ = 99.99;
+    }
+}
+
+NmeaGenerator::EpochKind NmeaGenerator::epoch_kind(uint64_t epoch, double& corruption_rate) const {
+    corruption_rate = config_.corruption_rate;
+    EpochKind kind = EpochKind::Normal;
+    for (const BurstPattern& b : config_.bursts) {
+        if (b.period_epochs == 0 || b.length_epochs == 0 || epoch < b.offset_epochs) {
+            continue;
+        }
+        if ((epoch - b.offset_epochs) % b.period_epochs >= b.length_epochs) {
+            continue;
+        }
+        switch (b.mode) {
+            case BurstPattern::Mode::Drop:
+                return EpochKind::Drop;
+            case BurstPattern::Mode::Outage:
+                kind = EpochKind::Outage;
+                break;
+            case BurstPattern::Mode::Corrupt:
+                corruption_rate = std::max(corruption_rate, b.corruption_rate);
+                if (kind == EpochKind::Normal) {
+                    kind = EpochKind::Corrupt;
+                }
+                break;
+        }
+    }
+    return kind;
+}
+
+std::string NmeaGenerator::make_sentence(const std::string& body) {
+    uint8_t cs = 0;
+    for (char c : body) {
+        cs ^= (uint8_t)c;
+    }
+    char tail[8];
+    std::snprintf(tail, sizeof(tail), "*%02X\r\n", cs);
+    std::string s;
+    s.reserve(body.size() + 6);
+    s.push_back('$');
+    s += body;
+    s += tail;
+    return s;
+}
+
+void NmeaGenerator::corrupt(std::string& sentence) {
+    std::uniform_int_distribution<int> mode_dist(0, 3);
+    size_t star = sentence.find('*');
+    if (star == std::string::npos || star < 2) {
+        return;
+    }
+    switch (mode_dist(rng_)) {
+        case 0: {
+            // 正文中翻转一个字符的低位，校验和失配
+            std::uniform_int_distribution<size_t> pos(1, star - 1);
+            size_t p = pos(rng_);
+            sentence[p] = (char)(sentence[p] ^ 0x01);
+            break;
+        }
+        case 1: {
+            // 截断（模拟缓冲区边界丢字节）
+            std::uniform_int_distribution<size_t> pos(1, sentence.size() - 1);
+            sentence.resize(pos(rng_));
+            break;
+        }
+        case 2:
+            // 校验和字段错误
+            sentence[star + 1] = sentence[star + 1] == '0' ? '1' : '0';
+            break;
+        default: {
+            // 插入噪声字节
+            std::uniform_int_distribution<size_t> pos(0, sentence.size() - 1);
+            std::uniform_int_distribution<int> byte(0, 255);
+            sentence.insert(pos(rng_), 1, (char)(byte(rng_) | 0x80));
+            break;
+        }
+    }
+}
+
+void NmeaGenerator::emit(std::string& out, const std::string& body, double corruption_rate) {
+    std::string sentence = make_sentence(body);
+    if (corruption_rate > 0) {
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        if (u(rng_) < corruption_rate) {
+            corrupt(sentence);
+            stats_.corrupted++;
+        }
+    }
+    stats_.sentences++;
+    stats_.bytes += sentence.size();
+    out += sentence;
+}
+
+void NmeaGenerator::format_utc(double t_s, char* time_buf, size_t time_len, char* date_buf, size_t date_len) const {
+    uint64_t ms_total = (uint64_t)std::llround(t_s * 1000.0) + (uint64_t)start_second_of_day_ * 1000ull;
+    int64_t days = start_epoch_days_ + (int64_t)(ms_total / 86400000ull);
+    uint64_t ms_of_day = ms_total % 86400000ull;
+    unsigned h = (unsigned)(ms_of_day / 3600000ull);
+    unsigned mi = (unsigned)(ms_of_day / 60000ull % 60);
+    unsigned s = (unsigned)(ms_of_day / 1000ull % 60);
+    unsigned ms = (unsigned)(ms_of_day % 1000ull);
+    std::snprintf(time_buf, time_len, "%02u%02u%02u.%03u", h, mi, s, ms);
+
+    int y;
+    unsigned m, d;
+    civil_from_days(days, y, m, d);
+    std::snprintf(date_buf, date_len, "%02u%02u%02d", d, m, y % 100);
+}
+
+void NmeaGenerator::append_rmc(std::string& out, const MotionState& m, const char* time, const char* date,
+                               bool valid, double cr) {
+    char lat[32], lon[32], body[192];
+    char ns, ew;
+    format_lat(m.lat, lat, sizeof(lat), ns);
+    format_lon(m.lon, lon, sizeof(lon), ew);
+    if (valid) {
+        std::snprintf(body, sizeof(body), "GNRMC,%s,A,%s,%c,%s,%c,%.3f,%.2f,%s,,,A,V",
+                      time, lat, ns, lon, ew, m.speed_kmh / kKmhPerKnot, m.course_deg, date);
+    } else {
+        std::snprintf(body, sizeof(body), "GNRMC,%s,V,,,,,,,%s,,,N,V", time, date);
+    }
+    emit(out, body, cr);
+}
+
+void NmeaGenerator::append_vtg(std::string& out, const MotionState& m, bool valid, double cr) {
+    char body[96];
+    if (valid) {
+        std::snprintf(body, sizeof(body), "GNVTG,%.2f,T,,M,%.3f,N,%.3f,K,A",
+                      m.course_deg, m.speed_kmh / kKmhPerKnot, m.speed_kmh);
+    } else {
+        std::snprintf(body, sizeof(body), "GNVTG,,T,,M,,N,,K,N");
+    }
+    emit(out, body, cr);
+}
+
+void NmeaGenerator::append_gga(std::string& out, const MotionState& m, const char* time, bool valid, double cr) {
+    char lat[32], lon[32], body[192];
+    char ns, ew;
+    if (valid) {
+        format_lat(m.lat, lat, sizeof(lat), ns);
+        format_lon(m.lon, lon, sizeof(lon), ew);
+        std::snprintf(body, sizeof(body), "GNGGA,%s,%s,%c,%s,%c,1,%02d,%.2f,%.1f,M,8.5,M,,",
+                      time, lat, ns, lon, ew, std::min(used_count_, 99), hdop_, m.alt_m);
+    } else {
+        std::snprintf(body, sizeof(body), "GNGGA,%s,,,,,0,00,99.99,,M,,M,,", time);
+    }
+    emit(out, body, cr);
+}
+
+void NmeaGenerator::append_gsa(std::string& out, bool valid, double cr) {
+    for (int s = 0; s < (int)Constellation::Count; s++) {
+        if (!(config_.constellation_mask & (1u << s))) {
+            continue;
+        }
+        std::string body = "GNGSA,A,";
+        body += valid ? '3' : '1';
+        int slots = 0;
+        for (const Satellite& sat : sky_) {
+            if ((int)sat.system != s || !sat.used || slots >= 12) {
+                continue;
+            }
+            char prn[8];
+            std::snprintf(prn, sizeof(prn), ",%02u", sat.prn);
+            body += prn;
+            slots++;
+        }
+        for (; slots < 12; slots++) {
+            body += ',';
+        }
+        char tail[48];
+        std::snprintf(tail, sizeof(tail), ",%.2f,%.2f,%.2f,%u", pdop_, hdop_, vdop_, kSystems[s].nmea_system_id);
+        body += tail;
+        emit(out, body, cr);
+    }
+}
+
+void NmeaGenerator::append_gsv(std::string& out, double cr) {
+    for (int s = 0; s < (int)Constellation::Count; s++) {
+        if (!(config_.constellation_mask & (1u << s))) {
+            continue;
+        }
+        std::vector<const Satellite*> sats;
+        for (const Satellite& sat : sky_) {
+            if ((int)sat.system == s) {
+                sats.push_back(&sat);
+            }
+        }
+        const int total = (int)sats.size();
+        const int messages = total == 0 ? 1 : (total + 3) / 4;
+        for (int msg = 0; msg < messages; msg++) {
+            char head[48];
+            std::snprintf(head, sizeof(head), "%sGSV,%d,%d,%02d", kSystems[s].talker, messages, msg + 1, total);
+            std::string body = head;
+            for (int i = msg * 4; i < std::min(total, msg * 4 + 4); i++) {
+                const Satellite* sat = sats[i];
+                char field[48];
+                if (sat->snr > 0) {
+                    std::snprintf(field, sizeof(field), ",%02u,%02d,%03d,%02d",
+                                  sat->prn, (int)sat->elevation, (int)sat->azimuth, sat->snr);
+                } else {
+                    std::snprintf(field, sizeof(field), ",%02u,%02d,%03d,",
+                                  sat->prn, (int)sat->elevation, (int)sat->azimuth);
+                }
+                body += field;
+            }
+            body += ",1";   // 信号ID (L1 C/A / E1 / B1I)
+            emit(out, body, cr);
+        }
+    }
+}
+
+void NmeaGenerator::append_pair_acks(std::string& out, double cr) {
+    while (!pending_acks_.empty()) {
+        char body[32];
+        std::snprintf(body, sizeof(body), "PAIR001,%03u,%u",
+                      pending_acks_.front().first, pending_acks_.front().second);
+        pending_acks_.pop_front();
+        emit(out, body, cr);
+        stats_.pair_acks++;
+    }
+}
+
+void NmeaGenerator::queue_pair_ack(uint16_t command_id, uint8_t result) {
+    pending_acks_.emplace_back(command_id, result);
+}
+
+double NmeaGenerator::generate_epoch(std::string& out) {
+    const double t = (double)epoch_ / (double)config_.rate_hz;
+    double cr = 0;
+    EpochKind kind = epoch_kind(epoch_, cr);
+    stats_.epochs++;
+
+    if (config_.pair_ack_every_epochs && (epoch_ + 1) % config_.pair_ack_every_epochs == 0) {
+        size_t idx = (size_t)((epoch_ + 1) / config_.pair_ack_every_epochs) % (sizeof(kAckCommands) / sizeof(kAckCommands[0]));
+        queue_pair_ack(kAckCommands[idx], 0);
+    }
+
+    epoch_++;
+    if (kind == EpochKind::Drop) {
+        stats_.dropped_epochs++;
+        return t;
+    }
+
+    const bool acquiring = t < acquire_until_s_;
+    const bool outage = kind == EpochKind::Outage || acquiring;
+    if (acquiring) {
+        stats_.acquiring_epochs++;
+    } else if (outage) {
+        stats_.outage_epochs++;
+    }
+
+    MotionState m = trajectory_.at(t);
+    update_sky(t, outage);
+    const bool valid = !outage && used_count_ >= 4;
+
+    char time_buf[16], date_buf[8];
+    format_utc(t, time_buf, sizeof(time_buf), date_buf, sizeof(date_buf));
+
+    if (config_.emit_rmc) append_rmc(out, m, time_buf, date_buf, valid, cr);
+    if (config_.emit_vtg) append_vtg(out, m, valid, cr);
+    if (config_.emit_gga) append_gga(out, m, time_buf, valid, cr);
+    if (config_.emit_gsa) append_gsa(out, valid, cr);
+    if (config_.emit_gsv) append_gsv(out, cr);
+    append_pair_acks(out, cr);
+    return t;
+}
+
+// =============================================================================
+// NmeaSource
+// =============================================================================
+
+size_t NmeaGenerator::available(uint64_t now_us) {
+    const uint64_t interval = epoch_interval_us();
+    while (next_epoch_us_ <= now_us) {
+        generate_epoch(output_);
+        next_epoch_us_ += interval;
+    }
+
+    // 模块内部缓冲有限，主机取得太慢时最旧的数据被覆盖
+    size_t pending = output_.size() - output_pos_;
+    if (pending > config_.output_buffer_limit) {
+        size_t drop = pending - config_.output_buffer_limit;
+        output_pos_ += drop;
+        stats_.overflow_bytes += drop;
+    }
+    if (output_pos_ > 0 && output_pos_ * 2 >= output_.size()) {
+        output_.erase(0, output_pos_);
+        output_pos_ = 0;
+    }
+    return output_.size() - output_pos_;
+}
+
+size_t NmeaGenerator::pull(uint8_t* dst, size_t max_len, uint64_t now_us) {
+    size_t n = std::min(available(now_us), max_len);
+    std::memcpy(dst, output_.data() + output_pos_, n);
+    output_pos_ += n;
+    return n;
+}
+
+void NmeaGenerator::start_acquisition(unsigned command_id, double t_s) {
+    if (command_id == config_.assist_pair_id && command_id != 0) {
+        stats_.assist_commands++;
+        // 冷启动后收到足够的星历，捕获时间缩短到辅助冷启动的TTFF
+        if (cold_start_s_ >= 0 && config_.assisted_ttff_s > 0 && ++assist_received_ == config_.assist_sentences) {
+            acquire_until_s_ = std::min(acquire_until_s_, cold_start_s_ + config_.assisted_ttff_s);
+        }
+        return;
+    }
+
+    double ttff = 0;
+    switch (command_id) {
+        case 4: ttff = config_.hot_ttff_s; break;
+        case 5: ttff = config_.warm_ttff_s; break;
+        case 6:
+        case 7: ttff = config_.cold_ttff_s; break;
+        default: return;
+    }
+    if (ttff <= 0) {
+        return;
+    }
+    acquire_until_s_ = t_s + ttff;
+    cold_start_s_ = command_id >= 6 ? t_s : -1;
+    assist_received_ = 0;
+}
+
+void NmeaGenerator::on_command(const uint8_t* data, size_t len, uint64_t now_us) {
+    command_rx_.append((const char*)data, len);
+
+    size_t eol;
+    while ((eol = command_rx_.find('\n')) != std::string::npos) {
+        std::string line = command_rx_.substr(0, eol + 1);
+        command_rx_.erase(0, eol + 1);
+
+        size_t start = line.find('$');
+        size_t star = line.find('*', start == std::string::npos ? 0 : start);
+        if (start == std::string::npos || star == std::string::npos || star + 2 >= line.size()) {
+            continue;
+        }
+        uint8_t cs = 0;
+        for (size_t i = start + 1; i < star; i++) {
+            cs ^= (uint8_t)line[i];
+        }
+        unsigned provided = 0;
+        if (std::sscanf(line.c_str() + star + 1, "%2x", &provided) != 1 || provided != cs) {
+            continue;   // 模块丢弃校验失败的命令
+        }
+        unsigned id = 0;
+        if (line.compare(start, 5, "$PAIR") == 0 && std::sscanf(line.c_str() + start + 5, "%3u", &id) == 1) {
+            start_acquisition(id, now_us / 1e6);
+            // 应答立即进入输出缓冲
+            queue_pair_ack((uint16_t)id, 0);
+            append_pair_acks(output_, 0.0);
+        }
+    }
+    // 防止无换行的垃圾数据无限增长
+    if (command_rx_.size() > 512) {
+        command_rx_.clear();
+    }
+}
+
+// =============================================================================
+// 参数解析
+// =============================================================================
+
+uint8_t parse_constellation_mask(const std::string& list) {
+    uint8_t mask = 0;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        bool found = false;
+        for (int s = 0; s < (int)Constellation::Count; s++) {
+            if (item == kSystems[s].talker) {
+                mask |= (uint8_t)(1u << s);
+                found = true;
+            }
+        }
+        if (!found) {
+            return 0;
+        }
+    }
+    return mask;
+}
+
+bool parse_burst_pattern(const std::string& spec, BurstPattern& burst) {
+    char mode[16] = "corrupt";
+    double rate = 0.5;
+    unsigned period = 0, length = 0, offset = 0;
+    int n = std::sscanf(spec.c_str(), "%u:%u:%15[a-z]:%lf:%u", &period, &length, mode, &rate, &offset);
+    if (n < 2 || period == 0 || length == 0) {
+        return false;
+    }
+    burst.period_epochs = period;
+    burst.length_epochs = length;
+    burst.offset_epochs = offset;
+    burst.corruption_rate = rate;
+    if (std::strcmp(mode, "corrupt") == 0) {
+        burst.mode = BurstPattern::Mode::Corrupt;
+    } else if (std::strcmp(mode, "outage") == 0) {
+        burst.mode = BurstPattern::Mode::Outage;
+    } else if (std::strcmp(mode, "drop") == 0) {
+        burst.mode = BurstPattern::Mode::Drop;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_start_time(const std::string& text, GeneratorConfig& config) {
+    unsigned year, month, day, hour, minute, second;
+    if (std::sscanf(text.c_str(), "%u-%u-%uT%u:%u:%u", &year, &month, &day, &hour, &minute, &second) != 6 ||
+        month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59) {
+        return false;
+    }
+    config.year = (uint16_t)year;
+    config.month = (uint8_t)month;
+    config.day = (uint8_t)day;
+    config.hour = (uint8_t)hour;
+    config.minute = (uint8_t)minute;
+    config.second = (uint8_t)second;
+    return true;
+}
+
+int64_t start_utc_seconds(const GeneratorConfig& config) {
+    return days_from_civil(config.year, config.month, config.day) * 86400 +
+           (int64_t)config.hour * 3600 + (int64_t)config.minute * 60 + config.second;
+}
+
+std::string make_assist_file(const AssistFileConfig& config) {
+    std::mt19937 rng(config.seed);
+    const uint32_t segment_s = config.segment_s ? config.segment_s : 6 * 3600;
+    int64_t seg_start = config.start_utc - config.start_utc % segment_s;
+
+    std::string out = "# 合成辅助数据，仅用于主机仿真\n";
+    char line[64];
+    for (uint32_t seg = 0; seg < config.segments; seg++, seg_start += segment_s) {
+        std::snprintf(line, sizeof(line), "#SEG,%lld,%lld\n",
+                      (long long)seg_start, (long long)(seg_start + segment_s));
+        out += line;
+
+        for (uint32_t prn = 1; prn <= config.satellites; prn++) {
+            // 每颗卫星72字节星历
+            std::snprintf(line, sizeof(line), "PAIR%03u,%u,%u,", (unsigned)config.pair_id, seg, prn);
+            std::string body = line;
+            for (int i = 0; i < 72; i++) {
+                std::snprintf(line, sizeof(line), "%02X", (unsigned)(rng() & 0xFF));
+                body += line;
+            }
+            std::string sentence = NmeaGenerator::make_sentence(body);
+            sentence.erase(sentence.size() - 2);    // 文件中每行以\n结尾
+            out += sentence;
+            out += '\n';
+        }
+    }
+    return out;
+}
+
+std::string make_geofence_file(const GeofenceFileConfig& config, const Trajectory& trajectory) {
+    std::mt19937 rng(config.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const std::vector<Waypoint>& waypoints = trajectory.waypoints();
+    const uint32_t vertices = std::max<uint32_t>(3, std::min<uint32_t>(config.vertices, GPS_GEOFENCE_MAX_FENCE_VERTICES));
+
+    double center_lat = 0, center_lon = 0;
+    for (const Waypoint& w : waypoints) {
+        center_lat += w.lat / waypoints.size();
+        center_lon += w.lon / waypoints.size();
+    }
+    const double m_per_deg_lat = 111320.0;
+    const double m_per_deg_lon = m_per_deg_lat * std::cos(center_lat * M_PI / 180.0);
+
+    auto append = [](std::string& out, const void* data, size_t len) {
+        out.append(static_cast<const char*>(data), len);
+    };
+
+    gps_geofence_file_header_t header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = GPS_GEOFENCE_MAGIC;
+    header.version = GPS_GEOFENCE_VERSION;
+    header.fence_count = (uint16_t)config.count;
+    header.vertex_count = config.count * vertices;
+
+    std::string out;
+    append(out, &header, sizeof(header));
+    for (uint32_t n = 0; n < config.count; n++) {
+        // 前route_fences个围栏以航点为中心，其余在中心周围随机分布
+        double lat, lon;
+        if (n < config.route_fences && !waypoints.empty()) {
+            lat = waypoints[n % waypoints.size()].lat;
+            lon = waypoints[n % waypoints.size()].lon;
+        } else {
+            double r = config.spread_m * std::sqrt(unit(rng));
+            double a = 2 * M_PI * unit(rng);
+            lat = center_lat + r * std::cos(a) / m_per_deg_lat;
+            lon = center_lon + r * std::sin(a) / m_per_deg_lon;
+        }
+
+        gps_geofence_file_fence_t fence;
+        std::memset(&fence, 0, sizeof(fence));
+        fence.id = 1000 + n;
+        fence.vertex_count = (uint16_t)vertices;
+        fence.margin_m = config.margin_m;
+        std::snprintf(fence.name, sizeof(fence.name), n < config.route_fences ? "ROUTE-%u" : "SITE-%u", n);
+        append(out, &fence, sizeof(fence));
+
+        // 半径随机起伏的星形多边形（简单多边形，可为凹）
+        for (uint32_t k = 0; k < vertices; k++) {
+            double a = 2 * M_PI * k / vertices;
+            double r = config.radius_m * (0.6 + 0.8 * unit(rng));
+            int32_t v[2] = {
+                (int32_t)std::lround((lat + r * std::cos(a) / m_per_deg_lat) * 1e7),
+                (int32_t)std::lround((lon + r * std::sin(a) / m_per_deg_lon) * 1e7),
+            };
+            append(out, v, sizeof(v));
+        }
+    }
+    return out;
+}
+
+} // namespace sim
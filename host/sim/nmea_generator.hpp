@@ -0,0 +1,352 @@
+/**
+ * @file nmea_generator.hpp
+ * @brief 合成NMEA数据流生成器
+ *
+ * 沿脚本化轨迹生成带正确校验和的NMEA语句，用于负载和压力测试：
+ * - RMC / VTG / GGA / GSA / GSV，GSA和GSV覆盖 GP/GL/GA/GB/GQ 五个星座
+ * - $PAIR001 命令应答（响应写入的$PAIRxxx命令，或按固定周期插入）
+ * - 可配置输出频率、卫星数量、随机损坏率和突发模式（损坏/失锁/丢包）
+ *
+ * 两种用法：
+ * - 文件写入：generate_epoch() 逐历元取出文本（见 host/tools/nmea_gen.cpp）
+ * - 设备模型数据源：实现 NmeaSource，按时间拉取字节并接收命令
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+// =============================================================================
+// 数据源接口（供LC76G I2C寄存器模型使用）
+// =============================================================================
+
+/**
+ * @brief 模块输出数据源
+ */
+class NmeaSource {
+public:
+    virtual ~NmeaSource() = default;
+
+    /**
+     * @brief 推进到now_us，返回此刻模块已产生但尚未取走的字节数
+     */
+    virtual size_t available(uint64_t now_us) = 0;
+
+    /**
+     * @brief 取走最多max_len字节
+     * @return 实际取出的字节数
+     */
+    virtual size_t pull(uint8_t* dst, size_t max_len, uint64_t now_us) = 0;
+
+    /**
+     * @brief 模块收到主机写入的命令数据
+     */
+    virtual void on_command(const uint8_t* data, size_t len, uint64_t now_us) = 0;
+};
+
+// =============================================================================
+// 轨迹
+// =============================================================================
+
+/**
+ * @brief 轨迹航点
+ */
+struct Waypoint {
+    double lat = 0;         // 纬度 (度, WGS84)
+    double lon = 0;         // 经度 (度, WGS84)
+    double alt_m = 0;       // 海拔 (米)
+    double speed_kmh = 0;   // 驶向下一航点的速度
+    double hold_s = 0;      // 到达后停留时间
+};
+
+/**
+ * @brief 某一时刻的运动状态
+ */
+struct MotionState {
+    double lat = 0;
+    double lon = 0;
+    double alt_m = 0;
+    double speed_kmh = 0;
+    double course_deg = 0;
+};
+
+/**
+ * @brief 循环脚本轨迹（航点间直线匀速，到达后停留）
+ */
+class Trajectory {
+public:
+    Trajectory();
+    explicit Trajectory(std::vector<Waypoint> waypoints);
+
+    /**
+     * @brief 从文本文件加载航点，每行 "lat,lon,alt_m,speed_kmh,hold_s"，#开头为注释
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief 默认轨迹：上海市区一个闭合环线，含停车段
+     */
+    static Trajectory default_route();
+
+    MotionState at(double t_s) const;
+    double loop_duration_s() const { return loop_s_; }
+    const std::vector<Waypoint>& waypoints() const { return waypoints_; }
+
+private:
+    struct Leg {
+        double start_s;
+        double move_s;
+        double hold_s;
+        double course_deg;
+    };
+
+    void build_legs();
+
+    std::vector<Waypoint> waypoints_;
+    std::vector<Leg> legs_;
+    double loop_s_ = 0;
+};
+
+// =============================================================================
+// 生成器
+// =============================================================================
+
+/**
+ * @brief 星座
+ */
+enum class Constellation : uint8_t {
+    GPS = 0,    // GP
+    GLONASS,    // GL
+    Galileo,    // GA
+    BeiDou,     // GB
+    QZSS,       // GQ
+    Count
+};
+
+/**
+ * @brief 突发模式：每period_epochs个历元中，连续length_epochs个历元进入突发状态
+ */
+struct BurstPattern {
+    enum class Mode : uint8_t {
+        Corrupt,    // 以corruption_rate损坏语句
+        Outage,     // 失锁：RMC为V、GGA质量为0、不使用卫星
+        Drop        // 整个历元不输出
+    };
+    uint32_t period_epochs = 0;     // 0表示禁用
+    uint32_t length_epochs = 0;
+    uint32_t offset_epochs = 0;
+    Mode mode = Mode::Corrupt;
+    double corruption_rate = 0.5;
+};
+
+/**
+ * @brief 生成器配置
+ */
+struct GeneratorConfig {
+    uint32_t rate_hz = 1;                   // 输出频率 (1-10Hz)
+    uint32_t satellites = 24;               // 可见卫星总数，按启用的星座轮流分配
+    uint8_t constellation_mask = 0x1F;      // bit0..4 = GP/GL/GA/GB/GQ
+    double corruption_rate = 0.0;           // 每条语句被损坏的概率
+    std::vector<BurstPattern> bursts;
+    uint32_t seed = 1;
+
+    // 起始UTC时间
+    uint16_t year = 2025;
+    uint8_t month = 1;
+    uint8_t day = 1;
+    uint8_t hour = 0;
+    uint8_t minute = 0;
+    uint8_t second = 0;
+
+    // 语句开关
+    bool emit_rmc = true;
+    bool emit_vtg = true;
+    bool emit_gga = true;
+    bool emit_gsa = true;
+    bool emit_gsv = true;
+
+    uint32_t pair_ack_every_epochs = 0;     // 文件模式下周期性插入PAIR001应答，0表示禁用
+    size_t output_buffer_limit = 4096;      // 设备模型中未取走数据的上限，超出时丢弃最旧数据
+
+    // 捕获模型：收到$PAIR004/005/006/007后失锁，经过对应TTFF后恢复定位 (0表示不模拟)
+    double hot_ttff_s = 0;
+    double warm_ttff_s = 0;
+    double cold_ttff_s = 0;
+    double assisted_ttff_s = 0;             // 冷启动后收到assist_sentences条辅助命令时的TTFF
+    uint16_t assist_pair_id = 0;            // 视为辅助数据的$PAIR命令号，0表示禁用
+    uint32_t assist_sentences = 32;
+};
+
+/**
+ * @brief 生成统计
+ */
+struct GeneratorStats {
+    uint64_t epochs = 0;
+    uint64_t sentences = 0;
+    uint64_t corrupted = 0;
+    uint64_t dropped_epochs = 0;
+    uint64_t outage_epochs = 0;
+    uint64_t pair_acks = 0;
+    uint64_t acquiring_epochs = 0;          // 启动命令后尚未定位的历元
+    uint64_t assist_commands = 0;           // 收到的辅助数据命令
+    uint64_t bytes = 0;
+    uint64_t overflow_bytes = 0;            // 设备模型缓冲溢出丢弃的字节
+};
+
+/**
+ * @brief 合成NMEA生成器
+ */
+class NmeaGenerator : public NmeaSource {
+public:
+    explicit NmeaGenerator(const GeneratorConfig& config, Trajectory trajectory = Trajectory::default_route());
+
+    /**
+     * @brief 生成下一个历元的全部语句
+     * @param out 追加输出
+     * @return 该历元的UTC偏移（秒，自起始时刻）
+     */
+    double generate_epoch(std::string& out);
+
+    /**
+     * @brief 排队一条$PAIR001应答，下次输出时发出
+     */
+    void queue_pair_ack(uint16_t command_id, uint8_t result);
+
+    /**
+     * @brief 为NMEA正文计算校验和并组成完整语句（$...*HH\r\n）
+     */
+    static std::string make_sentence(const std::string& body);
+
+    /**
+     * @brief 历元间隔（微秒）
+     */
+    uint64_t epoch_interval_us() const;
+
+    const GeneratorStats& stats() const { return stats_; }
+    const GeneratorConfig& config() const { return config_; }
+    const Trajectory& trajectory() const { return trajectory_; }
+
+    // NmeaSource
+    size_t available(uint64_t now_us) override;
+    size_t pull(uint8_t* dst, size_t max_len, uint64_t now_us) override;
+    void on_command(const uint8_t* data, size_t len, uint64_t now_us) override;
+
+private:
+    struct Satellite {
+        Constellation system;
+        uint16_t prn;
+        double phase;
+        double az0;
+        double elevation;
+        double azimuth;
+        int snr;
+        bool used;
+    };
+
+    enum class EpochKind { Normal, Corrupt, Outage, Drop };
+
+    void build_sky();
+    void update_sky(double t_s, bool outage);
+    EpochKind epoch_kind(uint64_t epoch, double& corruption_rate) const;
+    void emit(std::string& out, const std::string& body, double corruption_rate);
+    void corrupt(std::string& sentence);
+    void format_utc(double t_s, char* time_buf, size_t time_len, char* date_buf, size_t date_len) const;
+
+    void append_rmc(std::string& out, const MotionState& m, const char* time, const char* date, bool valid, double cr);
+    void append_vtg(std::string& out, const MotionState& m, bool valid, double cr);
+    void append_gga(std::string& out, const MotionState& m, const char* time, bool valid, double cr);
+    void append_gsa(std::string& out, bool valid, double cr);
+    void append_gsv(std::string& out, double cr);
+    void append_pair_acks(std::string& out, double cr);
+    void start_acquisition(unsigned command_id, double t_s);
+
+    GeneratorConfig config_;
+    Trajectory trajectory_;
+    std::mt19937 rng_;
+    std::vector<Satellite> sky_;
+    std::deque<std::pair<uint16_t, uint8_t>> pending_acks_;
+    GeneratorStats stats_;
+    uint64_t epoch_ = 0;
+    int64_t start_epoch_days_ = 0;
+    uint32_t start_second_of_day_ = 0;
+    double hdop_ = 0;
+    double vdop_ = 0;
+    double pdop_ = 0;
+    int used_count_ = 0;
+
+    // 捕获模型状态
+    double acquire_until_s_ = 0;
+    double cold_start_s_ = -1;              // 最近一次冷启动时刻，-1表示不在冷启动中
+    uint32_t assist_received_ = 0;
+
+    // 设备模型输出缓冲
+    std::string output_;
+    size_t output_pos_ = 0;
+    uint64_t next_epoch_us_ = 0;
+    std::string command_rx_;
+};
+
+/**
+ * @brief 解析星座列表，如 "GP,GL,GA,GB,GQ"
+ * @return 星座掩码，格式错误返回0
+ */
+uint8_t parse_constellation_mask(const std::string& list);
+
+/**
+ * @brief 解析突发模式，格式 "period:length[:mode[:rate[:offset]]]"，mode为corrupt/outage/drop
+ */
+bool parse_burst_pattern(const std::string& spec, BurstPattern& burst);
+
+/**
+ * @brief 解析起始UTC时间，格式 "YYYY-MM-DDThh:mm:ss"
+ */
+bool parse_start_time(const std::string& text, GeneratorConfig& config);
+
+/**
+ * @brief 配置中起始时刻的UTC秒（1970-01-01起）
+ */
+int64_t start_utc_seconds(const GeneratorConfig& config);
+
+/**
+ * @brief 辅助数据文件参数
+ */
+struct AssistFileConfig {
+    int64_t start_utc = 0;                  // 第一段起始UTC，向下取整到段长
+    uint32_t segments = 4;
+    uint32_t segment_s = 6 * 3600;          // 每段有效期 (EPO为6小时)
+    uint32_t satellites = 32;               // 每段的卫星条数
+    uint16_t pair_id = 470;                 // 辅助命令号（合成，非厂商定义）
+    uint32_t seed = 1;
+};
+
+/**
+ * @brief 生成gps_assist格式的合成辅助数据文件内容（#SEG段 + $PAIR命令）
+ */
+std::string make_assist_file(const AssistFileConfig& config);
+
+/**
+ * @brief 地理围栏文件参数
+ */
+struct GeofenceFileConfig {
+    uint32_t count = 300;                   // 围栏总数
+    uint32_t route_fences = 6;              // 其中沿轨迹航点放置的围栏数（保证有进出事件）
+    uint32_t vertices = 12;                 // 每个围栏的顶点数
+    double radius_m = 150;                  // 围栏平均半径
+    double spread_m = 15000;                // 其余围栏在轨迹中心周围的分布半径
+    uint16_t margin_m = 10;                 // 迟滞距离
+    uint32_t seed = 1;
+};
+
+/**
+ * @brief 生成gps_geofence格式的合成围栏文件内容（二进制）
+ */
+std::string make_geofence_file(const GeofenceFileConfig& config, const Trajectory& trajectory);
+
+} // namespace sim
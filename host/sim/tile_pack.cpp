@@ -0,0 +1,269 @@
+/**
+ * @file tile_pack.cpp
+ * @brief 离线底图瓦片包生成实现
+ */
+
+#include "tile_pack.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#include "ili9488_tile_map.hpp"
+
+namespace sim {
+
+namespace {
+
+constexpr double kMetersPerDegLat = 111320.0;
+
+uint32_t to_rgb666(uint32_t rgb) {
+    return rgb & 0xFCFCFCu;
+}
+
+/**
+ * @brief 6×6×6色立方量化（每分量0,51,...,255）
+ */
+uint32_t to_cube(uint32_t rgb) {
+    uint32_t out = 0;
+    for (int shift = 16; shift >= 0; shift -= 8) {
+        uint32_t c = (rgb >> shift) & 0xFF;
+        uint32_t level = (c * 5 + 127) / 255;
+        out |= to_rgb666(level * 51) << shift;
+    }
+    return out;
+}
+
+void append(std::string& out, const void* data, size_t len) {
+    out.append(static_cast<const char*>(data), len);
+}
+
+/**
+ * @brief 编码一个瓦片（调色板+游程）
+ */
+std::string encode_tile(const std::vector<uint32_t>& pixels, bool* quantized) {
+    std::vector<uint32_t> colors;
+    std::unordered_map<uint32_t, uint8_t> lookup;
+    std::vector<uint8_t> indices(pixels.size());
+
+    *quantized = false;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        colors.clear();
+        lookup.clear();
+        bool overflow = false;
+        for (size_t i = 0; i < pixels.size() && !overflow; i++) {
+            uint32_t c = *quantized ? to_cube(pixels[i]) : to_rgb666(pixels[i]);
+            auto it = lookup.find(c);
+            if (it == lookup.end()) {
+                if (colors.size() == 256) {
+                    overflow = true;
+                    break;
+                }
+                it = lookup.emplace(c, (uint8_t)colors.size()).first;
+                colors.push_back(c);
+            }
+            indices[i] = it->second;
+        }
+        if (!overflow) {
+            break;
+        }
+        *quantized = true;
+    }
+
+    std::string blob;
+    blob.push_back((char)(colors.size() - 1));
+    for (uint32_t c : colors) {
+        blob.push_back((char)((c >> 16) & 0xFF));
+        blob.push_back((char)((c >> 8) & 0xFF));
+        blob.push_back((char)(c & 0xFF));
+    }
+    for (size_t i = 0; i < indices.size();) {
+        size_t run = 1;
+        while (i + run < indices.size() && run < 256 && indices[i + run] == indices[i]) {
+            run++;
+        }
+        blob.push_back((char)(run - 1));
+        blob.push_back((char)indices[i]);
+        i += run;
+    }
+    return blob;
+}
+
+} // namespace
+
+std::string make_tile_pack(const TilePackConfig& config, const TileSampler& sampler, TilePackStats* stats) {
+    TilePackStats local;
+    TilePackStats& st = stats ? *stats : local;
+    st = TilePackStats();
+
+    const uint32_t size = config.tile_size;
+    const uint32_t level_count = std::min<uint32_t>((uint32_t)config.levels_dm.size(), ili9488::TILE_PACK_MAX_LEVELS);
+
+    ili9488::TilePackHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = ili9488::TILE_PACK_MAGIC;
+    header.version = ili9488::TILE_PACK_VERSION;
+    header.tile_size = (uint16_t)size;
+    header.origin_lat_e7 = (int32_t)std::lround(config.origin_lat * 1e7);
+    header.origin_lon_e7 = (int32_t)std::lround(config.origin_lon * 1e7);
+    header.level_count = (uint16_t)level_count;
+
+    // 级别表和索引紧跟文件头，瓦片数据从对齐位置开始
+    std::vector<ili9488::TilePackLevel> levels(level_count);
+    uint32_t offset = sizeof(header) + level_count * sizeof(ili9488::TilePackLevel);
+    for (uint32_t l = 0; l < level_count; l++) {
+        double m_per_px = config.levels_dm[l] / 10.0;
+        std::memset(&levels[l], 0, sizeof(levels[l]));
+        levels[l].dm_per_pixel = config.levels_dm[l];
+        levels[l].cols = (uint16_t)std::min(4095.0, std::ceil(config.width_m / m_per_px / size));
+        levels[l].rows = (uint16_t)std::min(4095.0, std::ceil(config.height_m / m_per_px / size));
+        levels[l].index_offset = offset;
+        offset += (uint32_t)levels[l].cols * levels[l].rows * sizeof(ili9488::TilePackTile);
+    }
+
+    std::string data;
+    // 不超过一个扇区的瓦片不跨扇区边界，更大的瓦片从扇区边界开始
+    auto align = [&data](size_t base, size_t length) {
+        size_t pos = base + data.size();
+        size_t used = pos % ili9488::TILE_PACK_ALIGN;
+        if (used != 0 && (length > ili9488::TILE_PACK_ALIGN || used + length > ili9488::TILE_PACK_ALIGN)) {
+            data.append(ili9488::TILE_PACK_ALIGN - used, '\0');
+        }
+    };
+    const size_t data_base = offset;
+
+    std::vector<std::vector<ili9488::TilePackTile>> indices(level_count);
+    std::vector<uint32_t> pixels(size * size);
+    for (uint32_t l = 0; l < level_count; l++) {
+        const double m_per_px = config.levels_dm[l] / 10.0;
+        indices[l].resize((size_t)levels[l].cols * levels[l].rows);
+        for (uint32_t r = 0; r < levels[l].rows; r++) {
+            for (uint32_t c = 0; c < levels[l].cols; c++) {
+                bool any = false;
+                for (uint32_t y = 0; y < size; y++) {
+                    for (uint32_t x = 0; x < size; x++) {
+                        double east = ((double)c * size + x + 0.5) * m_per_px;
+                        double south = ((double)r * size + y + 0.5) * m_per_px;
+                        uint32_t rgb = sampler(east, south);
+                        any = any || rgb != kTileNoData;
+                        pixels[y * size + x] = rgb == kTileNoData ? 0 : rgb;
+                    }
+                }
+
+                ili9488::TilePackTile& tile = indices[l][(size_t)r * levels[l].cols + c];
+                tile.offset = 0;
+                tile.length = 0;
+                st.tiles++;
+                if (!any) {
+                    st.empty_tiles++;
+                    continue;
+                }
+
+                bool quantized = false;
+                std::string blob = encode_tile(pixels, &quantized);
+                align(data_base, blob.size());
+                tile.offset = (uint32_t)(data_base + data.size());
+                tile.length = (uint32_t)blob.size();
+                data += blob;
+
+                st.quantized_tiles += quantized ? 1 : 0;
+                st.encoded_bytes += blob.size();
+                st.raw_bytes += (uint64_t)size * size * 3;
+                st.max_tile_bytes = std::max<uint32_t>(st.max_tile_bytes, (uint32_t)blob.size());
+            }
+        }
+    }
+
+    std::string out;
+    append(out, &header, sizeof(header));
+    append(out, levels.data(), levels.size() * sizeof(ili9488::TilePackLevel));
+    for (const auto& index : indices) {
+        append(out, index.data(), index.size() * sizeof(ili9488::TilePackTile));
+    }
+    out += data;
+    return out;
+}
+
+uint32_t synthetic_basemap_color(double east_m, double south_m) {
+    // 河流：沿东西向蜿蜒，宽60m
+    double river = 1500.0 + 300.0 * std::sin(east_m / 700.0);
+    if (std::fabs(south_m - river) < 30.0) {
+        return 0xAAD3DF;
+    }
+
+    // 主干道每1000m一条（宽20m），支路每200m一条（宽10m，带2m路缘）
+    double me = std::fmod(east_m, 1000.0);
+    double ms = std::fmod(south_m, 1000.0);
+    if (me < 10.0 || me > 990.0 || ms < 10.0 || ms > 990.0) {
+        return 0xF7C873;
+    }
+    double se = std::fmod(east_m, 200.0);
+    double ss = std::fmod(south_m, 200.0);
+    if (se < 5.0 || se > 195.0 || ss < 5.0 || ss > 195.0) {
+        return 0xFFFFFF;
+    }
+    if (se < 7.0 || se > 193.0 || ss < 7.0 || ss > 193.0) {
+        return 0xC8C4BC;
+    }
+
+    // 部分街区为绿地
+    uint32_t bx = (uint32_t)(int32_t)std::floor(east_m / 200.0);
+    uint32_t by = (uint32_t)(int32_t)std::floor(south_m / 200.0);
+    uint32_t h = (bx * 73856093u) ^ (by * 19349663u);
+    if (h % 7 == 0) {
+        return 0xC8E6B0;
+    }
+    return 0xF2EFE9;
+}
+
+void fit_tile_pack_to_route(TilePackConfig& config, const Trajectory& trajectory, double margin_m) {
+    const std::vector<Waypoint>& waypoints = trajectory.waypoints();
+    if (waypoints.empty()) {
+        return;
+    }
+    double lat_min = waypoints[0].lat, lat_max = waypoints[0].lat;
+    double lon_min = waypoints[0].lon, lon_max = waypoints[0].lon;
+    for (const Waypoint& w : waypoints) {
+        lat_min = std::min(lat_min, w.lat);
+        lat_max = std::max(lat_max, w.lat);
+        lon_min = std::min(lon_min, w.lon);
+        lon_max = std::max(lon_max, w.lon);
+    }
+    const double m_per_deg_lon = kMetersPerDegLat * std::cos(lat_max * M_PI / 180.0);
+    config.origin_lat = lat_max + margin_m / kMetersPerDegLat;
+    config.origin_lon = lon_min - margin_m / m_per_deg_lon;
+    config.width_m = (lon_max - lon_min) * m_per_deg_lon + 2 * margin_m;
+    config.height_m = (lat_max - lat_min) * kMetersPerDegLat + 2 * margin_m;
+}
+
+bool load_ppm(const std::string& path, RasterImage& image) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        printf("无法打开图像: %s\n", path.c_str());
+        return false;
+    }
+    unsigned w = 0, h = 0, maxval = 0;
+    char magic[3] = {0};
+    bool ok = std::fscanf(f, "%2s %u %u %u", magic, &w, &h, &maxval) == 4 &&
+              std::strcmp(magic, "P6") == 0 && maxval == 255 && w > 0 && h > 0;
+    if (ok) {
+        std::fgetc(f);      // 头部后的单个空白
+        std::vector<uint8_t> rgb((size_t)w * h * 3);
+        ok = std::fread(rgb.data(), 1, rgb.size(), f) == rgb.size();
+        image.width = w;
+        image.height = h;
+        image.pixels.resize((size_t)w * h);
+        for (size_t i = 0; ok && i < image.pixels.size(); i++) {
+            image.pixels[i] = ((uint32_t)rgb[i * 3] << 16) | ((uint32_t)rgb[i * 3 + 1] << 8) | rgb[i * 3 + 2];
+        }
+    }
+    std::fclose(f);
+    if (!ok) {
+        printf("只支持8位二进制PPM(P6): %s\n", path.c_str());
+    }
+    return ok;
+}
+
+} // namespace sim
@@ -0,0 +1,78 @@
+/**
+ * @file tile_pack.hpp
+ * @brief 离线底图瓦片包生成（ili9488::TileMap格式）
+ *
+ * 按输出像素中心对源栅格最近邻采样，每个瓦片转为RGB666后建立调色板
+ * （超过256色时量化到6×6×6色立方），再做按行扫描的游程编码。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "nmea_generator.hpp"
+
+namespace sim {
+
+/**
+ * @brief 采样函数：输入相对原点的东向/南向距离（米），返回RGB888；
+ *        返回kTileNoData表示该处无数据
+ */
+using TileSampler = std::function<uint32_t(double east_m, double south_m)>;
+
+constexpr uint32_t kTileNoData = 0xFFFFFFFFu;
+
+/**
+ * @brief 瓦片包参数
+ */
+struct TilePackConfig {
+    double origin_lat = 0;                  // 覆盖范围西北角
+    double origin_lon = 0;
+    double width_m = 4000;                  // 向东覆盖范围
+    double height_m = 4000;                 // 向南覆盖范围
+    uint16_t tile_size = 64;
+    std::vector<uint32_t> levels_dm = {10, 20, 50, 100, 200, 500};  // 比例尺 (分米/像素)
+};
+
+/**
+ * @brief 生成统计
+ */
+struct TilePackStats {
+    uint32_t tiles = 0;
+    uint32_t empty_tiles = 0;
+    uint32_t quantized_tiles = 0;           // 超过256色而量化的瓦片
+    uint64_t encoded_bytes = 0;             // 瓦片数据（不含对齐填充）
+    uint64_t raw_bytes = 0;                 // 同样像素按RGB666存储的字节数
+    uint32_t max_tile_bytes = 0;
+};
+
+/**
+ * @brief 生成瓦片包文件内容
+ */
+std::string make_tile_pack(const TilePackConfig& config, const TileSampler& sampler, TilePackStats* stats);
+
+/**
+ * @brief 合成底图：街道网格、河流和绿地，用于无真实地图时测试
+ */
+uint32_t synthetic_basemap_color(double east_m, double south_m);
+
+/**
+ * @brief 按轨迹航点外包矩形（外扩margin_m）设置覆盖范围
+ */
+void fit_tile_pack_to_route(TilePackConfig& config, const Trajectory& trajectory, double margin_m);
+
+/**
+ * @brief 二进制PPM(P6)图像
+ */
+struct RasterImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint32_t> pixels;           // RGB888，按行
+};
+
+bool load_ppm(const std::string& path, RasterImage& image);
+
+} // namespace sim
@@ -0,0 +1,77 @@
+/**
+ * @file host_flash.c
+ * @brief hardware/flash shim的主机实现
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "host_fakes.h"
+
+static uint8_t g_flash[PICO_FLASH_SIZE_BYTES];
+static bool g_flash_ready = false;
+static uint32_t g_erase_count = 0;
+static uint32_t g_program_count = 0;
+
+static void flash_ensure_ready(void) {
+    if (!g_flash_ready) {
+        memset(g_flash, 0xFF, sizeof(g_flash));
+        g_flash_ready = true;
+    }
+}
+
+const uint8_t *host_flash_base(void) {
+    flash_ensure_ready();
+    return g_flash;
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    assert(flash_offs % FLASH_SECTOR_SIZE == 0 && count % FLASH_SECTOR_SIZE == 0);
+    assert(flash_offs + count <= sizeof(g_flash));
+    flash_ensure_ready();
+    memset(&g_flash[flash_offs], 0xFF, count);
+    g_erase_count += (uint32_t)(count / FLASH_SECTOR_SIZE);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    assert(flash_offs % FLASH_PAGE_SIZE == 0 && count % FLASH_PAGE_SIZE == 0);
+    assert(flash_offs + count <= sizeof(g_flash));
+    flash_ensure_ready();
+    // NOR Flash编程只能清除位
+    for (size_t i = 0; i < count; i++) {
+        g_flash[flash_offs + i] &= data[i];
+    }
+    g_program_count += (uint32_t)(count / FLASH_PAGE_SIZE);
+}
+
+bool host_flash_load(const char *path) {
+    flash_ensure_ready();
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    memset(g_flash, 0xFF, sizeof(g_flash));
+    size_t n = fread(g_flash, 1, sizeof(g_flash), f);
+    fclose(f);
+    return n > 0;
+}
+
+bool host_flash_save(const char *path) {
+    flash_ensure_ready();
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    size_t n = fwrite(g_flash, 1, sizeof(g_flash), f);
+    fclose(f);
+    return n == sizeof(g_flash);
+}
+
+uint32_t host_flash_erase_count(void) {
+    return g_erase_count;
+}
+
+uint32_t host_flash_program_count(void) {
+    return g_program_count;
+}
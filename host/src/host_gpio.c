@@ -0,0 +1,63 @@
+/**
+ * @file host_gpio.c
+ * @brief hardware/gpio shim的主机实现
+ */
+
+#include "hardware/gpio.h"
+#include "host_fakes.h"
+
+static const host_gpio_fake_t *g_gpio_fake = NULL;
+
+// 默认实现：记录输出电平，输入读回上次写入值（上拉时为高）
+static bool g_gpio_level[NUM_BANK0_GPIOS];
+
+void host_gpio_set_fake(const host_gpio_fake_t *fake) {
+    g_gpio_fake = fake;
+}
+
+void gpio_init(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS) {
+        g_gpio_level[gpio] = false;
+    }
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio; (void)fn;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    (void)gpio; (void)out;
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (g_gpio_fake && g_gpio_fake->put) {
+        g_gpio_fake->put(g_gpio_fake->ctx, gpio, value);
+        return;
+    }
+    if (gpio < NUM_BANK0_GPIOS) {
+        g_gpio_level[gpio] = value;
+    }
+}
+
+bool gpio_get(uint gpio) {
+    if (g_gpio_fake && g_gpio_fake->get) {
+        return g_gpio_fake->get(g_gpio_fake->ctx, gpio);
+    }
+    return gpio < NUM_BANK0_GPIOS ? g_gpio_level[gpio] : false;
+}
+
+void gpio_pull_up(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS) {
+        g_gpio_level[gpio] = true;
+    }
+}
+
+void gpio_pull_down(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS) {
+        g_gpio_level[gpio] = false;
+    }
+}
+
+void gpio_disable_pulls(uint gpio) {
+    (void)gpio;
+}
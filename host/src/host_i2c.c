@@ -0,0 +1,56 @@
+/**
+ * @file host_i2c.c
+ * @brief hardware/i2c shim的主机实现
+ */
+
+#include "hardware/i2c.h"
+#include "host_fakes.h"
+
+i2c_inst_t host_i2c0_inst = {0, 0};
+i2c_inst_t host_i2c1_inst = {1, 0};
+
+static const host_i2c_fake_t *g_i2c_fake = NULL;
+
+void host_i2c_set_fake(const host_i2c_fake_t *fake) {
+    g_i2c_fake = fake;
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    if (g_i2c_fake && g_i2c_fake->set_baudrate) {
+        g_i2c_fake->set_baudrate(g_i2c_fake->ctx, i2c->index, baudrate);
+    }
+    return baudrate;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+void i2c_deinit(i2c_inst_t *i2c) {
+    i2c->baudrate = 0;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    if (!g_i2c_fake || !g_i2c_fake->write) {
+        return PICO_ERROR_GENERIC;
+    }
+    return g_i2c_fake->write(g_i2c_fake->ctx, i2c->index, addr, src, len, nostop);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    if (!g_i2c_fake || !g_i2c_fake->read) {
+        return PICO_ERROR_GENERIC;
+    }
+    return g_i2c_fake->read(g_i2c_fake->ctx, i2c->index, addr, dst, len, nostop);
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us) {
+    (void)timeout_us;
+    return i2c_write_blocking(i2c, addr, src, len, nostop);
+}
+
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us) {
+    (void)timeout_us;
+    return i2c_read_blocking(i2c, addr, dst, len, nostop);
+}
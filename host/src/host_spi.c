@@ -0,0 +1,65 @@
+/**
+ * @file host_spi.c
+ * @brief hardware/spi shim的主机实现
+ */
+
+#include <string.h>
+#include "hardware/spi.h"
+#include "host_fakes.h"
+
+spi_inst_t host_spi0_inst = {0, 0};
+spi_inst_t host_spi1_inst = {1, 0};
+
+static const host_spi_fake_t *g_spi_fake = NULL;
+
+void host_spi_set_fake(const host_spi_fake_t *fake) {
+    g_spi_fake = fake;
+}
+
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate) {
+    spi->baudrate = baudrate;
+    if (g_spi_fake && g_spi_fake->set_baudrate) {
+        g_spi_fake->set_baudrate(g_spi_fake->ctx, spi->index, baudrate);
+    }
+    return baudrate;
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    return spi_set_baudrate(spi, baudrate);
+}
+
+void spi_deinit(spi_inst_t *spi) {
+    spi->baudrate = 0;
+}
+
+uint spi_get_baudrate(const spi_inst_t *spi) {
+    return spi->baudrate;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    (void)spi; (void)data_bits; (void)cpol; (void)cpha; (void)order;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    if (!g_spi_fake) {
+        return (int)len;
+    }
+    return g_spi_fake->transfer(g_spi_fake->ctx, spi->index, src, NULL, len);
+}
+
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len) {
+    (void)repeated_tx_data;
+    if (!g_spi_fake) {
+        memset(dst, 0xFF, len);
+        return (int)len;
+    }
+    return g_spi_fake->transfer(g_spi_fake->ctx, spi->index, NULL, dst, len);
+}
+
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len) {
+    if (!g_spi_fake) {
+        memset(dst, 0xFF, len);
+        return (int)len;
+    }
+    return g_spi_fake->transfer(g_spi_fake->ctx, spi->index, src, dst, len);
+}
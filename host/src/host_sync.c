@@ -0,0 +1,44 @@
+/**
+ * @file host_sync.c
+ * @brief pico/mutex shim的主机实现
+ */
+
+#include "pico/mutex.h"
+#include "host_fakes.h"
+
+static const host_sync_fake_t *g_sync_fake = NULL;
+
+void host_sync_set_fake(const host_sync_fake_t *fake) {
+    g_sync_fake = fake;
+}
+
+void mutex_init(mutex_t *mtx) {
+    mtx->owned = false;
+    mtx->enter_count = 0;
+}
+
+void mutex_enter_blocking(mutex_t *mtx) {
+    if (g_sync_fake && g_sync_fake->enter) {
+        g_sync_fake->enter(g_sync_fake->ctx, mtx);
+    }
+    mtx->owned = true;
+    mtx->enter_count++;
+}
+
+bool mutex_try_enter(mutex_t *mtx, uint32_t *owner_out) {
+    if (mtx->owned) {
+        if (owner_out) {
+            *owner_out = 0;
+        }
+        return false;
+    }
+    mutex_enter_blocking(mtx);
+    return true;
+}
+
+void mutex_exit(mutex_t *mtx) {
+    if (g_sync_fake && g_sync_fake->exit) {
+        g_sync_fake->exit(g_sync_fake->ctx, mtx);
+    }
+    mtx->owned = false;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file host_time.c
+ * @brief pico/time shim的主机实现
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+#include "pico/time.h"
+#include "host_fakes.h"
+
+static const host_time_fake_t *g_time_fake = NULL;
+static uint64_t g_boot_ns = 0;
+
+// 虚拟时钟
+static uint64_t g_virtual_now_us = 0;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t virtual_now_us(void *ctx) {
+    (void)ctx;
+    return g_virtual_now_us;
+}
+
+static void virtual_sleep_us(void *ctx, uint64_t us) {
+    (void)ctx;
+    g_virtual_now_us += us;
+}
+
+static const host_time_fake_t g_virtual_clock = {
+    virtual_now_us,
+    virtual_sleep_us,
+    NULL
+};
+
+void host_time_set_fake(const host_time_fake_t *fake) {
+    g_time_fake = fake;
+}
+
+void host_time_use_virtual_clock(uint64_t start_us) {
+    g_virtual_now_us = start_us;
+    g_time_fake = &g_virtual_clock;
+}
+
+void host_time_advance_us(uint64_t us) {
+    if (g_time_fake) {
+        g_time_fake->sleep_us(g_time_fake->ctx, us);
+    }
+}
+
+bool host_time_is_virtual(void) {
+    return g_time_fake == &g_virtual_clock;
+}
+
+absolute_time_t get_absolute_time(void) {
+    if (g_time_fake) {
+        return g_time_fake->now_us(g_time_fake->ctx);
+    }
+    if (g_boot_ns == 0) {
+        g_boot_ns = monotonic_ns();
+    }
+    return (monotonic_ns() - g_boot_ns) / 1000u;
+}
+
+void sleep_us(uint64_t us) {
+    if (g_time_fake) {
+        g_time_fake->sleep_us(g_time_fake->ctx, us);
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = (time_t)(us / 1000000u);
+    ts.tv_nsec = (long)((us % 1000000u) * 1000u);
+    while (nanosleep(&ts, &ts) != 0) {
+    }
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+void busy_wait_us(uint64_t us) {
+    if (g_time_fake) {
+        g_time_fake->sleep_us(g_time_fake->ctx, us);
+        return;
+    }
+    absolute_time_t end = get_absolute_time() + us;
+    while (get_absolute_time() < end) {
+    }
+}
+
+void busy_wait_ms(uint32_t ms) {
+    busy_wait_us((uint64_t)ms * 1000u);
+}
@@ -0,0 +1,465 @@
+/**
+ * @file bus_replay.cpp
+ * @brief 回放总线捕获文件，定位停顿的处理阶段
+ *
+ * 读取固件（LC76G_BUS_CAPTURE）或lc76g_i2c_sim --capture写出的捕获文件，
+ * 在虚拟时钟下按录制时间线重新执行：
+ * - GPS读取阶段：lc76g_read_fix走回放I2C总线，每次传输按录制的
+ *   返回值、短应答和耗时响应，数据内容由合成NMEA填充
+ * - 日志阶段：GPSLogger在主机FatFs上执行，SD卡SPI耗时按录制值计入
+ * - 命令、渲染、捕获写出阶段：按录制耗时推进时钟
+ *
+ * 输出各阶段录制/回放耗时统计，以及超过阈值的停顿及其主要原因。
+ *
+ * 用法示例:
+ *   bus_replay sd_card/gps_logs/bus_capture.bin
+ *   bus_replay capture.bin --stall-ms 500 --top 20
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "host_fakes.h"
+#include "pico/time.h"
+#include "nmea_generator.hpp"
+#include "gps/gps_logger.hpp"
+
+extern "C" {
+#include "gps/lc76g_i2c_adaptor.h"
+}
+#include "debug/bus_capture.h"
+
+namespace {
+
+// =============================================================================
+// 捕获文件
+// =============================================================================
+
+struct Record {
+    bus_capture_record_t raw;
+    uint64_t t_us;      // 展开32位回绕后的时间
+};
+
+struct StageRun {
+    uint8_t stage = BUS_STAGE_NONE;
+    uint64_t begin_us = 0;
+    uint64_t recorded_us = 0;
+    size_t first = 0;           // 阶段内第一条记录下标
+    size_t last = 0;            // 阶段结束记录下标（不含）
+    double bus_us = 0;
+    uint32_t transfers = 0;
+    uint32_t errors = 0;        // 返回值<0的传输（NAK/超时）
+    size_t slowest = SIZE_MAX;  // 阶段内最慢的传输
+    uint64_t replayed_us = 0;
+    bool replayed = false;
+};
+
+const char* kStageNames[BUS_STAGE_COUNT] = {
+    "unstaged", "gps_read", "gps_command", "log_write", "log_flush", "render", "capture_flush"
+};
+
+bool is_transfer(uint8_t type) {
+    return type >= BUS_CAPTURE_I2C_WRITE && type <= BUS_CAPTURE_SPI_XFER;
+}
+
+bool load_capture(const char* path, std::vector<Record>& records, uint64_t& gap_records) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        printf("无法打开捕获文件: %s\n", path);
+        return false;
+    }
+    bus_capture_file_header_t header;
+    if (std::fread(&header, sizeof(header), 1, f) != 1 || std::memcmp(header.magic, BUS_CAPTURE_MAGIC, 4) != 0) {
+        printf("不是总线捕获文件: %s\n", path);
+        std::fclose(f);
+        return false;
+    }
+    if (header.version != BUS_CAPTURE_VERSION || header.record_size != sizeof(bus_capture_record_t)) {
+        printf("不支持的捕获版本 %u (记录 %u 字节)\n", header.version, header.record_size);
+        std::fclose(f);
+        return false;
+    }
+
+    bus_capture_record_t raw;
+    uint64_t base = 0;
+    uint32_t prev = 0;
+    bool first = true;
+    while (std::fread(&raw, sizeof(raw), 1, f) == 1) {
+        if (raw.type == BUS_CAPTURE_GAP) {
+            gap_records += raw.len;
+        }
+        if (first) {
+            base = raw.t_us;
+            first = false;
+        } else {
+            base += (uint32_t)(raw.t_us - prev);
+        }
+        prev = raw.t_us;
+        records.push_back({raw, base});
+    }
+    std::fclose(f);
+    return true;
+}
+
+std::vector<StageRun> build_stages(const std::vector<Record>& records, StageRun& unstaged) {
+    std::vector<StageRun> runs;
+    StageRun current;
+    bool open = false;
+
+    auto account = [&records](StageRun& run, size_t i) {
+        const bus_capture_record_t& r = records[i].raw;
+        run.transfers += 1u + r.merged;
+        run.bus_us += r.dur_us;
+        if (r.status < 0) {
+            run.errors++;
+        }
+        if (run.slowest == SIZE_MAX || r.dur_us > records[run.slowest].raw.dur_us) {
+            run.slowest = i;
+        }
+    };
+
+    for (size_t i = 0; i < records.size(); i++) {
+        const bus_capture_record_t& r = records[i].raw;
+        if (r.type == BUS_CAPTURE_STAGE_BEGIN) {
+            if (open) {
+                // 未配对的BEGIN：按截断处理
+                current.last = i;
+                current.recorded_us = records[i].t_us - current.begin_us;
+                runs.push_back(current);
+            }
+            current = StageRun();
+            current.stage = r.addr < BUS_STAGE_COUNT ? r.addr : (uint8_t)BUS_STAGE_NONE;
+            current.begin_us = records[i].t_us;
+            current.first = i + 1;
+            open = true;
+        } else if (r.type == BUS_CAPTURE_STAGE_END) {
+            if (open && r.addr == current.stage) {
+                current.last = i;
+                current.recorded_us = r.dur_us;
+                runs.push_back(current);
+                open = false;
+            }
+        } else if (is_transfer(r.type)) {
+            account(open ? current : unstaged, i);
+        }
+    }
+    return runs;
+}
+
+// =============================================================================
+// 回放I2C总线
+// =============================================================================
+
+class ReplayI2c {
+public:
+    ReplayI2c(const std::vector<Record>& records, sim::NmeaSource& filler)
+        : records_(records), filler_(filler) {
+        fake_.write = &ReplayI2c::on_write;
+        fake_.read = &ReplayI2c::on_read;
+        fake_.ctx = this;
+    }
+
+    void install() { host_i2c_set_fake(&fake_); }
+    void uninstall() { host_i2c_set_fake(nullptr); }
+
+    /**
+     * @brief 设置当前阶段的记录范围
+     */
+    void bind(size_t first, size_t last) {
+        cursor_ = first;
+        end_ = last;
+        bound_ = true;
+    }
+
+    void unbind() { bound_ = false; }
+
+    uint64_t divergences() const { return divergences_; }
+    uint64_t served() const { return served_; }
+
+private:
+    static int on_write(void* ctx, uint bus, uint8_t addr, const uint8_t* src, size_t len, bool nostop) {
+        (void)bus;
+        (void)src;
+        (void)nostop;
+        return static_cast<ReplayI2c*>(ctx)->serve(BUS_CAPTURE_I2C_WRITE, addr, nullptr, len);
+    }
+
+    static int on_read(void* ctx, uint bus, uint8_t addr, uint8_t* dst, size_t len, bool nostop) {
+        (void)bus;
+        (void)nostop;
+        return static_cast<ReplayI2c*>(ctx)->serve(BUS_CAPTURE_I2C_READ, addr, dst, len);
+    }
+
+    int serve(uint8_t type, uint8_t addr, uint8_t* dst, size_t len) {
+        // 向前最多查找8条以便在少量偏差后重新对齐
+        for (size_t i = cursor_, n = 0; i < end_ && n < 8; i++) {
+            const bus_capture_record_t& r = records_[i].raw;
+            if (!is_transfer(r.type) || r.type > BUS_CAPTURE_I2C_READ) {
+                continue;
+            }
+            n++;
+            if (r.type != type || r.addr != addr || r.len != std::min<size_t>(len, UINT16_MAX)) {
+                continue;
+            }
+            cursor_ = i + 1;
+            served_++;
+            host_time_advance_us(r.dur_us);
+            if (dst && r.status > 0) {
+                if (len <= sizeof(r.data)) {
+                    std::memcpy(dst, r.data, len);
+                } else {
+                    uint64_t now = to_us_since_boot(get_absolute_time());
+                    size_t got = filler_.pull(dst, len, now);
+                    std::memset(dst + got, 0, len - got);
+                }
+            }
+            return r.status;
+        }
+        // 阶段外的访问（如初始化时的连接测试）没有录制数据，按无应答处理
+        if (bound_) {
+            divergences_++;
+        }
+        return PICO_ERROR_GENERIC;
+    }
+
+    const std::vector<Record>& records_;
+    sim::NmeaSource& filler_;
+    host_i2c_fake_t fake_{};
+    size_t cursor_ = 0;
+    size_t end_ = 0;
+    bool bound_ = false;
+    uint64_t divergences_ = 0;
+    uint64_t served_ = 0;
+};
+
+// =============================================================================
+// 报告
+// =============================================================================
+
+void describe_transfer(const bus_capture_record_t& r, char* buf, size_t len) {
+    static const char* kTypes[] = {"?", "I2C W", "I2C R", "SPI W", "SPI R", "SPI X"};
+    const char* type = r.type <= BUS_CAPTURE_SPI_XFER ? kTypes[r.type] : "?";
+    if (r.type <= BUS_CAPTURE_I2C_READ) {
+        std::snprintf(buf, len, "%s%u 0x%02X %uB %.2f ms (返回 %d)", type, r.bus, r.addr, r.len,
+                      r.dur_us / 1e3, r.status);
+    } else {
+        std::snprintf(buf, len, "%s%u %uB x%u %.2f ms (返回 %d)", type, r.bus, r.len, r.merged + 1u,
+                      r.dur_us / 1e3, r.status);
+    }
+}
+
+uint64_t median_of(std::vector<uint64_t> v) {
+    if (v.empty()) {
+        return 0;
+    }
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+}
+
+void print_usage(const char* prog) {
+    printf("用法: %s <捕获文件> [选项]\n", prog);
+    printf("  --stall-ms <ms>        超过该耗时的阶段视为停顿 (默认按中位数倍数)\n");
+    printf("  --stall-factor <倍>    超过本阶段中位数该倍数视为停顿 (默认3)\n");
+    printf("  --top <N>              最多列出N个停顿 (默认10)\n");
+    printf("  --no-logger            不在主机FatFs上重放日志阶段\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    double stall_ms = 0;
+    double stall_factor = 3.0;
+    size_t top = 10;
+    bool use_logger = true;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--stall-ms") == 0 && has_value) {
+            stall_ms = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--stall-factor") == 0 && has_value) {
+            stall_factor = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--top") == 0 && has_value) {
+            top = (size_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--no-logger") == 0) {
+            use_logger = false;
+        } else if (arg[0] != '-' && !path) {
+            path = arg;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!path) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Record> records;
+    uint64_t gap_records = 0;
+    if (!load_capture(path, records, gap_records)) {
+        return 1;
+    }
+    if (records.empty()) {
+        printf("捕获文件为空\n");
+        return 0;
+    }
+
+    StageRun unstaged;
+    std::vector<StageRun> runs = build_stages(records, unstaged);
+
+    // ---- 回放 ----
+    host_time_use_virtual_clock(records.front().t_us);
+
+    sim::GeneratorConfig gen_config;
+    sim::NmeaGenerator filler(gen_config);
+    ReplayI2c bus(records, filler);
+    bus.install();
+    lc76g_i2c_init(i2c1, 6, 7, 100000, -1);
+
+    std::unique_ptr<GPS::GPSLogger> logger;
+    if (use_logger) {
+        logger = std::make_unique<GPS::GPSLogger>(SimpleSD::SPIConfig{}, GPS::GPSLogger::LogConfig{});
+        if (!logger->initialize()) {
+            logger.reset();
+        }
+    }
+
+    gps_fix_t last_fix;
+    std::memset(&last_fix, 0, sizeof(last_fix));
+    uint64_t late_us = 0;
+
+    for (StageRun& run : runs) {
+        uint64_t now = to_us_since_boot(get_absolute_time());
+        if (now < run.begin_us) {
+            host_time_advance_us(run.begin_us - now);
+        } else {
+            late_us += now - run.begin_us;
+        }
+        uint64_t start = to_us_since_boot(get_absolute_time());
+
+        switch (run.stage) {
+            case BUS_STAGE_GPS_READ:
+                bus.bind(run.first, run.last);
+                lc76g_read_fix(&last_fix);
+                bus.unbind();
+                run.replayed = true;
+                break;
+            case BUS_STAGE_LOG_WRITE:
+            case BUS_STAGE_LOG_FLUSH:
+                if (logger) {
+                    if (run.stage == BUS_STAGE_LOG_WRITE) {
+                        logger->log_fix(last_fix);
+                    } else {
+                        logger->flush_buffer();
+                    }
+                    run.replayed = true;
+                }
+                // 主机FatFs没有SPI，SD卡耗时按录制值计入
+                host_time_advance_us((uint64_t)run.bus_us);
+                break;
+            default:
+                host_time_advance_us(run.recorded_us);
+                break;
+        }
+        run.replayed_us = to_us_since_boot(get_absolute_time()) - start;
+
+        // 与录制时间线对齐
+        now = to_us_since_boot(get_absolute_time());
+        if (now < run.begin_us + run.recorded_us) {
+            host_time_advance_us(run.begin_us + run.recorded_us - now);
+        }
+    }
+    bus.uninstall();
+
+    // ---- 阶段统计 ----
+    const double span_s = (records.back().t_us - records.front().t_us) / 1e6;
+    printf("捕获: %zu 条记录, 时长 %.1f s, 溢出丢失 %llu 条, 阶段 %zu 个\n",
+           records.size(), span_s, (unsigned long long)gap_records, runs.size());
+    printf("回放: I2C传输 %llu 次按录制响应, 偏离 %llu 次, 累计落后录制时间线 %.1f ms\n\n",
+           (unsigned long long)bus.served(), (unsigned long long)bus.divergences(), late_us / 1e3);
+
+    printf("%-14s %6s %10s %10s %10s %10s %8s %6s\n",
+           "阶段", "次数", "录制平均", "录制最大", "回放平均", "回放最大", "总线%", "错误");
+    std::vector<uint64_t> medians(BUS_STAGE_COUNT, 0);
+    for (int s = 1; s < BUS_STAGE_COUNT; s++) {
+        std::vector<uint64_t> durations;
+        uint64_t rec_sum = 0, rec_max = 0, rep_sum = 0, rep_max = 0;
+        double bus_sum = 0;
+        uint64_t errors = 0;
+        for (const StageRun& run : runs) {
+            if (run.stage != s) {
+                continue;
+            }
+            durations.push_back(run.recorded_us);
+            rec_sum += run.recorded_us;
+            rec_max = std::max(rec_max, run.recorded_us);
+            rep_sum += run.replayed_us;
+            rep_max = std::max(rep_max, run.replayed_us);
+            bus_sum += run.bus_us;
+            errors += run.errors;
+        }
+        if (durations.empty()) {
+            continue;
+        }
+        medians[s] = median_of(durations);
+        double n = (double)durations.size();
+        printf("%-14s %6zu %8.1fms %8.1fms %8.1fms %8.1fms %7.1f%% %6llu\n",
+               kStageNames[s], durations.size(), rec_sum / 1e3 / n, rec_max / 1e3,
+               rep_sum / 1e3 / n, rep_max / 1e3, rec_sum ? bus_sum * 100.0 / (double)rec_sum : 0.0,
+               (unsigned long long)errors);
+    }
+    if (unstaged.transfers) {
+        printf("%-14s %6u 次传输, 总线 %.1f ms, 错误 %u\n",
+               kStageNames[0], unstaged.transfers, unstaged.bus_us / 1e3, unstaged.errors);
+    }
+
+    // ---- 停顿 ----
+    std::vector<const StageRun*> stalls;
+    for (const StageRun& run : runs) {
+        double threshold_us = stall_ms > 0 ? stall_ms * 1e3 : (double)medians[run.stage] * stall_factor;
+        if (run.recorded_us > threshold_us && run.recorded_us > 1000) {
+            stalls.push_back(&run);
+        }
+    }
+    std::sort(stalls.begin(), stalls.end(),
+              [](const StageRun* a, const StageRun* b) { return a->recorded_us > b->recorded_us; });
+
+    printf("\n停顿: %zu 个", stalls.size());
+    if (stall_ms > 0) {
+        printf(" (超过 %.1f ms)\n", stall_ms);
+    } else {
+        printf(" (超过本阶段中位数的 %.1f 倍)\n", stall_factor);
+    }
+    for (size_t i = 0; i < stalls.size() && i < top; i++) {
+        const StageRun& run = *stalls[i];
+        double non_bus_us = (double)run.recorded_us - run.bus_us;
+        const char* cause;
+        if (run.errors > 0) {
+            cause = "总线错误重试";
+        } else if (run.bus_us >= non_bus_us) {
+            cause = "总线传输";
+        } else {
+            cause = "非总线耗时(CPU/等待)";
+        }
+        printf("  t=%9.3fs %-13s %8.1f ms (中位数 %.1f ms, 回放 %.1f ms) 原因: %s, 总线 %.1f ms, 错误 %u\n",
+               (run.begin_us - records.front().t_us) / 1e6, kStageNames[run.stage], run.recorded_us / 1e3,
+               medians[run.stage] / 1e3, run.replayed_us / 1e3, cause, run.bus_us / 1e3, run.errors);
+        if (run.slowest != SIZE_MAX) {
+            char desc[96];
+            describe_transfer(records[run.slowest].raw, desc, sizeof(desc));
+            printf("               最慢传输: %s\n", desc);
+        }
+    }
+    if (!stalls.empty()) {
+        const StageRun& worst = *stalls.front();
+        printf("\n结论: 最严重的停顿在 %s 阶段 (t=%.3fs, %.1f ms)\n", kStageNames[worst.stage],
+               (worst.begin_us - records.front().t_us) / 1e6, worst.recorded_us / 1e3);
+    }
+    return 0;
+}
@@ -0,0 +1,453 @@
+/**
+ * @file lc76g_i2c_sim.cpp
+ * @brief 在寄存器模型上运行lc76g_i2c_adaptor的轮询/读取/命令路径
+ *
+ * 全程使用虚拟时钟，相同参数的输出逐字节可复现，可用于调节轮询间隔、
+ * I2C时钟和重试策略，以及回归比较总线开销。
+ *
+ * 用法示例:
+ *   lc76g_i2c_sim --duration 120 --rate 10 --poll-ms 100
+ *   lc76g_i2c_sim --nak 0.05 --latency-us 200 --free-limit 16 --cmd-every 10
+ *   lc76g_i2c_sim --capture bus_capture.bin     (生成供bus_replay使用的捕获文件)
+ *   lc76g_i2c_sim --warm-start flash.bin --start 2025-01-01T03:00:00
+ *                                               (两次运行间模拟断电，验证热/温/冷启动选择)
+ *   lc76g_i2c_sim --warm-start flash.bin --ttff 2:25:35:12 --assist epo.txt
+ *                                               (冷启动时注入SD根目录下的辅助数据，比较TTFF)
+ *   lc76g_i2c_sim --rate 1 --frame-ms 33         (按30fps采样显示预测器，与真实轨迹比较)
+ *   lc76g_i2c_sim --duration 600 --trip          (行程统计的里程/运动时间与真实轨迹比较)
+ *   lc76g_i2c_sim --duration 900 --geofence fences.bin
+ *                                               (每次定位判定SD根目录下围栏文件中的围栏)
+ *   lc76g_i2c_sim --sats 5 --burst 60:10:outage --quality
+ *                                               (定位质量分级，拒绝的历元不进入下游)
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "ff.h"
+#include "host_fakes.h"
+#include "pico/time.h"
+#include "lc76g_i2c_model.hpp"
+#include "nmea_generator.hpp"
+
+extern "C" {
+#include "gps/lc76g_i2c_adaptor.h"
+}
+#include "debug/bus_capture.h"
+#include "gps/gps_warm_start.h"
+#include "gps/gps_assist.h"
+#include "gps/gps_predictor.h"
+#include "gps/gps_trip.h"
+#include "gps/gps_geofence.h"
+#include "gps/gps_quality.h"
+#include "gps/gps_sky.h"
+
+namespace {
+
+uint64_t now_us() {
+    return to_us_since_boot(get_absolute_time());
+}
+
+void print_usage(const char* prog) {
+    printf("用法: %s [选项]\n", prog);
+    printf("  --duration <秒>        仿真时长 (默认60)\n");
+    printf("  --poll-ms <ms>         lc76g_read_fix轮询间隔 (默认1000)\n");
+    printf("  --rate <Hz>            模块输出频率 (默认1)\n");
+    printf("  --sats <N>             可见卫星数 (默认24)\n");
+    printf("  --i2c-hz <Hz>          I2C时钟 (默认400000)\n");
+    printf("  --nak <概率>           每次传输NAK概率 (默认0)\n");
+    printf("  --latency-us <us>      每次传输固定延迟 (默认0)\n");
+    printf("  --free-limit <N>       QL_CW_REG报告的空闲空间上限 (默认不限)\n");
+    printf("  --drain-bps <N>        模块消化命令速度 (默认立即)\n");
+    printf("  --cmd-every <秒>       周期性发送$PAIR062并等待$PAIR001应答\n");
+    printf("  --seed <N>             随机种子 (默认1)\n");
+    printf("  --capture <文件>       记录总线传输到SD根目录下的捕获文件\n");
+    printf("  --start <时间>         模块起始UTC，格式YYYY-MM-DDThh:mm:ss (默认2025-01-01T00:00:00)\n");
+    printf("  --burst <模式>         突发 period:length[:corrupt|outage|drop[:rate[:offset]]]，可重复\n");
+    printf("  --warm-start <文件>    Flash镜像文件：启动时载入启动状态，结束时正常关机保存\n");
+    printf("  --ttff <秒>            启动命令后的捕获时间 hot:warm:cold[:assisted] (默认不模拟)\n");
+    printf("  --assist <文件>        冷启动时注入SD根目录下的辅助数据文件 (需--warm-start)\n");
+    printf("  --assist-id <N>        模块视为辅助数据的$PAIR命令号 (默认470)\n");
+    printf("  --frame-ms <ms>        轮询间隙按该帧间隔采样显示预测器，统计与真实轨迹的偏差\n");
+    printf("  --trip                 统计行程里程和运动时间，与真实轨迹比较\n");
+    printf("  --geofence <文件>      加载SD根目录下的围栏文件，打印进出事件和判定开销\n");
+    printf("  --quality              每次轮询做定位质量分级，拒绝的定位按无效交给下游\n");
+}
+
+// 局部平面近似距离，足够比较米级偏差
+double distance_m(double lat1, double lon1, double lat2, double lon2) {
+    const double k = 111320.0;
+    double dn = (lat2 - lat1) * k;
+    double de = (lon2 - lon1) * k * std::cos((lat1 + lat2) * 0.5 * 3.14159265358979324 / 180.0);
+    return std::sqrt(dn * dn + de * de);
+}
+
+/**
+ * @brief 显示帧与真实轨迹的偏差统计
+ */
+struct FrameError {
+    uint64_t frames = 0;
+    uint64_t extrapolated = 0;
+    double sum_sq = 0;
+    double max = 0;
+
+    void add(double err) {
+        frames++;
+        sum_sq += err * err;
+        if (err > max) {
+            max = err;
+        }
+    }
+    double rms() const {
+        return frames ? std::sqrt(sum_sq / (double)frames) : 0.0;
+    }
+};
+
+/**
+ * @brief 真实轨迹的路程和运动时间（按100ms步长积分）
+ */
+struct TruthPath {
+    double t_s = 0;
+    double distance_m = 0;
+    double moving_s = 0;
+
+    void advance(const sim::Trajectory& trajectory, double to_s) {
+        const double step_s = 0.1;
+        sim::MotionState prev = trajectory.at(t_s);
+        while (t_s < to_s) {
+            double dt = std::fmin(step_s, to_s - t_s);
+            t_s += dt;
+            sim::MotionState cur = trajectory.at(t_s);
+            distance_m += ::distance_m(prev.lat, prev.lon, cur.lat, cur.lon);
+            if (cur.speed_kmh >= GPS_TRIP_MIN_SPEED_KMH) {
+                moving_s += dt;
+            }
+            prev = cur;
+        }
+    }
+};
+
+bool parse_ttff(const char* spec, sim::GeneratorConfig& config) {
+    double hot = 0, warm = 0, cold = 0, assisted = 0;
+    int n = std::sscanf(spec, "%lf:%lf:%lf:%lf", &hot, &warm, &cold, &assisted);
+    if (n < 3 || hot < 0 || warm < 0 || cold < 0 || assisted < 0) {
+        return false;
+    }
+    config.hot_ttff_s = hot;
+    config.warm_ttff_s = warm;
+    config.cold_ttff_s = cold;
+    config.assisted_ttff_s = assisted;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    sim::GeneratorConfig gen_config;
+    sim::Lc76gI2cModelConfig model_config;
+    double duration_s = 60.0;
+    uint32_t poll_ms = 1000;
+    uint32_t i2c_hz = 400000;
+    double cmd_every_s = 0;
+    const char* capture_path = nullptr;
+    const char* flash_path = nullptr;
+    const char* assist_path = nullptr;
+    const char* geofence_path = nullptr;
+    uint32_t frame_ms = 0;
+    bool trip = false;
+    bool quality = false;
+    gen_config.assist_pair_id = 470;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--duration") == 0 && has_value) {
+            duration_s = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--poll-ms") == 0 && has_value) {
+            poll_ms = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--rate") == 0 && has_value) {
+            gen_config.rate_hz = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--sats") == 0 && has_value) {
+            gen_config.satellites = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--i2c-hz") == 0 && has_value) {
+            i2c_hz = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--nak") == 0 && has_value) {
+            model_config.nak_probability = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--latency-us") == 0 && has_value) {
+            model_config.latency_us = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--free-limit") == 0 && has_value) {
+            model_config.free_space_limit = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--drain-bps") == 0 && has_value) {
+            model_config.command_drain_bps = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--cmd-every") == 0 && has_value) {
+            cmd_every_s = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--seed") == 0 && has_value) {
+            gen_config.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+            model_config.seed = gen_config.seed;
+        } else if (std::strcmp(arg, "--capture") == 0 && has_value) {
+            capture_path = argv[++i];
+        } else if (std::strcmp(arg, "--start") == 0 && has_value && sim::parse_start_time(argv[i + 1], gen_config)) {
+            i++;
+        } else if (std::strcmp(arg, "--burst") == 0 && has_value) {
+            sim::BurstPattern burst;
+            if (!sim::parse_burst_pattern(argv[++i], burst)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            gen_config.bursts.push_back(burst);
+        } else if (std::strcmp(arg, "--warm-start") == 0 && has_value) {
+            flash_path = argv[++i];
+        } else if (std::strcmp(arg, "--ttff") == 0 && has_value && parse_ttff(argv[i + 1], gen_config)) {
+            i++;
+        } else if (std::strcmp(arg, "--assist") == 0 && has_value) {
+            assist_path = argv[++i];
+        } else if (std::strcmp(arg, "--frame-ms") == 0 && has_value) {
+            frame_ms = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--trip") == 0) {
+            trip = true;
+        } else if (std::strcmp(arg, "--quality") == 0) {
+            quality = true;
+        } else if (std::strcmp(arg, "--geofence") == 0 && has_value) {
+            geofence_path = argv[++i];
+        } else if (std::strcmp(arg, "--assist-id") == 0 && has_value) {
+            gen_config.assist_pair_id = (uint16_t)std::atoi(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (assist_path && !flash_path) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    host_time_use_virtual_clock(0);
+
+    sim::NmeaGenerator gen(gen_config);
+    sim::Lc76gI2cModel model(gen, model_config);
+    model.install();
+
+    lc76g_i2c_init(i2c1, 6, 7, i2c_hz, -1);
+
+    static FATFS fatfs;
+    // 固件中由SimpleSD挂载，这里直接挂载主机FatFs
+    if ((capture_path || assist_path || geofence_path) && f_mount(&fatfs, "0:", 1) != FR_OK) {
+        printf("无法挂载主机SD目录: %s\n", host_fatfs_get_root());
+        return 1;
+    }
+    if (capture_path) {
+        f_unlink(capture_path);
+        bus_capture_init();
+        bus_capture_enable(true);
+    }
+    uint64_t next_capture_flush_us = 10000000;
+    if (geofence_path && !gps_geofence_load_file(geofence_path)) {
+        return 1;
+    }
+
+    if (flash_path) {
+        // 镜像不存在时从空白Flash开始
+        host_flash_load(flash_path);
+        if (trip) {
+            gps_trip_init();
+        }
+        gps_warm_start_init();
+        gps_warm_start_print_stats();
+
+        // 先读一次，模块RTC的时间随RMC输出
+        gps_fix_t fix;
+        lc76g_read_fix(&fix);
+        uint32_t utc_now = 0;
+        lc76g_get_utc_time(&utc_now);
+        gps_warm_start_boot(utc_now);
+
+        if (assist_path && gps_warm_start_boot_type() == GPS_START_COLD &&
+            gps_assist_load_file(assist_path, utc_now, NULL)) {
+            gps_warm_start_mark_assisted();
+        }
+    }
+
+    const uint64_t end_us = (uint64_t)(duration_s * 1e6);
+    const uint64_t cmd_interval_us = (uint64_t)(cmd_every_s * 1e6);
+    uint64_t next_cmd_us = cmd_interval_us;
+    const std::string command = sim::NmeaGenerator::make_sentence("PAIR062,0,1");
+
+    uint64_t polls = 0, poll_ok = 0, fixes = 0, commands = 0, acks = 0;
+    uint64_t poll_time_us = 0, poll_time_max_us = 0;
+    uint64_t cmd_time_us = 0;
+    FrameError predicted_error, hold_error;
+    TruthPath truth_path;
+    // 从Flash载入的行程是之前运行累计的，只比较本次增量
+    const gps_trip_t trip_base = *gps_trip_get(0);
+    gps_fix_t last_fix;
+    memset(&last_fix, 0, sizeof(last_fix));
+
+    while (now_us() < end_us) {
+        uint64_t start = now_us();
+        gps_fix_t fix;
+        memset(&fix, 0, sizeof(fix));
+        BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_GPS_READ);
+        bool ok = lc76g_read_fix(&fix);
+        BUS_CAPTURE_STAGE_END(BUS_STAGE_GPS_READ);
+        uint64_t elapsed = now_us() - start;
+
+        polls++;
+        poll_time_us += elapsed;
+        if (elapsed > poll_time_max_us) {
+            poll_time_max_us = elapsed;
+        }
+        if (ok) {
+            poll_ok++;
+        }
+        if (quality && gps_quality_classify(&fix, (uint32_t)(start / 1000), nullptr) == GPS_QUALITY_REJECT) {
+            fix.flags &= (uint8_t)~GPS_FIX_VALID;
+        }
+        if (gps_fix_is_valid(&fix)) {
+            fixes++;
+            if (flash_path) {
+                gps_warm_start_update(&fix);
+            }
+            if (frame_ms) {
+                // 读取本身可能耗时数百毫秒，以开始读取的时刻作为定位时刻
+                gps_predictor_update(&fix, (uint32_t)(start / 1000));
+                last_fix = fix;
+            }
+        }
+        if (geofence_path) {
+            gps_geofence_event_t events[4];
+            int n = gps_geofence_update(&fix, events, 4);
+            for (int e = 0; e < n; e++) {
+                printf("[%7.1f s] 围栏 %lu %-16s %s\n", start / 1e6, (unsigned long)events[e].id,
+                       events[e].name, events[e].entered ? "进入" : "离开");
+            }
+        }
+        if (trip) {
+            gps_trip_update(&fix, (uint32_t)(start / 1000));
+            truth_path.advance(gen.trajectory(), start / 1e6);
+        }
+
+        if (cmd_interval_us && now_us() >= next_cmd_us) {
+            Ql_gnss_command_contx_TypeDef info;
+            uint64_t cmd_start = now_us();
+            commands++;
+            BUS_CAPTURE_STAGE_BEGIN(BUS_STAGE_GPS_COMMAND);
+            if (lc76g_send_command_and_get_response(command.c_str(), "$PAIR001", 1000, &info)) {
+                acks++;
+            }
+            BUS_CAPTURE_STAGE_END(BUS_STAGE_GPS_COMMAND);
+            cmd_time_us += now_us() - cmd_start;
+            next_cmd_us += cmd_interval_us;
+        }
+
+        if (capture_path && now_us() >= next_capture_flush_us) {
+            bus_capture_flush(capture_path);
+            next_capture_flush_us += 10000000;
+        }
+
+        const uint64_t next_poll_us = start + (uint64_t)poll_ms * 1000;
+        while (frame_ms && now_us() + (uint64_t)frame_ms * 1000 <= next_poll_us) {
+            sleep_us((uint64_t)frame_ms * 1000);
+            gps_predictor_state_t state;
+            if (!gps_predictor_sample(to_ms_since_boot(get_absolute_time()), &state)) {
+                continue;
+            }
+            sim::MotionState truth = gen.trajectory().at(now_us() / 1e6);
+            predicted_error.add(distance_m(truth.lat, truth.lon, state.lat, state.lon));
+            hold_error.add(distance_m(truth.lat, truth.lon, last_fix.lat_e7 * 1e-7, last_fix.lon_e7 * 1e-7));
+            if (state.extrapolating) {
+                predicted_error.extrapolated++;
+            }
+        }
+        if (now_us() < next_poll_us) {
+            sleep_us(next_poll_us - now_us());
+        }
+    }
+
+    if (capture_path) {
+        bus_capture_flush(capture_path);
+        bus_capture_enable(false);
+    }
+    if (flash_path) {
+        gps_warm_start_save(true);
+        if (trip) {
+            gps_trip_save();
+        }
+    }
+    model.uninstall();
+
+    const sim::Lc76gI2cModelStats& s = model.stats();
+    const sim::GeneratorStats& g = gen.stats();
+    printf("仿真时长:       %.1f s (I2C %u Hz, 轮询 %u ms)\n", now_us() / 1e6, i2c_hz, poll_ms);
+    printf("轮询:           %llu 次, 成功 %llu, 有效定位 %llu\n",
+           (unsigned long long)polls, (unsigned long long)poll_ok, (unsigned long long)fixes);
+    printf("单次轮询耗时:   平均 %.1f ms, 最大 %.1f ms\n",
+           polls ? poll_time_us / 1e3 / (double)polls : 0.0, poll_time_max_us / 1e3);
+    printf("命令:           %llu 次, 收到应答 %llu, 平均耗时 %.1f ms\n",
+           (unsigned long long)commands, (unsigned long long)acks,
+           commands ? cmd_time_us / 1e3 / (double)commands : 0.0);
+    printf("总线传输:       %llu (NAK注入 %llu, 状态NAK %llu, 探测 %llu)\n",
+           (unsigned long long)s.transactions, (unsigned long long)s.naks,
+           (unsigned long long)s.state_naks, (unsigned long long)s.probes);
+    printf("长度查询:       %llu (为空 %llu), 数据读取 %llu, 空闲查询 %llu, 命令写入 %llu\n",
+           (unsigned long long)s.length_polls, (unsigned long long)s.empty_polls,
+           (unsigned long long)s.data_reads, (unsigned long long)s.free_queries,
+           (unsigned long long)s.command_writes);
+    printf("字节:           读出 %llu / 模块产生 %llu, 写入 %llu, 补零 %llu, 模块缓冲溢出 %llu\n",
+           (unsigned long long)s.bytes_read, (unsigned long long)g.bytes,
+           (unsigned long long)s.bytes_written, (unsigned long long)s.underrun_bytes,
+           (unsigned long long)g.overflow_bytes);
+    if (gps_sky_has_used()) {
+        printf("卫星:           可见 %u, 参与定位 %u (GP %u, GL %u, GA %u, GB %u, GQ %u)\n", gps_sky_count(),
+               gps_sky_used_count(GPS_SKY_SYSTEM_COUNT), gps_sky_used_count(GPS_SKY_GPS),
+               gps_sky_used_count(GPS_SKY_GLONASS), gps_sky_used_count(GPS_SKY_GALILEO),
+               gps_sky_used_count(GPS_SKY_BEIDOU), gps_sky_used_count(GPS_SKY_QZSS));
+    }
+    if (g.acquiring_epochs || g.assist_commands) {
+        printf("捕获模型:       未定位历元 %llu, 收到辅助命令 %llu\n",
+               (unsigned long long)g.acquiring_epochs, (unsigned long long)g.assist_commands);
+    }
+    if (frame_ms) {
+        gps_predictor_stats_t ps;
+        gps_predictor_get_stats(&ps);
+        printf("显示预测:       %llu 帧 (外推 %llu), 偏差RMS %.2f m / 最大 %.2f m; 保持上次定位 RMS %.2f m / 最大 %.2f m\n",
+               (unsigned long long)predicted_error.frames, (unsigned long long)predicted_error.extrapolated,
+               predicted_error.rms(), predicted_error.max, hold_error.rms(), hold_error.max);
+        printf("定位时偏差:     外推 %.2f m, 保持 %.2f m (滑动平均, %lu 次, 跳变 %lu)\n",
+               ps.mean_error_m, ps.mean_hold_error_m, (unsigned long)ps.fixes, (unsigned long)ps.snaps);
+    }
+    if (trip) {
+        const gps_trip_t* t = gps_trip_get(0);
+        double distance = t->distance_m - trip_base.distance_m;
+        printf("行程统计:       本次里程 %.1f m / 真实 %.1f m (%+.2f%%), 运动 %.0f s / 真实 %.0f s\n",
+               distance, truth_path.distance_m,
+               truth_path.distance_m > 0 ? (distance / truth_path.distance_m - 1.0) * 100.0 : 0.0,
+               (t->moving_ms - trip_base.moving_ms) / 1e3, truth_path.moving_s);
+        printf("                累计 %.1f m, 平均 %.1f km/h, 最高 %.1f km/h, 总里程 %.1f m\n",
+               t->distance_m, gps_trip_avg_speed_kmh(t), t->max_speed_kmh, gps_trip_odometer()->distance_m);
+    }
+    if (geofence_path) {
+        gps_geofence_print_stats();
+    }
+    if (quality) {
+        gps_quality_print_stats();
+    }
+    printf("线上时间:       %.1f ms (%.2f%% 总线占用)\n",
+           s.bus_time_us / 1e3, now_us() ? s.bus_time_us * 100.0 / (double)now_us() : 0.0);
+    if (capture_path) {
+        printf("捕获文件:       %s/%s (丢失记录 %lu)\n", host_fatfs_get_root(), capture_path,
+               (unsigned long)bus_capture_dropped());
+    }
+    if (flash_path) {
+        gps_warm_start_print_stats();
+        if (!host_flash_save(flash_path)) {
+            printf("无法写入Flash镜像: %s\n", flash_path);
+            return 1;
+        }
+        printf("Flash镜像:      %s (擦除扇区 %lu, 编程页 %lu)\n", flash_path,
+               (unsigned long)host_flash_erase_count(), (unsigned long)host_flash_program_count());
+    }
+    return 0;
+}
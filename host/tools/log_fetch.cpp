@@ -0,0 +1,489 @@
+/**
+ * @file log_fetch.cpp
+ * @brief 通过USB串口列出/下载设备SD卡上的日志文件
+ *
+ * 与固件gps_log_transfer模块通信（协议见gps_log_transfer.h）。下载先写入
+ * <输出>.part，中断后再次执行从.part的长度继续；完成并校验CRC32后改名。
+ *
+ * --loopback <目录> 不连接设备，在本进程内运行设备端模块，以该目录为SD卡根目录
+ * （日志在<目录>/gps_logs下），通过socketpair通信，用于在Linux上测试协议。
+ *
+ * 用法示例:
+ *   log_fetch --port /dev/ttyACM0 list
+ *   log_fetch --port /dev/ttyACM0 get gps_20261018_001.csv --out trip.csv
+ *   log_fetch --loopback sd_card get gps_20261018_001.csv --loss 50
+ *   log_fetch --loopback sd_card get gps_20261018_001.csv --max-bytes 100000   (模拟中断)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "ff.h"
+
+extern "C" {
+#include "gps/gps_log_transfer.h"
+}
+
+namespace {
+
+constexpr int kReplyTimeoutMs = 2000;
+constexpr int kDataTimeoutMs = 1000;       // 无数据时发送NAK催促重发
+constexpr int kGiveUpMs = 6000;
+
+using Clock = std::chrono::steady_clock;
+
+void print_usage(const char* prog) {
+    printf("用法: %s (--port <串口> | --loopback <SD目录>) <命令> [选项]\n", prog);
+    printf("命令:\n");
+    printf("  list                   列出日志目录中的文件\n");
+    printf("  get <文件名>           下载文件（可断点续传）\n");
+    printf("选项:\n");
+    printf("  --out <文件>           输出文件 (默认与设备上同名)\n");
+    printf("  --window <帧数>        未确认帧数上限 1-%d (默认%d)\n",
+           GPS_LOG_TRANSFER_MAX_WINDOW, GPS_LOG_TRANSFER_MAX_WINDOW);
+    printf("  --restart              忽略已有的.part文件，从头下载\n");
+    printf("  --max-bytes <字节>     收到指定字节数后中止（测试续传）\n");
+    printf("  --loss <N>             回环模式下每N个数据帧破坏一个（测试重发）\n");
+}
+
+double elapsed_ms(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// =============================================================================
+// 连接
+// =============================================================================
+
+/**
+ * @brief 串口或socketpair上的帧收发
+ */
+class Link {
+public:
+    explicit Link(int fd) : fd_(fd) {
+        gps_log_transfer_rx_reset(&rx_);
+        rx_.dropped = 0;
+    }
+
+    ~Link() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    void send(uint8_t type, uint8_t flags, uint32_t offset, uint16_t arg,
+              const void* payload = nullptr, uint16_t length = 0) {
+        gps_log_transfer_header_t header;
+        gps_log_transfer_make_header(&header, type, flags, offset, arg, payload, length);
+        write_all(&header, sizeof(header));
+        if (length > 0) {
+            write_all(payload, length);
+        }
+    }
+
+    /**
+     * @brief 接收下一帧
+     * @return 超时返回false
+     */
+    bool receive(int timeout_ms, gps_log_transfer_header_t* header, const uint8_t** payload) {
+        Clock::time_point start = Clock::now();
+        while (true) {
+            while (pos_ < pending_.size()) {
+                uint32_t consumed = 0;
+                bool complete = gps_log_transfer_rx_feed(&rx_, pending_.data() + pos_,
+                                                         (uint32_t)(pending_.size() - pos_), &consumed);
+                pos_ += consumed;
+                if (complete) {
+                    std::memcpy(header, rx_.data, sizeof(*header));
+                    std::memcpy(frame_, rx_.data + sizeof(*header), header->length);
+                    *payload = frame_;
+                    gps_log_transfer_rx_reset(&rx_);
+                    return true;
+                }
+            }
+
+            int remaining = timeout_ms - (int)elapsed_ms(start);
+            if (remaining <= 0) {
+                return false;
+            }
+            pollfd pfd = {fd_, POLLIN, 0};
+            if (poll(&pfd, 1, remaining) <= 0) {
+                return false;
+            }
+            pending_.resize(16384);
+            ssize_t n = read(fd_, pending_.data(), pending_.size());
+            if (n <= 0) {
+                return false;
+            }
+            pending_.resize((size_t)n);
+            pos_ = 0;
+        }
+    }
+
+    uint32_t dropped() const { return rx_.dropped; }
+
+private:
+    void write_all(const void* data, size_t length) {
+        const uint8_t* p = (const uint8_t*)data;
+        while (length > 0) {
+            ssize_t n = write(fd_, p, length);
+            if (n <= 0) {
+                return;
+            }
+            p += n;
+            length -= (size_t)n;
+        }
+    }
+
+    int fd_;
+    gps_log_transfer_rx_t rx_;
+    std::vector<uint8_t> pending_;
+    size_t pos_ = 0;
+    uint8_t frame_[GPS_LOG_TRANSFER_MAX_PAYLOAD];
+};
+
+int open_serial(const char* path) {
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        printf("无法打开串口: %s\n", path);
+        return -1;
+    }
+    termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetspeed(&tio, B115200);      // USB CDC忽略波特率
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+// =============================================================================
+// 回环设备
+// =============================================================================
+
+struct Loopback {
+    int fd = -1;
+    uint32_t loss_every = 0;
+    uint32_t payload_writes = 0;
+    std::atomic<bool> stop{false};
+    std::thread thread;
+    gps_log_transfer_transport_t transport = {};
+};
+
+int loopback_read(void* ctx, uint8_t* data, uint32_t max) {
+    Loopback* loop = (Loopback*)ctx;
+    ssize_t n = recv(loop->fd, data, max, MSG_DONTWAIT);
+    return n > 0 ? (int)n : 0;
+}
+
+void loopback_write(void* ctx, const uint8_t* data, uint32_t length) {
+    Loopback* loop = (Loopback*)ctx;
+    std::vector<uint8_t> copy;
+    // 负载单独写出，按--loss破坏其中一个字节
+    if (loop->loss_every > 0 && length > sizeof(gps_log_transfer_header_t) &&
+        ++loop->payload_writes % loop->loss_every == 0) {
+        copy.assign(data, data + length);
+        copy[length / 2] ^= 0x5A;
+        data = copy.data();
+    }
+    while (length > 0) {
+        ssize_t n = send(loop->fd, data, length, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        length -= (uint32_t)n;
+    }
+}
+
+void loopback_flush(void*) {
+}
+
+/**
+ * @brief 启动回环设备线程，返回主机端fd
+ */
+int start_loopback(Loopback& loop, const char* root) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("socketpair失败\n");
+        return -1;
+    }
+    loop.fd = fds[1];
+    loop.transport = {&loop, loopback_read, loopback_write, loopback_flush};
+
+    host_fatfs_set_root(root);
+    static FATFS fs;
+    f_mount(&fs, "0:", 1);
+    gps_log_transfer_init(&loop.transport, "/gps_logs");
+
+    loop.thread = std::thread([&loop] {
+        while (!loop.stop.load()) {
+            if (!gps_log_transfer_poll(20)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    });
+    return fds[0];
+}
+
+void stop_loopback(Loopback& loop) {
+    if (loop.thread.joinable()) {
+        loop.stop = true;
+        loop.thread.join();
+        gps_log_transfer_print_stats();
+        close(loop.fd);
+    }
+}
+
+// =============================================================================
+// 命令
+// =============================================================================
+
+int do_list(Link& link) {
+    link.send(GPS_LOG_TRANSFER_LIST, 0, 0, 0);
+    gps_log_transfer_header_t header;
+    const uint8_t* payload = nullptr;
+    uint64_t total = 0;
+    while (link.receive(kReplyTimeoutMs, &header, &payload)) {
+        if (header.type == GPS_LOG_TRANSFER_ENTRY) {
+            printf("%10lu  %.*s\n", (unsigned long)header.offset, (int)header.length, (const char*)payload);
+            total += header.offset;
+        } else if (header.type == GPS_LOG_TRANSFER_LIST_END) {
+            printf("共%lu个文件，%llu字节\n", (unsigned long)header.offset, (unsigned long long)total);
+            return 0;
+        } else if (header.type == GPS_LOG_TRANSFER_ERROR) {
+            printf("设备错误 %u: %.*s\n", header.arg, (int)header.length, (const char*)payload);
+            return 1;
+        }
+    }
+    printf("设备无应答\n");
+    return 1;
+}
+
+struct GetOptions {
+    std::string name;
+    std::string out;
+    uint16_t window = GPS_LOG_TRANSFER_MAX_WINDOW;
+    bool restart = false;
+    uint64_t max_bytes = 0;
+};
+
+long file_size(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? (long)st.st_size : -1;
+}
+
+/**
+ * @brief 发送GET并等待INFO
+ */
+bool request_file(Link& link, const GetOptions& options, uint32_t offset, uint32_t* size) {
+    for (int attempt = 0; attempt < 3; attempt++) {
+        link.send(GPS_LOG_TRANSFER_GET, 0, offset, options.window, options.name.data(),
+                  (uint16_t)options.name.size());
+        gps_log_transfer_header_t header;
+        const uint8_t* payload = nullptr;
+        Clock::time_point start = Clock::now();
+        while (elapsed_ms(start) < kReplyTimeoutMs &&
+               link.receive(kReplyTimeoutMs, &header, &payload)) {
+            if (header.type == GPS_LOG_TRANSFER_INFO) {
+                *size = header.offset;
+                return true;
+            }
+            if (header.type == GPS_LOG_TRANSFER_ERROR) {
+                printf("设备错误 %u: %.*s\n", header.arg, (int)header.length, (const char*)payload);
+                return false;
+            }
+        }
+    }
+    printf("设备无应答\n");
+    return false;
+}
+
+int do_get(Link& link, const GetOptions& options) {
+    std::string part = options.out + ".part";
+    long existing = options.restart ? -1 : file_size(part);
+    uint32_t offset = existing > 0 ? (uint32_t)existing : 0;
+
+    uint32_t size = 0;
+    if (!request_file(link, options, offset, &size)) {
+        return 1;
+    }
+    if (offset > size) {
+        printf(".part比设备上的文件大，从头下载\n");
+        offset = 0;
+        if (!request_file(link, options, offset, &size)) {
+            return 1;
+        }
+    }
+    if (offset > 0) {
+        printf("从%lu字节处继续下载 (共%lu字节)\n", (unsigned long)offset, (unsigned long)size);
+    }
+
+    FILE* out = std::fopen(part.c_str(), offset > 0 ? "r+b" : "wb");
+    if (!out || std::fseek(out, offset, SEEK_SET) != 0) {
+        printf("无法写入: %s\n", part.c_str());
+        if (out) std::fclose(out);
+        link.send(GPS_LOG_TRANSFER_ABORT, 0, 0, 0);
+        return 1;
+    }
+
+    const uint32_t ack_every = std::max<uint32_t>(1, options.window / 4);
+    uint32_t expected = offset;
+    uint32_t crc = 0;
+    uint32_t unacked = 0;
+    uint32_t naks = 0, duplicates = 0, kicks = 0;
+    bool nak_sent = false;
+    bool done = false;
+    bool crc_ok = false;
+    Clock::time_point start = Clock::now();
+    Clock::time_point last_frame = start;
+
+    while (!done) {
+        gps_log_transfer_header_t header;
+        const uint8_t* payload = nullptr;
+        if (!link.receive(kDataTimeoutMs, &header, &payload)) {
+            if (elapsed_ms(last_frame) > kGiveUpMs) {
+                printf("设备无应答，已保存%lu字节，重新执行以继续\n", (unsigned long)expected);
+                break;
+            }
+            link.send(GPS_LOG_TRANSFER_ACK, GPS_LOG_TRANSFER_FLAG_NAK, expected, 0);
+            kicks++;
+            continue;
+        }
+        last_frame = Clock::now();
+
+        if (header.type == GPS_LOG_TRANSFER_DATA) {
+            if (header.offset == expected) {
+                std::fwrite(payload, 1, header.length, out);
+                crc = gps_log_transfer_crc32(crc, payload, header.length);
+                expected += header.length;
+                nak_sent = false;
+                if (++unacked >= ack_every || expected == size) {
+                    link.send(GPS_LOG_TRANSFER_ACK, 0, expected, 0);
+                    unacked = 0;
+                }
+                if (options.max_bytes && expected - offset >= options.max_bytes && expected < size) {
+                    link.send(GPS_LOG_TRANSFER_ABORT, 0, 0, 0);
+                    printf("已收到%lu字节，按--max-bytes中止\n", (unsigned long)(expected - offset));
+                    break;
+                }
+            } else if (header.offset > expected) {
+                // 前面的帧丢失或校验失败：请求从expected重发，之后到达的帧丢弃
+                if (!nak_sent) {
+                    link.send(GPS_LOG_TRANSFER_ACK, GPS_LOG_TRANSFER_FLAG_NAK, expected, 0);
+                    nak_sent = true;
+                    naks++;
+                }
+            } else {
+                duplicates++;
+            }
+        } else if (header.type == GPS_LOG_TRANSFER_END) {
+            uint32_t device_crc = 0;
+            if (header.length == sizeof(device_crc)) {
+                std::memcpy(&device_crc, payload, sizeof(device_crc));
+            }
+            crc_ok = expected == size && device_crc == crc;
+            done = true;
+        } else if (header.type == GPS_LOG_TRANSFER_ERROR) {
+            printf("设备错误 %u: %.*s\n", header.arg, (int)header.length, (const char*)payload);
+            break;
+        }
+    }
+    std::fclose(out);
+
+    double seconds = elapsed_ms(start) / 1000.0;
+    uint32_t received = expected - offset;
+    printf("接收 %lu字节，%.2f秒，%.1f KB/s (NAK %lu，重复帧 %lu，催促 %lu，坏帧 %lu)\n",
+           (unsigned long)received, seconds, seconds > 0 ? received / 1024.0 / seconds : 0.0,
+           (unsigned long)naks, (unsigned long)duplicates, (unsigned long)kicks,
+           (unsigned long)link.dropped());
+
+    if (!done) {
+        return 1;
+    }
+    if (!crc_ok) {
+        printf("CRC校验失败，删除%s后重新下载\n", part.c_str());
+        return 1;
+    }
+    if (std::rename(part.c_str(), options.out.c_str()) != 0) {
+        printf("无法改名为: %s\n", options.out.c_str());
+        return 1;
+    }
+    printf("已保存: %s (%lu字节，CRC32校验通过)\n", options.out.c_str(), (unsigned long)size);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* port = nullptr;
+    const char* loopback_root = nullptr;
+    const char* command = nullptr;
+    GetOptions get;
+    Loopback loop;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--port") == 0 && has_value) {
+            port = argv[++i];
+        } else if (std::strcmp(arg, "--loopback") == 0 && has_value) {
+            loopback_root = argv[++i];
+        } else if (std::strcmp(arg, "--out") == 0 && has_value) {
+            get.out = argv[++i];
+        } else if (std::strcmp(arg, "--window") == 0 && has_value) {
+            get.window = (uint16_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--restart") == 0) {
+            get.restart = true;
+        } else if (std::strcmp(arg, "--max-bytes") == 0 && has_value) {
+            get.max_bytes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--loss") == 0 && has_value) {
+            loop.loss_every = (uint32_t)std::atoi(argv[++i]);
+        } else if (!command && (std::strcmp(arg, "list") == 0 || std::strcmp(arg, "get") == 0)) {
+            command = arg;
+            if (std::strcmp(arg, "get") == 0 && has_value) {
+                get.name = argv[++i];
+            }
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    bool is_get = command && std::strcmp(command, "get") == 0;
+    if (!command || (port != nullptr) == (loopback_root != nullptr) || (is_get && get.name.empty()) ||
+        get.window < 1 || get.window > GPS_LOG_TRANSFER_MAX_WINDOW) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (get.out.empty()) {
+        get.out = get.name;
+    }
+
+    int fd = port ? open_serial(port) : start_loopback(loop, loopback_root);
+    if (fd < 0) {
+        return 1;
+    }
+
+    int result;
+    {
+        Link link(fd);
+        result = is_get ? do_get(link, get) : do_list(link);
+    }
+    stop_loopback(loop);
+    return result;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file map_tiler.cpp
+ * @brief 离线底图瓦片包生成工具
+ *
+ * 用法示例:
+ *   map_tiler --synthetic --out sd_card/maps/basemap.bin
+ *                          (在nmea_gen默认轨迹周围生成合成底图)
+ *   map_tiler --ppm city.ppm --nw 31.2501,121.4402 --mpp 0.5 --levels 5,10,20,50 --out basemap.bin
+ *                          (把已配准的栅格图切成瓦片，图像按北上、每像素mpp米)
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ili9488_tile_map.hpp"
+#include "nmea_generator.hpp"
+#include "tile_pack.hpp"
+
+namespace {
+
+void print_usage(const char* prog) {
+    printf("用法: %s [选项]\n", prog);
+    printf("  --synthetic            合成底图（街道网格、河流、绿地），范围取轨迹外包矩形\n");
+    printf("  --route <文件>         合成底图使用的轨迹文件 (默认nmea_gen默认轨迹)\n");
+    printf("  --margin <米>          轨迹外包矩形外扩 (默认500)\n");
+    printf("  --ppm <文件>           源图像，8位二进制PPM(P6)\n");
+    printf("  --nw <纬度,经度>       源图像左上角坐标\n");
+    printf("  --mpp <米>             源图像每像素米数\n");
+    printf("  --levels <表>          输出比例尺列表 (分米/像素)，如 10,20,50 (默认10,20,50,100,200,500)\n");
+    printf("  --tile <像素>          瓦片边长 16-64 (默认64)\n");
+    printf("  --out <文件>           输出文件\n");
+}
+
+bool parse_levels(const char* text, std::vector<uint32_t>& levels) {
+    levels.clear();
+    const char* p = text;
+    while (*p) {
+        char* end = nullptr;
+        unsigned long v = std::strtoul(p, &end, 10);
+        if (end == p || v == 0) {
+            return false;
+        }
+        levels.push_back((uint32_t)v);
+        p = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') {
+            return false;
+        }
+    }
+    return !levels.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    sim::TilePackConfig config;
+    bool synthetic = false;
+    const char* route_path = nullptr;
+    const char* ppm_path = nullptr;
+    const char* out_path = nullptr;
+    double margin_m = 500;
+    double nw_lat = 0, nw_lon = 0, mpp = 0;
+    bool have_nw = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--synthetic") == 0) {
+            synthetic = true;
+        } else if (std::strcmp(arg, "--route") == 0 && has_value) {
+            route_path = argv[++i];
+        } else if (std::strcmp(arg, "--margin") == 0 && has_value) {
+            margin_m = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--ppm") == 0 && has_value) {
+            ppm_path = argv[++i];
+        } else if (std::strcmp(arg, "--nw") == 0 && has_value) {
+            have_nw = std::sscanf(argv[++i], "%lf,%lf", &nw_lat, &nw_lon) == 2;
+        } else if (std::strcmp(arg, "--mpp") == 0 && has_value) {
+            mpp = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--levels") == 0 && has_value) {
+            if (!parse_levels(argv[++i], config.levels_dm)) {
+                printf("无效的比例尺列表: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--tile") == 0 && has_value) {
+            config.tile_size = (uint16_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--out") == 0 && has_value) {
+            out_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!out_path || synthetic == (ppm_path != nullptr) ||
+        config.tile_size < 16 || config.tile_size > ILI9488_TILE_MAX_SIZE) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    sim::RasterImage image;
+    sim::TileSampler sampler;
+    if (synthetic) {
+        sim::Trajectory trajectory = sim::Trajectory::default_route();
+        if (route_path && !trajectory.load(route_path)) {
+            return 1;
+        }
+        sim::fit_tile_pack_to_route(config, trajectory, margin_m);
+        sampler = sim::synthetic_basemap_color;
+    } else {
+        if (!have_nw || mpp <= 0) {
+            printf("--ppm需要--nw和--mpp\n");
+            return 1;
+        }
+        if (!sim::load_ppm(ppm_path, image)) {
+            return 1;
+        }
+        config.origin_lat = nw_lat;
+        config.origin_lon = nw_lon;
+        config.width_m = image.width * mpp;
+        config.height_m = image.height * mpp;
+        sampler = [&image, mpp](double east_m, double south_m) -> uint32_t {
+            long x = (long)std::floor(east_m / mpp);
+            long y = (long)std::floor(south_m / mpp);
+            if (x < 0 || y < 0 || x >= (long)image.width || y >= (long)image.height) {
+                return sim::kTileNoData;
+            }
+            return image.pixels[(size_t)y * image.width + x];
+        };
+    }
+
+    sim::TilePackStats stats;
+    const std::string data = sim::make_tile_pack(config, sampler, &stats);
+
+    FILE* out = std::fopen(out_path, "wb");
+    if (!out) {
+        printf("无法创建输出文件: %s\n", out_path);
+        return 1;
+    }
+    std::fwrite(data.data(), 1, data.size(), out);
+    std::fclose(out);
+
+    printf("瓦片包: 原点 %.6f,%.6f, 范围 %.0fm x %.0fm, %zu级\n", config.origin_lat, config.origin_lon,
+           config.width_m, config.height_m, config.levels_dm.size());
+    printf("瓦片 %u (空 %u, 量化 %u), 编码 %llu 字节 (RGB666 %llu, %.1f%%), 最大瓦片 %u 字节, 文件 %zu 字节\n",
+           stats.tiles, stats.empty_tiles, stats.quantized_tiles,
+           (unsigned long long)stats.encoded_bytes, (unsigned long long)stats.raw_bytes,
+           stats.raw_bytes ? 100.0 * stats.encoded_bytes / stats.raw_bytes : 0.0,
+           stats.max_tile_bytes, data.size());
+    return 0;
+}
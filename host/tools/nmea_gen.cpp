@@ -0,0 +1,162 @@
+/**
+ * @file nmea_gen.cpp
+ * @brief 合成NMEA数据流生成工具
+ *
+ * 用法示例:
+ *   nmea_gen --duration 600 --rate 10 --sats 40 --out drive.nmea
+ *   nmea_gen --duration 120 --corrupt 0.01 --burst 60:5:outage --burst 30:2:corrupt:0.8
+ *   nmea_gen --start 2025-01-01T03:00:00 --assist-segments 4 --out epo.txt
+ *                                         (生成gps_assist格式的合成辅助数据文件)
+ *   nmea_gen --geofences 300 --out fences.bin (生成gps_geofence格式的合成围栏文件)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "nmea_generator.hpp"
+
+namespace {
+
+void print_usage(const char* prog) {
+    printf("用法: %s [选项]\n", prog);
+    printf("  --duration <秒>        生成时长 (默认60)\n");
+    printf("  --rate <Hz>            输出频率 1-10 (默认1)\n");
+    printf("  --sats <N>             可见卫星总数 (默认24)\n");
+    printf("  --constellations <表>  星座列表，如 GP,GL,GA,GB,GQ (默认全部)\n");
+    printf("  --corrupt <概率>       每条语句的随机损坏概率 (默认0)\n");
+    printf("  --burst <模式>         突发 period:length[:corrupt|outage|drop[:rate[:offset]]]，可重复\n");
+    printf("  --seed <N>             随机种子 (默认1)\n");
+    printf("  --route <文件>         轨迹文件，每行 lat,lon,alt_m,speed_kmh,hold_s\n");
+    printf("  --ack-every <N>        每N个历元插入一条$PAIR001应答\n");
+    printf("  --start <时间>         起始UTC，格式YYYY-MM-DDThh:mm:ss (默认2025-01-01T00:00:00)\n");
+    printf("  --assist-segments <N>  改为输出N段合成辅助数据 (每段6小时)\n");
+    printf("  --assist-id <N>        辅助数据的$PAIR命令号 (默认470)\n");
+    printf("  --geofences <N>        改为输出N个合成地理围栏 (前6个位于轨迹航点)\n");
+    printf("  --fence-radius <米>    围栏平均半径 (默认150)\n");
+    printf("  --out <文件>           输出文件 (默认标准输出)\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    sim::GeneratorConfig config;
+    double duration_s = 60.0;
+    const char* route_path = nullptr;
+    const char* out_path = nullptr;
+    sim::AssistFileConfig assist;
+    assist.segments = 0;
+    sim::GeofenceFileConfig geofence;
+    geofence.count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--duration") == 0 && has_value) {
+            duration_s = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--rate") == 0 && has_value) {
+            config.rate_hz = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--sats") == 0 && has_value) {
+            config.satellites = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--constellations") == 0 && has_value) {
+            config.constellation_mask = sim::parse_constellation_mask(argv[++i]);
+            if (config.constellation_mask == 0) {
+                printf("无效的星座列表: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--corrupt") == 0 && has_value) {
+            config.corruption_rate = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--burst") == 0 && has_value) {
+            sim::BurstPattern burst;
+            if (!sim::parse_burst_pattern(argv[++i], burst)) {
+                printf("无效的突发模式: %s\n", argv[i]);
+                return 1;
+            }
+            config.bursts.push_back(burst);
+        } else if (std::strcmp(arg, "--seed") == 0 && has_value) {
+            config.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--route") == 0 && has_value) {
+            route_path = argv[++i];
+        } else if (std::strcmp(arg, "--ack-every") == 0 && has_value) {
+            config.pair_ack_every_epochs = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--start") == 0 && has_value && sim::parse_start_time(argv[i + 1], config)) {
+            i++;
+        } else if (std::strcmp(arg, "--assist-segments") == 0 && has_value) {
+            assist.segments = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--assist-id") == 0 && has_value) {
+            assist.pair_id = (uint16_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--geofences") == 0 && has_value) {
+            geofence.count = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--fence-radius") == 0 && has_value) {
+            geofence.radius_m = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--out") == 0 && has_value) {
+            out_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    sim::Trajectory trajectory = sim::Trajectory::default_route();
+    if (route_path && !trajectory.load(route_path)) {
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (out_path) {
+        out = std::fopen(out_path, "wb");
+        if (!out) {
+            printf("无法创建输出文件: %s\n", out_path);
+            return 1;
+        }
+    }
+
+    if (assist.segments) {
+        assist.start_utc = sim::start_utc_seconds(config);
+        assist.seed = config.seed;
+        const std::string text = sim::make_assist_file(assist);
+        std::fwrite(text.data(), 1, text.size(), out);
+        if (out != stdout) {
+            std::fclose(out);
+        }
+        std::fprintf(stderr, "辅助数据 %u 段, 每段 %u 条 $PAIR%03u, 字节 %zu\n",
+                     assist.segments, assist.satellites, (unsigned)assist.pair_id, text.size());
+        return 0;
+    }
+
+    if (geofence.count) {
+        geofence.seed = config.seed;
+        const std::string data = sim::make_geofence_file(geofence, trajectory);
+        std::fwrite(data.data(), 1, data.size(), out);
+        if (out != stdout) {
+            std::fclose(out);
+        }
+        std::fprintf(stderr, "地理围栏 %u 个, 每个 %u 个顶点, 字节 %zu\n",
+                     geofence.count, geofence.vertices, data.size());
+        return 0;
+    }
+
+    sim::NmeaGenerator gen(config, trajectory);
+    const uint64_t epochs = (uint64_t)(duration_s * gen.config().rate_hz);
+    std::string chunk;
+    for (uint64_t i = 0; i < epochs; i++) {
+        chunk.clear();
+        gen.generate_epoch(chunk);
+        std::fwrite(chunk.data(), 1, chunk.size(), out);
+    }
+
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    // 统计写到stderr，避免混入标准输出的NMEA流
+    const sim::GeneratorStats& s = gen.stats();
+    std::fprintf(stderr,
+                 "历元 %llu (丢弃 %llu, 失锁 %llu), 语句 %llu (损坏 %llu), PAIR应答 %llu, 字节 %llu\n",
+                 (unsigned long long)s.epochs, (unsigned long long)s.dropped_epochs,
+                 (unsigned long long)s.outage_epochs, (unsigned long long)s.sentences,
+                 (unsigned long long)s.corrupted, (unsigned long long)s.pair_acks,
+                 (unsigned long long)s.bytes);
+    return 0;
+}
@@ -0,0 +1,417 @@
+/**
+ * @file telemetry_rx.cpp
+ * @brief 接收并解码固件的实时定位遥测（协议见gps_telemetry.h）
+ *
+ * 打印每个定位记录，结束时统计丢帧/坏帧、缺失的历元和延迟分布：
+ * - 设备内延迟：记录中的"历元可用 -> 帧写出"（固件以上一次读空模块缓冲的时刻为起点，是上界）
+ * - 链路延迟：串口模式下设备与主机时钟不同，用最近若干帧(主机收到时刻 - 设备
+ *   发出时刻)的最小值作为时钟偏差，报告超出最小值的排队延迟；回环模式两端
+ *   共用时钟，直接得到从历元可用到主机解出记录的端到端延迟
+ *
+ * - 缺失的历元：seq只能发现已发出后丢失的帧；发出之前丢失的历元（模块缓冲
+ *   溢出等）按记录中UTC时间的间隔统计，定位频率取最小的非零间隔
+ *
+ * 帧与固件的printf文本共用串口。文本不含0x00，解码端把两个分隔符之间的文本
+ * 当作一帧读入，长度或CRC不符时丢弃并计入非帧字节，在下一个分隔符处重新同步；
+ * 串口中途打开时第一个不完整的帧同样丢弃。
+ *
+ * --loopback 不连接设备，在本进程内按实时节奏生成NMEA，经lc76g_parse_nmea_fix
+ * 解析，由适配器的历元钩子发出遥测（与固件相同），帧之间插入调试文本，
+ * 通过socketpair交给解码端。生成的历元先留在模拟的模块缓冲中，按--poll-ms
+ * 的间隔成批解析（与固件的遥测轮询相同）；延迟从上一次轮询算起，与固件的
+ * 历元钩子一致，包含历元在缓冲中等待读取的时间。
+ *
+ * 用法示例:
+ *   telemetry_rx --port /dev/ttyACM0
+ *   telemetry_rx --port /dev/ttyACM0 --quiet --seconds 600
+ *   telemetry_rx --loopback --rate 10 --seconds 30 --loss 50
+ *   telemetry_rx --loopback --rate 10 --seconds 30 --skip 20
+ *   telemetry_rx --loopback --rate 1 --poll-ms 2000    # 只在2秒GPS更新中读取时的延迟
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "pico/time.h"
+#include "nmea_generator.hpp"
+
+extern "C" {
+#include "gps/lc76g_i2c_adaptor.h"
+}
+#include "gps/gps_telemetry.h"
+
+namespace {
+
+constexpr size_t kOffsetWindow = 64;        // 估计时钟偏差的帧数
+constexpr uint32_t kDayMs = 86400000u;
+
+std::atomic<bool> g_interrupted{false};
+
+void print_usage(const char* prog) {
+    printf("用法: %s (--port <串口> | --loopback) [选项]\n", prog);
+    printf("选项:\n");
+    printf("  --seconds <秒>         接收时长 (默认一直接收，Ctrl+C结束)\n");
+    printf("  --quiet                不打印每个定位记录，只输出统计\n");
+    printf("回环模式:\n");
+    printf("  --rate <Hz>            定位频率 1-10 (默认10)\n");
+    printf("  --loss <N>             每N帧丢弃一帧（测试丢帧统计）\n");
+    printf("  --skip <N>             每N个历元不解析（测试缺失历元统计）\n");
+    printf("  --poll-ms <ms>         读取模块缓冲的间隔 (默认200，与固件TELEMETRY_POLL_INTERVAL相同；0为生成后立即解析)\n");
+}
+
+uint64_t now_us() {
+    return to_us_since_boot(get_absolute_time());
+}
+
+int open_serial(const char* path) {
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        printf("无法打开串口: %s\n", path);
+        return -1;
+    }
+    termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetspeed(&tio, B115200);      // USB CDC忽略波特率
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+// =============================================================================
+// 回环设备
+// =============================================================================
+
+struct Loopback {
+    int fd = -1;
+    uint32_t rate_hz = 10;
+    uint32_t loss_every = 0;
+    uint32_t skip_every = 0;
+    uint32_t poll_ms = 200;
+    uint32_t frames = 0;
+    uint32_t since_us = 0;          // 本批历元可用时刻的下界（上一次轮询）
+    std::atomic<bool> stop{false};
+    std::thread thread;
+};
+
+void send_all(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        length -= (size_t)n;
+    }
+}
+
+void loopback_write(void* ctx, const uint8_t* data, uint32_t length) {
+    Loopback* loop = (Loopback*)ctx;
+    if (loop->loss_every > 0 && ++loop->frames % loop->loss_every == 0) {
+        return;
+    }
+    send_all(loop->fd, data, length);
+}
+
+int start_loopback(Loopback& loop) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("socketpair失败\n");
+        return -1;
+    }
+    loop.fd = fds[1];
+
+    lc76g_i2c_init(i2c1, 6, 7, 400000, -1);
+    gps_telemetry_init(loopback_write, &loop);
+    // lc76g_parse_nmea_fix以调用时刻为起点，回环按固件的方式改为上一次轮询的时刻
+    lc76g_set_epoch_hook([](const gps_fix_t* fix, uint32_t, void* ctx) {
+        gps_telemetry_send_fix(fix, ((Loopback*)ctx)->since_us);
+    }, &loop);
+
+    loop.thread = std::thread([&loop] {
+        sim::GeneratorConfig config;
+        config.rate_hz = loop.rate_hz;
+        sim::NmeaGenerator gen(config);
+        const uint64_t interval = gen.epoch_interval_us();
+        const uint64_t poll_interval = (uint64_t)loop.poll_ms * 1000u;
+        uint64_t next_epoch = now_us();
+        uint64_t next_poll = next_epoch + poll_interval;
+        uint64_t last_poll = next_epoch;
+        std::string epoch;
+        std::string pending;        // 模块缓冲中尚未读取的历元
+        char text[96];
+        uint32_t epochs = 0;
+
+        // 解析缓冲中的全部历元，之后输出一行调试文本（与固件相同）
+        auto drain = [&](uint64_t since) {
+            if (pending.empty()) {
+                return;
+            }
+            gps_fix_t fix{};
+            loop.since_us = (uint32_t)since;
+            lc76g_parse_nmea_fix(pending.c_str(), (int)pending.size(), &fix);
+            pending.clear();
+            int n = snprintf(text, sizeof(text), "[GPS调试] 状态: %d, 纬度: %.6f, 经度: %.6f\n",
+                             gps_fix_is_valid(&fix), fix.lat_e7 * 1e-7, fix.lon_e7 * 1e-7);
+            send_all(loop.fd, (const uint8_t*)text, (size_t)n);
+        };
+
+        while (!loop.stop.load()) {
+            uint64_t now = now_us();
+            if (now >= next_epoch) {
+                epoch.clear();
+                gen.generate_epoch(epoch);
+                if (loop.skip_every == 0 || ++epochs % loop.skip_every != 0) {
+                    pending += epoch;
+                }
+                next_epoch += interval;
+                if (poll_interval == 0) {
+                    drain(now);
+                }
+            }
+            if (poll_interval > 0 && now >= next_poll) {
+                drain(last_poll);
+                last_poll = now;
+                next_poll += poll_interval;
+            }
+
+            uint64_t next = poll_interval > 0 ? std::min(next_epoch, next_poll) : next_epoch;
+            now = now_us();
+            if (next > now) {
+                std::this_thread::sleep_for(std::chrono::microseconds(next - now));
+            }
+        }
+    });
+    return fds[0];
+}
+
+void stop_loopback(Loopback& loop) {
+    if (loop.thread.joinable()) {
+        loop.stop = true;
+        loop.thread.join();
+        gps_telemetry_print_stats();
+        close(loop.fd);
+    }
+}
+
+// =============================================================================
+// 统计
+// =============================================================================
+
+/**
+ * @brief 用最近若干帧的最小(主机时刻 - 设备时刻)估计时钟偏差
+ */
+class LinkEstimator {
+public:
+    int64_t sample(uint32_t device_us, uint64_t host_us) {
+        if (have_last_ && device_us < last_device_us_) {
+            device_wraps_++;
+        }
+        have_last_ = true;
+        last_device_us_ = device_us;
+
+        int64_t device = (int64_t)((device_wraps_ << 32) | device_us);
+        int64_t offset = (int64_t)host_us - device;
+        offsets_.push_back(offset);
+        if (offsets_.size() > kOffsetWindow) {
+            offsets_.pop_front();
+        }
+        return offset - *std::min_element(offsets_.begin(), offsets_.end());
+    }
+
+private:
+    std::deque<int64_t> offsets_;
+    uint64_t device_wraps_ = 0;
+    uint32_t last_device_us_ = 0;
+    bool have_last_ = false;
+};
+
+/**
+ * @brief 按记录中的UTC时间统计缺失的历元
+ */
+class EpochGapCounter {
+public:
+    void sample(const gps_fix_t& fix) {
+        if (!(fix.flags & GPS_FIX_HAS_TIME)) {
+            return;
+        }
+        if (have_last_) {
+            steps_.push_back((fix.utc_ms + kDayMs - last_ms_) % kDayMs);
+        }
+        have_last_ = true;
+        last_ms_ = fix.utc_ms;
+    }
+
+    /**
+     * @brief 缺失的历元数，interval_ms输出推算的历元间隔
+     */
+    uint32_t missed(uint32_t* interval_ms) const {
+        uint32_t interval = 0;
+        for (uint32_t step : steps_) {
+            if (step > 0 && (interval == 0 || step < interval)) {
+                interval = step;
+            }
+        }
+        uint32_t missed = 0;
+        for (uint32_t step : steps_) {
+            if (interval > 0 && step > interval) {
+                missed += (step + interval / 2) / interval - 1;
+            }
+        }
+        *interval_ms = interval;
+        return missed;
+    }
+
+private:
+    std::vector<uint32_t> steps_;
+    uint32_t last_ms_ = 0;
+    bool have_last_ = false;
+};
+
+void print_distribution(const char* name, std::vector<uint32_t>& values) {
+    if (values.empty()) {
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    auto pct = [&values](double p) { return values[(size_t)(p * (values.size() - 1))]; };
+    printf("%s: p50 %u us, p95 %u us, p99 %u us, 最大 %u us\n", name,
+           pct(0.50), pct(0.95), pct(0.99), values.back());
+}
+
+void print_fix(const gps_telemetry_fix_t& record, uint16_t seq, uint32_t link_us) {
+    const gps_fix_t& fix = record.fix;
+    uint32_t s = fix.utc_ms / 1000;
+    printf("#%-5u %02u:%02u:%02u %s %11.7f %12.7f %8.2fm %6.2fkm/h %6.2f° 卫星%2u HDOP %.2f | 设备%6u us 链路%6u us\n",
+           seq, s / 3600, s / 60 % 60, s % 60,
+           (fix.flags & GPS_TELEMETRY_STATUS_VALID) ? "有效" : "无效",
+           fix.lat_e7 * 1e-7, fix.lon_e7 * 1e-7, fix.alt_cm * 0.01,
+           fix.speed_cms * 0.036, fix.course_cdeg * 0.01, fix.satellites, fix.hdop_c * 0.01,
+           record.latency_us, link_us);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* port = nullptr;
+    bool loopback = false;
+    bool quiet = false;
+    double seconds = 0;
+    Loopback loop;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--port") == 0 && has_value) {
+            port = argv[++i];
+        } else if (std::strcmp(arg, "--loopback") == 0) {
+            loopback = true;
+        } else if (std::strcmp(arg, "--seconds") == 0 && has_value) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--quiet") == 0) {
+            quiet = true;
+        } else if (std::strcmp(arg, "--rate") == 0 && has_value) {
+            loop.rate_hz = (uint32_t)std::min(std::max(std::atoi(argv[++i]), 1), 10);
+        } else if (std::strcmp(arg, "--loss") == 0 && has_value) {
+            loop.loss_every = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--skip") == 0 && has_value) {
+            loop.skip_every = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--poll-ms") == 0 && has_value) {
+            loop.poll_ms = (uint32_t)std::max(std::atoi(argv[++i]), 0);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!port == !loopback) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    int fd = port ? open_serial(port) : start_loopback(loop);
+    if (fd < 0) {
+        return 1;
+    }
+    std::signal(SIGINT, [](int) { g_interrupted = true; });
+
+    gps_telemetry_decoder_t decoder;
+    gps_telemetry_decoder_reset(&decoder);
+    LinkEstimator estimator;
+    EpochGapCounter gaps;
+    std::vector<uint32_t> device_latency;
+    std::vector<uint32_t> link_latency;
+    uint64_t bytes = 0;
+    const uint64_t start = now_us();
+    uint8_t buffer[4096];
+
+    while (!g_interrupted.load() && (seconds <= 0 || now_us() - start < (uint64_t)(seconds * 1e6))) {
+        pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0) {
+            continue;
+        }
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            printf("串口已断开\n");
+            break;
+        }
+        uint64_t host_us = now_us();
+        bytes += (uint64_t)n;
+
+        const uint8_t* p = buffer;
+        uint32_t left = (uint32_t)n;
+        while (left > 0) {
+            uint32_t consumed = 0;
+            gps_telemetry_fix_t fix;
+            uint16_t seq = 0;
+            bool decoded = gps_telemetry_decoder_feed(&decoder, p, left, &consumed, &fix, &seq);
+            p += consumed;
+            left -= consumed;
+            if (!decoded) {
+                continue;
+            }
+
+            // 回环模式两端共用时钟，从历元可用算起；串口模式只能得到超出最小值的部分
+            uint32_t link_us = loopback
+                ? (uint32_t)(host_us - (fix.device_time_us - fix.latency_us))
+                : (uint32_t)estimator.sample(fix.device_time_us, host_us);
+            gaps.sample(fix.fix);
+            device_latency.push_back(fix.latency_us);
+            link_latency.push_back(link_us);
+            if (!quiet) {
+                print_fix(fix, seq, link_us);
+            }
+        }
+    }
+
+    stop_loopback(loop);
+    close(fd);
+
+    double elapsed = (now_us() - start) / 1e6;
+    printf("\n接收 %.1f 秒，%llu字节，定位记录 %u帧 (%.1f帧/秒)，丢帧 %u，坏帧 %u，非帧字节 %u\n",
+           elapsed, (unsigned long long)bytes, decoder.frames, elapsed > 0 ? decoder.frames / elapsed : 0.0,
+           decoder.lost, decoder.bad_frames, decoder.junk_bytes);
+    uint32_t interval_ms = 0;
+    uint32_t missed = gaps.missed(&interval_ms);
+    // UTC间隔中的缺口包含发出后丢失的帧，扣除按seq统计的部分
+    printf("历元间隔 %u ms，缺失的历元 %u (发出之前 %u)\n", interval_ms, missed,
+           missed > decoder.lost ? missed - decoder.lost : 0u);
+    print_distribution("设备内延迟 (历元可用 -> 写出)", device_latency);
+    print_distribution(loopback ? "端到端延迟 (历元可用 -> 主机解出)" : "链路排队延迟 (超出最小值部分)",
+                       link_latency);
+    return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file bus_capture.h
+ * @brief I2C/SPI总线传输捕获 - 用于现场性能问题的记录与回放
+ *
+ * 开启LC76G_BUS_CAPTURE构建选项后，链接器通过--wrap接管
+ * i2c_write_blocking / i2c_read_blocking / spi_write_blocking /
+ * spi_read_blocking / spi_write_read_blocking，每次传输的地址、方向、
+ * 长度、起止时间和返回值写入一个固定大小的环形缓冲，可定期追加到SD卡，
+ * 在主机上用bus_replay回放。
+ *
+ * 应用在各处理阶段前后调用BUS_CAPTURE_STAGE_BEGIN/END，回放时据此
+ * 把耗时归到具体阶段（GPS读取、日志写入、渲染等）。
+ *
+ * 未开启选项时所有宏展开为空，不占用RAM和代码空间。
+ * 捕获只在单核上下文中使用，不做加锁。
+ */
+
+#ifndef BUS_CAPTURE_H
+#define BUS_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef BUS_CAPTURE_RING_RECORDS
+#define BUS_CAPTURE_RING_RECORDS 1024   // 环形缓冲记录数 (每条20字节)
+#endif
+
+#ifndef BUS_CAPTURE_MERGE_GAP_US
+#define BUS_CAPTURE_MERGE_GAP_US 20     // 同一SPI总线上间隔小于此值的连续传输合并为一条
+#endif
+
+// =============================================================================
+// 记录格式
+// =============================================================================
+
+#define BUS_CAPTURE_MAGIC   "LCBC"
+#define BUS_CAPTURE_VERSION 1
+
+enum BUS_CAPTURE_TYPE {
+    BUS_CAPTURE_I2C_WRITE   = 1,
+    BUS_CAPTURE_I2C_READ    = 2,
+    BUS_CAPTURE_SPI_WRITE   = 3,
+    BUS_CAPTURE_SPI_READ    = 4,
+    BUS_CAPTURE_SPI_XFER    = 5,
+    BUS_CAPTURE_STAGE_BEGIN = 6,
+    BUS_CAPTURE_STAGE_END   = 7,
+    BUS_CAPTURE_GAP         = 8     // 环形缓冲溢出，len为丢失的记录数
+};
+
+enum BUS_CAPTURE_STAGE {
+    BUS_STAGE_NONE          = 0,
+    BUS_STAGE_GPS_READ      = 1,    // lc76g_read_fix
+    BUS_STAGE_GPS_COMMAND   = 2,    // 发送命令/等待应答
+    BUS_STAGE_LOG_WRITE     = 3,    // GPSLogger::log_fix
+    BUS_STAGE_LOG_FLUSH     = 4,    // GPSLogger::flush_buffer 等
+    BUS_STAGE_RENDER        = 5,    // 显示刷新
+    BUS_STAGE_CAPTURE_FLUSH = 6,    // 捕获数据自身写SD（期间不记录传输）
+    BUS_STAGE_COUNT
+};
+
+/**
+ * @brief 一条捕获记录 (20字节)
+ *
+ * 传输记录: addr为I2C从机地址（SPI为0），data保存前4个字节
+ *   （I2C写为寄存器号，I2C读为长度/空闲空间等短应答；SPI不保存）。
+ * 阶段记录: addr为阶段ID，STAGE_END的dur_us为阶段耗时。
+ */
+typedef struct {
+    uint32_t t_us;          // 开始时间 (启动后微秒，32位回绕)
+    uint32_t dur_us;        // 持续时间
+    uint16_t len;           // 请求字节数 (合并记录为总数，饱和于65535)
+    uint8_t type;           // BUS_CAPTURE_TYPE
+    uint8_t bus;            // 总线索引 (i2c0/i2c1, spi0/spi1)
+    uint8_t addr;           // I2C地址或阶段ID
+    uint8_t merged;         // 额外合并的传输数 (饱和于255)
+    int16_t status;         // 返回值: >=0 实际字节数(饱和), <0 PICO_ERROR_*
+    uint8_t data[4];
+} bus_capture_record_t;
+
+/**
+ * @brief 捕获文件头（每个文件开头一份，其后是连续的记录）
+ */
+typedef struct {
+    char magic[4];          // "LCBC"
+    uint16_t version;
+    uint16_t record_size;   // sizeof(bus_capture_record_t)
+    uint32_t reserved;
+} bus_capture_file_header_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 清空环形缓冲并设置默认过滤（全部总线）
+ */
+void bus_capture_init(void);
+
+/**
+ * @brief 开始/停止记录
+ */
+void bus_capture_enable(bool enable);
+bool bus_capture_is_enabled(void);
+
+/**
+ * @brief 按总线过滤，bit n 对应 i2cN / spiN
+ */
+void bus_capture_set_filter(uint8_t i2c_mask, uint8_t spi_mask);
+
+/**
+ * @brief 标记处理阶段的开始和结束
+ */
+void bus_capture_stage_begin(uint8_t stage);
+void bus_capture_stage_end(uint8_t stage);
+
+/**
+ * @brief 缓冲中待写出的记录数
+ */
+uint32_t bus_capture_pending(void);
+
+/**
+ * @brief 启动以来因缓冲溢出丢失的记录数
+ */
+uint32_t bus_capture_dropped(void);
+
+/**
+ * @brief 把缓冲中的记录追加到SD卡文件（新文件先写文件头），成功后清空缓冲
+ * @param path FatFs路径，如 "/bus_capture.bin"
+ * @return 是否写入成功
+ */
+bool bus_capture_flush(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+// =============================================================================
+// 应用侧宏
+// =============================================================================
+
+#ifdef LC76G_BUS_CAPTURE
+#define BUS_CAPTURE_STAGE_BEGIN(stage) bus_capture_stage_begin(stage)
+#define BUS_CAPTURE_STAGE_END(stage)   bus_capture_stage_end(stage)
+#else
+#define BUS_CAPTURE_STAGE_BEGIN(stage) ((void)0)
+#define BUS_CAPTURE_STAGE_END(stage)   ((void)0)
+#endif
+
+#endif // BUS_CAPTURE_H
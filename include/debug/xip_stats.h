@@ -0,0 +1,80 @@
+/**
+ * @file xip_stats.h
+ * @brief XIP缓存命中统计 - 按处理阶段记录每帧的访问/未命中数和耗时
+ *
+ * RP2040从外部Flash经16KB的XIP缓存执行代码，字库读取和printf等大段代码
+ * 会换出热点路径，未命中时每条缓存行要经QSPI重新读取。本模块在每个阶段
+ * （一次GPS读取、一帧渲染）开始时清零XIP_CTRL的CTR_HIT/CTR_ACC计数器，
+ * 结束时读出，累计每个阶段的访问数、未命中数以及单帧最坏耗时。
+ *
+ * 硬件计数器只有一组，同一时刻只能有一个阶段在统计，阶段不能嵌套。
+ * 仅固件（xip_stats_pico.c）。
+ */
+
+#ifndef XIP_STATS_H
+#define XIP_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 阶段和统计
+// =============================================================================
+
+enum XIP_STATS_STAGE {
+    XIP_STAGE_GPS_READ  = 0,    // lc76g_read_fix
+    XIP_STAGE_RENDER    = 1,    // 一帧显示刷新
+    XIP_STAGE_COUNT
+};
+
+typedef struct {
+    uint32_t frames;
+    uint32_t last_us;           // 最近一帧耗时
+    uint32_t last_accesses;     // 最近一帧的XIP访问数
+    uint32_t last_misses;       // 最近一帧的未命中数
+    uint32_t worst_us;          // 单帧最长耗时
+    uint32_t worst_misses;      // 单帧最多未命中
+    uint32_t worst_us_misses;   // 最长那一帧的未命中数
+    uint64_t accesses;          // 累计
+    uint64_t misses;
+} xip_stage_stats_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 清零计数器，开始统计一个阶段
+ */
+void xip_stats_begin(uint8_t stage);
+
+/**
+ * @brief 读出计数器，累计到该阶段
+ */
+void xip_stats_end(uint8_t stage);
+
+/**
+ * @brief 获取某阶段的统计
+ * @return stage无效时返回false
+ */
+bool xip_stats_get(uint8_t stage, xip_stage_stats_t *stats);
+
+/**
+ * @brief 清零所有阶段的统计（例如切换测试场景前）
+ */
+void xip_stats_reset(void);
+
+/**
+ * @brief 打印各阶段的命中率和最坏耗时
+ */
+void xip_stats_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // XIP_STATS_H
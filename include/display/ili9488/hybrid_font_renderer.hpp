@@ -75,7 +75,6 @@ public:
      */
     int calculate_string_width(const char* text) const;
     
-private:
     /**
      * @brief 解码UTF-8字符
      * @param str 字符串指针（会被修改）
@@ -83,6 +82,7 @@ private:
      */
     uint32_t decode_utf8_char(const char*& str) const;
     
+private:
     /**
      * @brief 绘制ASCII字符（8x16）
      * @param display 显示驱动实例
@@ -224,6 +224,12 @@ public:
      * @param length Length of data in bytes
      */
     void writeDataBuffer(const uint8_t* data, size_t length);
+    
+    /**
+     * @brief Set drawing window and start a RAM write
+     * @note Follow with writeDataBuffer() calls carrying RGB666 bytes (3 per pixel)
+     */
+    void setAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
 
 public:
     // === Text Rendering ===
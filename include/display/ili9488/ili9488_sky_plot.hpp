@@ -0,0 +1,134 @@
+/**
+ * @file ili9488_sky_plot.hpp
+ * @brief 卫星天空图 - 极坐标显示gps_sky中各卫星的方位角/仰角，按信噪比着色
+ *
+ * 参与定位的卫星画实心标记；已跟踪但未参与定位的卫星画同色空心标记，
+ * 未跟踪的卫星画灰色空心标记。没有GSA时按是否跟踪区分。
+ *
+ * 圆心为天顶，外圈为地平线，内圈为仰角30°/60°，正北朝上（外圈顶部的小三角）。
+ * 极坐标到屏幕坐标用定点查表：方位角用Q14正弦表（0-90°，按象限对称），
+ * 仰角到半径的表在构造时按视图大小算好，运行时没有浮点和三角函数。
+ *
+ * 显示屏不能回读GRAM，标记擦除后要恢复下面的网格。网格在构造时光栅化为
+ * 按行索引的水平线段表，擦除标记时先填背景色，再只重画与标记矩形相交的
+ * 网格线段。更新时只处理位置或颜色变化的标记；被擦除区域波及、或需要
+ * 叠放到上层的相邻标记随后重画（按槽位顺序叠放，与全量重画结果一致）。
+ * 每次update()最多执行Config::budget次标记绘制/擦除（每次开销受标记面积
+ * 限制），剩余的留到下一次，40颗以上卫星同时变化时单次刷新的SPI传输量
+ * 仍有固定上限。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "ili9488_driver.hpp"
+
+extern "C" {
+#include "gps/gps_sky.h"
+}
+
+#ifndef ILI9488_SKY_PLOT_MAX_SPANS
+#define ILI9488_SKY_PLOT_MAX_SPANS 1536         // 网格线段表容量 (每条2字节)
+#endif
+
+#ifndef ILI9488_SKY_PLOT_MAX_MARKERS
+#define ILI9488_SKY_PLOT_MAX_MARKERS GPS_SKY_MAX_SATS
+#endif
+
+namespace ili9488 {
+
+class SkyPlot {
+public:
+    /**
+     * @brief 视图配置（颜色为RGB888，按RGB666写入）
+     */
+    struct Config {
+        uint16_t x = 0;                     // 外接正方形左上角
+        uint16_t y = 0;
+        uint8_t size = 160;                 // 外接正方形边长
+        uint32_t background = 0x000000;
+        uint32_t grid = 0x404040;
+        uint32_t untracked = 0x808080;      // 未跟踪卫星（空心标记）
+        uint8_t marker = 7;                 // 标记边长 (像素)
+        uint8_t budget = 12;                // 每次update()最多绘制/擦除的标记数
+    };
+
+    /**
+     * @brief 绘制统计
+     */
+    struct Stats {
+        uint32_t markers_drawn = 0;
+        uint32_t markers_erased = 0;
+        uint32_t restored_spans = 0;        // 擦除标记时重画的网格线段
+        uint32_t damaged = 0;               // 因相邻标记擦除或叠放而重画的标记
+        uint32_t deferred = 0;              // 预算用完、留到下一次的update()次数
+        uint32_t redraws = 0;
+    };
+
+    SkyPlot(ILI9488Driver& driver, const Config& config);
+
+    /**
+     * @brief 按卫星表增量更新标记
+     * @param show_used 按used标志区分参与定位的卫星（gps_sky_has_used()）
+     * @return 是否还有因预算留下的未完成更新
+     */
+    bool update(const gps_sky_sat_t* sats, uint8_t count, bool show_used = false);
+
+    /**
+     * @brief 清空视图，重画网格和全部标记
+     */
+    void redraw();
+
+    bool pending() const { return pending_; }
+
+    /**
+     * @brief 信噪比对应的标记颜色 (RGB888)，图例使用同一阈值
+     */
+    static uint32_t snrColor(uint8_t snr);
+
+    uint16_t spanCount() const { return row_start_[config_.size]; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Span {
+        uint8_t x0;                         // 相对外接正方形
+        uint8_t x1;
+    };
+
+    struct Marker {
+        uint16_t key;                       // 星座 << 8 | PRN
+        bool used;
+        bool want;                          // 目标：需要显示
+        bool drawn;                         // 屏幕上已有
+        bool damaged;                       // 被相邻标记覆盖，需要重画
+        bool hollow;                        // 已画样式
+        bool target_hollow;
+        int16_t x, y;                       // 已画位置（标记左上角，相对外接正方形）
+        int16_t target_x, target_y;
+        uint32_t color;
+        uint32_t target_color;
+    };
+
+    void buildGrid();
+    void addRowSpans(uint8_t row, Span* spans, uint8_t count);
+    void polarToPlot(int8_t elevation, uint16_t azimuth, int16_t* x, int16_t* y) const;
+    void drawMarker(Marker& marker);
+    void eraseMarker(Marker& marker);
+    bool overlaps(const Marker& marker, int32_t x, int32_t y) const;
+    void fillPlot(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    Marker* findMarker(uint16_t key);
+
+    ILI9488Driver& driver_;
+    Config config_;
+    Stats stats_;
+    bool pending_ = false;
+
+    int16_t center_;
+    uint8_t radius_[91];                    // 仰角 -> 半径 (像素)
+
+    Span spans_[ILI9488_SKY_PLOT_MAX_SPANS];
+    uint16_t row_start_[256 + 1];           // 每行网格线段在spans_中的起点
+    Marker markers_[ILI9488_SKY_PLOT_MAX_MARKERS];
+};
+
+} // namespace ili9488
@@ -0,0 +1,134 @@
+/**
+ * @file ili9488_strip_chart.hpp
+ * @brief 滚动曲线图 - 速度/海拔/信噪比等数值的历史曲线
+ *
+ * 样本按像素列抽取：每列累积Config::samples_per_column个样本，只保存
+ * 最小值、最大值和最后一个值，列环形缓冲的容量等于图宽，内存与显示时长无关。
+ *
+ * ILI9488的垂直滚动区域横跨整个面板，也不能回读GRAM做移位拷贝，所以不做
+ * 整图左移，而是按列偏移循环写入（示波器扫描式）：第i列固定画在屏幕第
+ * i % width列，最新列前方留Config::gap列空白作为扫描位置标记。每个样本
+ * 只重写最新一列（列完成后再清空前方一列），每列是一次窗口设置加
+ * height×3字节，CPU和SPI开销与图宽、历史长度无关。
+ *
+ * 纵轴范围固定，或在range_step>0时自动调整：第一个样本把纵轴平移到包含它的
+ * 步长格（网格与数值无关，不需重画），之后按步长向外扩展以包含新样本
+ * （只扩不缩），扩展后全量重画一次。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "ili9488_driver.hpp"
+
+#ifndef ILI9488_STRIP_CHART_MAX_COLUMNS
+#define ILI9488_STRIP_CHART_MAX_COLUMNS 240     // 图宽上限 (每列12字节)
+#endif
+
+#ifndef ILI9488_STRIP_CHART_MAX_HEIGHT
+#define ILI9488_STRIP_CHART_MAX_HEIGHT 128      // 图高上限 (列缓冲每像素3字节)
+#endif
+
+namespace ili9488 {
+
+class StripChart {
+public:
+    /**
+     * @brief 图表配置（颜色为RGB888，按RGB666写入）
+     */
+    struct Config {
+        uint16_t x = 0;
+        uint16_t y = 0;
+        uint16_t width = 200;               // 列数
+        uint16_t height = 48;
+        uint32_t background = 0x000000;
+        uint32_t grid = 0x404040;
+        uint32_t line = 0x00FFFF;
+        uint8_t grid_divisions = 4;         // 水平网格线把纵轴分成的格数，0为不画
+        uint8_t samples_per_column = 1;     // 每列抽取的样本数
+        uint8_t gap = 4;                    // 最新列前方的空白列数 (至少1)
+        float min_value = 0.0f;
+        float max_value = 100.0f;
+        float range_step = 0.0f;            // 自动扩展纵轴的步长，0为固定范围
+    };
+
+    /**
+     * @brief 绘制统计
+     */
+    struct Stats {
+        uint32_t samples = 0;
+        uint32_t columns_drawn = 0;         // 写入的列数（含清空的空白列）
+        uint32_t redraws = 0;
+        uint32_t rescales = 0;              // 纵轴扩展次数
+    };
+
+    StripChart(ILI9488Driver& driver, const Config& config);
+
+    /**
+     * @brief 加入一个样本（只记录，绘制在update()中）
+     */
+    void push(float value);
+
+    /**
+     * @brief 画出上次绘制后变化的列；纵轴扩展或积压超过一屏时全量重画
+     * @return 是否绘制了内容
+     */
+    bool update();
+
+    /**
+     * @brief 按列缓冲全量重画（切换到图表视图时调用）
+     */
+    void redraw();
+
+    /**
+     * @brief 清空历史样本（下一次update()重画）
+     */
+    void clear();
+
+    bool empty() const { return samples_ == 0; }
+    float last() const { return last_; }
+    float minValue() const { return min_value_; }
+    float maxValue() const { return max_value_; }
+
+    /**
+     * @brief 图表覆盖的时长（样本数）
+     */
+    uint32_t spanSamples() const;
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Column {
+        float min;
+        float max;
+        float last;
+    };
+
+    bool visible(uint32_t column) const;
+    int32_t valueRow(float value) const;
+    void expandRange(float value);
+    void buildTemplate();
+    void drawColumn(uint32_t column);
+    void writeColumn(uint16_t screen_x, int32_t top, int32_t bottom);
+
+    ILI9488Driver& driver_;
+    Config config_;
+    Stats stats_;
+
+    float min_value_;
+    float max_value_;
+    float row_scale_;                       // (height-1) / (max-min)
+    float last_ = 0.0f;
+
+    uint32_t head_ = 0;                     // 最新列的序号（单调递增）
+    uint8_t samples_ = 0;                   // 最新列已有的样本数
+    uint32_t drawn_head_ = 0;               // 上次绘制时的head_/samples_
+    uint8_t drawn_samples_ = 0;
+    bool needs_redraw_ = true;
+
+    Column columns_[ILI9488_STRIP_CHART_MAX_COLUMNS];   // 第i列存于columns_[i % width]
+    uint8_t template_[ILI9488_STRIP_CHART_MAX_HEIGHT * 3];  // 空列：背景和网格
+    uint8_t column_[ILI9488_STRIP_CHART_MAX_HEIGHT * 3];
+};
+
+} // namespace ili9488
@@ -0,0 +1,211 @@
+/**
+ * @file ili9488_tile_map.hpp
+ * @brief 离线底图 - 从SD卡瓦片包解码并直接写入显示屏
+ *
+ * 瓦片包由主机工具map_tiler生成（默认TileMap::DEFAULT_PATH），小端二进制：
+ *
+ *   TilePackHeader                          文件头，原点为所有级别像素(0,0)的西北角
+ *   TilePackLevel × level_count             每级比例尺和瓦片行列数
+ *   每级: TilePackTile × cols × rows         瓦片索引（按行），length为0表示空瓦片
+ *   瓦片数据，不超过512字节的瓦片不跨扇区，更大的从扇区边界开始
+ *
+ * 瓦片像素以原点为切点的局部东北平面排列（与gps_track一致），每级比例尺与
+ * TrackView的缩放级别对应。瓦片数据为调色板+游程编码：
+ *
+ *   uint8_t  颜色数-1
+ *   uint8_t  调色板[颜色数][3]              RGB666字节（低2位为0，可直接发送）
+ *   { uint8_t 游程-1, uint8_t 颜色索引 }...  按行扫描覆盖tile_size²个像素
+ *
+ * 绘制时瓦片数据一次f_read读入SRAM瓦片缓存（环形区，按插入顺序淘汰），
+ * 按行解码到暂存行缓冲后直接写入显示窗口，没有整块RGB缓冲。先画缓存中
+ * 已有的瓦片再读缺失的，平移后只有新露出的瓦片需要读SD卡。
+ * 超过缓存1/4的瓦片不进缓存，按扇区边读边解码。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "ili9488_driver.hpp"
+#include "ff.h"
+
+#ifndef ILI9488_TILE_CACHE_BYTES
+#define ILI9488_TILE_CACHE_BYTES 32768          // 瓦片缓存大小
+#endif
+
+#ifndef ILI9488_TILE_CACHE_ENTRIES
+#define ILI9488_TILE_CACHE_ENTRIES 48           // 缓存瓦片数上限
+#endif
+
+#ifndef ILI9488_TILE_INDEX_MAX
+#define ILI9488_TILE_INDEX_MAX 1024             // 常驻RAM的瓦片索引条数 (每条8字节)，超出时按需读取
+#endif
+
+#ifndef ILI9488_TILE_WINDOW
+#define ILI9488_TILE_WINDOW 64                  // 索引不常驻时，一次绘制可读入的可见瓦片索引数
+#endif
+
+#ifndef ILI9488_TILE_MAX_SIZE
+#define ILI9488_TILE_MAX_SIZE 64                // 瓦片边长上限 (像素)
+#endif
+
+namespace ili9488 {
+
+// =============================================================================
+// 文件格式
+// =============================================================================
+
+constexpr uint32_t TILE_PACK_MAGIC = 0x4C49544Du;      // "MTIL"
+constexpr uint16_t TILE_PACK_VERSION = 1;
+constexpr uint32_t TILE_PACK_ALIGN = 512;
+constexpr uint16_t TILE_PACK_MAX_LEVELS = 16;
+
+/**
+ * @brief 文件头 (32字节)
+ */
+struct TilePackHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t tile_size;
+    int32_t origin_lat_e7;      // 原点 (1e-7度)
+    int32_t origin_lon_e7;
+    uint16_t level_count;
+    uint16_t reserved0;
+    uint32_t reserved[3];
+};
+
+/**
+ * @brief 级别描述 (16字节)
+ */
+struct TilePackLevel {
+    uint32_t dm_per_pixel;      // 比例尺 (分米/像素)
+    uint16_t cols;
+    uint16_t rows;
+    uint32_t index_offset;      // 瓦片索引在文件中的偏移
+    uint32_t reserved;
+};
+
+/**
+ * @brief 瓦片索引 (8字节)
+ */
+struct TilePackTile {
+    uint32_t offset;
+    uint32_t length;            // 0表示空瓦片（画背景色）
+};
+
+static_assert(sizeof(TilePackHeader) == 32, "TilePackHeader必须为32字节");
+static_assert(sizeof(TilePackLevel) == 16, "TilePackLevel必须为16字节");
+static_assert(sizeof(TilePackTile) == 8, "TilePackTile必须为8字节");
+
+// =============================================================================
+// 渲染器
+// =============================================================================
+
+class TileMap {
+public:
+    static constexpr const char* DEFAULT_PATH = "/maps/basemap.bin";
+
+    /**
+     * @brief 绘制和读取统计
+     */
+    struct Stats {
+        uint32_t tiles_drawn = 0;
+        uint32_t empty_tiles = 0;           // 空瓦片或超出范围（画背景色）
+        uint32_t cache_hits = 0;
+        uint32_t sd_reads = 0;              // 读取瓦片数据的次数
+        uint32_t sd_bytes = 0;
+        uint32_t index_reads = 0;           // 级别索引不常驻时读取索引的次数（每个可见瓦片行一次）
+        uint32_t streamed_tiles = 0;        // 超过缓存上限、边读边解码的瓦片
+        uint32_t decode_errors = 0;
+    };
+
+    explicit TileMap(ILI9488Driver& driver);
+    ~TileMap();
+
+    /**
+     * @brief 打开瓦片包（需已挂载FatFs）
+     * @return 是否打开成功
+     */
+    bool open(const char* path);
+    void close();
+    bool isOpen() const { return open_; }
+
+    /**
+     * @brief 查找比例尺为dm_per_pixel的级别
+     * @return 级别序号，没有时返回-1
+     */
+    int findLevel(uint32_t dm_per_pixel) const;
+
+    /**
+     * @brief 瓦片包原点（像素(0,0)的西北角）
+     */
+    void origin(double* lat, double* lon) const;
+
+    /**
+     * @brief 在屏幕矩形内绘制底图
+     * @param level 级别序号
+     * @param map_x 屏幕矩形左上角对应的级别像素坐标（可为负或超出范围）
+     * @param map_y 同上
+     * @param background 空瓦片和范围外区域的颜色 (RGB888)
+     */
+    void draw(int level, int32_t map_x, int32_t map_y,
+              uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t background);
+
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = Stats(); }
+
+    /**
+     * @brief 清空瓦片缓存
+     */
+    void flushCache();
+
+private:
+    struct CacheEntry {
+        uint32_t key;               // 级别 << 24 | 行 << 12 | 列
+        uint32_t offset;            // 在cache_中的偏移
+        uint32_t length;
+        bool valid;
+    };
+
+    /**
+     * @brief 逐字节读取瓦片数据：内存中的缓存块或按扇区读取的文件
+     */
+    struct ByteSource {
+        const uint8_t* ptr;
+        const uint8_t* end;
+        uint32_t file_remaining;    // 仍需从文件读取的字节数 (流式)
+    };
+
+    bool loadLevel(int level);
+    bool tileEntry(int level, uint32_t col, uint32_t row, TilePackTile* tile);
+    const CacheEntry* findCached(uint32_t key) const;
+    const uint8_t* cacheInsert(uint32_t key, uint32_t length);
+    bool nextByte(ByteSource& source, uint8_t* byte);
+    bool decodeTile(ByteSource& source, uint16_t x, uint16_t y,
+                    uint32_t col0, uint32_t row0, uint32_t col1, uint32_t row1);
+    void drawTile(uint32_t key, const TilePackTile& tile,
+                  uint16_t x, uint16_t y, uint32_t col0, uint32_t row0, uint32_t col1, uint32_t row1,
+                  uint32_t background);
+
+    ILI9488Driver& driver_;
+    Stats stats_;
+
+    FIL file_;
+    bool open_ = false;
+    TilePackHeader header_ = {};
+    TilePackLevel levels_[TILE_PACK_MAX_LEVELS] = {};
+
+    int index_level_ = -1;                  // index_中常驻的级别
+    TilePackTile index_[ILI9488_TILE_INDEX_MAX];
+    TilePackTile window_[ILI9488_TILE_WINDOW];     // 非常驻级别的可见瓦片索引
+
+    uint8_t cache_[ILI9488_TILE_CACHE_BYTES];
+    CacheEntry entries_[ILI9488_TILE_CACHE_ENTRIES] = {};
+    uint32_t cache_head_ = 0;               // 下一次插入位置
+    uint32_t next_entry_ = 0;
+
+    uint8_t sector_[TILE_PACK_ALIGN];       // 流式读取缓冲
+    uint8_t palette_[256][3];
+    uint8_t rows_[ILI9488_TILE_MAX_SIZE * 8 * 3];   // 暂存行缓冲（最多8行一次写出）
+};
+
+} // namespace ili9488
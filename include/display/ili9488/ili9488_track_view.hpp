@@ -0,0 +1,126 @@
+/**
+ * @file ili9488_track_view.hpp
+ * @brief 轨迹地图视图 - 在屏幕矩形区域内增量绘制gps_track轨迹
+ *
+ * 显示屏没有帧缓冲，也不能回读GRAM，所以绘制分两种：
+ *
+ * - 增量：每次有新轨迹点时只画新增的线段。最新一段用高亮色表示当前
+ *   位置，下一段到来时把它重画为轨迹色。开销只与新线段长度有关。
+ * - 全量：只在平移、缩放或重新显示时清空视口并从轨迹存储重画。相邻点
+ *   投影到同一像素时跳过，开销受视口像素数限制，与轨迹点数基本无关。
+ *
+ * 最新点离开视口内框时自动平移：沿越界方向把视口中心移到最新点前方
+ * 1/4视口处，下一次平移前还能走3/4个视口。ILI9488的垂直滚动区域横跨
+ * 整个面板（会带动左侧信息栏），也不能回读GRAM做移位拷贝，平移只能全量重画。
+ *
+ * 线段按水平/垂直游程合并为fillAreaRGB666，一条n像素的斜线只需约
+ * min(|dx|,|dy|)+1次窗口设置，而不是n次单像素写入。
+ *
+ * 设置了底图（TileMap）且有与当前比例尺相同的级别时，全量重画以底图代替
+ * 背景色填充；底图原点按gps_track的投影换算到视口像素。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "ili9488_driver.hpp"
+#include "ili9488_tile_map.hpp"
+
+extern "C" {
+#include "gps/gps_track.h"
+}
+
+namespace ili9488 {
+
+class TrackView {
+public:
+    /**
+     * @brief 视图配置（颜色为RGB888，按RGB666写入）
+     */
+    struct Config {
+        uint16_t x = 0;
+        uint16_t y = 0;
+        uint16_t width = 240;
+        uint16_t height = 200;
+        uint32_t background = 0x000000;
+        uint32_t trail = 0x00FFFF;          // 轨迹
+        uint32_t head = 0xFFFF00;           // 最新一段
+        uint32_t scale = 0x808080;          // 比例尺
+        uint8_t line_width = 2;
+        uint8_t pan_margin = 16;            // 最新点离边缘小于该值时平移
+    };
+
+    /**
+     * @brief 绘制统计
+     */
+    struct Stats {
+        uint32_t segments = 0;              // 绘制的线段数
+        uint32_t spans = 0;                 // fillArea调用次数
+        uint32_t redraws = 0;               // 全量重画次数
+        uint32_t pans = 0;                  // 自动平移次数
+        uint32_t skipped_points = 0;        // 全量重画时与前一点同像素而跳过的点
+    };
+
+    TrackView(ILI9488Driver& driver, const Config& config);
+
+    /**
+     * @brief 每次定位后调用，有新轨迹点时增量绘制或平移后重画
+     * @return 是否绘制了内容
+     */
+    bool update();
+
+    /**
+     * @brief 清空视口并从轨迹存储全量重画（切换到地图视图时调用）
+     */
+    void redraw();
+
+    /**
+     * @brief 缩放级别，0为最大比例尺
+     */
+    void setZoomLevel(uint8_t level);
+    uint8_t zoomLevel() const { return zoom_level_; }
+    uint8_t zoomLevelCount() const;
+
+    /**
+     * @brief 当前比例尺 (分米/像素)
+     */
+    uint32_t decimetersPerPixel() const;
+
+    /**
+     * @brief 设置底图（nullptr取消），下一次全量重画生效
+     */
+    void setBasemap(TileMap* basemap) { basemap_ = basemap; }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Pixel {
+        int32_t x;
+        int32_t y;
+    };
+
+    Pixel project(const gps_track_point_t& point) const;
+    bool needsPan(const Pixel& pixel) const;
+    void panTo(const gps_track_point_t& point, const Pixel& pixel);
+    void drawSegment(Pixel a, Pixel b, uint32_t color);
+    void drawSpan(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawScaleBar();
+    void drawBackground();
+
+    ILI9488Driver& driver_;
+    Config config_;
+    Stats stats_;
+    TileMap* basemap_ = nullptr;
+
+    uint8_t zoom_level_;
+    bool has_center_ = false;
+    int32_t center_e_dm_ = 0;
+    int32_t center_n_dm_ = 0;
+
+    uint32_t drawn_appended_ = 0;           // 已绘制到的gps_track_appended()
+    bool has_head_ = false;
+    gps_track_point_t head_from_ = {0, 0};  // 高亮中的最新一段
+    gps_track_point_t head_to_ = {0, 0};
+};
+
+} // namespace ili9488
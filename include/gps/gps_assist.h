@@ -0,0 +1,93 @@
+/**
+ * @file gps_assist.h
+ * @brief GPS辅助数据(EPO)注入 - 从SD卡读取星历文件缩短冷启动TTFF
+ *
+ * 辅助数据文件由下载服务生成（离线时可直接拷贝到SD卡），为文本格式：
+ *
+ *   # 注释
+ *   #SEG,<起始UTC>,<结束UTC>       一段星历的有效期（1970-01-01起的秒）
+ *   $PAIRnnn,...*HH                 该段的厂商辅助命令，每行一条
+ *
+ * 加载时跳过已过期的段，最多注入GPS_ASSIST_MAX_SEGMENTS段。每条命令校验
+ * 校验和后通过lc76g_i2c_adaptor写入（按QL_CW_REG报告的空闲空间分块），
+ * 并等待对应的$PAIR001应答：处理中则继续等待，忙则重试，不支持则中止。
+ *
+ * 当前时间未知时从文件第一段开始注入。接收机从首颗卫星解出时间只需数秒，
+ * 之后即可使用注入的星历，省去逐颗卫星下载星历的30秒以上。
+ */
+
+#ifndef GPS_ASSIST_H
+#define GPS_ASSIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef GPS_ASSIST_MAX_SEGMENTS
+#define GPS_ASSIST_MAX_SEGMENTS 4           // 最多注入的段数 (EPO每段6小时)
+#endif
+
+#ifndef GPS_ASSIST_MAX_LINE
+#define GPS_ASSIST_MAX_LINE 256             // 单行最大长度，超长行视为格式错误
+#endif
+
+#ifndef GPS_ASSIST_ACK_TIMEOUT_MS
+#define GPS_ASSIST_ACK_TIMEOUT_MS 1000      // 单条命令等待应答的时间
+#endif
+
+#ifndef GPS_ASSIST_MAX_RETRIES
+#define GPS_ASSIST_MAX_RETRIES 3            // 超时或模块忙时的重试次数
+#endif
+
+#define GPS_ASSIST_DEFAULT_PATH "/gps_assist/epo.txt"
+
+// =============================================================================
+// 数据结构
+// =============================================================================
+
+/**
+ * @brief 一次加载的结果
+ */
+typedef struct {
+    uint32_t segments;          // 注入的段数
+    uint32_t expired_segments;  // 已过期跳过的段数
+    uint32_t sentences;         // 发送的命令数（不含重试）
+    uint32_t acked;             // 应答成功的命令数
+    uint32_t failed;            // 应答失败或重试用尽的命令数
+    uint32_t retries;
+    uint32_t invalid_lines;     // 格式或校验和错误的行
+    uint32_t bytes;             // 写入模块的字节数
+    uint32_t elapsed_ms;
+    bool unsupported;           // 模块不支持该命令，已中止
+} gps_assist_result_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 把SD卡上的辅助数据文件注入模块（需已挂载FatFs并初始化lc76g_i2c_adaptor）
+ * @param path FatFs路径，如GPS_ASSIST_DEFAULT_PATH
+ * @param utc_now 当前UTC秒，0表示未知
+ * @param result 输出加载统计，可为NULL
+ * @return 是否至少有一条命令被模块接受且未中止
+ */
+bool gps_assist_load_file(const char *path, uint32_t utc_now, gps_assist_result_t *result);
+
+/**
+ * @brief 打印加载统计
+ */
+void gps_assist_print_result(const gps_assist_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_ASSIST_H
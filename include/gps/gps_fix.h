@@ -0,0 +1,131 @@
+/**
+ * @file gps_fix.h
+ * @brief 紧凑的定点定位记录 - 解析器、日志、UI之间传递的定位数据
+ *
+ * LC76G_GPS_Data/GNRMC以double为主，约140字节，每个历元在解析、复制、比较时
+ * 要搬运多个cache行，RP2040（无FPU）上每个double运算都是软件库调用。
+ * gps_fix_t全部为定点整数，32字节，按自然对齐排列（无填充，不使用packed，
+ * Cortex-M0+不支持非对齐访问），解析器（gps_nmea.h）直接从NMEA文本得到定点值，
+ * 不经过double。
+ *
+ * 精度：坐标1e-7度（约1.1厘米），海拔1厘米，速度1厘米/秒，航向和DOP为0.01。
+ * 与旧结构的转换：gps_fix_t -> 旧结构 -> gps_fix_t 除UTC的毫秒外无损（旧结构
+ * 的时间只到秒）；旧结构 -> gps_fix_t 按上述精度取整。
+ */
+
+#ifndef GPS_FIX_H
+#define GPS_FIX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 定位记录
+// =============================================================================
+
+// 旧结构的Time_H为北京时间 (UTC+8)，gps_fix_t中为UTC
+#define GPS_FIX_LOCAL_UTC_OFFSET_HOURS  8
+
+enum GPS_FIX_FLAG {
+    GPS_FIX_VALID           = 0x01,     // 定位有效（旧结构的Status==1）
+    GPS_FIX_HAS_TIME        = 0x02,     // utc_ms有效
+    GPS_FIX_HAS_POSITION    = 0x04      // 收到过坐标（失锁后保留上一次的坐标）
+};
+
+/**
+ * @brief 定位记录 (32字节)
+ */
+typedef struct gps_fix {
+    int32_t lat_e7;             // 纬度 (1e-7度，北正南负)
+    int32_t lon_e7;             // 经度 (1e-7度，东正西负)
+    int32_t alt_cm;             // 海拔 (厘米)
+    uint32_t utc_ms;            // UTC时刻 (当日毫秒)
+    uint16_t utc_date;          // UTC日期，FAT格式: (年-1980)<<9 | 月<<5 | 日，0表示未知
+    uint16_t speed_cms;         // 速度 (厘米/秒)
+    uint16_t course_cdeg;       // 航向 (0.01度，0-35999)
+    uint16_t hdop_c;            // HDOP (0.01)，0表示未知
+    uint16_t pdop_c;
+    uint16_t vdop_c;
+    uint8_t flags;              // GPS_FIX_*
+    uint8_t quality;            // GGA质量指示
+    uint8_t satellites;         // 使用的卫星数
+    char mode;                  // RMC模式指示 ('A'/'D'/'N'...)，0表示未知
+} gps_fix_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(gps_fix_t) == 32, "gps_fix_t必须为32字节");
+#else
+_Static_assert(sizeof(gps_fix_t) == 32, "gps_fix_t必须为32字节");
+#endif
+
+static inline bool gps_fix_is_valid(const gps_fix_t *fix) {
+    return (fix->flags & GPS_FIX_VALID) != 0;
+}
+
+/**
+ * @brief 速度 (公里/小时)
+ */
+static inline float gps_fix_speed_kmh(const gps_fix_t *fix) {
+    return fix->speed_cms * 0.036f;
+}
+
+/**
+ * @brief 北京时间的时分秒（与旧结构的Time_H/M/S一致）
+ */
+static inline void gps_fix_local_hms(const gps_fix_t *fix, uint8_t *hour, uint8_t *minute, uint8_t *second) {
+    uint32_t s = fix->utc_ms / 1000u;
+    *hour = (uint8_t)((s / 3600u + GPS_FIX_LOCAL_UTC_OFFSET_HOURS) % 24u);
+    *minute = (uint8_t)(s / 60u % 60u);
+    *second = (uint8_t)(s % 60u);
+}
+
+/**
+ * @brief UTC日期拆分为年月日
+ * @return utc_date为0时返回false
+ */
+bool gps_fix_date(const gps_fix_t *fix, uint16_t *year, uint8_t *month, uint8_t *day);
+
+// =============================================================================
+// 坐标系转换
+// =============================================================================
+
+#ifndef GPS_COORDINATES_DEFINED
+#define GPS_COORDINATES_DEFINED
+typedef struct {
+    double Lon;         // 经度
+    double Lat;         // 纬度
+} Coordinates;
+#endif
+
+/**
+ * @brief WGS-84 -> GCJ-02（高德/谷歌中国地图）
+ */
+Coordinates gps_fix_to_gcj02(const gps_fix_t *fix);
+
+/**
+ * @brief WGS-84 -> BD-09（百度地图）
+ */
+Coordinates gps_fix_to_bd09(const gps_fix_t *fix);
+
+// =============================================================================
+// 与旧结构的转换
+// =============================================================================
+
+struct LC76G_GPS_Data;
+struct GNRMC;
+
+void gps_fix_from_lc76g(const struct LC76G_GPS_Data *data, gps_fix_t *fix);
+void gps_fix_to_lc76g(const gps_fix_t *fix, struct LC76G_GPS_Data *data);
+
+void gps_fix_from_gnrmc(const struct GNRMC *data, gps_fix_t *fix);
+void gps_fix_to_gnrmc(const gps_fix_t *fix, struct GNRMC *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_FIX_H
@@ -0,0 +1,79 @@
+/**
+ * @file gps_flash_log.h
+ * @brief Flash追加记录环 - 启动状态和里程等小块状态的掉电保存
+ *
+ * 在连续的若干个扇区中按顺序追加定长记录，写满一个扇区后擦除下一个扇区
+ * 继续写（磨损均衡），载入时取序号最大的有效记录。最新记录所在的扇区
+ * 不会被擦除，写入过程中掉电最多丢失正在写的一条。
+ *
+ * 记录以gps_flash_log_header_t开头、以CRC32结尾，长度须整除FLASH_PAGE_SIZE。
+ * Flash擦写期间关闭中断，只在单核上下文中使用。
+ */
+
+#ifndef GPS_FLASH_LOG_H
+#define GPS_FLASH_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 记录头（每种记录的前12字节）
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;             // 由使用者定义
+    uint32_t seq;               // 写入序号，越大越新
+} gps_flash_log_header_t;
+
+/**
+ * @brief 记录环描述和运行状态
+ */
+typedef struct {
+    // 配置
+    uint32_t flash_offset;      // 区域起始（相对Flash起始，扇区对齐）
+    uint32_t sectors;           // 轮换扇区数，至少2个
+    uint32_t record_size;       // 记录长度（含头和CRC）
+    uint32_t magic;
+    uint16_t version;
+
+    // 运行状态
+    int32_t latest_slot;        // 最新记录所在槽位，-1表示没有
+    uint32_t next_slot;
+} gps_flash_log_t;
+
+/**
+ * @brief 扫描区域，把最新的有效记录拷贝到record
+ * @return 是否找到有效记录
+ */
+bool gps_flash_log_load(gps_flash_log_t *log, void *record);
+
+/**
+ * @brief 追加一条记录：填写magic/version、序号加1、计算CRC后写入并校验
+ * @param record 记录内容，头和CRC字段由本函数更新
+ * @return 是否写入成功
+ */
+bool gps_flash_log_append(gps_flash_log_t *log, void *record);
+
+/**
+ * @brief 最新记录所在槽位（-1表示没有）
+ */
+static inline int32_t gps_flash_log_latest_slot(const gps_flash_log_t *log) {
+    return log->latest_slot;
+}
+
+/**
+ * @brief CRC32 (IEEE 802.3)
+ */
+uint32_t gps_flash_log_crc32(const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_FLASH_LOG_H
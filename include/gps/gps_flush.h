@@ -0,0 +1,159 @@
+/**
+ * @file gps_flush.h
+ * @brief 日志刷新控制器 - 按实测SD卡写入耗时决定何时、写多少
+ *
+ * 固定的条数/间隔/80%缓冲阈值不随SD卡速度和定位频率变化：慢卡上一次刷新
+ * 可能阻塞显示和GPS读取数百毫秒，快速定位时又频繁写入不满一个扇区的数据。
+ * 本模块按以下规则决定每次刷新的字节数：
+ *
+ * - 期限：最早一条未写入记录的等待时间加上预计写入耗时达到数据风险窗口
+ *   （max_at_risk_ms）时写出全部数据
+ * - 缓冲将满：写出到扇区边界为止的数据（不足一个扇区时全部写出）
+ * - 空闲：调用方给出的空闲时间容得下预计耗时、且到扇区边界的数据达到
+ *   目标批量时写出。目标批量为GPS_FLUSH_MAX_LATENCY_US内能写完的扇区数
+ *
+ * 扇区边界按文件中的位置计算，刷新结束于扇区边界时下一次写入不需要FatFs
+ * 先读回不完整的扇区。每扇区耗时按实测值滑动平均（换卡后调用reset重新学习），
+ * 预计耗时取平均值加两倍平均偏差。
+ *
+ * 统计每次刷新的耗时、写出数据中最早一条等待的时间（数据风险窗口）和
+ * 刷新前缓冲的字节数，用对数分桶直方图给出分位数（误差不超过25%）。
+ * 记录时间用固定大小的数组保存，不分配内存。
+ */
+
+#ifndef GPS_FLUSH_H
+#define GPS_FLUSH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef GPS_FLUSH_SECTOR_SIZE
+#define GPS_FLUSH_SECTOR_SIZE 512
+#endif
+
+#ifndef GPS_FLUSH_MAX_LATENCY_US
+#define GPS_FLUSH_MAX_LATENCY_US 20000          // 空闲时一次刷新的目标耗时上限
+#endif
+
+#ifndef GPS_FLUSH_INITIAL_SECTOR_US
+#define GPS_FLUSH_INITIAL_SECTOR_US 5000        // 还没有实测值时的每扇区耗时
+#endif
+
+#ifndef GPS_FLUSH_MAX_RECORDS
+#define GPS_FLUSH_MAX_RECORDS 64                // 缓冲中可单独跟踪时间的记录数
+#endif
+
+#define GPS_FLUSH_HIST_BUCKETS 96               // 每个2倍区间4个桶，覆盖0到约3.3e7
+
+// =============================================================================
+// 刷新原因和统计
+// =============================================================================
+
+enum GPS_FLUSH_REASON {
+    GPS_FLUSH_NONE      = 0,
+    GPS_FLUSH_DEADLINE  = 1,    // 到达数据风险窗口
+    GPS_FLUSH_FULL      = 2,    // 缓冲将满
+    GPS_FLUSH_SLACK     = 3,    // 空闲时写出整扇区批量
+    GPS_FLUSH_FORCED    = 4,    // 调用方要求（事件、关闭文件）
+    GPS_FLUSH_REASON_COUNT
+};
+
+typedef struct {
+    uint32_t flushes;
+    uint32_t by_reason[GPS_FLUSH_REASON_COUNT];
+    uint32_t failures;
+    uint32_t aligned;               // 结束于扇区边界的刷新
+    uint64_t bytes;
+    uint32_t sector_us;             // 当前每扇区耗时估计
+    uint32_t flush_us_max;
+    uint32_t at_risk_ms_max;
+    uint32_t at_risk_bytes_max;
+    uint32_t flush_us_hist[GPS_FLUSH_HIST_BUCKETS];
+    uint32_t at_risk_ms_hist[GPS_FLUSH_HIST_BUCKETS];
+    uint32_t at_risk_bytes_hist[GPS_FLUSH_HIST_BUCKETS];
+} gps_flush_stats_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 清除缓冲中的记录、耗时估计和统计
+ * @param max_at_risk_ms 数据风险窗口
+ * @param capacity 写入缓冲容量 (字节)
+ */
+void gps_flush_reset(uint32_t max_at_risk_ms, uint32_t capacity);
+
+/**
+ * @brief 登记一条进入缓冲的记录
+ */
+void gps_flush_record(uint32_t bytes, uint32_t now_ms);
+
+/**
+ * @brief 计划本次刷新的字节数
+ * @param file_size 缓冲之前已写入文件的字节数（决定扇区边界）
+ * @param slack_us 调用方此刻的空闲时间，0表示没有空闲（只检查期限和缓冲将满）
+ * @param reason 输出GPS_FLUSH_*，可为NULL
+ * @return 应从缓冲开头写出的字节数，0表示暂不刷新
+ */
+uint32_t gps_flush_plan(uint32_t now_ms, uint32_t file_size, uint32_t slack_us, uint8_t *reason);
+
+/**
+ * @brief 缓冲开头一段属于另一个文件时计划刷新（日志轮转后，旧文件的记录还在缓冲中）
+ *
+ * 开头head_bytes字节按head_file_size计算扇区边界和耗时，写完整段即视为边界
+ * （该文件不再追加）；其余按file_size计算。head_bytes为0时与gps_flush_plan相同。
+ * @param head_file_size 开头一段所属文件已写入的字节数
+ * @param head_bytes 开头一段的字节数（超过缓冲中的字节数时按缓冲截断）
+ * @param file_size 当前文件已写入的字节数
+ */
+uint32_t gps_flush_plan_split(uint32_t now_ms, uint32_t head_file_size, uint32_t head_bytes,
+                              uint32_t file_size, uint32_t slack_us, uint8_t *reason);
+
+/**
+ * @brief 预计写出bytes字节的耗时 (微秒)
+ */
+uint32_t gps_flush_estimate_us(uint32_t file_size, uint32_t bytes);
+
+/**
+ * @brief 登记一次成功的刷新：更新耗时估计和统计，移除已写出的记录
+ * @param file_size 写出之前文件的字节数
+ */
+void gps_flush_done(uint32_t now_ms, uint32_t file_size, uint32_t bytes, uint32_t elapsed_us, uint8_t reason);
+
+/**
+ * @brief 登记一次失败的刷新（缓冲保持不变）
+ */
+void gps_flush_failed(void);
+
+/**
+ * @brief 缓冲中的字节数
+ */
+uint32_t gps_flush_pending(void);
+
+void gps_flush_get_stats(gps_flush_stats_t *stats);
+
+/**
+ * @brief 直方图的分位数（所在桶的上界）
+ * @param permille 例如500为中位数，990为p99
+ */
+uint32_t gps_flush_percentile(const uint32_t *hist, uint32_t permille);
+
+/**
+ * @brief 打印刷新耗时和数据风险窗口的p50/p90/p99/最大值
+ */
+void gps_flush_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_FLUSH_H
@@ -0,0 +1,176 @@
+/**
+ * @file gps_geofence.h
+ * @brief 地理围栏 - 网格索引的多边形进出判定
+ *
+ * 围栏文件存放在SD卡上（默认GPS_GEOFENCE_DEFAULT_PATH），为小端二进制格式：
+ *
+ *   gps_geofence_file_header_t                      文件头
+ *   重复fence_count次:
+ *     gps_geofence_file_fence_t                     围栏ID、名称、顶点数、迟滞距离
+ *     int32_t lat_e7, lon_e7 × vertex_count         顶点 (1e-7度)
+ *
+ * 加载时整个文件读入RAM，并在所有围栏的外包矩形上建立
+ * GPS_GEOFENCE_GRID × GPS_GEOFENCE_GRID的均匀网格：每个单元格记录外包矩形
+ * （按迟滞距离外扩）与之相交的围栏。每次定位只检查所在单元格中的围栏和当前
+ * 处于内部的围栏，单元格围栏数和多边形顶点数都有上限，耗时与围栏总数无关。
+ *
+ * 点在多边形内按1e-7度定点坐标做射线法判断（64位叉积，无浮点误差）。进出
+ * 状态只在越过边界超过该围栏的迟滞距离(margin_m)后才切换，避免在边界附近抖动。
+ * 处于内部的围栏每次定位都精确判定；单元格截断只影响进入判定。
+ */
+
+#ifndef GPS_GEOFENCE_H
+#define GPS_GEOFENCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gps/lc76g_i2c_adaptor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef GPS_GEOFENCE_MAX_FENCES
+#define GPS_GEOFENCE_MAX_FENCES 384             // 最多围栏数
+#endif
+
+#ifndef GPS_GEOFENCE_MAX_VERTICES
+#define GPS_GEOFENCE_MAX_VERTICES 6144          // 所有围栏的顶点总数 (每个8字节，共48KB)
+#endif
+
+#ifndef GPS_GEOFENCE_MAX_FENCE_VERTICES
+#define GPS_GEOFENCE_MAX_FENCE_VERTICES 64      // 单个围栏的顶点上限
+#endif
+
+#ifndef GPS_GEOFENCE_GRID
+#define GPS_GEOFENCE_GRID 32                    // 网格每边的单元格数
+#endif
+
+#ifndef GPS_GEOFENCE_MAX_PER_CELL
+#define GPS_GEOFENCE_MAX_PER_CELL 16            // 单元格内最多围栏数，超出的不参与判定
+#endif
+
+#ifndef GPS_GEOFENCE_MAX_CELL_ENTRIES
+#define GPS_GEOFENCE_MAX_CELL_ENTRIES 4096      // 所有单元格的围栏引用总数 (每个2字节)
+#endif
+
+#ifndef GPS_GEOFENCE_MAX_ACTIVE
+#define GPS_GEOFENCE_MAX_ACTIVE 16              // 同时处于内部的围栏上限
+#endif
+
+#define GPS_GEOFENCE_DEFAULT_PATH "/geofence/fences.bin"
+
+// =============================================================================
+// 文件格式
+// =============================================================================
+
+#define GPS_GEOFENCE_MAGIC   0x434E4647u        // "GFNC"
+#define GPS_GEOFENCE_VERSION 1
+#define GPS_GEOFENCE_NAME_LEN 16
+
+/**
+ * @brief 文件头 (16字节)
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t fence_count;
+    uint32_t vertex_count;      // 所有围栏的顶点总数
+    uint32_t reserved;
+} gps_geofence_file_header_t;
+
+/**
+ * @brief 围栏记录头 (24字节)，后跟vertex_count个顶点
+ */
+typedef struct {
+    uint32_t id;
+    uint16_t vertex_count;      // 3..GPS_GEOFENCE_MAX_FENCE_VERTICES
+    uint16_t margin_m;          // 迟滞距离 (米)
+    char name[GPS_GEOFENCE_NAME_LEN];   // 不足时补0，可以不以0结尾
+} gps_geofence_file_fence_t;
+
+// =============================================================================
+// 数据结构
+// =============================================================================
+
+/**
+ * @brief 进出事件
+ */
+typedef struct {
+    uint32_t id;
+    char name[GPS_GEOFENCE_NAME_LEN + 1];
+    bool entered;               // true进入，false离开
+} gps_geofence_event_t;
+
+/**
+ * @brief 加载和判定统计
+ */
+typedef struct {
+    uint32_t fences;
+    uint32_t vertices;
+    uint32_t cell_entries;
+    uint32_t max_cell_fences;       // 单元格内最多围栏数（截断前）
+    uint32_t truncated_cells;       // 围栏数超过GPS_GEOFENCE_MAX_PER_CELL的单元格
+    uint32_t updates;
+    uint32_t candidates;            // 累计检查的围栏数
+    uint32_t max_candidates;        // 单次定位最多检查的围栏数
+    uint32_t edge_tests;            // 累计检查的边数
+    uint32_t max_edge_tests;        // 单次定位最多检查的边数
+    uint32_t events;
+    uint32_t dropped_events;        // 事件缓冲不足或活动围栏已满时丢弃的事件
+} gps_geofence_stats_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 从SD卡加载围栏文件并建立网格索引（需已挂载FatFs）
+ * @param path FatFs路径，如GPS_GEOFENCE_DEFAULT_PATH
+ * @return 是否加载成功；失败时清空已有围栏
+ */
+bool gps_geofence_load_file(const char *path);
+
+/**
+ * @brief 清空围栏和进出状态
+ */
+void gps_geofence_clear(void);
+
+/**
+ * @brief 已加载的围栏数
+ */
+uint32_t gps_geofence_count(void);
+
+/**
+ * @brief 每次定位后调用，判定进出
+ * @param fix 解析器输出，定位无效时不判定
+ * @param events 输出本次产生的事件
+ * @param max_events events容量
+ * @return 写入events的事件数
+ */
+int gps_geofence_update(const gps_fix_t *fix, gps_geofence_event_t *events, int max_events);
+
+/**
+ * @brief 围栏id当前是否处于内部
+ */
+bool gps_geofence_is_inside(uint32_t id);
+
+/**
+ * @brief 获取统计
+ */
+void gps_geofence_get_stats(gps_geofence_stats_t *stats);
+
+/**
+ * @brief 打印加载和判定统计
+ */
+void gps_geofence_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_GEOFENCE_H
@@ -0,0 +1,197 @@
+/**
+ * @file gps_log_transfer.h
+ * @brief 日志文件USB下载 - 不取出SD卡列出并下载日志目录中的文件
+ *
+ * 与printf共用USB CDC串口，二进制帧以"LT"开头并带CRC32，主机端跳过帧之间
+ * 的文本输出。一次poll内整帧写出，调试输出不会插入帧中间。帧格式（小端）：
+ *
+ *   gps_log_transfer_header_t (16字节)      crc为帧头(crc置0)+负载的CRC32
+ *   负载 (最多GPS_LOG_TRANSFER_MAX_PAYLOAD字节)
+ *
+ * 主机命令：LIST列出日志目录；GET从offset开始下载（断点续传），arg为窗口
+ * 帧数；ACK确认offset之前的数据，flags带NAK时设备从offset重发（回退N帧）；
+ * ABORT结束下载。设备应答：ENTRY/LIST_END、INFO（文件大小）、DATA（offset为
+ * 文件偏移）、END（负载为本次下载范围的CRC32）、ERROR。
+ *
+ * 数据按扇区对齐整块f_read到读缓冲（FatFs对整扇区直接读入用户缓冲），
+ * DATA帧负载直接指向读缓冲写出，不再拷贝；重发时f_lseek回到确认位置重读，
+ * 不保留已发送的数据。超过GPS_LOG_TRANSFER_ACK_TIMEOUT_MS没有新的确认时
+ * 从确认位置重发，连续多次超时则放弃本次下载。
+ *
+ * 传输层由调用者提供（固件为gps_log_transfer_usb_transport()，主机为
+ * log_fetch的回环设备），模块本身只依赖FatFs。
+ */
+
+#ifndef GPS_LOG_TRANSFER_H
+#define GPS_LOG_TRANSFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#define GPS_LOG_TRANSFER_MAX_PAYLOAD    512     // DATA帧负载 (一个扇区)
+
+#ifndef GPS_LOG_TRANSFER_READ_BYTES
+#define GPS_LOG_TRANSFER_READ_BYTES     2048    // 读缓冲，扇区整数倍
+#endif
+
+#ifndef GPS_LOG_TRANSFER_MAX_WINDOW
+#define GPS_LOG_TRANSFER_MAX_WINDOW     32      // 未确认帧数上限
+#endif
+
+#ifndef GPS_LOG_TRANSFER_ACK_TIMEOUT_MS
+#define GPS_LOG_TRANSFER_ACK_TIMEOUT_MS 500     // 无新确认时从确认位置重发
+#endif
+
+#ifndef GPS_LOG_TRANSFER_MAX_TIMEOUTS
+#define GPS_LOG_TRANSFER_MAX_TIMEOUTS   10      // 连续超时次数上限，超过则放弃下载
+#endif
+
+#ifndef GPS_LOG_TRANSFER_MAX_NAME
+#define GPS_LOG_TRANSFER_MAX_NAME       64      // 文件名长度上限 (不含目录)
+#endif
+
+// =============================================================================
+// 帧格式
+// =============================================================================
+
+#define GPS_LOG_TRANSFER_MAGIC0 'L'
+#define GPS_LOG_TRANSFER_MAGIC1 'T'
+
+enum GPS_LOG_TRANSFER_TYPE {
+    // 主机 -> 设备
+    GPS_LOG_TRANSFER_LIST       = 0x01,
+    GPS_LOG_TRANSFER_GET        = 0x02,     // offset: 起始偏移, arg: 窗口帧数, 负载: 文件名
+    GPS_LOG_TRANSFER_ACK        = 0x03,     // offset: 已连续收到的字节数
+    GPS_LOG_TRANSFER_ABORT      = 0x04,
+    // 设备 -> 主机
+    GPS_LOG_TRANSFER_ENTRY      = 0x81,     // offset: 文件大小, 负载: 文件名
+    GPS_LOG_TRANSFER_LIST_END   = 0x82,     // offset: 文件数
+    GPS_LOG_TRANSFER_INFO       = 0x83,     // offset: 文件大小, arg: 实际窗口帧数
+    GPS_LOG_TRANSFER_DATA       = 0x84,     // offset: 负载在文件中的偏移
+    GPS_LOG_TRANSFER_END        = 0x85,     // offset: 文件大小, 负载: uint32 CRC32
+    GPS_LOG_TRANSFER_ERROR      = 0x86      // arg: 错误码, 负载: 说明文字
+};
+
+#define GPS_LOG_TRANSFER_FLAG_NAK 0x01      // ACK帧：从offset重发
+
+enum GPS_LOG_TRANSFER_ERROR_CODE {
+    GPS_LOG_TRANSFER_ERR_NOT_FOUND  = 1,
+    GPS_LOG_TRANSFER_ERR_BAD_NAME   = 2,
+    GPS_LOG_TRANSFER_ERR_READ       = 3,
+    GPS_LOG_TRANSFER_ERR_TIMEOUT    = 4,
+    GPS_LOG_TRANSFER_ERR_NO_SESSION = 5
+};
+
+typedef struct {
+    uint8_t magic[2];
+    uint8_t type;               // GPS_LOG_TRANSFER_TYPE
+    uint8_t flags;
+    uint32_t offset;
+    uint16_t length;            // 负载字节数
+    uint16_t arg;
+    uint32_t crc;
+} gps_log_transfer_header_t;
+
+/**
+ * @brief 接收帧的状态机（设备和主机共用）
+ */
+typedef struct {
+    uint8_t data[sizeof(gps_log_transfer_header_t) + GPS_LOG_TRANSFER_MAX_PAYLOAD];
+    uint32_t length;
+    uint32_t dropped;           // 同步失败或CRC错误丢弃的字节/帧
+} gps_log_transfer_rx_t;
+
+/**
+ * @brief 传输层
+ */
+typedef struct {
+    void *ctx;
+    int (*read)(void *ctx, uint8_t *data, uint32_t max);            // 非阻塞，返回读到的字节数
+    void (*write)(void *ctx, const uint8_t *data, uint32_t length); // 全部写出后返回
+    void (*flush)(void *ctx);
+} gps_log_transfer_transport_t;
+
+/**
+ * @brief 下载统计
+ */
+typedef struct {
+    uint32_t sessions;
+    uint32_t completed;
+    uint32_t frames_sent;
+    uint64_t bytes_sent;        // DATA负载字节（含重发）
+    uint64_t bytes_resent;
+    uint32_t naks;
+    uint32_t timeouts;
+    uint32_t bad_frames;        // 收到的CRC错误/无法识别的命令帧
+    uint32_t last_bytes;        // 最近一次完成的下载
+    uint32_t last_ms;
+} gps_log_transfer_stats_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 初始化
+ * @param transport 传输层（需在模块使用期间保持有效）
+ * @param log_dir 可下载的目录，如"/gps_logs"
+ */
+void gps_log_transfer_init(const gps_log_transfer_transport_t *transport, const char *log_dir);
+
+/**
+ * @brief 处理主机命令并发送数据，在主循环中周期调用
+ * @param budget_ms 本次最多用于发送的时间
+ * @return 是否有进行中的下载
+ */
+bool gps_log_transfer_poll(uint32_t budget_ms);
+
+bool gps_log_transfer_active(void);
+
+void gps_log_transfer_get_stats(gps_log_transfer_stats_t *stats);
+void gps_log_transfer_print_stats(void);
+
+/**
+ * @brief 固件的USB CDC传输层（与stdio_usb共用串口）
+ */
+const gps_log_transfer_transport_t *gps_log_transfer_usb_transport(void);
+
+// -----------------------------------------------------------------------------
+// 帧编解码（主机工具也使用）
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief CRC32 (IEEE 802.3)，可分段计算：crc初值为0
+ */
+uint32_t gps_log_transfer_crc32(uint32_t crc, const void *data, size_t length);
+
+/**
+ * @brief 填写帧头（含CRC）
+ */
+void gps_log_transfer_make_header(gps_log_transfer_header_t *header, uint8_t type, uint8_t flags,
+                                  uint32_t offset, uint16_t arg,
+                                  const void *payload, uint16_t length);
+
+/**
+ * @brief 送入接收到的字节，跳过帧之间的文本
+ * @param consumed 返回本次用掉的字节数（收到完整帧时可能小于length）
+ * @return 是否收到一个完整且校验正确的帧，帧在rx->data中，处理后调用gps_log_transfer_rx_reset()
+ */
+bool gps_log_transfer_rx_feed(gps_log_transfer_rx_t *rx, const uint8_t *data, uint32_t length,
+                              uint32_t *consumed);
+
+void gps_log_transfer_rx_reset(gps_log_transfer_rx_t *rx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_LOG_TRANSFER_H
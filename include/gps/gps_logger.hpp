@@ -9,8 +9,8 @@
  * - 支持高德地图API兼容的坐标格式
  * - 自动坐标转换 (WGS84 -> GCJ02)
  * - 时间戳ISO 8601格式
- * - 文件大小限制和自动轮转
- * - 批量写入优化 (减少SD卡写入次数)
+ * - 文件大小限制和自动轮转 (后台预先创建下一个文件，记录路径上只交换文件名)
+ * - 批量写入优化 (按实测SD卡耗时和数据风险窗口刷新，见gps_flush.h)
  * - 错误处理和恢复机制
  * - 适配RP2040内存限制 (264KB RAM)
  */
@@ -45,8 +45,8 @@ public:
         
         // 内存优化配置
         size_t buffer_size = 1024;                  // 写入缓冲区大小 (1KB)
-        size_t batch_write_count = 10;              // 批量写入条数
-        uint32_t write_interval_ms = 5000;          // 批量写入间隔 (5秒)
+        size_t batch_write_count = 10;              // 批量写入条数 (已由刷新控制器按扇区批量取代)
+        uint32_t write_interval_ms = 5000;          // 数据风险窗口：记录在缓冲中最长停留时间 (5秒)
         bool enable_immediate_write = false;        // 是否立即写入 (调试用)
     };
 
@@ -67,14 +67,43 @@ public:
     };
 
 private:
+    /**
+     * @brief 当地日期缓存：跨日时才调用localtime，时间戳由当日秒数计算
+     */
+    struct DayCache {
+        time_t start = 0;       // 当日0点
+        time_t end = 0;         // 次日0点
+        char date[9] = {};      // YYYYMMDD
+        char prefix[12] = {};   // YYYY-MM-DDT
+    };
+
     std::unique_ptr<SimpleSD::SimpleSDWriter> sd_card_;
     LogConfig config_;
     std::string current_log_file_;
     size_t current_file_size_;
+    size_t current_header_size_;   // 当前文件的文件头字节数，大小相等时文件中还没有记录
     uint32_t daily_file_counter_;
     std::string current_date_;
     bool is_initialized_;
     bool log_file_created_;        // 日志文件是否已创建
+    time_t file_day_end_;          // 当前文件日期的结束时刻，到达后轮转
+    DayCache clock_day_;
+    
+    // 日志轮转：下一个文件在空闲时预先创建并写好文件头，轮转时只交换文件名
+    static constexpr size_t ROTATE_PREPARE_PERCENT = 75;    // 文件达到上限的该比例时预先创建
+    static constexpr time_t ROTATE_PREPARE_SECONDS = 60;    // 日期变化前多久预先创建
+    std::string next_log_file_;
+    std::string next_date_;
+    size_t next_file_size_;                         // 下一个文件的文件头字节数
+    uint32_t next_file_counter_;
+    time_t next_file_day_end_;
+    bool next_file_ready_;
+    uint32_t rotations_;                            // 轮转次数
+    uint32_t sync_rotations_;                       // 没有预先创建、在记录路径上同步创建的次数
+    uint32_t rotation_swap_us_max_;                 // 记录路径上交换文件的最长耗时
+    std::string previous_log_file_;                 // 轮转前的文件，缓冲中还有属于它的记录
+    size_t previous_file_size_;
+    size_t previous_pending_bytes_;                 // 缓冲开头属于上一个文件的字节数
     
     // 内存优化的批量写入缓冲区
     std::array<char, 2048> write_buffer_;           // 2KB写入缓冲区
@@ -86,11 +115,6 @@ private:
     static constexpr size_t MAX_COORDINATES = 1000;  // 最大坐标数量
     std::pair<double, double> gaode_coordinates_[MAX_COORDINATES];  // 存储[经度,纬度]对
     size_t gaode_coordinate_count_;  // 当前坐标数量
-    
-    // 坐标转换相关
-    static constexpr double PI = 3.14159265358979324;
-    static constexpr double A = 6378245.0;
-    static constexpr double EE = 0.00669342162296594323;
 
 public:
     /**
@@ -137,8 +161,15 @@ public:
     bool is_initialized() const { return is_initialized_; }
 
     /**
-     * @brief 记录GPS数据到SD卡
-     * @param gps_data LC76G GPS数据结构
+     * @brief 记录定位到SD卡
+     * @param fix 解析器输出的定位
+     * @return 记录是否成功
+     */
+    bool log_fix(const gps_fix_t& fix);
+
+    /**
+     * @brief 记录GPS数据到SD卡（旧结构，转换为gps_fix_t后同log_fix）
+     * @param gps_data GPS数据
      * @return 记录是否成功
      */
     bool log_gps_data(const LC76G_GPS_Data& gps_data);
@@ -151,11 +182,25 @@ public:
     bool log_coordinate_data(const CoordinateData& coord_data);
 
     /**
-     * @brief 从LC76G GPS数据创建坐标数据
-     * @param gps_data LC76G GPS数据结构
+     * @brief 记录事件（如地理围栏进出）到当前日志文件
+     * @param event 事件描述，写为"# 事件,<时间戳>,<描述>"注释行，并立即刷新缓冲区
+     * @return 记录是否成功
+     */
+    bool log_event(const std::string& event);
+
+    /**
+     * @brief 从定位创建坐标数据
+     * @param fix 解析器输出的定位
      * @return 坐标数据结构
      */
-    CoordinateData create_coordinate_data(const LC76G_GPS_Data& gps_data);
+    CoordinateData create_coordinate_data(const gps_fix_t& fix);
+
+    /**
+     * @brief 格式化坐标数据为日志行
+     * @param coord_data 坐标数据
+     * @return 格式化的日志行
+     */
+    std::string format_log_line(const CoordinateData& coord_data);
 
     /**
      * @brief 获取当前日志文件路径
@@ -217,10 +262,30 @@ public:
     bool flush_buffer();
 
     /**
-     * @brief 检查是否需要批量写入
+     * @brief 检查是否需要批量写入（到达数据风险窗口、缓冲将满，或空闲时间容得下整扇区批量）
+     * @param slack_us 调用方的空闲时间，0表示只检查数据风险窗口和缓冲将满
      * @return 是否需要写入
      */
-    bool should_batch_write();
+    bool should_batch_write(uint32_t slack_us = 0);
+
+    /**
+     * @brief 按刷新控制器的计划写出缓冲（GPS/界面空闲时调用）
+     * @param slack_us 到下一个GPS读取或显示帧之前的空闲时间
+     * @return 写入失败时返回false，不需要写入时返回true
+     */
+    bool service_flush(uint32_t slack_us);
+
+    /**
+     * @brief 是否需要预先创建下一个日志文件（当前文件接近大小上限或日期即将变化）
+     */
+    bool needs_next_log_file() const;
+
+    /**
+     * @brief 空闲时间容得下时预先创建下一个日志文件并写好文件头（GPS/界面空闲时调用）
+     * @param slack_us 到下一个GPS读取或显示帧之前的空闲时间
+     * @return 创建失败时返回false，不需要或空闲不足时返回true
+     */
+    bool service_rotation(uint32_t slack_us);
 
     /**
      * @brief 获取内存使用统计
@@ -250,10 +315,21 @@ private:
     std::string get_current_timestamp();
 
     /**
-     * @brief 检查是否需要创建新文件
-     * @return 是否需要创建新文件
+     * @brief 时间跨出缓存的当日范围时重新计算日期缓存
+     */
+    void update_clock_day(time_t now);
+
+    /**
+     * @brief 计算某时刻所在当地日期的起止时刻和日期字符串
      */
-    bool should_create_new_file();
+    static void fill_day_cache(DayCache& day, time_t t);
+
+    /**
+     * @brief 检查是否需要切换到新文件（只比较文件大小和当日结束时刻）
+     * @param now time(nullptr)
+     * @param overdue 为true时检查是否已超出轮转点的余量（文件上限的1/4或ROTATE_PREPARE_SECONDS）
+     */
+    bool rotation_due(time_t now, bool overdue) const;
 
     /**
      * @brief 创建新的日志文件
@@ -262,26 +338,25 @@ private:
     bool create_new_log_file();
 
     /**
-     * @brief 格式化坐标数据为日志行
-     * @param coord_data 坐标数据
-     * @return 格式化的日志行
+     * @brief 创建文件并写入文件头
+     * @param path 文件路径
+     * @param header_size 输出文件头字节数
+     * @return 创建是否成功
      */
-    std::string format_log_line(const CoordinateData& coord_data);
+    bool write_log_header(const std::string& path, size_t& header_size);
 
     /**
-     * @brief WGS84坐标转换为GCJ02坐标
-     * @param wgs_lon WGS84经度
-     * @param wgs_lat WGS84纬度
-     * @param gcj_lon GCJ02经度输出
-     * @param gcj_lat GCJ02纬度输出
+     * @brief 预先创建下一个日志文件（日期即将变化时按次日命名）
+     * @return 创建是否成功
      */
-    void wgs84_to_gcj02(double wgs_lon, double wgs_lat, double& gcj_lon, double& gcj_lat);
+    bool prepare_next_log_file();
 
     /**
-     * @brief 坐标转换辅助函数
+     * @brief 切换到预先创建的文件：只交换文件名和计数，不访问SD卡
+     *
+     * 缓冲中已有的记录仍属于原文件，记下其字节数，刷新时写入原文件。
      */
-    double transform_lat(double x, double y);
-    double transform_lon(double x, double y);
+    void swap_to_next_log_file();
 
     /**
      * @brief 确保日志目录存在
@@ -291,10 +366,14 @@ private:
 
     /**
      * @brief 获取下一个可用的文件计数器
+     *
+     * 从列表中最大的编号和first中较大者开始，逐个检查文件是否已存在，
+     * 重启后不会覆盖当天已有的日志。
      * @param date 日期字符串
+     * @param first 最小编号
      * @return 下一个可用的计数器值
      */
-    uint32_t get_next_file_counter(const std::string& date);
+    uint32_t get_next_file_counter(const std::string& date, uint32_t first = 1);
 
     /**
      * @brief 添加数据到写入缓冲区
@@ -303,6 +382,34 @@ private:
      */
     bool add_to_buffer(const std::string& data);
 
+    /**
+     * @brief 写出缓冲区开头的bytes字节，剩余数据前移
+     *
+     * 轮转前进入缓冲的记录写入上一个文件，其余写入当前文件。
+     * @param reason 刷新原因 (GPS_FLUSH_*)
+     * @return 写入是否成功
+     */
+    bool write_buffer_prefix(size_t bytes, uint8_t reason);
+
+    /**
+     * @brief 把缓冲区开头的bytes字节追加到指定文件，剩余数据前移
+     * @param path 文件路径
+     * @param file_size 该文件的当前大小，写入后更新
+     * @param reason 刷新原因 (GPS_FLUSH_*)
+     * @return 写入是否成功
+     */
+    bool append_buffer_prefix(const std::string& path, size_t& file_size, size_t bytes, uint8_t reason);
+
+    /**
+     * @brief 计划本次刷新的字节数，缓冲开头属于上一个文件的记录按上一个文件计算
+     */
+    uint32_t plan_flush(uint32_t now_ms, uint32_t slack_us, uint8_t* reason) const;
+
+    /**
+     * @brief 缓冲中属于上一个文件的记录能否在空闲时间内写出
+     */
+    bool previous_tail_fits(uint32_t slack_us) const;
+
     /**
      * @brief 获取当前时间戳 (毫秒)
      * @return 时间戳
@@ -310,18 +417,18 @@ private:
     uint64_t get_current_timestamp_ms();
     
     /**
-     * @brief 从GPS数据中提取日期时间
-     * @param gps_data GPS数据
+     * @brief 从定位中提取日期时间
+     * @param fix 定位
      * @return 日期时间字符串 (YYYY-MM-DD_HH:MM:SS格式)
      */
-    std::string extract_datetime_from_gps(const LC76G_GPS_Data& gps_data);
+    std::string extract_datetime_from_gps(const gps_fix_t& fix);
     
     /**
      * @brief 基于GPS日期创建日志文件
-     * @param gps_data GPS数据
+     * @param fix 定位
      * @return 创建是否成功
      */
-    bool create_log_file_from_gps_date(const LC76G_GPS_Data& gps_data);
+    bool create_log_file_from_gps_date(const gps_fix_t& fix);
 };
 
 /**
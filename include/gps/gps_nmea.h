@@ -0,0 +1,182 @@
+/**
+ * @file gps_nmea.h
+ * @brief 表驱动的NMEA解析引擎 - lc76g_i2c_adaptor和vendor_gps_parser共用
+ *
+ * 地址字段（如"GNRMC"）的语句类型3个字符经编译期确定的完美哈希直接索引
+ * 语句表，每条语句是一张字段描述表（字段序号、类型、在gps_fix_t中的偏移）。
+ * 一条语句的分派是一次哈希和一次3字节比较，与支持的语句数量无关；新增语句
+ * 只需在gps_nmea.c的语句表中增加一项（哈希冲突时编译报错）。
+ *
+ * 缓冲区中每条语句先校验和，不完整或校验和错误的语句被丢弃；字段为空或格式
+ * 错误时gps_fix_t中保留上一次的值。所有字段解析只用整数运算。分帧和校验和
+ * 在同一遍扫描中按字（4字节）完成，每个字节只读一次。
+ */
+
+#ifndef GPS_NMEA_H
+#define GPS_NMEA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gps/gps_fix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#define GPS_NMEA_MAX_FIELDS     24      // 含地址字段；GSV最多21个，GSA最多19个
+
+// =============================================================================
+// 语句类型和解析结果
+// =============================================================================
+
+enum GPS_NMEA_SENTENCE {
+    GPS_NMEA_UNKNOWN = 0,
+    GPS_NMEA_RMC,
+    GPS_NMEA_GGA,
+    GPS_NMEA_GSA,
+    GPS_NMEA_GSV,
+    GPS_NMEA_VTG,
+    GPS_NMEA_ZDA,
+    GPS_NMEA_SENTENCE_COUNT
+};
+
+#define GPS_NMEA_MASK(type)     (1u << (type))
+
+/**
+ * @brief 一条语句更新了gps_fix_t的哪些内容
+ */
+enum GPS_NMEA_UPDATE {
+    GPS_NMEA_UPD_TIME       = 0x0001,   // utc_ms
+    GPS_NMEA_UPD_DATE       = 0x0002,   // utc_date
+    GPS_NMEA_UPD_POSITION   = 0x0004,   // lat_e7/lon_e7
+    GPS_NMEA_UPD_STATUS     = 0x0008,   // GPS_FIX_VALID (RMC状态或GGA质量)
+    GPS_NMEA_UPD_MOTION     = 0x0010,   // speed_cms/course_cdeg
+    GPS_NMEA_UPD_ALTITUDE   = 0x0020,
+    GPS_NMEA_UPD_DOP        = 0x0040,
+    GPS_NMEA_UPD_SATELLITES = 0x0080,
+    GPS_NMEA_UPD_MODE       = 0x0100
+};
+
+/**
+ * @brief 已校验并按表解析过的一条语句，交给前端的回调
+ */
+typedef struct {
+    uint8_t type;                               // GPS_NMEA_*
+    uint16_t updated;                           // GPS_NMEA_UPD_*
+    const char *text;                           // 指向'$'，以'*'校验和结束
+    const char *fields[GPS_NMEA_MAX_FIELDS];    // fields[0]为地址字段
+    int field_count;
+} gps_nmea_sentence_t;
+
+typedef void (*gps_nmea_sentence_cb_t)(const gps_nmea_sentence_t *sentence, void *ctx);
+
+typedef struct {
+    uint32_t sentences;                         // 校验和正确的语句
+    uint32_t checksum_errors;                   // 校验和错误或不完整
+    uint32_t unknown;                           // 不在语句表中（含$P专有语句）
+    uint32_t by_type[GPS_NMEA_SENTENCE_COUNT];
+} gps_nmea_stats_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 由地址字段查语句类型
+ * @param address '$'之后的地址字段，如"GNRMC,..."
+ * @return GPS_NMEA_*，不支持时返回GPS_NMEA_UNKNOWN
+ */
+uint8_t gps_nmea_sentence_type(const char *address);
+
+/**
+ * @brief 按语句表把已切分的字段写入定位记录
+ * @return GPS_NMEA_UPD_*
+ */
+uint16_t gps_nmea_apply(uint8_t type, const char *const *fields, int field_count, gps_fix_t *fix);
+
+/**
+ * @brief 解析缓冲区中的所有语句
+ * @param data NMEA文本，不要求以NUL结尾
+ * @param fix 按语句顺序更新
+ * @param callback 每条已识别的语句解析后调用，可为NULL
+ * @param stats 累加统计，可为NULL
+ * @return 出现过的语句类型 (GPS_NMEA_MASK的组合)
+ */
+uint32_t gps_nmea_parse_buffer(const char *data, int data_len, gps_fix_t *fix,
+                               gps_nmea_sentence_cb_t callback, void *ctx, gps_nmea_stats_t *stats);
+
+// =============================================================================
+// 校验和与分帧（每次处理4字节）
+// =============================================================================
+
+/**
+ * @brief 计算异或校验和
+ * @param data '$'和'*'之间的内容
+ */
+uint8_t gps_nmea_xor(const char *data, int len);
+
+/**
+ * @brief 从p开始累计异或校验和，直到'*' '$'或控制字符（含'\r' '\n' NUL）
+ * @param p 通常为'$'之后的位置
+ * @param end 缓冲区末尾
+ * @param checksum 输出p到返回位置之间的异或值
+ * @return 停止的位置，到达缓冲区末尾时返回end
+ */
+const char *gps_nmea_scan(const char *p, const char *end, uint8_t *checksum);
+
+/**
+ * @brief 目标板上用SysTick测量校验和/分帧的周期数并打印（gps_nmea_bench_pico.c，仅固件）
+ */
+void gps_nmea_bench_run(void);
+
+// =============================================================================
+// 字段解析（整数运算，不使用浮点）
+// =============================================================================
+
+/**
+ * @brief 按逗号切分语句，空字段也占一个位置
+ * @param sentence 以'$'开头的语句，字段结束于',' '*' '\r' '\n'或NUL
+ * @param fields 输出每个字段的起始位置，fields[0]为"GNRMC"等地址字段
+ * @return 字段数（最多max_fields）
+ */
+int gps_nmea_split(const char *sentence, const char **fields, int max_fields);
+
+static inline bool gps_nmea_field_empty(const char *field) {
+    return *field == ',' || *field == '*' || *field == '\r' || *field == '\n' || *field == '\0';
+}
+
+/**
+ * @brief 解析十进制小数为定点整数，多余的小数位四舍五入
+ * @param frac_digits 保留的小数位数，例如2表示结果单位为0.01
+ * @return 字段为空或格式错误时返回false
+ */
+bool gps_nmea_parse_decimal(const char *field, uint8_t frac_digits, int32_t *value);
+
+/**
+ * @brief 解析(d)ddmm.mmmm格式的坐标
+ * @param hemisphere 方向字段的首字符，'S'/'W'取负
+ * @param e7 输出1e-7度
+ */
+bool gps_nmea_parse_coord(const char *field, char hemisphere, int32_t *e7);
+
+/**
+ * @brief 解析hhmmss(.sss)格式的时间
+ * @param utc_ms 输出当日毫秒
+ */
+bool gps_nmea_parse_time(const char *field, uint32_t *utc_ms);
+
+/**
+ * @brief 解析ddmmyy格式的日期
+ * @param fat_date 输出FAT格式日期
+ */
+bool gps_nmea_parse_date(const char *field, uint16_t *fat_date);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_NMEA_H
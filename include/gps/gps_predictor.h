@@ -0,0 +1,117 @@
+/**
+ * @file gps_predictor.h
+ * @brief GPS显示预测器 - 在两次定位之间按显示帧率外推平滑的位置/速度/航向
+ *
+ * 定位只有1-10Hz，直接显示时位置、速度和航向每次定位都会跳变。预测器在
+ * 解析器和界面之间：
+ *
+ * - 每次定位时记录位置和速度矢量（由速度和航向分解），低于
+ *   GPS_PREDICTOR_MIN_SPEED_KMH时视为静止，不外推（抑制静止漂移）
+ * - 界面按自己的帧率采样，位置按恒速恒航向外推，最长外推
+ *   GPS_PREDICTOR_MAX_EXTRAPOLATE_MS，之后保持不动并标记为过期
+ * - 新定位与当前显示值之差不直接跳过去，而是在GPS_PREDICTOR_BLEND_MS
+ *   时间常数内指数衰减；偏差超过GPS_PREDICTOR_SNAP_M时直接跳到新位置
+ *
+ * 位置外推在以最近定位为原点的局部平面内用float计算（米），只有绝对
+ * 经纬度使用double，与lc76g_i2c_adaptor一致。
+ */
+
+#ifndef GPS_PREDICTOR_H
+#define GPS_PREDICTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gps/lc76g_i2c_adaptor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef GPS_PREDICTOR_MAX_EXTRAPOLATE_MS
+#define GPS_PREDICTOR_MAX_EXTRAPOLATE_MS 3000   // 最长外推时间，超过后保持最后位置
+#endif
+
+#ifndef GPS_PREDICTOR_BLEND_MS
+#define GPS_PREDICTOR_BLEND_MS 400              // 新定位修正量的衰减时间常数
+#endif
+
+#ifndef GPS_PREDICTOR_SNAP_M
+#define GPS_PREDICTOR_SNAP_M 50.0f              // 偏差超过该值时直接跳到新位置
+#endif
+
+#ifndef GPS_PREDICTOR_MIN_SPEED_KMH
+#define GPS_PREDICTOR_MIN_SPEED_KMH 1.5f        // 低于该速度视为静止
+#endif
+
+#ifndef GPS_PREDICTOR_STALE_MS
+#define GPS_PREDICTOR_STALE_MS 10000            // 超过该时间没有定位则输出无效
+#endif
+
+// =============================================================================
+// 数据结构
+// =============================================================================
+
+/**
+ * @brief 某一时刻的平滑状态
+ */
+typedef struct {
+    double lat;                 // 纬度 (度)
+    double lon;                 // 经度 (度)
+    float altitude_m;
+    float speed_kmh;
+    float course_deg;           // 0-360
+    uint32_t fix_age_ms;        // 距最近一次定位
+    float prediction_error_m;   // 最近一次定位时外推位置与实测位置的偏差
+    float correction_m;         // 尚未消化的修正量
+    bool valid;                 // 有定位且未超过GPS_PREDICTOR_STALE_MS
+    bool extrapolating;         // 正在外推（运动中且未超过最长外推时间）
+} gps_predictor_state_t;
+
+/**
+ * @brief 预测效果统计
+ */
+typedef struct {
+    uint32_t fixes;
+    uint32_t snaps;             // 偏差过大直接跳变的次数
+    float mean_error_m;         // 外推位置与新定位偏差的滑动平均
+    float mean_hold_error_m;    // 若保持上次定位不动的偏差滑动平均（对照）
+} gps_predictor_stats_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 清除状态和统计
+ */
+void gps_predictor_reset(void);
+
+/**
+ * @brief 输入一次定位
+ * @param fix 解析器输出，定位无效时忽略
+ * @param fix_ms 定位时刻 (to_ms_since_boot)
+ */
+void gps_predictor_update(const gps_fix_t *fix, uint32_t fix_ms);
+
+/**
+ * @brief 按显示帧采样
+ * @param now_ms 当前时刻 (to_ms_since_boot)
+ * @param state 输出平滑状态
+ * @return state->valid
+ */
+bool gps_predictor_sample(uint32_t now_ms, gps_predictor_state_t *state);
+
+/**
+ * @brief 取预测效果统计
+ */
+void gps_predictor_get_stats(gps_predictor_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_PREDICTOR_H
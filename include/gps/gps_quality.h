@@ -0,0 +1,149 @@
+/**
+ * @file gps_quality.h
+ * @brief 定位质量门限 - 把每个历元分为拒绝/降级/良好，拒绝的历元不进入下游
+ *
+ * 解析器只按RMC状态/GGA质量给出GPS_FIX_VALID，HDOP为20的定位也会被记录、
+ * 做GCJ-02转换并触发地图重画。本模块在解析器和下游之间按以下条件分级：
+ *
+ * - 拒绝：无定位（RMC状态无效或GGA质量为0）、卫星数少于GPS_QUALITY_MIN_SATELLITES、
+ *   HDOP/PDOP超过拒绝门限、报告速度超过GPS_QUALITY_MAX_SPEED_KMH，
+ *   或相对上一个接受的定位的位移所需速度超过上限（加上HDOP对应的余量）
+ * - 降级：卫星数少于GPS_QUALITY_GOOD_SATELLITES或HDOP/PDOP超过良好门限
+ * - 良好：其余
+ *
+ * 默认门限与config/gps_logger_config.json的gps_settings一致：
+ * min_satellites为拒绝门限，min_hdop（实为HDOP上限）为良好门限。
+ * 卫星数或DOP为0（未知，例如没有GGA/GSA）时不参与判定。位移检查只用整数和float，
+ * 每个历元为常数开销。连续GPS_QUALITY_MAX_JUMP_REJECTS次因位移被拒绝时
+ * 接受新位置作为基准，避免基准本身是错误定位时一直拒绝。
+ *
+ * 下游在拒绝的历元跳过的工作用gps_quality_work_skipped()登记，执行时用
+ * gps_quality_work_done()登记耗时，统计中据此估算节省的时间。
+ */
+
+#ifndef GPS_QUALITY_H
+#define GPS_QUALITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gps/gps_fix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef GPS_QUALITY_MIN_SATELLITES
+#define GPS_QUALITY_MIN_SATELLITES 4            // 少于该值拒绝 (gps_settings.min_satellites)
+#endif
+
+#ifndef GPS_QUALITY_GOOD_SATELLITES
+#define GPS_QUALITY_GOOD_SATELLITES 6           // 少于该值降级
+#endif
+
+#ifndef GPS_QUALITY_GOOD_HDOP_C
+#define GPS_QUALITY_GOOD_HDOP_C 500             // HDOP超过5.0降级 (gps_settings.min_hdop)
+#endif
+
+#ifndef GPS_QUALITY_MAX_HDOP_C
+#define GPS_QUALITY_MAX_HDOP_C 1000             // HDOP超过10.0拒绝
+#endif
+
+#ifndef GPS_QUALITY_GOOD_PDOP_C
+#define GPS_QUALITY_GOOD_PDOP_C 600
+#endif
+
+#ifndef GPS_QUALITY_MAX_PDOP_C
+#define GPS_QUALITY_MAX_PDOP_C 1500
+#endif
+
+#ifndef GPS_QUALITY_MAX_SPEED_KMH
+#define GPS_QUALITY_MAX_SPEED_KMH 250           // 报告速度和位移速度上限
+#endif
+
+#ifndef GPS_QUALITY_JUMP_M_PER_HDOP
+#define GPS_QUALITY_JUMP_M_PER_HDOP 10          // 位移检查的余量 (米/HDOP)
+#endif
+
+#ifndef GPS_QUALITY_MAX_JUMP_REJECTS
+#define GPS_QUALITY_MAX_JUMP_REJECTS 3          // 连续因位移拒绝后重新取基准
+#endif
+
+// =============================================================================
+// 分级和原因
+// =============================================================================
+
+enum GPS_QUALITY_CLASS {
+    GPS_QUALITY_REJECT      = 0,
+    GPS_QUALITY_DEGRADED    = 1,
+    GPS_QUALITY_GOOD        = 2,
+    GPS_QUALITY_CLASS_COUNT
+};
+
+enum GPS_QUALITY_REASON {
+    GPS_QUALITY_NO_FIX          = 0x01,     // 未定位或没有坐标
+    GPS_QUALITY_FEW_SATELLITES  = 0x02,
+    GPS_QUALITY_HIGH_HDOP       = 0x04,
+    GPS_QUALITY_HIGH_PDOP       = 0x08,
+    GPS_QUALITY_SPEED           = 0x10,     // 报告速度超过上限
+    GPS_QUALITY_JUMP            = 0x20,     // 位移所需速度超过上限
+    GPS_QUALITY_REASON_COUNT    = 6
+};
+
+/**
+ * @brief 下游工作（用于估算拒绝历元节省的时间）
+ */
+enum GPS_QUALITY_WORK {
+    GPS_QUALITY_WORK_LOG    = 0,    // GCJ-02转换和日志写入
+    GPS_QUALITY_WORK_MAP    = 1,    // 轨迹地图更新
+    GPS_QUALITY_WORK_FENCE  = 2,    // 地理围栏判定和事件写入
+    GPS_QUALITY_WORK_COUNT
+};
+
+typedef struct {
+    uint32_t epochs;
+    uint32_t by_class[GPS_QUALITY_CLASS_COUNT];
+    uint32_t by_reason[GPS_QUALITY_REASON_COUNT];   // 拒绝或降级的原因，一个历元可计入多项
+    uint32_t work_done[GPS_QUALITY_WORK_COUNT];
+    uint32_t work_skipped[GPS_QUALITY_WORK_COUNT];
+    uint64_t work_us[GPS_QUALITY_WORK_COUNT];       // 已执行工作的累计耗时
+} gps_quality_stats_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 清除基准定位和统计
+ */
+void gps_quality_reset(void);
+
+/**
+ * @brief 对一个历元分级，接受（非拒绝）时作为下一次位移检查的基准
+ * @param fix_ms 定位时刻 (to_ms_since_boot)
+ * @param reasons 输出GPS_QUALITY_*原因组合，可为NULL
+ * @return GPS_QUALITY_REJECT/DEGRADED/GOOD
+ */
+uint8_t gps_quality_classify(const gps_fix_t *fix, uint32_t fix_ms, uint8_t *reasons);
+
+/**
+ * @brief 登记下游工作：执行了一次（含耗时）或因拒绝跳过一次
+ */
+void gps_quality_work_done(uint8_t work, uint32_t elapsed_us);
+void gps_quality_work_skipped(uint8_t work);
+
+void gps_quality_get_stats(gps_quality_stats_t *stats);
+
+/**
+ * @brief 打印各级比例、原因和估算节省的时间
+ */
+void gps_quality_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_QUALITY_H
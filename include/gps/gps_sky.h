@@ -0,0 +1,146 @@
+/**
+ * @file gps_sky.h
+ * @brief 可见卫星表 - 由GSV句子维护各星座卫星的仰角/方位角/信噪比
+ *
+ * GSV按星座（讲话者GP/GL/GA/GB/BD/GQ）分组发送，每组若干条，每条最多4颗卫星：
+ *
+ * - 组内第1条开始新一轮：该星座的卫星在本轮内刷新
+ * - 组内最后一条结束本轮：该星座本轮未出现的卫星从表中删除
+ *
+ * 句子由NMEA引擎（gps_nmea）校验和切分后交给本模块，直接读取已切分的字段，
+ * 不再扫描原文、不复制、不分配内存；空字段（未跟踪卫星的SNR、未知的仰角
+ * 方位角）按0/无效处理。NMEA 4.10多频输出每个信号各发一组GSV，
+每个星座只采用最先出现的信号ID的分组。
+ *
+ * GSA给出参与定位的卫星：每个历元的GSA按星座记入PRN位图（每个星座256位，
+ * 固定大小），连续的一组GSA之后收到其他语句时（gps_sky_commit_gsa）整组提交，
+ * 并与卫星表逐项比对设置used标志。星座优先取NMEA 4.10的系统ID字段，没有时按
+ * 讲话者；GN讲话者且没有系统ID时按PRN范围区分GPS(1-32)和GLONASS(65-96)。
+ * 每个历元的开销与GSA条数和表中卫星数成正比，不分配内存。
+ *
+ * gps_sky_generation()在表内容变化时递增，界面据此跳过没有变化的刷新。
+ */
+
+#ifndef GPS_SKY_H
+#define GPS_SKY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gps/gps_nmea.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef GPS_SKY_MAX_SATS
+#define GPS_SKY_MAX_SATS 64                     // 表容量（多星座同时可见时约40-50颗）
+#endif
+
+// =============================================================================
+// 数据结构
+// =============================================================================
+
+/**
+ * @brief 星座（由GSV讲话者决定）
+ */
+typedef enum {
+    GPS_SKY_GPS = 0,
+    GPS_SKY_GLONASS,
+    GPS_SKY_GALILEO,
+    GPS_SKY_BEIDOU,
+    GPS_SKY_QZSS,
+    GPS_SKY_SYSTEM_COUNT
+} gps_sky_system_t;
+
+/**
+ * @brief 一颗可见卫星
+ */
+typedef struct {
+    uint8_t system;             // gps_sky_system_t
+    uint8_t prn;
+    int8_t elevation;           // 仰角 (度, 0-90)，未知为-1
+    uint8_t snr;                // 信噪比 (dB-Hz)，0表示未跟踪
+    uint16_t azimuth;           // 方位角 (度, 0-359)，正北为0，顺时针
+    uint8_t cycle;              // 内部使用：最后出现的轮次
+    uint8_t used;               // 最近一个历元的GSA中参与定位
+} gps_sky_sat_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 清空卫星表
+ */
+void gps_sky_clear(void);
+
+/**
+ * @brief 处理一条GSV句子
+ * @param sentence NMEA引擎切分好的语句（gps_nmea_parse_buffer的回调参数）
+ * @return 是否为可识别的GSV句子
+ */
+bool gps_sky_parse_gsv(const gps_nmea_sentence_t *sentence);
+
+/**
+ * @brief 处理一条GSA句子，记入本历元的PRN位图
+ * @param sentence NMEA引擎切分好的语句，PRN取自fields[3..14]，系统ID取自fields[18]
+ * @return 是否为可识别的GSA句子
+ */
+bool gps_sky_parse_gsa(const gps_nmea_sentence_t *sentence);
+
+/**
+ * @brief 结束当前的一组GSA：提交位图并更新卫星表的used标志
+ *
+ * 前端在收到GSA以外的语句时调用；没有未提交的GSA时直接返回。
+ */
+void gps_sky_commit_gsa(void);
+
+/**
+ * @brief 是否收到过GSA（没有时used标志无意义）
+ */
+bool gps_sky_has_used(void);
+
+/**
+ * @brief 某星座参与定位的卫星数，system为GPS_SKY_SYSTEM_COUNT时返回总数
+ */
+uint8_t gps_sky_used_count(uint8_t system);
+
+/**
+ * @brief 某颗卫星是否参与定位（不要求在卫星表中）
+ */
+bool gps_sky_is_used(uint8_t system, uint8_t prn);
+
+/**
+ * @brief 当前可见卫星数
+ */
+uint8_t gps_sky_count(void);
+
+/**
+ * @brief 卫星数组（顺序不固定，删除时用末尾元素填补）
+ */
+const gps_sky_sat_t *gps_sky_sats(void);
+
+/**
+ * @brief 正在跟踪（SNR>0）的卫星数
+ */
+uint8_t gps_sky_tracked(void);
+
+/**
+ * @brief 正在跟踪的卫星的平均信噪比 (dB-Hz)，没有跟踪卫星时为0
+ */
+float gps_sky_mean_snr(void);
+
+/**
+ * @brief 表内容变化计数（单调递增）
+ */
+uint32_t gps_sky_generation(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_SKY_H
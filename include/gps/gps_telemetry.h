@@ -0,0 +1,148 @@
+/**
+ * @file gps_telemetry.h
+ * @brief 实时定位遥测 - 每个历元通过USB串口输出一帧紧凑的二进制定位记录
+ *
+ * 固件由LC76G适配器的历元钩子（lc76g_set_epoch_hook）驱动，一次读取中缓存的
+ * 每个RMC+GGA历元各发一帧；示例按TELEMETRY_POLL_INTERVAL读空模块缓冲，
+ * 延迟从历元可用的下界（上一次读空的时刻）算起。
+ *
+ * 与printf共用USB CDC串口。每帧用COBS编码，前后各一个0x00分隔符，帧内不含
+ * 0x00；帧之间的调试文本被解码端当作一帧读入，长度或CRC不符而丢弃，解码端在
+ * 下一个分隔符处重新同步（printf与遥测在同一线程写出，文本不会插入帧中间）。
+ * 编码前的帧：
+ *
+ *   type (1字节) | seq (uint16) | 记录 (GPS_TELEMETRY_FIX_SIZE字节) | CRC16 (uint16)
+ *
+ * 多字节字段均为小端，CRC16为CRC-16/CCITT-FALSE，覆盖type到记录末尾。seq每帧
+ * 加1，解码端据此统计发出后丢失的帧；发出之前丢失的历元由telemetry_rx按记录中
+ * 的UTC间隔统计。
+ *
+ * 定位记录为gps_fix_t（单位见gps/gps_fix.h）加设备时间戳，逐字段序列化，与结构体
+ * 布局无关。记录中带有设备发出时刻和"历元可用 -> 写入USB"的设备内延迟，主机
+ * 用收到时刻估计链路延迟（回环测试时两端共用时钟，得到端到端延迟）。
+ *
+ * 编码和解码在同一文件中，主机工具telemetry_rx链接同一份代码。
+ */
+
+#ifndef GPS_TELEMETRY_H
+#define GPS_TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gps/gps_fix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 帧格式
+// =============================================================================
+
+#define GPS_TELEMETRY_FIX_SIZE      40      // 定位记录序列化后的字节数
+#define GPS_TELEMETRY_FRAME_SIZE    (3 + GPS_TELEMETRY_FIX_SIZE + 2)
+// COBS每254字节最多增加1字节，再加前后分隔符
+#define GPS_TELEMETRY_MAX_ENCODED   (GPS_TELEMETRY_FRAME_SIZE + GPS_TELEMETRY_FRAME_SIZE / 254 + 1 + 2)
+
+enum GPS_TELEMETRY_TYPE {
+    GPS_TELEMETRY_FIX = 0x01
+};
+
+#define GPS_TELEMETRY_STATUS_VALID  GPS_FIX_VALID  // status字节即gps_fix_t的flags
+
+/**
+ * @brief 定位记录：定位数据加上设备时间戳
+ */
+typedef struct {
+    gps_fix_t fix;
+    uint32_t device_time_us;    // 帧写出时的设备时钟
+    uint32_t latency_us;        // 从历元可用到帧写出的设备内延迟
+} gps_telemetry_fix_t;
+
+/**
+ * @brief 传输层写函数，全部写出后返回
+ */
+typedef void (*gps_telemetry_write_t)(void *ctx, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief 发送统计
+ */
+typedef struct {
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t latency_max_us;    // 记录中的设备内延迟
+    uint64_t latency_sum_us;
+    uint32_t write_max_us;      // 写入USB的耗时（发送FIFO满时等待主机）
+} gps_telemetry_stats_t;
+
+/**
+ * @brief 解码器（主机端）
+ */
+typedef struct {
+    uint8_t buffer[GPS_TELEMETRY_MAX_ENCODED];
+    uint32_t length;
+    bool overflow;              // 当前帧超长，丢弃到下一个分隔符
+    bool have_seq;
+    uint16_t last_seq;
+    // 统计
+    uint32_t frames;
+    uint32_t lost;              // 按seq推算的丢帧数
+    uint32_t bad_frames;        // 长度正确但CRC错误或类型未知的帧
+    uint32_t junk_bytes;        // 解不出帧的字节（帧间的调试文本、截断的帧）
+} gps_telemetry_decoder_t;
+
+// =============================================================================
+// 设备端接口
+// =============================================================================
+
+/**
+ * @brief 初始化
+ * @param write 传输层写函数（固件为gps_telemetry_usb_write）
+ */
+void gps_telemetry_init(gps_telemetry_write_t write, void *ctx);
+
+/**
+ * @brief 发送一个历元的定位记录
+ * @param fix 解析后的定位（定位无效时也发送，status不带VALID）
+ * @param since_us 该历元可用的时刻（固件为历元钩子给出的下界），0表示未知
+ */
+void gps_telemetry_send_fix(const gps_fix_t *fix, uint32_t since_us);
+
+void gps_telemetry_get_stats(gps_telemetry_stats_t *stats);
+void gps_telemetry_print_stats(void);
+
+/**
+ * @brief 固件的USB CDC写函数（与stdio_usb共用串口）
+ */
+void gps_telemetry_usb_write(void *ctx, const uint8_t *data, uint32_t length);
+
+// =============================================================================
+// 编解码（主机工具也使用）
+// =============================================================================
+
+/**
+ * @brief 编码一帧（含前后分隔符）
+ * @param out 至少GPS_TELEMETRY_MAX_ENCODED字节
+ * @return 编码后的字节数
+ */
+uint32_t gps_telemetry_encode_fix(const gps_telemetry_fix_t *fix, uint16_t seq, uint8_t *out);
+
+void gps_telemetry_decoder_reset(gps_telemetry_decoder_t *decoder);
+
+/**
+ * @brief 送入收到的字节
+ * @param consumed 返回本次用掉的字节数（解出一帧时可能小于length）
+ * @param fix 解出的定位记录
+ * @param seq 解出帧的序号
+ * @return 是否解出一帧校验正确的定位记录
+ */
+bool gps_telemetry_decoder_feed(gps_telemetry_decoder_t *decoder, const uint8_t *data, uint32_t length,
+                                uint32_t *consumed, gps_telemetry_fix_t *fix, uint16_t *seq);
+
+uint16_t gps_telemetry_crc16(const uint8_t *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_TELEMETRY_H
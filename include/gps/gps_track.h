@@ -0,0 +1,96 @@
+/**
+ * @file gps_track.h
+ * @brief 轨迹存储 - 固定容量、自动抽稀的局部ENU轨迹点
+ *
+ * 第一个有效定位作为原点，之后每个定位投影到以原点为切点的局部东北(ENU)
+ * 平面，以分米整数保存（±200km内无精度损失，每点8字节）。
+ *
+ * - 与上一个存储点距离小于当前步长的定位不存储（静止时不增长）
+ * - 存满GPS_TRACK_MAX_POINTS后隔点删除（保留起点和最新点），步长加倍
+ *
+ * 因此轨迹长度不受限制，内存固定，点密度随轨迹变长逐级降低。
+ * gps_track_appended()是单调递增的追加计数，渲染端可以据此只处理新增的点。
+ */
+
+#ifndef GPS_TRACK_H
+#define GPS_TRACK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gps/lc76g_i2c_adaptor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef GPS_TRACK_MAX_POINTS
+#define GPS_TRACK_MAX_POINTS 4096               // 轨迹点上限 (每个8字节，共32KB)
+#endif
+
+#ifndef GPS_TRACK_MIN_STEP_DM
+#define GPS_TRACK_MIN_STEP_DM 10                // 初始存储步长 (分米)
+#endif
+
+// =============================================================================
+// 数据结构
+// =============================================================================
+
+/**
+ * @brief 轨迹点，相对原点的东/北偏移 (分米)
+ */
+typedef struct {
+    int32_t e_dm;
+    int32_t n_dm;
+} gps_track_point_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 清空轨迹，下一个有效定位成为新原点
+ */
+void gps_track_clear(void);
+
+/**
+ * @brief 每次定位后调用
+ * @param fix 解析器输出，定位无效时忽略
+ * @return 是否追加了新的轨迹点
+ */
+bool gps_track_update(const gps_fix_t *fix);
+
+/**
+ * @brief 当前存储的轨迹点数
+ */
+uint32_t gps_track_count(void);
+
+/**
+ * @brief 轨迹点数组（按时间顺序，最新点在末尾）
+ */
+const gps_track_point_t *gps_track_points(void);
+
+/**
+ * @brief 累计追加的点数（单调递增，抽稀不减少；清空时归零）
+ */
+uint32_t gps_track_appended(void);
+
+/**
+ * @brief 当前存储步长 (分米)
+ */
+uint32_t gps_track_step_dm(void);
+
+/**
+ * @brief 将经纬度投影到轨迹的ENU平面
+ * @return 尚无原点时返回false
+ */
+bool gps_track_project(double lat, double lon, gps_track_point_t *point);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_TRACK_H
@@ -0,0 +1,158 @@
+/**
+ * @file gps_trip.h
+ * @brief 行程统计 - 每次定位O(1)更新的里程、运动时间和最高/平均速度
+ *
+ * 每次定位更新总里程和GPS_TRIP_COUNT个可单独清零的行程（如行程A/B）：
+ *
+ * - 距离按等距圆柱投影计算（相邻定位相距很近，误差可忽略）
+ * - 静止漂移抑制：速度不低于GPS_TRIP_MIN_SPEED_KMH且HDOP不超过
+ *   GPS_TRIP_MAX_HDOP时才累计；低速时相对上一个累计点的位移超过
+ *   HDOP × GPS_TRIP_JITTER_M_PER_HDOP 也累计，避免步行等慢速移动丢失
+ * - 相邻定位间隔超过GPS_TRIP_MAX_GAP_MS（失锁）时该段不计时间，距离按
+ *   失锁前后两点的直线距离补上
+ *
+ * 总里程和各行程保存在Flash中（独立于启动状态的两个扇区），运动中每
+ * GPS_TRIP_SAVE_INTERVAL_MS保存一次，关机前应调用gps_trip_save()。
+ */
+
+#ifndef GPS_TRIP_H
+#define GPS_TRIP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "gps/lc76g_i2c_adaptor.h"
+#include "gps/gps_warm_start.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#define GPS_TRIP_COUNT 2                        // 可单独清零的行程数 (Flash记录按2个布局)
+
+#ifndef GPS_TRIP_SECTORS
+#define GPS_TRIP_SECTORS 2
+#endif
+
+#ifndef GPS_TRIP_FLASH_OFFSET                   // 默认紧挨启动状态区之前
+#define GPS_TRIP_FLASH_OFFSET (GPS_WARM_START_FLASH_OFFSET - GPS_TRIP_SECTORS * FLASH_SECTOR_SIZE)
+#endif
+
+#ifndef GPS_TRIP_SAVE_INTERVAL_MS
+#define GPS_TRIP_SAVE_INTERVAL_MS 600000        // 里程变化后的周期保存间隔 (10分钟)
+#endif
+
+#ifndef GPS_TRIP_MIN_SPEED_KMH
+#define GPS_TRIP_MIN_SPEED_KMH 2.0f             // 低于该速度视为静止
+#endif
+
+#ifndef GPS_TRIP_MAX_HDOP
+#define GPS_TRIP_MAX_HDOP 5.0f                  // HDOP超过该值的定位不累计
+#endif
+
+#ifndef GPS_TRIP_JITTER_M_PER_HDOP
+#define GPS_TRIP_JITTER_M_PER_HDOP 5.0f         // 低速时位移门限 (米/HDOP)
+#endif
+
+#ifndef GPS_TRIP_MAX_GAP_MS
+#define GPS_TRIP_MAX_GAP_MS 5000                // 相邻定位间隔超过该值不计时间
+#endif
+
+// =============================================================================
+// 数据结构
+// =============================================================================
+
+#define GPS_TRIP_MAGIC   0x5054434Cu            // "LCTP"
+#define GPS_TRIP_VERSION 1
+
+/**
+ * @brief 一段行程（或总里程）的累计值
+ */
+typedef struct {
+    double distance_m;
+    uint64_t moving_ms;         // 速度不低于GPS_TRIP_MIN_SPEED_KMH的时间 (32位毫秒49.7天即回绕)
+    uint64_t elapsed_ms;        // 有定位的总时间（含停车）
+    float max_speed_kmh;
+    uint32_t start_utc;         // 清零时的UTC秒，0表示未知
+} gps_trip_t;
+
+/**
+ * @brief Flash中的一条记录 (64字节)
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t seq;
+    uint32_t odometer_dm;           // 总里程 (分米)
+    uint32_t odometer_moving_s;     // 总运动时间 (秒)
+    struct {
+        uint32_t distance_dm;
+        uint32_t moving_s;
+        uint32_t elapsed_s;
+        uint16_t max_speed_dkmh;    // 最高速度 (0.1公里/小时)
+        uint16_t reserved;
+        uint32_t start_utc;
+    } trips[GPS_TRIP_COUNT];
+    uint32_t crc;
+} gps_trip_record_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 从Flash载入总里程和各行程
+ * @return 是否找到有效记录
+ */
+bool gps_trip_init(void);
+
+/**
+ * @brief 每次读取GPS数据后调用
+ * @param fix 解析器输出，定位无效时只结束当前连续段（不计时间）
+ * @param fix_ms 定位时刻 (to_ms_since_boot)
+ */
+void gps_trip_update(const gps_fix_t *fix, uint32_t fix_ms);
+
+/**
+ * @brief 第index个行程，越界返回NULL
+ */
+const gps_trip_t *gps_trip_get(int index);
+
+/**
+ * @brief 总里程
+ */
+const gps_trip_t *gps_trip_odometer(void);
+
+/**
+ * @brief 平均速度（距离/运动时间），运动时间为0时返回0
+ */
+float gps_trip_avg_speed_kmh(const gps_trip_t *trip);
+
+/**
+ * @brief 清零第index个行程
+ * @param utc_now 当前UTC秒，0表示未知
+ */
+void gps_trip_reset(int index, uint32_t utc_now);
+
+/**
+ * @brief 立即保存到Flash
+ * @return 是否写入成功
+ */
+bool gps_trip_save(void);
+
+/**
+ * @brief 格式化一行摘要，如"总里程 1234.5km 行程A 12.34km ..."，供日志文件头和串口输出
+ * @return 写入的字符数（不含结尾0）
+ */
+int gps_trip_format_summary(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_TRIP_H
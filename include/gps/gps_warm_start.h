@@ -0,0 +1,178 @@
+/**
+ * @file gps_warm_start.h
+ * @brief GPS热/温启动状态持久化 - 缩短断电重启后的首次定位时间(TTFF)
+ *
+ * 把最后一次定位的位置、UTC时间、接收机配置和各启动方式的TTFF统计
+ * 保存在片上Flash末尾的两个扇区中。每条记录64字节，按顺序追加写入，
+ * 写满一个扇区后擦除另一个扇区继续写（磨损均衡），启动时取序号最大的
+ * 有效记录。
+ *
+ * 启动时由断电时长选择热/温/冷启动（阈值与vendor_gps_smart_start一致），
+ * 热/温启动前把当前UTC写回接收机RTC，并在首次定位时记录该启动方式的TTFF。
+ *
+ * 命令通过lc76g_i2c_adaptor发送；Flash擦写期间关闭中断，只在单核上下文中使用。
+ */
+
+#ifndef GPS_WARM_START_H
+#define GPS_WARM_START_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gps/lc76g_i2c_adaptor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef GPS_WARM_START_SECTORS
+#define GPS_WARM_START_SECTORS 2                // 轮换使用的Flash扇区数
+#endif
+
+#ifndef GPS_WARM_START_FLASH_OFFSET             // 默认位于Flash末尾
+#define GPS_WARM_START_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - GPS_WARM_START_SECTORS * FLASH_SECTOR_SIZE)
+#endif
+
+#ifndef GPS_WARM_START_SAVE_INTERVAL_MS
+#define GPS_WARM_START_SAVE_INTERVAL_MS 600000  // 定位期间周期保存间隔 (10分钟)
+#endif
+
+#define GPS_WARM_START_HOT_MAX_S  7200          // 断电2小时内热启动（星历仍有效）
+#define GPS_WARM_START_WARM_MAX_S 86400         // 断电24小时内温启动（历书/位置可用）
+
+// =============================================================================
+// 数据结构
+// =============================================================================
+
+#define GPS_WARM_START_MAGIC   0x5357434Cu      // "LCWS"
+#define GPS_WARM_START_VERSION 2
+
+typedef enum {
+    GPS_START_HOT           = 0,
+    GPS_START_WARM          = 1,
+    GPS_START_COLD          = 2,
+    GPS_START_COLD_ASSISTED = 3,    // 冷启动后注入了辅助数据（只用于TTFF统计）
+    GPS_START_TYPE_COUNT
+} gps_start_type_t;
+
+enum GPS_WARM_START_FLAG {
+    GPS_WARM_START_FLAG_FIX      = 0x0001,  // 位置和fix_utc有效
+    GPS_WARM_START_FLAG_CONFIG   = 0x0002,  // 接收机配置有效
+    GPS_WARM_START_FLAG_SHUTDOWN = 0x0004   // 正常关机时写入
+};
+
+/**
+ * @brief 接收机配置（启动后重新下发）
+ */
+typedef struct {
+    uint16_t fix_interval_ms;   // PMTK220 定位间隔
+    uint8_t nmea_rates[6];      // PMTK314 前6个字段: GLL RMC VTG GGA GSA GSV
+} gps_receiver_config_t;
+
+/**
+ * @brief Flash中的一条记录 (64字节)
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;             // GPS_WARM_START_FLAG
+    uint32_t seq;               // 写入序号，越大越新
+    uint32_t fix_utc;           // 最后定位时间 (1970-01-01起的UTC秒)
+    int32_t lat_e7;             // 纬度 (1e-7度)
+    int32_t lon_e7;             // 经度 (1e-7度)
+    int32_t alt_dm;             // 海拔 (分米)
+    gps_receiver_config_t config;
+    uint16_t ttff_count[GPS_START_TYPE_COUNT];      // 各启动方式的定位次数
+    uint16_t ttff_last_ds[GPS_START_TYPE_COUNT];    // 最近一次TTFF (0.1秒)
+    uint16_t ttff_avg_ds[GPS_START_TYPE_COUNT];     // TTFF滑动平均 (0.1秒，最近16次)
+    uint32_t crc;               // 之前所有字段的CRC32
+} gps_warm_start_record_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 扫描Flash载入最新记录
+ * @return 是否找到有效记录
+ */
+bool gps_warm_start_init(void);
+
+/**
+ * @brief 当前记录（含本次运行中的更新），没有有效记录时返回NULL
+ */
+const gps_warm_start_record_t *gps_warm_start_record(void);
+
+/**
+ * @brief 根据记录和当前UTC选择启动方式
+ * @param utc_now 当前UTC秒，0表示未知
+ * @param off_seconds 输出距最后定位的时长，可为NULL
+ * @return 启动方式（无定位记录或时间未知时为冷启动）
+ */
+gps_start_type_t gps_warm_start_select(uint32_t utc_now, uint32_t *off_seconds);
+
+/**
+ * @brief 执行启动：选择启动方式、回写RTC时间、发送启动命令并开始TTFF计时
+ * @param utc_now 当前UTC秒，0表示未知
+ * @return 启动命令是否得到应答
+ */
+bool gps_warm_start_boot(uint32_t utc_now);
+
+/**
+ * @brief 本次启动选择的启动方式
+ */
+gps_start_type_t gps_warm_start_boot_type(void);
+
+/**
+ * @brief 冷启动后已注入辅助数据，本次TTFF计入GPS_START_COLD_ASSISTED
+ */
+void gps_warm_start_mark_assisted(void);
+
+/**
+ * @brief 下发接收机配置（NMEA输出和定位间隔）并记入持久状态
+ * @return 命令是否全部发送成功
+ */
+bool gps_warm_start_apply_config(const gps_receiver_config_t *config);
+
+/**
+ * @brief 取保存的接收机配置
+ * @return 记录中是否有配置，没有时config填入默认值(RMC+GGA, 1秒)
+ */
+bool gps_warm_start_get_config(gps_receiver_config_t *config);
+
+/**
+ * @brief 每次读取GPS数据后调用：更新位置，首次定位时记录TTFF，并按间隔保存
+ */
+void gps_warm_start_update(const gps_fix_t *fix);
+
+/**
+ * @brief 立即写入一条记录
+ * @param shutdown 是否为关机前的最后一次保存
+ * @return 是否写入成功
+ */
+bool gps_warm_start_save(bool shutdown);
+
+/**
+ * @brief 某启动方式的TTFF统计
+ * @return 是否有该启动方式的定位记录
+ */
+bool gps_warm_start_get_ttff(gps_start_type_t type, uint32_t *last_ms, uint32_t *avg_ms, uint32_t *count);
+
+/**
+ * @brief 打印各启动方式的TTFF统计
+ */
+void gps_warm_start_print_stats(void);
+
+/**
+ * @brief 启动方式名称（"热启动"/"温启动"/"冷启动"/"辅助冷启动"）
+ */
+const char *gps_warm_start_type_name(gps_start_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPS_WARM_START_H
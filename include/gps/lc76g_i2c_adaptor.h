@@ -17,6 +17,7 @@
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
 #include "pico/time.h"
+#include "gps/gps_nmea.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -85,8 +86,8 @@ typedef struct {
 // GPS数据结构
 // =============================================================================
 
-// LC76G GPS数据结构
-typedef struct {
+// LC76G GPS数据结构（紧凑的定点版本见gps/gps_fix.h）
+typedef struct LC76G_GPS_Data {
     // 基本定位数据
     double Lon;         // 经度 (十进制度格式)
     double Lat;         // 纬度 (十进制度格式)
@@ -115,12 +116,6 @@ typedef struct {
     char NavStatus;     // 导航状态 (V=无效, A=有效)
 } LC76G_GPS_Data;
 
-// 坐标结构
-typedef struct {
-    double Lon;         // 经度
-    double Lat;         // 纬度
-} Coordinates;
-
 // =============================================================================
 // I2C适配器函数声明
 // =============================================================================
@@ -156,12 +151,109 @@ bool lc76g_send_command_and_get_response(const char *cmd_buf, const char *expect
                                         uint32_t timeout_ms, Ql_gnss_command_contx_TypeDef *info);
 
 /**
- * @brief 读取GPS数据
+ * @brief 不发送命令，继续等待响应（如$PAIR001结果为"处理中"时）
+ * @param expect_rsp 期望的响应前缀
+ * @param timeout_ms 超时时间(毫秒)
+ * @param info 命令上下文结构指针
+ * @return 是否成功获取响应
+ */
+bool lc76g_wait_response(const char *expect_rsp, uint32_t timeout_ms, Ql_gnss_command_contx_TypeDef *info);
+
+/**
+ * @brief 读取并解析GPS数据
+ *
+ * RMC/GGA直接解析为定点的gps_fix_t，各语句只更新自己带有的字段，字段为空
+ * （如失锁时的坐标）时保留上一次的值。
+ * @param fix 输出定位，读取失败时为上一次的解析结果
+ * @return 是否成功读取到有效定位
+ */
+bool lc76g_read_fix(gps_fix_t *fix);
+
+/**
+ * @brief 读取GPS数据（旧结构，由lc76g_read_fix的结果转换）
  * @param gps_data GPS数据结构指针
  * @return 是否成功读取到有效数据
  */
 bool lc76g_read_gps_data(LC76G_GPS_Data *gps_data);
 
+/**
+ * @brief 解析已读取的NMEA数据（与lc76g_read_fix使用同一解析路径，需先调用lc76g_i2c_init）
+ * @param nmea_data NMEA文本（以NUL结尾）
+ * @param data_len 数据长度
+ * @param fix 输出定位，可为NULL
+ * @return 解析后是否为有效定位
+ */
+bool lc76g_parse_nmea_fix(const char *nmea_data, int data_len, gps_fix_t *fix);
+
+/**
+ * @brief 同lc76g_parse_nmea_fix，输出旧结构
+ */
+bool lc76g_parse_nmea(const char *nmea_data, int data_len, LC76G_GPS_Data *gps_data);
+
+/**
+ * @brief 获取当前UTC时间
+ *
+ * 由最近一次RMC语句的时间和日期加上此后经过的本地时间推算。
+ * 模块RTC由备用电池维持时，未定位也能得到时间。
+ * @param utc_seconds 输出1970-01-01起的UTC秒数
+ * @return 是否已收到过带日期的RMC语句
+ */
+bool lc76g_get_utc_time(uint32_t *utc_seconds);
+
+/**
+ * @brief 最近一次收到NMEA数据的时刻
+ *
+ * I2C读取完成（或lc76g_parse_nmea被调用）、开始解析之前的time_us_32时刻，
+ * 变化即表示读到了新数据（遥测延迟的起点见lc76g_epoch_hook_t）。
+ * @return 微秒时刻，未收到过数据时为0
+ */
+uint32_t lc76g_get_rx_time_us(void);
+
+/**
+ * @brief NMEA语句统计（校验和错误、各类语句数量），自启动起累计
+ */
+void lc76g_get_nmea_stats(gps_nmea_stats_t *stats);
+
+/**
+ * @brief 历元钩子，一个历元的RMC和GGA都解析完成时调用
+ * @param fix 解析到该历元为止的定位
+ * @param since_us 该历元可用时刻的下界：上一次读空模块缓冲时读取长度寄存器的时刻
+ *                 （lc76g_parse_nmea注入时为调用时刻；启动后第一次读取为0）。
+ *                 以此为起点的延迟是上界，包含数据在模块缓冲中等待读取的时间
+ */
+typedef void (*lc76g_epoch_hook_t)(const gps_fix_t *fix, uint32_t since_us, void *ctx);
+
+/**
+ * @brief 设置历元钩子
+ *
+ * 一次读取中缓存了多个历元时，每个历元各调用一次（lc76g_read_fix只返回最后一个）。
+ * 语句时间变化或同类语句再次出现时开始新的历元。解析中凑齐的历元先排队（一次
+ * 读取最多8个），lc76g_read_fix/lc76g_parse_nmea_fix释放I2C互斥锁后、返回前
+ * 依次调用钩子，钩子阻塞（如USB写）时不占用总线。需在lc76g_i2c_init之后调用。
+ * @param hook 钩子函数，NULL表示取消
+ */
+void lc76g_set_epoch_hook(lc76g_epoch_hook_t hook, void *ctx);
+
+/**
+ * @brief 总线空闲钩子，持有I2C互斥锁时调用，可访问同一总线上的其他设备
+ */
+typedef void (*lc76g_bus_gap_hook_t)(void *ctx);
+
+/**
+ * @brief 设置总线空闲钩子
+ *
+ * 读写LC76G时各段传输之间固定等待10ms，钩子在等待开始时运行，耗时从等待中
+ * 扣除，GPS的总线时序不变。钩子应自行控制采样间隔，单次运行远小于10ms。
+ * 需在lc76g_i2c_init之后调用。
+ * @param hook 钩子函数，NULL表示取消
+ */
+void lc76g_set_bus_gap_hook(lc76g_bus_gap_hook_t hook, void *ctx);
+
+/**
+ * @brief 在GPS读写之外运行总线空闲钩子（总线正被占用时直接返回）
+ */
+void lc76g_run_bus_gap_hook(void);
+
 /**
  * @brief 设置调试输出
  * @param enable 是否启用调试输出
@@ -0,0 +1,50 @@
+/**
+ * @file lc76g_i2c_xfer.h
+ * @brief LC76G适配器的I2C传输和计时原语
+ *
+ * 读取状态机在SRAM中运行，它调用的传输和等待也必须不经过XIP：
+ * 固件实现（lc76g_i2c_xfer_pico.c）直接操作I2C和定时器寄存器，整个字节
+ * 循环放在SRAM中；SDK的i2c_write_blocking/i2c_read_blocking/sleep_us
+ * 在Flash中，字库读取换出XIP缓存后每次传输都会重新取指。
+ * 主机构建使用lc76g_i2c_xfer.c，转调SDK shim。
+ *
+ * 语义与i2c_write_blocking/i2c_read_blocking(nostop=false)相同：
+ * 返回传输的字节数，地址无应答时返回PICO_ERROR_GENERIC，无超时。
+ */
+
+#ifndef LC76G_I2C_XFER_H
+#define LC76G_I2C_XFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hardware/i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 向从机写入len字节，结束时发送STOP
+ */
+int lc76g_i2c_xfer_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len);
+
+/**
+ * @brief 从从机读取len字节，结束时发送STOP
+ */
+int lc76g_i2c_xfer_read(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len);
+
+/**
+ * @brief 当前时间（微秒，32位回绕）
+ */
+uint32_t lc76g_i2c_xfer_time_us(void);
+
+/**
+ * @brief 等待到start之后us微秒（start取自lc76g_i2c_xfer_time_us）
+ */
+void lc76g_i2c_xfer_wait_until(uint32_t start, uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LC76G_I2C_XFER_H
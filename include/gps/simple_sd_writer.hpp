@@ -88,6 +88,13 @@ public:
      */
     bool file_exists(const std::string& filepath);
     
+    /**
+     * @brief 删除文件
+     * @param filepath 文件路径
+     * @return 删除是否成功
+     */
+    bool remove_file(const std::string& filepath);
+    
     /**
      * @brief 获取文件大小
      * @param filepath 文件路径
@@ -10,9 +10,10 @@
 #include <stdbool.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "gps/gps_fix.h"     // Coordinates, gps_fix_t
 
 // LC76G Enhanced GPS data structure supporting multiple NMEA formats
-typedef struct {
+typedef struct GNRMC {
     // Basic positioning data
     double Lon;         // Longitude (decimal degree format)
     double Lat;         // Latitude (decimal degree format)
@@ -48,12 +49,6 @@ typedef struct {
     bool Valid;         // Whether response is valid
 } PAIRResponse;
 
-// Coordinates structure
-typedef struct {
-    double Lon;         // Longitude
-    double Lat;         // Latitude
-} Coordinates;
-
 /**
  * @brief Set whether to output detailed debug logs
  * @param enable Whether to enable
@@ -89,6 +84,13 @@ void vendor_gps_exit_backup_mode(void);
  */
 GNRMC vendor_gps_get_gnrmc(void);
 
+/**
+ * @brief Parse an already received NMEA buffer (same logic as vendor_gps_get_gnrmc)
+ * @param nmea_data NUL-terminated NMEA text, truncated to the internal buffer size
+ * @return GNRMC data structure
+ */
+GNRMC vendor_gps_parse_nmea(const char *nmea_data);
+
 /**
  * @brief Get GPS coordinates in Baidu Map format
  * @return Baidu Map coordinates
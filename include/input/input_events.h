@@ -0,0 +1,136 @@
+/**
+ * @file input_events.h
+ * @brief 按键和摇杆输入事件队列
+ *
+ * 按键由GPIO边沿中断驱动：中断中记录边沿时刻并消抖，松开时产生短按，按住
+ * 达到BUTTON_LONG_PRESS_MS时由定时器产生长按，主循环阻塞在GPS读取时也不会
+ * 漏掉或推迟判定。摇杆（与LC76G共用I2C1）通过lc76g_set_bus_gap_hook在GPS
+ * 各段传输之间的等待中采样，GPS读取之外由主循环调用input_events_poll采样，
+ * 间隔JOYSTICK_LOOP_DELAY_MS。
+ *
+ * 两个来源各写一个单生产者单消费者环形队列（按键在中断中写，摇杆在主循环
+ * 上下文中写），不需要关中断；input_events_pop按时间戳合并。事件带有输入
+ * 发生的时刻，UI处理完并绘制后调用input_events_record_latency统计输入到
+ * 屏幕的延迟。
+ *
+ * 按键/摇杆的判定逻辑不依赖硬件（主机也可构建），GPIO中断、定时器和摇杆的
+ * I2C读取在input_events_pico.c中。
+ */
+
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// 配置
+// =============================================================================
+
+#ifndef INPUT_QUEUE_SIZE
+#define INPUT_QUEUE_SIZE            16      // 每个来源的队列长度 (2的幂)
+#endif
+
+#define INPUT_LATENCY_BUCKETS       6       // <1ms, <5ms, <20ms, <50ms, <100ms, >=100ms
+
+// =============================================================================
+// 事件
+// =============================================================================
+
+enum INPUT_EVENT_TYPE {
+    INPUT_BUTTON_SHORT = 1,     // 松开时产生，duration_ms为按住时长
+    INPUT_BUTTON_LONG,          // 按住达到BUTTON_LONG_PRESS_MS时产生
+    INPUT_JOY_UP,               // 摇杆偏出阈值
+    INPUT_JOY_DOWN,
+    INPUT_JOY_LEFT,
+    INPUT_JOY_RIGHT,
+    INPUT_JOY_CENTER,           // 摇杆回中
+    INPUT_JOY_PRESS,            // 摇杆按下
+    INPUT_JOY_RELEASE
+};
+
+typedef struct {
+    uint8_t type;               // INPUT_EVENT_TYPE
+    uint16_t duration_ms;
+    uint32_t time_us;           // 输入发生的时刻 (time_us_32)
+} input_event_t;
+
+/**
+ * @brief 统计
+ */
+typedef struct {
+    uint32_t events;
+    uint32_t dropped;           // 队列满丢弃
+    uint32_t bounces;           // 消抖窗口内被忽略的边沿
+    uint32_t joystick_samples;
+    uint32_t joystick_errors;   // I2C读取失败
+    uint32_t joystick_read_max_us;
+    uint32_t handled;           // 已记录延迟的事件
+    uint64_t latency_sum_us;
+    uint32_t latency_max_us;
+    uint32_t latency_buckets[INPUT_LATENCY_BUCKETS];
+} input_events_stats_t;
+
+// =============================================================================
+// 接口
+// =============================================================================
+
+/**
+ * @brief 初始化按键中断和摇杆采样（需在lc76g_i2c_init之后调用）
+ */
+void input_events_init(void);
+
+/**
+ * @brief GPS读取之外采样摇杆，在主循环中调用
+ */
+void input_events_poll(void);
+
+/**
+ * @brief 取出最早的事件
+ * @return 队列为空时返回false
+ */
+bool input_events_pop(input_event_t *event);
+
+/**
+ * @brief 事件处理并绘制完成后记录输入到屏幕的延迟
+ * @param done_us 绘制完成的时刻
+ */
+void input_events_record_latency(const input_event_t *event, uint32_t done_us);
+
+void input_events_get_stats(input_events_stats_t *stats);
+void input_events_print_stats(void);
+
+// -----------------------------------------------------------------------------
+// 判定逻辑（input_events_pico.c和主机基准使用）
+// -----------------------------------------------------------------------------
+
+void input_events_reset(void);
+
+/**
+ * @brief 处理按键电平（边沿中断或定时器中调用）
+ * @param pressed 当前是否按下
+ * @param now_us 当前时刻
+ * @return 需要再次调用的延时（微秒，消抖窗口结束或长按到期），0表示不需要
+ */
+uint32_t input_button_update(bool pressed, uint32_t now_us);
+
+/**
+ * @brief 处理一次摇杆采样
+ * @param dx,dy 相对中点的偏移（12位ADC，右/下为正）
+ */
+void input_joystick_sample(int32_t dx, int32_t dy, bool pressed, uint32_t now_us);
+
+/**
+ * @brief 记录一次摇杆I2C读取的结果和耗时
+ */
+void input_joystick_read_result(bool ok, uint32_t read_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_EVENTS_H
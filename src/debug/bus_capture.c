@@ -0,0 +1,299 @@
+/**
+ * @file bus_capture.c
+ * @brief I2C/SPI总线传输捕获实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/spi.h"
+#include "pico/time.h"
+#include "ff.h"
+#include "debug/bus_capture.h"
+
+_Static_assert(sizeof(bus_capture_record_t) == 20, "bus_capture_record_t必须为20字节");
+_Static_assert(sizeof(bus_capture_file_header_t) == 12, "bus_capture_file_header_t必须为12字节");
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static bus_capture_record_t g_ring[BUS_CAPTURE_RING_RECORDS];
+static uint32_t g_head = 0;             // 下一条写入位置
+static uint32_t g_count = 0;            // 缓冲中的记录数
+static uint32_t g_dropped_pending = 0;  // 上次写出后丢失的记录数
+static uint32_t g_dropped_total = 0;
+static bool g_enabled = false;
+static bool g_flushing = false;
+static uint8_t g_i2c_mask = 0xFF;
+static uint8_t g_spi_mask = 0xFF;
+static uint32_t g_stage_start[BUS_STAGE_COUNT] = {0};
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline uint32_t now_us32(void) {
+    return (uint32_t)to_us_since_boot(get_absolute_time());
+}
+
+static inline bool capture_active(void) {
+    return g_enabled && !g_flushing;
+}
+
+static bus_capture_record_t *push_record(void) {
+    if (g_count == BUS_CAPTURE_RING_RECORDS) {
+        // 覆盖最旧的记录
+        g_count--;
+        g_dropped_pending++;
+        g_dropped_total++;
+    }
+    bus_capture_record_t *rec = &g_ring[g_head];
+    g_head = (g_head + 1) % BUS_CAPTURE_RING_RECORDS;
+    g_count++;
+    memset(rec, 0, sizeof(*rec));
+    return rec;
+}
+
+static bus_capture_record_t *last_record(void) {
+    if (g_count == 0) {
+        return NULL;
+    }
+    return &g_ring[(g_head + BUS_CAPTURE_RING_RECORDS - 1) % BUS_CAPTURE_RING_RECORDS];
+}
+
+static int16_t clamp_status(int result) {
+    if (result > INT16_MAX) {
+        return INT16_MAX;
+    }
+    return (int16_t)result;
+}
+
+static void record_transfer(uint8_t type, uint8_t bus, uint8_t addr, uint32_t t0, uint32_t t1,
+                            size_t len, int result, const uint8_t *data) {
+    // SPI连续小块传输（逐像素、逐命令字节）合并，避免刷屏时填满缓冲
+    if (type >= BUS_CAPTURE_SPI_WRITE) {
+        bus_capture_record_t *prev = last_record();
+        if (prev && prev->type == type && prev->bus == bus && prev->merged < UINT8_MAX &&
+            prev->status >= 0 && result >= 0 &&
+            (uint32_t)(t0 - (prev->t_us + prev->dur_us)) <= BUS_CAPTURE_MERGE_GAP_US &&
+            (uint32_t)prev->len + len <= UINT16_MAX) {
+            prev->dur_us = t1 - prev->t_us;
+            prev->len = (uint16_t)(prev->len + len);
+            prev->status = clamp_status(prev->status + result);
+            prev->merged++;
+            return;
+        }
+    }
+
+    bus_capture_record_t *rec = push_record();
+    rec->t_us = t0;
+    rec->dur_us = t1 - t0;
+    rec->len = len > UINT16_MAX ? UINT16_MAX : (uint16_t)len;
+    rec->type = type;
+    rec->bus = bus;
+    rec->addr = addr;
+    rec->status = clamp_status(result);
+    if (data && result > 0) {
+        size_t n = (size_t)result < sizeof(rec->data) ? (size_t)result : sizeof(rec->data);
+        memcpy(rec->data, data, n);
+    }
+}
+
+// =============================================================================
+// 链接器包装 (-Wl,--wrap=...)
+// =============================================================================
+
+int __real_i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int __real_i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+int __real_spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+int __real_spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len);
+int __real_spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len);
+
+int __wrap_i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    uint8_t bus = (uint8_t)i2c_hw_index(i2c);
+    if (!capture_active() || !(g_i2c_mask & (1u << bus))) {
+        return __real_i2c_write_blocking(i2c, addr, src, len, nostop);
+    }
+    uint32_t t0 = now_us32();
+    int result = __real_i2c_write_blocking(i2c, addr, src, len, nostop);
+    record_transfer(BUS_CAPTURE_I2C_WRITE, bus, addr, t0, now_us32(), len, result, src);
+    return result;
+}
+
+int __wrap_i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    uint8_t bus = (uint8_t)i2c_hw_index(i2c);
+    if (!capture_active() || !(g_i2c_mask & (1u << bus))) {
+        return __real_i2c_read_blocking(i2c, addr, dst, len, nostop);
+    }
+    uint32_t t0 = now_us32();
+    int result = __real_i2c_read_blocking(i2c, addr, dst, len, nostop);
+    record_transfer(BUS_CAPTURE_I2C_READ, bus, addr, t0, now_us32(), len, result, dst);
+    return result;
+}
+
+int __wrap_spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    uint8_t bus = (uint8_t)spi_get_index(spi);
+    if (!capture_active() || !(g_spi_mask & (1u << bus))) {
+        return __real_spi_write_blocking(spi, src, len);
+    }
+    uint32_t t0 = now_us32();
+    int result = __real_spi_write_blocking(spi, src, len);
+    record_transfer(BUS_CAPTURE_SPI_WRITE, bus, 0, t0, now_us32(), len, result, NULL);
+    return result;
+}
+
+int __wrap_spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len) {
+    uint8_t bus = (uint8_t)spi_get_index(spi);
+    if (!capture_active() || !(g_spi_mask & (1u << bus))) {
+        return __real_spi_read_blocking(spi, repeated_tx_data, dst, len);
+    }
+    uint32_t t0 = now_us32();
+    int result = __real_spi_read_blocking(spi, repeated_tx_data, dst, len);
+    record_transfer(BUS_CAPTURE_SPI_READ, bus, 0, t0, now_us32(), len, result, NULL);
+    return result;
+}
+
+int __wrap_spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len) {
+    uint8_t bus = (uint8_t)spi_get_index(spi);
+    if (!capture_active() || !(g_spi_mask & (1u << bus))) {
+        return __real_spi_write_read_blocking(spi, src, dst, len);
+    }
+    uint32_t t0 = now_us32();
+    int result = __real_spi_write_read_blocking(spi, src, dst, len);
+    record_transfer(BUS_CAPTURE_SPI_XFER, bus, 0, t0, now_us32(), len, result, NULL);
+    return result;
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void bus_capture_init(void) {
+    g_head = 0;
+    g_count = 0;
+    g_dropped_pending = 0;
+    g_dropped_total = 0;
+    g_i2c_mask = 0xFF;
+    g_spi_mask = 0xFF;
+    memset(g_stage_start, 0, sizeof(g_stage_start));
+}
+
+void bus_capture_enable(bool enable) {
+    g_enabled = enable;
+}
+
+bool bus_capture_is_enabled(void) {
+    return g_enabled;
+}
+
+void bus_capture_set_filter(uint8_t i2c_mask, uint8_t spi_mask) {
+    g_i2c_mask = i2c_mask;
+    g_spi_mask = spi_mask;
+}
+
+void bus_capture_stage_begin(uint8_t stage) {
+    if (!capture_active() || stage >= BUS_STAGE_COUNT) {
+        return;
+    }
+    bus_capture_record_t *rec = push_record();
+    rec->t_us = now_us32();
+    rec->type = BUS_CAPTURE_STAGE_BEGIN;
+    rec->addr = stage;
+    g_stage_start[stage] = rec->t_us;
+}
+
+void bus_capture_stage_end(uint8_t stage) {
+    if (!capture_active() || stage >= BUS_STAGE_COUNT) {
+        return;
+    }
+    bus_capture_record_t *rec = push_record();
+    rec->t_us = now_us32();
+    rec->dur_us = rec->t_us - g_stage_start[stage];
+    rec->type = BUS_CAPTURE_STAGE_END;
+    rec->addr = stage;
+}
+
+uint32_t bus_capture_pending(void) {
+    return g_count;
+}
+
+uint32_t bus_capture_dropped(void) {
+    return g_dropped_total;
+}
+
+bool bus_capture_flush(const char *path) {
+    if (!path || g_flushing) {
+        return false;
+    }
+
+    uint32_t t0 = now_us32();
+    g_flushing = true;
+
+    FIL file;
+    FRESULT fr = f_open(&file, path, FA_WRITE | FA_OPEN_APPEND);
+    if (fr != FR_OK) {
+        printf("[总线捕获] 无法打开文件 %s: %d\n", path, fr);
+        g_flushing = false;
+        return false;
+    }
+
+    bool ok = true;
+    UINT written = 0;
+    if (f_size(&file) == 0) {
+        bus_capture_file_header_t header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, BUS_CAPTURE_MAGIC, 4);
+        header.version = BUS_CAPTURE_VERSION;
+        header.record_size = sizeof(bus_capture_record_t);
+        ok = f_write(&file, &header, sizeof(header), &written) == FR_OK && written == sizeof(header);
+    }
+
+    if (ok && g_dropped_pending > 0) {
+        bus_capture_record_t gap;
+        memset(&gap, 0, sizeof(gap));
+        gap.t_us = g_count ? g_ring[(g_head + BUS_CAPTURE_RING_RECORDS - g_count) % BUS_CAPTURE_RING_RECORDS].t_us : t0;
+        gap.type = BUS_CAPTURE_GAP;
+        gap.len = g_dropped_pending > UINT16_MAX ? UINT16_MAX : (uint16_t)g_dropped_pending;
+        ok = f_write(&file, &gap, sizeof(gap), &written) == FR_OK && written == sizeof(gap);
+    }
+
+    // 环形缓冲最多分两段连续写出
+    uint32_t tail = (g_head + BUS_CAPTURE_RING_RECORDS - g_count) % BUS_CAPTURE_RING_RECORDS;
+    uint32_t remaining = g_count;
+    while (ok && remaining > 0) {
+        uint32_t chunk = BUS_CAPTURE_RING_RECORDS - tail;
+        if (chunk > remaining) {
+            chunk = remaining;
+        }
+        UINT bytes = chunk * sizeof(bus_capture_record_t);
+        ok = f_write(&file, &g_ring[tail], bytes, &written) == FR_OK && written == bytes;
+        tail = (tail + chunk) % BUS_CAPTURE_RING_RECORDS;
+        remaining -= chunk;
+    }
+
+    f_close(&file);
+    g_flushing = false;
+
+    if (!ok) {
+        printf("[总线捕获] 写入失败: %s\n", path);
+        return false;
+    }
+
+    g_head = 0;
+    g_count = 0;
+    g_dropped_pending = 0;
+
+    // 记录本次写出的耗时（写出期间的SD传输不记录）
+    bus_capture_record_t *begin = push_record();
+    begin->t_us = t0;
+    begin->type = BUS_CAPTURE_STAGE_BEGIN;
+    begin->addr = BUS_STAGE_CAPTURE_FLUSH;
+    bus_capture_record_t *end = push_record();
+    end->t_us = now_us32();
+    end->dur_us = end->t_us - t0;
+    end->type = BUS_CAPTURE_STAGE_END;
+    end->addr = BUS_STAGE_CAPTURE_FLUSH;
+    return true;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file xip_stats_pico.c
+ * @brief XIP缓存命中统计实现（读取XIP_CTRL的CTR_HIT/CTR_ACC）
+ *
+ * 计数器为32位饱和计数器，写任意值清零；每个阶段开始时清零，不会饱和。
+ * begin/end放在SRAM中，统计本身不产生XIP访问。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "debug/xip_stats.h"
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static xip_stage_stats_t g_stats[XIP_STAGE_COUNT];
+static uint32_t g_start_us = 0;
+
+static const char *const kStageNames[XIP_STAGE_COUNT] = {
+    "GPS读取",
+    "渲染",
+};
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void __not_in_flash_func(xip_stats_begin)(uint8_t stage) {
+    (void)stage;
+    xip_ctrl_hw->ctr_hit = 0;
+    xip_ctrl_hw->ctr_acc = 0;
+    g_start_us = time_us_32();
+}
+
+void __not_in_flash_func(xip_stats_end)(uint8_t stage) {
+    uint32_t elapsed = time_us_32() - g_start_us;
+    uint32_t accesses = xip_ctrl_hw->ctr_acc;
+    uint32_t hits = xip_ctrl_hw->ctr_hit;
+    if (stage >= XIP_STAGE_COUNT) {
+        return;
+    }
+
+    xip_stage_stats_t *s = &g_stats[stage];
+    uint32_t misses = accesses > hits ? accesses - hits : 0;
+    s->frames++;
+    s->last_us = elapsed;
+    s->last_accesses = accesses;
+    s->last_misses = misses;
+    s->accesses += accesses;
+    s->misses += misses;
+    if (misses > s->worst_misses) {
+        s->worst_misses = misses;
+    }
+    if (elapsed > s->worst_us) {
+        s->worst_us = elapsed;
+        s->worst_us_misses = misses;
+    }
+}
+
+bool xip_stats_get(uint8_t stage, xip_stage_stats_t *stats) {
+    if (stage >= XIP_STAGE_COUNT || !stats) {
+        return false;
+    }
+    *stats = g_stats[stage];
+    return true;
+}
+
+void xip_stats_reset(void) {
+    memset(g_stats, 0, sizeof(g_stats));
+}
+
+void xip_stats_print(void) {
+    for (int i = 0; i < XIP_STAGE_COUNT; i++) {
+        const xip_stage_stats_t *s = &g_stats[i];
+        if (s->frames == 0) {
+            continue;
+        }
+        // 命中率 (0.1%)
+        uint32_t hit_permille = s->accesses ? (uint32_t)((s->accesses - s->misses) * 1000u / s->accesses) : 1000u;
+        printf("[XIP统计] %s: %lu帧, 命中率%lu.%lu%%, 平均未命中%lu/帧, 最多%lu; "
+               "最坏耗时%luus (未命中%lu), 最近%luus\n",
+               kStageNames[i], (unsigned long)s->frames,
+               (unsigned long)(hit_permille / 10u), (unsigned long)(hit_permille % 10u),
+               (unsigned long)(s->misses / s->frames), (unsigned long)s->worst_misses,
+               (unsigned long)s->worst_us, (unsigned long)s->worst_us_misses, (unsigned long)s->last_us);
+    }
+}
@@ -13,6 +13,7 @@
 #include <algorithm>
 
 #include "pico/stdlib.h"
+#include "pico/platform.h"
 #include "hardware/gpio.h"
 #include "hardware/spi.h" 
 #include "hardware/pwm.h"
@@ -37,6 +38,9 @@ namespace Commands {
     constexpr uint8_t PTLAR   = 0x30;
 }
 
+// 像素路径（颜色转换、区域填充、字符光栅化、窗口设置和SPI数据写入）放在SRAM中，
+// 大字库读取和printf换出XIP缓存时像素循环不受影响；小的辅助函数强制内联到这些函数中。
+// spi_write_blocking在SDK中本身就是__not_in_flash_func。
 struct ILI9488Driver::Impl {
     // Hardware configuration
     spi_inst_t* spi_inst_;
@@ -68,29 +72,29 @@ struct ILI9488Driver::Impl {
     }
     
     // Hardware control methods
-    void setCS(bool level) {
+    __force_inline void setCS(bool level) {
         gpio_put(pin_cs_, level ? 1 : 0);
     }
     
-    void setDC(bool level) {
+    __force_inline void setDC(bool level) {
         gpio_put(pin_dc_, level ? 1 : 0);
     }
     
-    void writeCommand(uint8_t cmd) {
+    __force_inline void writeCommand(uint8_t cmd) {
         setCS(false);
         setDC(false);  // Command mode
         spi_write_blocking(spi_inst_, &cmd, 1);
         setCS(true);
     }
     
-    void writeData(uint8_t data) {
+    __force_inline void writeData(uint8_t data) {
         setCS(false);
         setDC(true);   // Data mode
         spi_write_blocking(spi_inst_, &data, 1);
         setCS(true);
     }
     
-    void writeDataBuffer(const uint8_t* data, size_t length) {
+    void __not_in_flash_func(writeDataBuffer)(const uint8_t* data, size_t length) {
         if (!data || length == 0) return;
         
         setCS(false);
@@ -113,7 +117,7 @@ struct ILI9488Driver::Impl {
 
     
     // Convert RGB565 to RGB666 bytes
-    void rgb565ToRGB666Bytes(uint16_t color, uint8_t* bytes) {
+    __force_inline void rgb565ToRGB666Bytes(uint16_t color, uint8_t* bytes) {
         // 提取RGB565的各个分量
         uint8_t r5 = (color >> 11) & 0x1F;  // 5位红色 (0-31)
         uint8_t g6 = (color >> 5) & 0x3F;   // 6位绿色 (0-63)
@@ -131,7 +135,7 @@ struct ILI9488Driver::Impl {
     }
     
     // Convert RGB888 to RGB666 bytes
-    void rgb888ToRGB666Bytes(uint32_t color, uint8_t* bytes) {
+    __force_inline void rgb888ToRGB666Bytes(uint32_t color, uint8_t* bytes) {
         // 提取RGB888的各个分量
         uint8_t r8 = (color >> 16) & 0xFF;  // 8位红色
         uint8_t g8 = (color >> 8) & 0xFF;   // 8位绿色
@@ -144,7 +148,7 @@ struct ILI9488Driver::Impl {
     }
     
     // Set drawing window
-    void setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    void __not_in_flash_func(setWindow)(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
         // Column address
         writeCommand(Commands::CASET);
         writeData(x0 >> 8);
@@ -388,7 +392,7 @@ void ILI9488Driver::drawPixel(uint16_t x, uint16_t y, uint16_t color565) {
 }
 
 // Draw a single pixel (RGB888/24-bit)
-void ILI9488Driver::drawPixelRGB24(uint16_t x, uint16_t y, uint32_t color24) {
+void __not_in_flash_func(ILI9488Driver::drawPixelRGB24)(uint16_t x, uint16_t y, uint32_t color24) {
     if (x >= pImpl_->display_width_ || y >= pImpl_->display_height_) {
         return;
     }
@@ -406,7 +410,7 @@ void ILI9488Driver::drawPixelRGB666(uint16_t x, uint16_t y, uint32_t color666) {
 }
 
 // Write multiple pixels (RGB565)
-void ILI9488Driver::writePixels(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, 
+void __not_in_flash_func(ILI9488Driver::writePixels)(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, 
                                 const uint16_t* colors, size_t count) {
     if (!colors || count == 0) return;
     
@@ -434,7 +438,7 @@ void ILI9488Driver::writePixels(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t
 }
 
 // Fill rectangular area (RGB565)
-void ILI9488Driver::fillArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+void __not_in_flash_func(ILI9488Driver::fillArea)(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
     if (x0 > x1 || y0 > y1) return;
     
     pImpl_->setWindow(x0, y0, x1, y1);
@@ -450,7 +454,7 @@ void ILI9488Driver::fillArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
 }
 
     // Fill rectangular area (RGB666 native - no conversion needed)
-    void ILI9488Driver::fillAreaRGB666(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color666) {
+    void __not_in_flash_func(ILI9488Driver::fillAreaRGB666)(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color666) {
         if (x0 > x1 || y0 > y1) return;
         
         pImpl_->setWindow(x0, y0, x1, y1);
@@ -556,6 +560,16 @@ void ILI9488Driver::setPartialArea(uint16_t /* x0 */, uint16_t y0, uint16_t /* x
     pImpl_->writeData(y1 & 0xFF);
 }
 
+// === Data Transfer Methods ===
+
+void __not_in_flash_func(ILI9488Driver::writeDataBuffer)(const uint8_t* data, size_t length) {
+    pImpl_->writeDataBuffer(data, length);
+}
+
+void ILI9488Driver::setAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    pImpl_->setWindow(x0, y0, x1, y1);
+}
+
 
 
 // === DMA-Optimized Fill Methods ===
@@ -593,7 +607,7 @@ uint16_t ILI9488Driver::getStringWidth(std::string_view str) const {
 }
 
 // Draw a character
-void ILI9488Driver::drawChar(uint16_t x, uint16_t y, char c, uint32_t color, uint32_t bg_color) {
+void __not_in_flash_func(ILI9488Driver::drawChar)(uint16_t x, uint16_t y, char c, uint32_t color, uint32_t bg_color) {
     using namespace font;
     
     const uint8_t* char_data = get_char_data(c);
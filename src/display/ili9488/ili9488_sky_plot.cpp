@@ -0,0 +1,384 @@
+/**
+ * @file ili9488_sky_plot.cpp
+ * @brief 卫星天空图实现
+ */
+
+#include "ili9488_sky_plot.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace ili9488 {
+
+namespace {
+
+// sin(0°..90°) × 16384
+constexpr int16_t kSinQ14[91] = {
+    0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+    2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+    5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+    8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384,
+};
+
+// 信噪比阈值 (dB-Hz)
+constexpr uint8_t kSnrFair = 25;
+constexpr uint8_t kSnrGood = 35;
+
+constexpr uint8_t kMaxRowSpans = 16;
+
+uint32_t isqrt(uint32_t v) {
+    uint32_t r = 0;
+    while ((r + 1) * (r + 1) <= v) {
+        r++;
+    }
+    return r;
+}
+
+/**
+ * @brief r × sin / 16384，四舍五入（正负对称）
+ */
+int32_t scale_q14(int32_t r, int32_t s) {
+    int32_t p = r * s;
+    return (p >= 0 ? p + 8192 : p - 8192) / 16384;
+}
+
+} // namespace
+
+SkyPlot::SkyPlot(ILI9488Driver& driver, const Config& config)
+    : driver_(driver), config_(config) {
+    config_.marker = std::max<uint8_t>(3, config_.marker | 1);
+    center_ = config_.size / 2;
+
+    // 外圈留出半个标记和北向三角的位置
+    int32_t horizon = center_ - config_.marker / 2 - 1;
+    horizon = std::max<int32_t>(horizon, 8);
+    for (int e = 0; e <= 90; e++) {
+        radius_[e] = (uint8_t)((horizon * (90 - e) + 45) / 90);
+    }
+
+    std::memset(markers_, 0, sizeof(markers_));
+    buildGrid();
+}
+
+uint32_t SkyPlot::snrColor(uint8_t snr) {
+    if (snr < kSnrFair) {
+        return 0xFF0000;
+    }
+    if (snr < kSnrGood) {
+        return 0xFFFF00;
+    }
+    return 0x00FF00;
+}
+
+// =============================================================================
+// 网格
+// =============================================================================
+
+void SkyPlot::addRowSpans(uint8_t row, Span* spans, uint8_t count) {
+    std::sort(spans, spans + count, [](const Span& a, const Span& b) { return a.x0 < b.x0; });
+
+    uint16_t start = row_start_[row];
+    uint16_t n = start;
+    for (uint8_t i = 0; i < count; i++) {
+        if (n > start && spans[i].x0 <= spans_[n - 1].x1 + 1) {
+            spans_[n - 1].x1 = std::max(spans_[n - 1].x1, spans[i].x1);
+        } else if (n < ILI9488_SKY_PLOT_MAX_SPANS) {
+            spans_[n++] = spans[i];
+        } else {
+            if (start < ILI9488_SKY_PLOT_MAX_SPANS) {
+                printf("[天空图] 网格线段表已满，第%u行以下的网格不完整\n", row);
+            }
+            break;
+        }
+    }
+    row_start_[row + 1] = n;
+}
+
+void SkyPlot::buildGrid() {
+    const int32_t c = center_;
+    const int32_t size = config_.size;
+    const int32_t half = config_.marker / 2;
+    const int32_t horizon = radius_[0];
+    const uint8_t rings[] = {radius_[0], radius_[30], radius_[60]};
+
+    row_start_[0] = 0;
+    for (int32_t row = 0; row < size; row++) {
+        Span spans[kMaxRowSpans];
+        uint8_t count = 0;
+        auto add = [&](int32_t x0, int32_t x1) {
+            x0 = std::max<int32_t>(x0, 0);
+            x1 = std::min<int32_t>(x1, size - 1);
+            if (x0 <= x1 && count < kMaxRowSpans) {
+                spans[count++] = {(uint8_t)x0, (uint8_t)x1};
+            }
+        };
+
+        const int32_t dy = row - c;
+
+        // 圆环：到圆心距离在 [R-0.5, R+0.5) 内的像素
+        for (uint8_t r : rings) {
+            int32_t outer = (2 * r + 1) * (2 * r + 1) - 4 * dy * dy;
+            if (outer <= 0) {
+                continue;
+            }
+            int32_t xo = (int32_t)isqrt((uint32_t)(outer - 1) / 4);
+            int32_t inner = (2 * r - 1) * (2 * r - 1) - 4 * dy * dy;
+            int32_t xi = inner > 0 ? (int32_t)isqrt((uint32_t)(inner - 1) / 4) : -1;
+            if (xi < 0) {
+                add(c - xo, c + xo);
+            } else if (xi < xo) {
+                add(c - xo, c - xi - 1);
+                add(c + xi + 1, c + xo);
+            }
+        }
+
+        // 南北、东西十字线
+        if (dy >= -horizon && dy <= horizon) {
+            add(c, c);
+        }
+        if (dy == 0) {
+            add(c - horizon, c + horizon);
+        }
+
+        // 外圈顶部的北向三角（尖端朝下）
+        int32_t t = row - (c - horizon - half - 1);
+        if (t >= 0 && t <= half) {
+            add(c - (half - t), c + (half - t));
+        }
+
+        addRowSpans((uint8_t)row, spans, count);
+    }
+}
+
+// =============================================================================
+// 坐标与标记
+// =============================================================================
+
+void SkyPlot::polarToPlot(int8_t elevation, uint16_t azimuth, int16_t* x, int16_t* y) const {
+    int32_t r = radius_[std::min<int32_t>(std::max<int32_t>(elevation, 0), 90)];
+    int32_t az = azimuth % 360;
+    int32_t s, co;
+    if (az < 90) {
+        s = kSinQ14[az];
+        co = kSinQ14[90 - az];
+    } else if (az < 180) {
+        s = kSinQ14[180 - az];
+        co = -kSinQ14[az - 90];
+    } else if (az < 270) {
+        s = -kSinQ14[az - 180];
+        co = -kSinQ14[270 - az];
+    } else {
+        s = -kSinQ14[360 - az];
+        co = kSinQ14[az - 270];
+    }
+    // 方位角从正北顺时针：东为+x，北为-y
+    int32_t half = config_.marker / 2;
+    *x = (int16_t)(center_ + scale_q14(r, s) - half);
+    *y = (int16_t)(center_ - scale_q14(r, co) - half);
+}
+
+void SkyPlot::fillPlot(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    x0 = std::max<int32_t>(x0, 0);
+    y0 = std::max<int32_t>(y0, 0);
+    x1 = std::min<int32_t>(x1, config_.size - 1);
+    y1 = std::min<int32_t>(y1, config_.size - 1);
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+    driver_.fillAreaRGB666(config_.x + x0, config_.y + y0, config_.x + x1, config_.y + y1, color);
+}
+
+void SkyPlot::drawMarker(Marker& marker) {
+    const int32_t m = config_.marker - 1;
+    const int32_t x = marker.target_x;
+    const int32_t y = marker.target_y;
+    if (marker.target_hollow) {
+        fillPlot(x, y, x + m, y, marker.target_color);
+        fillPlot(x, y + m, x + m, y + m, marker.target_color);
+        fillPlot(x, y + 1, x, y + m - 1, marker.target_color);
+        fillPlot(x + m, y + 1, x + m, y + m - 1, marker.target_color);
+    } else {
+        fillPlot(x, y, x + m, y + m, marker.target_color);
+    }
+    marker.x = marker.target_x;
+    marker.y = marker.target_y;
+    marker.color = marker.target_color;
+    marker.hollow = marker.target_hollow;
+    marker.drawn = true;
+    marker.damaged = false;
+    stats_.markers_drawn++;
+
+    // 按槽位顺序叠放：盖住了后面槽位的标记时，后面的标记需要重画到上层
+    for (Marker* other = &marker + 1; other < markers_ + ILI9488_SKY_PLOT_MAX_MARKERS; other++) {
+        if (other->used && other->drawn && overlaps(*other, marker.x, marker.y)) {
+            other->damaged = true;
+        }
+    }
+}
+
+void SkyPlot::eraseMarker(Marker& marker) {
+    const int32_t m = config_.marker - 1;
+    const int32_t x0 = marker.x;
+    const int32_t y0 = marker.y;
+    const int32_t x1 = x0 + m;
+    const int32_t y1 = y0 + m;
+    fillPlot(x0, y0, x1, y1, config_.background);
+
+    // 恢复矩形内的网格
+    for (int32_t row = std::max<int32_t>(y0, 0); row <= std::min<int32_t>(y1, config_.size - 1); row++) {
+        for (uint16_t i = row_start_[row]; i < row_start_[row + 1]; i++) {
+            int32_t sx0 = std::max<int32_t>(spans_[i].x0, x0);
+            int32_t sx1 = std::min<int32_t>(spans_[i].x1, x1);
+            if (sx0 <= sx1) {
+                fillPlot(sx0, row, sx1, row, config_.grid);
+                stats_.restored_spans++;
+            }
+        }
+    }
+    marker.drawn = false;
+    stats_.markers_erased++;
+
+    // 与擦除区域重叠的标记需要重画
+    for (Marker& other : markers_) {
+        if (&other != &marker && other.used && other.drawn && overlaps(other, x0, y0)) {
+            other.damaged = true;
+        }
+    }
+}
+
+bool SkyPlot::overlaps(const Marker& marker, int32_t x, int32_t y) const {
+    const int32_t m = config_.marker - 1;
+    return marker.x <= x + m && marker.x + m >= x && marker.y <= y + m && marker.y + m >= y;
+}
+
+SkyPlot::Marker* SkyPlot::findMarker(uint16_t key) {
+    Marker* free_slot = nullptr;
+    for (Marker& marker : markers_) {
+        if (marker.used && marker.key == key) {
+            return &marker;
+        }
+        if (!marker.used && !free_slot) {
+            free_slot = &marker;
+        }
+    }
+    if (free_slot) {
+        std::memset(free_slot, 0, sizeof(*free_slot));
+        free_slot->used = true;
+        free_slot->key = key;
+    }
+    return free_slot;
+}
+
+// =============================================================================
+// 绘制
+// =============================================================================
+
+bool SkyPlot::update(const gps_sky_sat_t* sats, uint8_t count, bool show_used) {
+    for (Marker& marker : markers_) {
+        marker.want = false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        const gps_sky_sat_t& sat = sats[i];
+        if (sat.elevation < 0) {
+            continue;
+        }
+        Marker* marker = findMarker((uint16_t)(sat.system << 8 | sat.prn));
+        if (!marker) {
+            continue;
+        }
+        marker->want = true;
+        polarToPlot(sat.elevation, sat.azimuth, &marker->target_x, &marker->target_y);
+        marker->target_hollow = sat.snr == 0 || (show_used && !sat.used);
+        marker->target_color = sat.snr == 0 ? config_.untracked : snrColor(sat.snr);
+    }
+
+    uint32_t ops = 0;
+    bool deferred = false;
+
+    // 消失、移动或变色的标记：擦除旧标记，画新标记
+    for (Marker& marker : markers_) {
+        if (!marker.used) {
+            continue;
+        }
+        bool changed = marker.drawn &&
+                       (!marker.want || marker.x != marker.target_x || marker.y != marker.target_y ||
+                        marker.color != marker.target_color || marker.hollow != marker.target_hollow);
+        bool missing = marker.want && !marker.drawn;
+        if (!changed && !missing) {
+            marker.used = marker.want || marker.drawn;
+            continue;
+        }
+        if (ops + (changed ? 1 : 0) + (marker.want ? 1 : 0) > config_.budget) {
+            deferred = true;
+            continue;
+        }
+        if (changed) {
+            eraseMarker(marker);
+            ops++;
+        }
+        if (marker.want) {
+            drawMarker(marker);
+            ops++;
+        } else {
+            marker.used = false;
+        }
+    }
+
+    // 被擦除区域覆盖、本身没有变化的标记原位重画
+    for (Marker& marker : markers_) {
+        if (!marker.used || !marker.drawn || !marker.damaged) {
+            continue;
+        }
+        bool changed = !marker.want || marker.x != marker.target_x || marker.y != marker.target_y ||
+                       marker.color != marker.target_color || marker.hollow != marker.target_hollow;
+        if (changed) {
+            deferred = true;            // 下一次按变化的标记处理
+            continue;
+        }
+        if (ops >= config_.budget) {
+            deferred = true;
+            continue;
+        }
+        drawMarker(marker);
+        stats_.damaged++;
+        ops++;
+    }
+
+    if (deferred) {
+        stats_.deferred++;
+    }
+    pending_ = deferred;
+    return pending_;
+}
+
+void SkyPlot::redraw() {
+    stats_.redraws++;
+    fillPlot(0, 0, config_.size - 1, config_.size - 1, config_.background);
+    for (int32_t row = 0; row < config_.size; row++) {
+        for (uint16_t i = row_start_[row]; i < row_start_[row + 1]; i++) {
+            fillPlot(spans_[i].x0, row, spans_[i].x1, row, config_.grid);
+        }
+    }
+
+    for (Marker& marker : markers_) {
+        marker.drawn = false;
+        marker.damaged = false;
+    }
+    for (Marker& marker : markers_) {
+        if (marker.used && marker.want) {
+            drawMarker(marker);
+        } else {
+            marker.used = false;
+        }
+    }
+    pending_ = false;
+}
+
+} // namespace ili9488
@@ -0,0 +1,229 @@
+/**
+ * @file ili9488_strip_chart.cpp
+ * @brief 滚动曲线图实现
+ */
+
+#include "ili9488_strip_chart.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace ili9488 {
+
+namespace {
+
+void color_bytes(uint32_t color, uint8_t* bytes) {
+    bytes[0] = (color >> 16) & 0xFC;
+    bytes[1] = (color >> 8) & 0xFC;
+    bytes[2] = color & 0xFC;
+}
+
+} // namespace
+
+StripChart::StripChart(ILI9488Driver& driver, const Config& config)
+    : driver_(driver), config_(config) {
+    config_.width = std::min<uint16_t>(std::max<uint16_t>(config_.width, 2), ILI9488_STRIP_CHART_MAX_COLUMNS);
+    config_.height = std::min<uint16_t>(std::max<uint16_t>(config_.height, 2), ILI9488_STRIP_CHART_MAX_HEIGHT);
+    config_.samples_per_column = std::max<uint8_t>(config_.samples_per_column, 1);
+    // 最旧可见列连线用到它的前一列，至少留1列空白保证前一列还在环形缓冲中
+    config_.gap = std::min<uint8_t>(std::max<uint8_t>(config_.gap, 1), config_.width / 2);
+    if (!(config_.max_value > config_.min_value)) {
+        config_.max_value = config_.min_value + 1.0f;
+    }
+
+    memset(columns_, 0, sizeof(columns_));
+    buildTemplate();
+    clear();
+}
+
+// =============================================================================
+// 样本
+// =============================================================================
+
+void StripChart::push(float value) {
+    if (!std::isfinite(value)) {
+        return;
+    }
+
+    bool first = empty();
+    if (samples_ == config_.samples_per_column) {
+        head_++;
+        samples_ = 0;
+    }
+
+    Column& column = columns_[head_ % config_.width];
+    if (samples_ == 0) {
+        column.min = value;
+        column.max = value;
+    } else {
+        column.min = std::min(column.min, value);
+        column.max = std::max(column.max, value);
+    }
+    column.last = value;
+    samples_++;
+    last_ = value;
+    stats_.samples++;
+
+    if (config_.range_step <= 0.0f) {
+        return;
+    }
+    if (first) {
+        // 保持配置的跨度，平移到包含第一个样本的步长格
+        float span = std::max(config_.max_value - config_.min_value, config_.range_step);
+        min_value_ = std::floor(value / config_.range_step) * config_.range_step;
+        max_value_ = min_value_ + span;
+        row_scale_ = (config_.height - 1) / (max_value_ - min_value_);
+    }
+    expandRange(value);
+}
+
+void StripChart::clear() {
+    head_ = 0;
+    samples_ = 0;
+    drawn_head_ = 0;
+    drawn_samples_ = 0;
+    needs_redraw_ = true;
+    min_value_ = config_.min_value;
+    max_value_ = config_.max_value;
+    row_scale_ = (config_.height - 1) / (max_value_ - min_value_);
+}
+
+uint32_t StripChart::spanSamples() const {
+    return (uint32_t)(config_.width - config_.gap) * config_.samples_per_column;
+}
+
+void StripChart::expandRange(float value) {
+    const float step = config_.range_step;
+    bool changed = false;
+    if (value < min_value_) {
+        min_value_ = std::floor(value / step) * step;
+        changed = true;
+    }
+    if (value > max_value_) {
+        max_value_ = std::ceil(value / step) * step;
+        changed = true;
+    }
+    if (changed) {
+        row_scale_ = (config_.height - 1) / (max_value_ - min_value_);
+        needs_redraw_ = true;
+        stats_.rescales++;
+    }
+}
+
+// =============================================================================
+// 绘制
+// =============================================================================
+
+bool StripChart::update() {
+    if (needs_redraw_) {
+        redraw();
+        return true;
+    }
+    if (head_ == drawn_head_ && samples_ == drawn_samples_) {
+        return false;
+    }
+    // 积压超过可见列数（视图隐藏期间）时逐列补画不再省事
+    if (head_ - drawn_head_ >= (uint32_t)(config_.width - config_.gap)) {
+        redraw();
+        return true;
+    }
+
+    uint32_t first = drawn_samples_ == config_.samples_per_column ? drawn_head_ + 1 : drawn_head_;
+    for (uint32_t i = first; i <= head_; i++) {
+        drawColumn(i);
+    }
+
+    // 新开始的列把空白区推前，清掉空白区前沿露出的旧列
+    for (uint32_t i = std::max(drawn_head_ + config_.gap, head_) + 1; i <= head_ + config_.gap; i++) {
+        drawColumn(i);
+    }
+
+    drawn_head_ = head_;
+    drawn_samples_ = samples_;
+    return true;
+}
+
+void StripChart::redraw() {
+    const uint32_t width = config_.width;
+    for (uint32_t x = 0; x < width; x++) {
+        // 屏幕第x列上最新的列序号
+        uint32_t back = (head_ % width + width - x) % width;
+        if (back > head_) {
+            writeColumn(x, -1, -1);
+        } else {
+            drawColumn(head_ - back);
+        }
+    }
+
+    drawn_head_ = head_;
+    drawn_samples_ = samples_;
+    needs_redraw_ = false;
+    stats_.redraws++;
+}
+
+bool StripChart::visible(uint32_t column) const {
+    if (column > head_ || head_ - column >= (uint32_t)(config_.width - config_.gap)) {
+        return false;
+    }
+    return column < head_ || samples_ > 0;
+}
+
+int32_t StripChart::valueRow(float value) const {
+    int32_t offset = (int32_t)std::lround((value - min_value_) * row_scale_);
+    return std::min<int32_t>(std::max<int32_t>(config_.height - 1 - offset, 0), config_.height - 1);
+}
+
+void StripChart::drawColumn(uint32_t column) {
+    const uint16_t screen_x = column % config_.width;
+    if (!visible(column)) {
+        writeColumn(screen_x, -1, -1);
+        return;
+    }
+
+    const Column& c = columns_[screen_x];
+    int32_t top = valueRow(c.max);
+    int32_t bottom = valueRow(c.min);
+
+    // 连到前一列的最后一个值，样本跳变时曲线不断开
+    if (column > 0 && head_ - (column - 1) < config_.width) {
+        int32_t previous = valueRow(columns_[(column - 1) % config_.width].last);
+        top = std::min(top, previous);
+        bottom = std::max(bottom, previous);
+    }
+    writeColumn(screen_x, top, bottom);
+}
+
+void StripChart::writeColumn(uint16_t screen_x, int32_t top, int32_t bottom) {
+    const size_t bytes = (size_t)config_.height * 3;
+    memcpy(column_, template_, bytes);
+    if (top >= 0) {
+        uint8_t line[3];
+        color_bytes(config_.line, line);
+        for (int32_t row = top; row <= bottom; row++) {
+            memcpy(column_ + row * 3, line, 3);
+        }
+    }
+
+    uint16_t x = config_.x + screen_x;
+    driver_.setAddressWindow(x, config_.y, x, config_.y + config_.height - 1);
+    driver_.writeDataBuffer(column_, bytes);
+    stats_.columns_drawn++;
+}
+
+void StripChart::buildTemplate() {
+    uint8_t background[3];
+    uint8_t grid[3];
+    color_bytes(config_.background, background);
+    color_bytes(config_.grid, grid);
+
+    for (uint16_t row = 0; row < config_.height; row++) {
+        memcpy(template_ + row * 3, background, 3);
+    }
+    for (uint8_t k = 0; config_.grid_divisions > 0 && k <= config_.grid_divisions; k++) {
+        uint16_t row = (uint16_t)((config_.height - 1) * k / config_.grid_divisions);
+        memcpy(template_ + row * 3, grid, 3);
+    }
+}
+
+} // namespace ili9488
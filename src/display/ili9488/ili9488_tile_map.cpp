@@ -0,0 +1,414 @@
+/**
+ * @file ili9488_tile_map.cpp
+ * @brief 离线底图实现
+ */
+
+#include "ili9488_tile_map.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace ili9488 {
+
+namespace {
+
+constexpr uint32_t kMaxTileCoord = 4095;    // 缓存键中行/列各占12位
+
+int32_t floor_div(int32_t a, int32_t b) {
+    int32_t q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+} // namespace
+
+TileMap::TileMap(ILI9488Driver& driver) : driver_(driver) {
+    std::memset(&file_, 0, sizeof(file_));
+}
+
+TileMap::~TileMap() {
+    close();
+}
+
+// =============================================================================
+// 文件
+// =============================================================================
+
+bool TileMap::open(const char* path) {
+    close();
+
+    if (f_open(&file_, path, FA_READ) != FR_OK) {
+        printf("[底图] 无瓦片包: %s\n", path);
+        return false;
+    }
+
+    UINT got = 0;
+    bool ok = f_read(&file_, &header_, sizeof(header_), &got) == FR_OK && got == sizeof(header_);
+    if (!ok || header_.magic != TILE_PACK_MAGIC || header_.version != TILE_PACK_VERSION) {
+        printf("[底图] 文件头无效: %s\n", path);
+        f_close(&file_);
+        return false;
+    }
+    if (header_.tile_size == 0 || header_.tile_size > ILI9488_TILE_MAX_SIZE ||
+        header_.level_count == 0 || header_.level_count > TILE_PACK_MAX_LEVELS) {
+        printf("[底图] 不支持的瓦片边长%u或级别数%u\n", header_.tile_size, header_.level_count);
+        f_close(&file_);
+        return false;
+    }
+
+    UINT bytes = header_.level_count * sizeof(TilePackLevel);
+    if (f_read(&file_, levels_, bytes, &got) != FR_OK || got != bytes) {
+        printf("[底图] 级别表读取失败\n");
+        f_close(&file_);
+        return false;
+    }
+    for (uint16_t i = 0; i < header_.level_count; i++) {
+        if (levels_[i].dm_per_pixel == 0 || levels_[i].cols > kMaxTileCoord || levels_[i].rows > kMaxTileCoord) {
+            printf("[底图] 级别%u无效\n", i);
+            f_close(&file_);
+            return false;
+        }
+    }
+
+    open_ = true;
+    index_level_ = -1;
+    flushCache();
+
+    printf("[底图] 已打开 %s: %u级, 瓦片%ux%u, 原点 %.6f,%.6f\n", path, header_.level_count,
+           header_.tile_size, header_.tile_size, header_.origin_lat_e7 / 1e7, header_.origin_lon_e7 / 1e7);
+    for (uint16_t i = 0; i < header_.level_count; i++) {
+        printf("[底图]   %.1f m/像素: %ux%u瓦片\n", levels_[i].dm_per_pixel / 10.0, levels_[i].cols, levels_[i].rows);
+    }
+    return true;
+}
+
+void TileMap::close() {
+    if (open_) {
+        f_close(&file_);
+        open_ = false;
+    }
+    index_level_ = -1;
+}
+
+int TileMap::findLevel(uint32_t dm_per_pixel) const {
+    if (!open_) {
+        return -1;
+    }
+    for (int i = 0; i < header_.level_count; i++) {
+        if (levels_[i].dm_per_pixel == dm_per_pixel) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void TileMap::origin(double* lat, double* lon) const {
+    if (lat) *lat = header_.origin_lat_e7 / 1e7;
+    if (lon) *lon = header_.origin_lon_e7 / 1e7;
+}
+
+bool TileMap::loadLevel(int level) {
+    const TilePackLevel& info = levels_[level];
+    uint32_t count = (uint32_t)info.cols * info.rows;
+    index_level_ = -1;
+    if (count > ILI9488_TILE_INDEX_MAX) {
+        return false;       // 索引按需读取
+    }
+
+    UINT bytes = count * sizeof(TilePackTile);
+    UINT got = 0;
+    if (f_lseek(&file_, info.index_offset) != FR_OK ||
+        f_read(&file_, index_, bytes, &got) != FR_OK || got != bytes) {
+        printf("[底图] 级别%d索引读取失败\n", level);
+        return false;
+    }
+    index_level_ = level;
+    return true;
+}
+
+bool TileMap::tileEntry(int level, uint32_t col, uint32_t row, TilePackTile* tile) {
+    const TilePackLevel& info = levels_[level];
+    uint32_t i = row * info.cols + col;
+    if (index_level_ == level) {
+        *tile = index_[i];
+        return true;
+    }
+
+    UINT got = 0;
+    stats_.index_reads++;
+    return f_lseek(&file_, info.index_offset + i * sizeof(TilePackTile)) == FR_OK &&
+           f_read(&file_, tile, sizeof(*tile), &got) == FR_OK && got == sizeof(*tile);
+}
+
+// =============================================================================
+// 瓦片缓存
+// =============================================================================
+
+void TileMap::flushCache() {
+    for (CacheEntry& entry : entries_) {
+        entry.valid = false;
+    }
+    cache_head_ = 0;
+    next_entry_ = 0;
+}
+
+const TileMap::CacheEntry* TileMap::findCached(uint32_t key) const {
+    for (const CacheEntry& entry : entries_) {
+        if (entry.valid && entry.key == key) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* TileMap::cacheInsert(uint32_t key, uint32_t length) {
+    // 环形区：放不下时回到开头，与新区域重叠的旧瓦片失效
+    if (cache_head_ + length > sizeof(cache_)) {
+        cache_head_ = 0;
+    }
+    uint32_t start = cache_head_;
+    uint32_t end = start + length;
+    for (CacheEntry& entry : entries_) {
+        if (entry.valid && entry.offset < end && start < entry.offset + entry.length) {
+            entry.valid = false;
+        }
+    }
+
+    CacheEntry& slot = entries_[next_entry_];
+    next_entry_ = (next_entry_ + 1) % ILI9488_TILE_CACHE_ENTRIES;
+    slot.key = key;
+    slot.offset = start;
+    slot.length = length;
+    slot.valid = true;
+    cache_head_ = end;
+    return cache_ + start;
+}
+
+// =============================================================================
+// 解码
+// =============================================================================
+
+bool TileMap::nextByte(ByteSource& source, uint8_t* byte) {
+    if (source.ptr == source.end) {
+        if (source.file_remaining == 0) {
+            return false;
+        }
+        UINT chunk = std::min<uint32_t>(source.file_remaining, sizeof(sector_));
+        UINT got = 0;
+        if (f_read(&file_, sector_, chunk, &got) != FR_OK || got != chunk) {
+            return false;
+        }
+        stats_.sd_bytes += chunk;
+        source.file_remaining -= chunk;
+        source.ptr = sector_;
+        source.end = sector_ + chunk;
+    }
+    *byte = *source.ptr++;
+    return true;
+}
+
+bool TileMap::decodeTile(ByteSource& source, uint16_t x, uint16_t y,
+                         uint32_t col0, uint32_t row0, uint32_t col1, uint32_t row1) {
+    const uint32_t size = header_.tile_size;
+    const uint32_t total = size * size;
+    const uint32_t row_bytes = (col1 - col0 + 1) * 3;
+    const uint32_t stage_rows = sizeof(rows_) / row_bytes;
+
+    uint8_t colors_m1 = 0;
+    if (!nextByte(source, &colors_m1)) {
+        return false;
+    }
+    uint32_t colors = colors_m1 + 1u;
+    for (uint32_t i = 0; i < colors; i++) {
+        if (!nextByte(source, &palette_[i][0]) || !nextByte(source, &palette_[i][1]) ||
+            !nextByte(source, &palette_[i][2])) {
+            return false;
+        }
+    }
+
+    driver_.setAddressWindow(x, y, x + (col1 - col0), y + (row1 - row0));
+
+    uint32_t staged = 0;
+    uint32_t p = 0;
+    while (p < total) {
+        uint8_t run_m1 = 0;
+        uint8_t index = 0;
+        if (!nextByte(source, &run_m1) || !nextByte(source, &index) || index >= colors) {
+            return false;
+        }
+        const uint8_t* color = palette_[index];
+
+        // 游程可能跨行，按行切开；只拷贝可见列
+        uint32_t remaining = run_m1 + 1u;
+        while (remaining > 0) {
+            if (p >= total) {
+                return false;
+            }
+            uint32_t row = p / size;
+            uint32_t col = p % size;
+            uint32_t n = std::min(remaining, size - col);
+            bool row_done = col + n == size;
+
+            if (row >= row0) {
+                uint32_t a = std::max(col, col0);
+                uint32_t b = std::min(col + n - 1, col1);
+                uint8_t* dst = rows_ + staged * row_bytes + (a - col0) * 3;
+                for (uint32_t k = a; k <= b; k++) {
+                    dst[0] = color[0];
+                    dst[1] = color[1];
+                    dst[2] = color[2];
+                    dst += 3;
+                }
+                if (row_done) {
+                    staged++;
+                    if (staged == stage_rows || row == row1) {
+                        driver_.writeDataBuffer(rows_, staged * row_bytes);
+                        staged = 0;
+                    }
+                    if (row == row1) {
+                        return true;    // 之后的行不可见，不再解码
+                    }
+                }
+            }
+            p += n;
+            remaining -= n;
+        }
+    }
+    return false;
+}
+
+void TileMap::drawTile(uint32_t key, const TilePackTile& tile,
+                       uint16_t x, uint16_t y, uint32_t col0, uint32_t row0, uint32_t col1, uint32_t row1,
+                       uint32_t background) {
+    uint16_t x1 = x + (col1 - col0);
+    uint16_t y1 = y + (row1 - row0);
+
+    if (tile.length == 0) {
+        driver_.fillAreaRGB666(x, y, x1, y1, background);
+        stats_.empty_tiles++;
+        return;
+    }
+
+    ByteSource source = {nullptr, nullptr, 0};
+    bool streamed = false;
+    const CacheEntry* cached = findCached(key);
+    if (cached) {
+        stats_.cache_hits++;
+        source.ptr = cache_ + cached->offset;
+        source.end = source.ptr + cached->length;
+    } else if (f_lseek(&file_, tile.offset) != FR_OK) {
+        source.file_remaining = 0;
+    } else if (tile.length <= sizeof(cache_) / 4) {
+        // 一次读入缓存（小瓦片不跨扇区只读一个扇区，大瓦片的整扇区由FatFs直接读到缓存）
+        const uint8_t* dst = cacheInsert(key, tile.length);
+        UINT got = 0;
+        stats_.sd_reads++;
+        if (f_read(&file_, (void*)dst, tile.length, &got) == FR_OK && got == tile.length) {
+            stats_.sd_bytes += tile.length;
+            source.ptr = dst;
+            source.end = dst + tile.length;
+        } else {
+            flushCache();
+        }
+    } else {
+        stats_.sd_reads++;
+        stats_.streamed_tiles++;
+        source.file_remaining = tile.length;
+        streamed = true;
+    }
+
+    if (!decodeTile(source, x, y, col0, row0, col1, row1)) {
+        stats_.decode_errors++;
+        if (!streamed) {
+            // 坏数据不能留在缓存中
+            flushCache();
+        }
+        driver_.fillAreaRGB666(x, y, x1, y1, background);
+        return;
+    }
+    stats_.tiles_drawn++;
+}
+
+// =============================================================================
+// 绘制
+// =============================================================================
+
+void TileMap::draw(int level, int32_t map_x, int32_t map_y,
+                   uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t background) {
+    if (!open_ || level < 0 || level >= header_.level_count || width == 0 || height == 0) {
+        driver_.fillAreaRGB666(x, y, x + width - 1, y + height - 1, background);
+        return;
+    }
+    if (index_level_ != level) {
+        loadLevel(level);
+    }
+
+    const TilePackLevel& info = levels_[level];
+    const int32_t size = header_.tile_size;
+    const int32_t c_first = floor_div(map_x, size);
+    const int32_t c_last = floor_div(map_x + width - 1, size);
+    const int32_t r_first = floor_div(map_y, size);
+    const int32_t r_last = floor_div(map_y + height - 1, size);
+
+    // 级别索引不常驻时，每个可见瓦片行一次读出可见列的索引
+    const int32_t vc0 = std::max<int32_t>(c_first, 0);
+    const int32_t vc1 = std::min<int32_t>(c_last, info.cols - 1);
+    const int32_t vr0 = std::max<int32_t>(r_first, 0);
+    const int32_t vr1 = std::min<int32_t>(r_last, info.rows - 1);
+    const int32_t window_cols = vc1 - vc0 + 1;
+    bool windowed = false;
+    if (index_level_ != level && vc0 <= vc1 && vr0 <= vr1 &&
+        (uint32_t)(window_cols * (vr1 - vr0 + 1)) <= ILI9488_TILE_WINDOW) {
+        windowed = true;
+        for (int32_t r = vr0; r <= vr1 && windowed; r++) {
+            UINT bytes = window_cols * sizeof(TilePackTile);
+            UINT got = 0;
+            stats_.index_reads++;
+            windowed = f_lseek(&file_, info.index_offset + ((uint32_t)r * info.cols + vc0) * sizeof(TilePackTile)) == FR_OK &&
+                       f_read(&file_, &window_[(r - vr0) * window_cols], bytes, &got) == FR_OK && got == bytes;
+        }
+    }
+
+    // 第一遍画范围外、空瓦片和缓存命中的瓦片，第二遍再读缺失的瓦片，
+    // 避免新读入的瓦片把本帧还没画的缓存瓦片挤出去
+    for (int pass = 0; pass < 2; pass++) {
+        for (int32_t r = r_first; r <= r_last; r++) {
+            for (int32_t c = c_first; c <= c_last; c++) {
+                int32_t px0 = std::max(c * size, map_x);
+                int32_t py0 = std::max(r * size, map_y);
+                int32_t px1 = std::min(c * size + size - 1, map_x + width - 1);
+                int32_t py1 = std::min(r * size + size - 1, map_y + height - 1);
+                uint16_t sx = (uint16_t)(x + (px0 - map_x));
+                uint16_t sy = (uint16_t)(y + (py0 - map_y));
+
+                bool outside = c < 0 || r < 0 || c >= info.cols || r >= info.rows;
+                bool known = outside || index_level_ == level || windowed;
+                TilePackTile tile = {0, 0};
+                if (!outside && index_level_ == level) {
+                    tile = index_[(uint32_t)r * info.cols + c];
+                } else if (!outside && windowed) {
+                    tile = window_[(r - vr0) * window_cols + (c - vc0)];
+                }
+                uint32_t key = ((uint32_t)level << 24) | ((uint32_t)r << 12) | (uint32_t)c;
+                bool first_pass = outside || (known && tile.length == 0) || findCached(key) != nullptr;
+                if (first_pass != (pass == 0)) {
+                    continue;
+                }
+
+                if (outside) {
+                    driver_.fillAreaRGB666(sx, sy, sx + (px1 - px0), sy + (py1 - py0), background);
+                    stats_.empty_tiles++;
+                    continue;
+                }
+                if (!known && !tileEntry(level, (uint32_t)c, (uint32_t)r, &tile)) {
+                    tile.length = 0;
+                }
+                drawTile(key, tile, sx, sy,
+                         (uint32_t)(px0 - c * size), (uint32_t)(py0 - r * size),
+                         (uint32_t)(px1 - c * size), (uint32_t)(py1 - r * size), background);
+            }
+        }
+    }
+}
+
+} // namespace ili9488
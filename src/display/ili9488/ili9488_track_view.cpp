@@ -0,0 +1,296 @@
+/**
+ * @file ili9488_track_view.cpp
+ * @brief 轨迹地图视图实现
+ */
+
+#include "ili9488_track_view.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+namespace ili9488 {
+
+namespace {
+
+// 缩放级别对应的比例尺 (分米/像素)：0.2m/px .. 100m/px
+constexpr uint32_t kZoomDmPerPixel[] = {2, 5, 10, 20, 50, 100, 200, 500, 1000};
+constexpr uint8_t kZoomLevels = sizeof(kZoomDmPerPixel) / sizeof(kZoomDmPerPixel[0]);
+constexpr uint8_t kDefaultZoom = 2;         // 1m/px
+
+constexpr int32_t kScaleBarPixels = 50;
+
+/**
+ * @brief 向下取整的整数除法（负数坐标也按同一方向取整，避免原点附近出现双宽像素）
+ */
+int32_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) {
+        q--;
+    }
+    return (int32_t)std::max<int64_t>(INT32_MIN / 2, std::min<int64_t>(INT32_MAX / 2, q));
+}
+
+} // namespace
+
+TrackView::TrackView(ILI9488Driver& driver, const Config& config)
+    : driver_(driver), config_(config), zoom_level_(kDefaultZoom) {
+}
+
+uint8_t TrackView::zoomLevelCount() const {
+    return kZoomLevels;
+}
+
+uint32_t TrackView::decimetersPerPixel() const {
+    return kZoomDmPerPixel[zoom_level_];
+}
+
+void TrackView::setZoomLevel(uint8_t level) {
+    zoom_level_ = std::min<uint8_t>(level, kZoomLevels - 1);
+}
+
+TrackView::Pixel TrackView::project(const gps_track_point_t& point) const {
+    int64_t scale = decimetersPerPixel();
+    Pixel pixel;
+    pixel.x = config_.x + config_.width / 2 + floor_div((int64_t)point.e_dm - center_e_dm_, scale);
+    pixel.y = config_.y + config_.height / 2 - floor_div((int64_t)point.n_dm - center_n_dm_, scale);
+    return pixel;
+}
+
+bool TrackView::needsPan(const Pixel& pixel) const {
+    int32_t m = config_.pan_margin;
+    return pixel.x < config_.x + m || pixel.x >= config_.x + config_.width - m ||
+           pixel.y < config_.y + m || pixel.y >= config_.y + config_.height - m;
+}
+
+void TrackView::panTo(const gps_track_point_t& point, const Pixel& pixel) {
+    int32_t m = config_.pan_margin;
+    int32_t scale = (int32_t)decimetersPerPixel();
+    int32_t ahead_e = config_.width / 4 * scale;
+    int32_t ahead_n = config_.height / 4 * scale;
+
+    // 最新点放到越界方向的反侧1/4处，前方留出3/4个视口
+    if (pixel.x < config_.x + m) {
+        center_e_dm_ = point.e_dm - ahead_e;
+    } else if (pixel.x >= config_.x + config_.width - m) {
+        center_e_dm_ = point.e_dm + ahead_e;
+    }
+    if (pixel.y < config_.y + m) {
+        center_n_dm_ = point.n_dm + ahead_n;
+    } else if (pixel.y >= config_.y + config_.height - m) {
+        center_n_dm_ = point.n_dm - ahead_n;
+    }
+    stats_.pans++;
+}
+
+void TrackView::drawSpan(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    int32_t w = config_.line_width - 1;
+    driver_.fillAreaRGB666((uint16_t)std::min(x0, x1), (uint16_t)std::min(y0, y1),
+                           (uint16_t)(std::max(x0, x1) + w), (uint16_t)(std::max(y0, y1) + w), color);
+    stats_.spans++;
+}
+
+void TrackView::drawSegment(Pixel a, Pixel b, uint32_t color) {
+    // 裁剪到线宽收缩后的视口，保证线宽不画出视口
+    const int32_t xmin = config_.x;
+    const int32_t ymin = config_.y;
+    const int32_t xmax = config_.x + config_.width - config_.line_width;
+    const int32_t ymax = config_.y + config_.height - config_.line_width;
+
+    auto inside = [&](const Pixel& p) {
+        return p.x >= xmin && p.x <= xmax && p.y >= ymin && p.y <= ymax;
+    };
+
+    if (!inside(a) || !inside(b)) {
+        // Liang-Barsky
+        float t0 = 0.0f, t1 = 1.0f;
+        float dx = (float)(b.x - a.x);
+        float dy = (float)(b.y - a.y);
+        const float p[4] = {-dx, dx, -dy, dy};
+        const float q[4] = {(float)(a.x - xmin), (float)(xmax - a.x),
+                            (float)(a.y - ymin), (float)(ymax - a.y)};
+        for (int i = 0; i < 4; i++) {
+            if (p[i] == 0.0f) {
+                if (q[i] < 0.0f) {
+                    return;
+                }
+                continue;
+            }
+            float t = q[i] / p[i];
+            if (p[i] < 0.0f) {
+                t0 = std::max(t0, t);
+            } else {
+                t1 = std::min(t1, t);
+            }
+            if (t0 > t1) {
+                return;
+            }
+        }
+        Pixel ca = {a.x + (int32_t)std::lround(t0 * dx), a.y + (int32_t)std::lround(t0 * dy)};
+        Pixel cb = {a.x + (int32_t)std::lround(t1 * dx), a.y + (int32_t)std::lround(t1 * dy)};
+        a = {std::clamp(ca.x, xmin, xmax), std::clamp(ca.y, ymin, ymax)};
+        b = {std::clamp(cb.x, xmin, xmax), std::clamp(cb.y, ymin, ymax)};
+    }
+
+    stats_.segments++;
+
+    // Bresenham，同一行（或列）上连续的像素合并为一次填充
+    int32_t dx = std::abs(b.x - a.x);
+    int32_t dy = std::abs(b.y - a.y);
+    int32_t sx = a.x < b.x ? 1 : -1;
+    int32_t sy = a.y < b.y ? 1 : -1;
+    int32_t x = a.x;
+    int32_t y = a.y;
+
+    if (dx >= dy) {
+        int32_t err = dx / 2;
+        int32_t run = x;
+        for (int32_t i = 0; i < dx; i++) {
+            err -= dy;
+            if (err < 0) {
+                drawSpan(run, y, x, y, color);
+                y += sy;
+                err += dx;
+                run = x + sx;
+            }
+            x += sx;
+        }
+        drawSpan(run, y, x, y, color);
+    } else {
+        int32_t err = dy / 2;
+        int32_t run = y;
+        for (int32_t i = 0; i < dy; i++) {
+            err -= dx;
+            if (err < 0) {
+                drawSpan(x, run, x, y, color);
+                x += sx;
+                err += dy;
+                run = y + sy;
+            }
+            y += sy;
+        }
+        drawSpan(x, run, x, y, color);
+    }
+}
+
+void TrackView::drawScaleBar() {
+    uint32_t meters = kScaleBarPixels * decimetersPerPixel() / 10;
+    char label[16];
+    if (meters >= 1000) {
+        snprintf(label, sizeof(label), "%lukm", (unsigned long)(meters / 1000));
+    } else {
+        snprintf(label, sizeof(label), "%lum", (unsigned long)meters);
+    }
+
+    uint16_t x = config_.x + 6;
+    uint16_t y = config_.y + config_.height - 6;
+    driver_.fillAreaRGB666(x, y, x + kScaleBarPixels - 1, y + 1, config_.scale);
+    driver_.fillAreaRGB666(x, y - 4, x + 1, y - 1, config_.scale);
+    driver_.fillAreaRGB666(x + kScaleBarPixels - 2, y - 4, x + kScaleBarPixels - 1, y - 1, config_.scale);
+    driver_.drawString(x + kScaleBarPixels + 4, y - 12, label, config_.scale, config_.background);
+}
+
+void TrackView::drawBackground() {
+    int level = basemap_ ? basemap_->findLevel(decimetersPerPixel()) : -1;
+    gps_track_point_t origin;
+    double lat = 0, lon = 0;
+    if (level >= 0) {
+        basemap_->origin(&lat, &lon);
+    }
+    if (level < 0 || !has_center_ || !gps_track_project(lat, lon, &origin)) {
+        driver_.fillAreaRGB666(config_.x, config_.y, config_.x + config_.width - 1,
+                               config_.y + config_.height - 1, config_.background);
+        return;
+    }
+
+    // 视口左上角对应的底图像素（与project()使用相同的取整）
+    int64_t scale = decimetersPerPixel();
+    int32_t map_x = floor_div((int64_t)center_e_dm_ - origin.e_dm, scale) - config_.width / 2;
+    int32_t map_y = floor_div((int64_t)origin.n_dm - center_n_dm_, scale) - config_.height / 2;
+    basemap_->draw(level, map_x, map_y, config_.x, config_.y, config_.width, config_.height, config_.background);
+}
+
+void TrackView::redraw() {
+    stats_.redraws++;
+
+    uint32_t count = gps_track_count();
+    const gps_track_point_t* points = gps_track_points();
+    drawn_appended_ = gps_track_appended();
+    has_head_ = false;
+
+    if (count == 0) {
+        drawBackground();
+        drawScaleBar();
+        return;
+    }
+
+    const gps_track_point_t& tail = points[count - 1];
+    if (!has_center_ || needsPan(project(tail))) {
+        // 首次显示或缩放后最新点不在视口内：以最新点为中心
+        center_e_dm_ = tail.e_dm;
+        center_n_dm_ = tail.n_dm;
+        has_center_ = true;
+    }
+    drawBackground();
+
+    // 最后一段留给高亮色，前面的点投影到同一像素时跳过
+    uint32_t head_index = count >= 2 ? count - 2 : 0;
+    Pixel prev = project(points[0]);
+    for (uint32_t i = 1; i <= head_index; i++) {
+        Pixel p = project(points[i]);
+        if (p.x == prev.x && p.y == prev.y) {
+            stats_.skipped_points++;
+            continue;
+        }
+        drawSegment(prev, p, config_.trail);
+        prev = p;
+    }
+
+    head_from_ = points[head_index];
+    head_to_ = tail;
+    has_head_ = true;
+    drawSegment(project(head_from_), project(head_to_), config_.head);
+
+    drawScaleBar();
+}
+
+bool TrackView::update() {
+    uint32_t appended = gps_track_appended();
+    if (appended == drawn_appended_) {
+        return false;
+    }
+
+    uint32_t count = gps_track_count();
+    uint32_t fresh = appended - drawn_appended_;
+    if (appended < drawn_appended_ || count == 0 || !has_center_ || !has_head_ || fresh >= count) {
+        // 轨迹被清空，或新增点已被抽稀掉起点
+        redraw();
+        return true;
+    }
+
+    const gps_track_point_t* points = gps_track_points();
+    const gps_track_point_t& tail = points[count - 1];
+    Pixel tail_pixel = project(tail);
+    if (needsPan(tail_pixel)) {
+        panTo(tail, tail_pixel);
+        redraw();
+        return true;
+    }
+
+    // 上一段高亮恢复为轨迹色，新增的点依次接上，最后一段高亮
+    drawSegment(project(head_from_), project(head_to_), config_.trail);
+    gps_track_point_t from = head_to_;
+    for (uint32_t i = count - fresh; i + 1 < count; i++) {
+        drawSegment(project(from), project(points[i]), config_.trail);
+        from = points[i];
+    }
+    drawSegment(project(from), tail_pixel, config_.head);
+    head_from_ = from;
+    head_to_ = tail;
+
+    drawn_appended_ = appended;
+    return true;
+}
+
+} // namespace ili9488
@@ -0,0 +1,264 @@
+/**
+ * @file gps_assist.c
+ * @brief GPS辅助数据(EPO)注入实现
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "ff.h"
+#include "gps/lc76g_i2c_adaptor.h"
+#include "gps/gps_assist.h"
+
+// $PAIR001结果码
+enum PAIR_ACK_RESULT {
+    PAIR_ACK_SUCCESS     = 0,
+    PAIR_ACK_PROCESSING  = 1,
+    PAIR_ACK_FAILED      = 2,
+    PAIR_ACK_UNSUPPORTED = 3,
+    PAIR_ACK_PARAM_ERROR = 4,
+    PAIR_ACK_BUSY        = 5
+};
+
+enum SEND_RESULT {
+    SEND_OK,
+    SEND_FAILED,
+    SEND_ABORT
+};
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/**
+ * @brief 校验"$PAIRnnn,...*HH"格式和校验和，取出命令ID
+ */
+static bool parse_sentence(const char *line, size_t len, char id[4]) {
+    if (len < 10 || strncmp(line, "$PAIR", 5) != 0 || line[len - 3] != '*') {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (line[5 + i] < '0' || line[5 + i] > '9') {
+            return false;
+        }
+        id[i] = line[5 + i];
+    }
+    id[3] = '\0';
+
+    int hi = hex_value(line[len - 2]);
+    int lo = hex_value(line[len - 1]);
+    if (hi < 0 || lo < 0) {
+        return false;
+    }
+    return lc76g_get_command_checksum(line + 1, (int32_t)(len - 4)) == hi * 16 + lo;
+}
+
+static int ack_result(const Ql_gnss_command_contx_TypeDef *info) {
+    return info->param_num >= 3 ? atoi(info->param[2]) : PAIR_ACK_FAILED;
+}
+
+static int send_with_ack(const char *sentence, const char *id, gps_assist_result_t *r) {
+    char expect[16];
+    snprintf(expect, sizeof(expect), "$PAIR001,%s,", id);
+
+    for (int attempt = 0; attempt <= GPS_ASSIST_MAX_RETRIES; attempt++) {
+        if (attempt > 0) {
+            r->retries++;
+        }
+
+        Ql_gnss_command_contx_TypeDef info;
+        memset(&info, 0, sizeof(info));
+        if (!lc76g_send_command_and_get_response(sentence, expect, GPS_ASSIST_ACK_TIMEOUT_MS, &info)) {
+            continue;   // 写入失败或应答超时
+        }
+        r->bytes += (uint32_t)strlen(sentence);
+
+        int result = ack_result(&info);
+        for (int wait = 0; result == PAIR_ACK_PROCESSING && wait < GPS_ASSIST_MAX_RETRIES; wait++) {
+            memset(&info, 0, sizeof(info));
+            result = lc76g_wait_response(expect, GPS_ASSIST_ACK_TIMEOUT_MS, &info) ? ack_result(&info) : PAIR_ACK_BUSY;
+        }
+
+        switch (result) {
+            case PAIR_ACK_SUCCESS:
+                return SEND_OK;
+            case PAIR_ACK_UNSUPPORTED:
+                printf("[GPS辅助] 模块不支持命令 PAIR%s，中止注入\n", id);
+                return SEND_ABORT;
+            case PAIR_ACK_BUSY:
+            case PAIR_ACK_PROCESSING:
+                sleep_ms(100);
+                break;
+            default:
+                printf("[GPS辅助] PAIR%s 被拒绝 (结果 %d)\n", id, result);
+                return SEND_FAILED;
+        }
+    }
+    return SEND_FAILED;
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+bool gps_assist_load_file(const char *path, uint32_t utc_now, gps_assist_result_t *result) {
+    gps_assist_result_t local;
+    gps_assist_result_t *r = result ? result : &local;
+    memset(r, 0, sizeof(*r));
+
+    if (!path) {
+        return false;
+    }
+
+    FIL file;
+    FRESULT fr = f_open(&file, path, FA_READ);
+    if (fr != FR_OK) {
+        printf("[GPS辅助] 无法打开辅助数据文件 %s: %d\n", path, fr);
+        return false;
+    }
+
+    uint32_t start_ms = now_ms();
+    printf("[GPS辅助] 开始注入 %s (%lu字节)\n", path, (unsigned long)f_size(&file));
+
+    char block[512];
+    char line[GPS_ASSIST_MAX_LINE + 4];
+    size_t line_len = 0;
+    bool line_overflow = false;
+    bool segment_active = true;     // 第一个#SEG之前的命令无有效期，总是注入
+    bool segment_counted = false;
+    bool done = false;
+
+    while (!done) {
+        UINT got = 0;
+        if (f_read(&file, block, sizeof(block), &got) != FR_OK) {
+            printf("[GPS辅助] 读取文件失败\n");
+            break;
+        }
+        // 文件末尾补一个换行，处理最后一行
+        if (got == 0) {
+            if (line_len == 0 && !line_overflow) {
+                break;
+            }
+            block[0] = '\n';
+            got = 1;
+            done = true;
+        }
+
+        for (UINT i = 0; i < got; i++) {
+            char c = block[i];
+            if (c != '\n') {
+                if (c == '\r') {
+                    continue;
+                }
+                if (line_len < GPS_ASSIST_MAX_LINE) {
+                    line[line_len++] = c;
+                } else {
+                    line_overflow = true;
+                }
+                continue;
+            }
+
+            line[line_len] = '\0';
+            size_t len = line_len;
+            bool overflow = line_overflow;
+            line_len = 0;
+            line_overflow = false;
+
+            if (overflow) {
+                r->invalid_lines++;
+                continue;
+            }
+            if (len == 0 || (line[0] == '#' && strncmp(line, "#SEG,", 5) != 0)) {
+                continue;
+            }
+
+            if (line[0] == '#') {
+                // 新的一段：判断有效期和段数上限
+                if (r->segments >= GPS_ASSIST_MAX_SEGMENTS) {
+                    done = true;
+                    break;
+                }
+                unsigned long seg_start = 0, seg_end = 0;
+                if (sscanf(line + 5, "%lu,%lu", &seg_start, &seg_end) != 2) {
+                    r->invalid_lines++;
+                    segment_active = false;
+                    continue;
+                }
+                (void)seg_start;
+                segment_active = utc_now == 0 || seg_end > utc_now;
+                segment_counted = false;
+                if (!segment_active) {
+                    r->expired_segments++;
+                }
+                continue;
+            }
+
+            if (!segment_active) {
+                continue;
+            }
+
+            char id[4];
+            if (!parse_sentence(line, len, id)) {
+                r->invalid_lines++;
+                continue;
+            }
+            if (!segment_counted) {
+                r->segments++;
+                segment_counted = true;
+            }
+
+            // 命令以\r\n结尾发送
+            line[len] = '\r';
+            line[len + 1] = '\n';
+            line[len + 2] = '\0';
+
+            r->sentences++;
+            int sent = send_with_ack(line, id, r);
+            if (sent == SEND_OK) {
+                r->acked++;
+            } else if (sent == SEND_ABORT) {
+                r->unsupported = true;
+                done = true;
+                break;
+            } else {
+                r->failed++;
+            }
+
+            if (r->sentences % 32 == 0) {
+                printf("[GPS辅助] 已注入 %lu 条\n", (unsigned long)r->sentences);
+            }
+        }
+    }
+
+    f_close(&file);
+    r->elapsed_ms = now_ms() - start_ms;
+    gps_assist_print_result(r);
+    return r->acked > 0 && !r->unsupported;
+}
+
+void gps_assist_print_result(const gps_assist_result_t *result) {
+    if (!result) {
+        return;
+    }
+    printf("[GPS辅助] 注入 %lu 段 (过期跳过 %lu)，命令 %lu 条，应答 %lu，失败 %lu，重试 %lu\n",
+           (unsigned long)result->segments, (unsigned long)result->expired_segments,
+           (unsigned long)result->sentences, (unsigned long)result->acked,
+           (unsigned long)result->failed, (unsigned long)result->retries);
+    printf("[GPS辅助] 写入 %lu 字节，耗时 %.1f秒%s%s\n",
+           (unsigned long)result->bytes, result->elapsed_ms / 1000.0f,
+           result->invalid_lines ? "，存在格式错误的行" : "",
+           result->unsupported ? "，模块不支持" : "");
+}
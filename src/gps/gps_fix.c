@@ -0,0 +1,189 @@
+/**
+ * @file gps_fix.c
+ * @brief 定点定位记录：旧结构转换和坐标系转换
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "gps/gps_fix.h"
+#include "gps/lc76g_i2c_adaptor.h"
+#include "gps/vendor_gps_parser.h"
+
+// GCJ-02转换常数
+static const double pi = 3.14159265358979324;
+static const double a = 6378245.0;
+static const double ee = 0.00669342162296594323;
+static const double x_pi = 3.14159265358979324 * 3000.0 / 180.0;
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static uint16_t clamp_u16(long value) {
+    if (value < 0) {
+        return 0;
+    }
+    return value > 65535 ? 65535 : (uint16_t)value;
+}
+
+/**
+ * @brief 1e-7度转回NMEA的(d)ddmm.mmmm
+ */
+static double e7_to_nmea(int32_t e7) {
+    uint32_t abs_e7 = e7 < 0 ? (uint32_t)(-(int64_t)e7) : (uint32_t)e7;
+    return (abs_e7 / 10000000u) * 100.0 + (abs_e7 % 10000000u) * 6e-6;
+}
+
+static uint16_t parse_iso_date(const char *date) {
+    unsigned year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    if (sscanf(date, "%4u-%2u-%2u", &year, &month, &day) != 3 || year < 1980 || year > 2107 ||
+        month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+    return (uint16_t)(((year - 1980) << 9) | (month << 5) | day);
+}
+
+static double transform_lat(double x, double y) {
+    double ret = -100.0 + 2.0 * x + 3.0 * y + 0.2 * y * y + 0.1 * x * y + 0.2 * sqrt(fabs(x));
+    ret += (20.0 * sin(6.0 * x * pi) + 20.0 * sin(2.0 * x * pi)) * 2.0 / 3.0;
+    ret += (20.0 * sin(y * pi) + 40.0 * sin(y / 3.0 * pi)) * 2.0 / 3.0;
+    ret += (160.0 * sin(y / 12.0 * pi) + 320 * sin(y * pi / 30.0)) * 2.0 / 3.0;
+    return ret;
+}
+
+static double transform_lon(double x, double y) {
+    double ret = 300.0 + x + 2.0 * y + 0.1 * x * x + 0.1 * x * y + 0.1 * sqrt(fabs(x));
+    ret += (20.0 * sin(6.0 * x * pi) + 20.0 * sin(2.0 * x * pi)) * 2.0 / 3.0;
+    ret += (20.0 * sin(x * pi) + 40.0 * sin(x / 3.0 * pi)) * 2.0 / 3.0;
+    ret += (150.0 * sin(x / 12.0 * pi) + 300.0 * sin(x / 30.0 * pi)) * 2.0 / 3.0;
+    return ret;
+}
+
+static uint32_t local_hms_to_utc_ms(uint8_t hour, uint8_t minute, uint8_t second) {
+    uint32_t utc_hour = (hour + 24u - GPS_FIX_LOCAL_UTC_OFFSET_HOURS) % 24u;
+    return ((utc_hour * 60u + minute) * 60u + second) * 1000u;
+}
+
+// LC76G_GPS_Data和GNRMC字段相同，两组转换共用同一段代码
+#define FIX_FROM_LEGACY(data, fix) do {                                                         \
+    memset((fix), 0, sizeof(*(fix)));                                                           \
+    if ((data)->Lat_area || (data)->Lon_area) {                                                 \
+        (fix)->flags |= GPS_FIX_HAS_POSITION;                                                   \
+    }                                                                                           \
+    (fix)->lat_e7 = (int32_t)lround((data)->Lat * 1e7);                                         \
+    (fix)->lon_e7 = (int32_t)lround((data)->Lon * 1e7);                                         \
+    (fix)->alt_cm = (int32_t)lround((data)->Altitude * 100.0);                                  \
+    (fix)->utc_date = parse_iso_date((data)->Date);                                             \
+    if ((data)->Time_H || (data)->Time_M || (data)->Time_S || (fix)->utc_date) {                \
+        (fix)->flags |= GPS_FIX_HAS_TIME;                                                       \
+        (fix)->utc_ms = local_hms_to_utc_ms((data)->Time_H, (data)->Time_M, (data)->Time_S);    \
+    }                                                                                           \
+    (fix)->speed_cms = clamp_u16(lround((data)->Speed / 0.036));                                \
+    (fix)->course_cdeg = clamp_u16(lround(fmod((data)->Course, 360.0) * 100.0)) % 36000u;       \
+    (fix)->hdop_c = clamp_u16(lround((data)->HDOP * 100.0));                                    \
+    (fix)->pdop_c = clamp_u16(lround((data)->PDOP * 100.0));                                    \
+    (fix)->vdop_c = clamp_u16(lround((data)->VDOP * 100.0));                                    \
+    if ((data)->Status == 1) {                                                                  \
+        (fix)->flags |= GPS_FIX_VALID;                                                          \
+    }                                                                                           \
+    (fix)->quality = (data)->Quality;                                                           \
+    (fix)->satellites = (data)->Satellites;                                                     \
+    (fix)->mode = (data)->Mode;                                                                 \
+} while (0)
+
+#define FIX_TO_LEGACY(fix, data) do {                                                           \
+    memset((data), 0, sizeof(*(data)));                                                        \
+    if ((fix)->flags & GPS_FIX_HAS_POSITION) {                                                  \
+        (data)->Lat = (fix)->lat_e7 * 1e-7;                                                     \
+        (data)->Lon = (fix)->lon_e7 * 1e-7;                                                     \
+        (data)->Lat_area = (fix)->lat_e7 < 0 ? 'S' : 'N';                                       \
+        (data)->Lon_area = (fix)->lon_e7 < 0 ? 'W' : 'E';                                       \
+        (data)->Lat_Raw = e7_to_nmea((fix)->lat_e7);                                            \
+        (data)->Lon_Raw = e7_to_nmea((fix)->lon_e7);                                            \
+    }                                                                                           \
+    if ((fix)->flags & GPS_FIX_HAS_TIME) {                                                      \
+        gps_fix_local_hms((fix), &(data)->Time_H, &(data)->Time_M, &(data)->Time_S);            \
+    }                                                                                           \
+    uint16_t year_;                                                                             \
+    uint8_t month_;                                                                             \
+    uint8_t day_;                                                                               \
+    if (gps_fix_date((fix), &year_, &month_, &day_)) {                                          \
+        snprintf((data)->Date, sizeof((data)->Date), "%04u-%02u-%02u", year_, month_, day_);    \
+    }                                                                                           \
+    (data)->Status = gps_fix_is_valid(fix) ? 1 : 0;                                             \
+    (data)->NavStatus = gps_fix_is_valid(fix) ? 'A' : 'V';                                      \
+    (data)->Speed = (fix)->speed_cms * 0.036;                                                   \
+    (data)->Course = (fix)->course_cdeg * 0.01;                                                 \
+    (data)->Altitude = (fix)->alt_cm * 0.01;                                                    \
+    (data)->Quality = (fix)->quality;                                                           \
+    (data)->Satellites = (fix)->satellites;                                                     \
+    (data)->HDOP = (fix)->hdop_c * 0.01;                                                        \
+    (data)->PDOP = (fix)->pdop_c * 0.01;                                                        \
+    (data)->VDOP = (fix)->vdop_c * 0.01;                                                        \
+    (data)->Mode = (fix)->mode;                                                                 \
+} while (0)
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+bool gps_fix_date(const gps_fix_t *fix, uint16_t *year, uint8_t *month, uint8_t *day) {
+    if (fix->utc_date == 0) {
+        return false;
+    }
+    *year = (uint16_t)(1980u + (fix->utc_date >> 9));
+    *month = (uint8_t)((fix->utc_date >> 5) & 0x0F);
+    *day = (uint8_t)(fix->utc_date & 0x1F);
+    return true;
+}
+
+void gps_fix_from_lc76g(const struct LC76G_GPS_Data *data, gps_fix_t *fix) {
+    FIX_FROM_LEGACY(data, fix);
+}
+
+void gps_fix_to_lc76g(const gps_fix_t *fix, struct LC76G_GPS_Data *data) {
+    FIX_TO_LEGACY(fix, data);
+}
+
+void gps_fix_from_gnrmc(const struct GNRMC *data, gps_fix_t *fix) {
+    FIX_FROM_LEGACY(data, fix);
+}
+
+void gps_fix_to_gnrmc(const gps_fix_t *fix, struct GNRMC *data) {
+    FIX_TO_LEGACY(fix, data);
+}
+
+Coordinates gps_fix_to_gcj02(const gps_fix_t *fix) {
+    Coordinates gps;
+    gps.Lat = fix->lat_e7 * 1e-7;
+    gps.Lon = fix->lon_e7 * 1e-7;
+
+    double dLat = transform_lat(gps.Lon - 105.0, gps.Lat - 35.0);
+    double dLon = transform_lon(gps.Lon - 105.0, gps.Lat - 35.0);
+    double radLat = gps.Lat / 180.0 * pi;
+    double magic = sin(radLat);
+    magic = 1 - ee * magic * magic;
+    double sqrtMagic = sqrt(magic);
+    dLat = (dLat * 180.0) / ((a * (1 - ee)) / (magic * sqrtMagic) * pi);
+    dLon = (dLon * 180.0) / (a / sqrtMagic * cos(radLat) * pi);
+
+    Coordinates gg;
+    gg.Lat = gps.Lat + dLat;
+    gg.Lon = gps.Lon + dLon;
+    return gg;
+}
+
+Coordinates gps_fix_to_bd09(const gps_fix_t *fix) {
+    Coordinates gg = gps_fix_to_gcj02(fix);
+    double x = gg.Lon, y = gg.Lat;
+    double z = sqrt(x * x + y * y) + 0.00002 * sin(y * x_pi);
+    double theta = atan2(y, x) + 0.000003 * cos(x * x_pi);
+
+    Coordinates bd;
+    bd.Lon = z * cos(theta) + 0.0065;
+    bd.Lat = z * sin(theta) + 0.006;
+    return bd;
+}
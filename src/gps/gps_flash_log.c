@@ -0,0 +1,161 @@
+/**
+ * @file gps_flash_log.c
+ * @brief Flash追加记录环实现
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "gps/gps_flash_log.h"
+
+#define MAX_RECORD_SIZE 256
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline uint32_t slots_per_sector(const gps_flash_log_t *log) {
+    return FLASH_SECTOR_SIZE / log->record_size;
+}
+
+static inline uint32_t slot_count(const gps_flash_log_t *log) {
+    return slots_per_sector(log) * log->sectors;
+}
+
+static inline uint32_t slot_offset(const gps_flash_log_t *log, uint32_t slot) {
+    return log->flash_offset + slot * log->record_size;
+}
+
+static inline uint32_t slot_sector(const gps_flash_log_t *log, uint32_t slot) {
+    return slot / slots_per_sector(log);
+}
+
+static inline const uint8_t *flash_ptr(uint32_t offset) {
+    return (const uint8_t *)(XIP_BASE + offset);
+}
+
+static bool config_is_valid(const gps_flash_log_t *log) {
+    return log && log->sectors >= 2 && log->record_size >= sizeof(gps_flash_log_header_t) + 4 &&
+           log->record_size <= MAX_RECORD_SIZE && FLASH_PAGE_SIZE % log->record_size == 0 &&
+           log->flash_offset % FLASH_SECTOR_SIZE == 0;
+}
+
+static bool range_is_erased(uint32_t offset, uint32_t len) {
+    const uint8_t *p = flash_ptr(offset);
+    for (uint32_t i = 0; i < len; i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t stored_crc(const gps_flash_log_t *log, const uint8_t *rec) {
+    uint32_t crc;
+    memcpy(&crc, rec + log->record_size - 4, sizeof(crc));
+    return crc;
+}
+
+static bool record_is_valid(const gps_flash_log_t *log, const uint8_t *rec) {
+    const gps_flash_log_header_t *hdr = (const gps_flash_log_header_t *)rec;
+    return hdr->magic == log->magic && hdr->version == log->version &&
+           stored_crc(log, rec) == gps_flash_log_crc32(rec, log->record_size - 4);
+}
+
+static void write_slot(const gps_flash_log_t *log, uint32_t slot, const void *rec) {
+    // 页内其余槽位填0xFF，编程时保持原内容不变
+    uint8_t page[FLASH_PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+    uint32_t offset = slot_offset(log, slot);
+    uint32_t page_offset = offset & ~(FLASH_PAGE_SIZE - 1u);
+    memcpy(&page[offset - page_offset], rec, log->record_size);
+
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_program(page_offset, page, FLASH_PAGE_SIZE);
+    restore_interrupts(ints);
+}
+
+static void erase_sector(const gps_flash_log_t *log, uint32_t sector) {
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_erase(log->flash_offset + sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE);
+    restore_interrupts(ints);
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+uint32_t gps_flash_log_crc32(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+bool gps_flash_log_load(gps_flash_log_t *log, void *record) {
+    if (!config_is_valid(log) || !record) {
+        return false;
+    }
+    log->latest_slot = -1;
+    log->next_slot = 0;
+
+    uint32_t best_seq = 0;
+    for (uint32_t slot = 0; slot < slot_count(log); slot++) {
+        const uint8_t *rec = flash_ptr(slot_offset(log, slot));
+        if (!record_is_valid(log, rec)) {
+            continue;
+        }
+        uint32_t seq = ((const gps_flash_log_header_t *)rec)->seq;
+        if (log->latest_slot < 0 || seq > best_seq) {
+            best_seq = seq;
+            log->latest_slot = (int32_t)slot;
+        }
+    }
+
+    if (log->latest_slot < 0) {
+        return false;
+    }
+    memcpy(record, flash_ptr(slot_offset(log, (uint32_t)log->latest_slot)), log->record_size);
+    log->next_slot = ((uint32_t)log->latest_slot + 1) % slot_count(log);
+    return true;
+}
+
+bool gps_flash_log_append(gps_flash_log_t *log, void *record) {
+    if (!config_is_valid(log) || !record) {
+        return false;
+    }
+
+    uint32_t slot = log->next_slot % slot_count(log);
+    if (slot % slots_per_sector(log) == 0 || !range_is_erased(slot_offset(log, slot), log->record_size)) {
+        // 进入新扇区（或槽位已被占用）：不能擦掉最新记录所在的扇区
+        if (log->latest_slot >= 0 && slot_sector(log, slot) == slot_sector(log, (uint32_t)log->latest_slot)) {
+            slot = ((slot_sector(log, slot) + 1) % log->sectors) * slots_per_sector(log);
+        }
+        uint32_t sector_offset = log->flash_offset + slot_sector(log, slot) * FLASH_SECTOR_SIZE;
+        if (!range_is_erased(sector_offset, FLASH_SECTOR_SIZE)) {
+            erase_sector(log, slot_sector(log, slot));
+        }
+    }
+
+    gps_flash_log_header_t *hdr = (gps_flash_log_header_t *)record;
+    hdr->magic = log->magic;
+    hdr->version = log->version;
+    hdr->seq++;
+    uint32_t crc = gps_flash_log_crc32(record, log->record_size - 4);
+    memcpy((uint8_t *)record + log->record_size - 4, &crc, sizeof(crc));
+
+    write_slot(log, slot, record);
+    if (memcmp(flash_ptr(slot_offset(log, slot)), record, log->record_size) != 0) {
+        return false;
+    }
+
+    log->latest_slot = (int32_t)slot;
+    log->next_slot = (slot + 1) % slot_count(log);
+    return true;
+}
@@ -0,0 +1,313 @@
+/**
+ * @file gps_flush.c
+ * @brief 日志刷新控制器实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "gps/gps_flush.h"
+
+#define EMA_SHIFT 3                     // 滑动平均权重1/8
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+/**
+ * @brief 缓冲中的一条记录：结束位置（相对缓冲开头）和进入缓冲的时刻
+ */
+typedef struct {
+    uint32_t end;
+    uint32_t ms;
+} record_mark_t;
+
+static struct {
+    uint32_t max_at_risk_ms;
+    uint32_t capacity;
+    uint32_t largest_record;            // 最长一条记录，判断缓冲将满
+    uint32_t sector_us;                 // 每扇区耗时的滑动平均
+    uint32_t deviation_us;              // 平均偏差
+    bool measured;
+    record_mark_t marks[GPS_FLUSH_MAX_RECORDS];
+    uint8_t mark_count;
+} g_flush;
+
+static gps_flush_stats_t g_stats;
+
+static const char *const kReasonNames[GPS_FLUSH_REASON_COUNT] = {"无", "期限", "缓冲满", "空闲", "强制"};
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline uint32_t pending_bytes(void) {
+    return g_flush.mark_count ? g_flush.marks[g_flush.mark_count - 1].end : 0;
+}
+
+/**
+ * @brief 写出bytes字节涉及的扇区数
+ */
+static inline uint32_t sectors_touched(uint32_t file_size, uint32_t bytes) {
+    uint32_t head = file_size % GPS_FLUSH_SECTOR_SIZE;
+    return (head + bytes + GPS_FLUSH_SECTOR_SIZE - 1) / GPS_FLUSH_SECTOR_SIZE;
+}
+
+/**
+ * @brief 不超过limit、写完后文件结束于扇区边界的最大字节数
+ */
+static inline uint32_t aligned_bytes(uint32_t file_size, uint32_t limit) {
+    uint32_t head = file_size % GPS_FLUSH_SECTOR_SIZE;
+    uint32_t end = (head + limit) / GPS_FLUSH_SECTOR_SIZE * GPS_FLUSH_SECTOR_SIZE;
+    return end > head ? end - head : 0;
+}
+
+/**
+ * @brief 缓冲的分段：开头head_bytes字节属于另一个文件（轮转前缓冲的记录），其余写入当前文件
+ */
+typedef struct {
+    uint32_t head_file_size;
+    uint32_t head_bytes;
+    uint32_t file_size;
+} flush_layout_t;
+
+static uint32_t layout_estimate_us(const flush_layout_t *layout, uint32_t bytes) {
+    uint32_t head = bytes < layout->head_bytes ? bytes : layout->head_bytes;
+    return gps_flush_estimate_us(layout->head_file_size, head) +
+           gps_flush_estimate_us(layout->file_size, bytes - head);
+}
+
+/**
+ * @brief 不超过limit、写完后结束于扇区边界的最大字节数；开头一段是那个文件最后的数据，
+ *        写完整段也算边界
+ */
+static uint32_t layout_aligned(const flush_layout_t *layout, uint32_t limit) {
+    if (limit < layout->head_bytes) {
+        return aligned_bytes(layout->head_file_size, limit);
+    }
+    return layout->head_bytes + aligned_bytes(layout->file_size, limit - layout->head_bytes);
+}
+
+/**
+ * @brief 对数分桶：0-3各一个桶，之后每个2倍区间4个桶
+ */
+static uint32_t bucket_of(uint32_t v) {
+    if (v < 4) {
+        return v;
+    }
+    uint32_t octave = 31u - (uint32_t)__builtin_clz(v);
+    uint32_t index = (octave - 1u) * 4u + ((v >> (octave - 2u)) & 3u);
+    return index < GPS_FLUSH_HIST_BUCKETS ? index : GPS_FLUSH_HIST_BUCKETS - 1;
+}
+
+static uint32_t bucket_upper(uint32_t index) {
+    if (index < 4) {
+        return index;
+    }
+    uint32_t octave = index / 4u + 1u;
+    uint32_t sub = index % 4u;
+    return ((4u + sub + 1u) << (octave - 2u)) - 1u;
+}
+
+static inline void hist_add(uint32_t *hist, uint32_t v) {
+    hist[bucket_of(v)]++;
+}
+
+/**
+ * @brief 分位数不超过实测最大值（桶上界可能大于最大值）
+ */
+static inline unsigned long bounded_percentile(const uint32_t *hist, uint32_t permille, uint32_t max) {
+    uint32_t value = gps_flush_percentile(hist, permille);
+    return (unsigned long)(value < max ? value : max);
+}
+
+/**
+ * @brief 移除已写出的记录，剩余记录的位置前移
+ */
+static void drop_marks(uint32_t bytes) {
+    uint8_t keep = 0;
+    for (uint8_t i = 0; i < g_flush.mark_count; i++) {
+        if (g_flush.marks[i].end > bytes) {
+            g_flush.marks[keep].end = g_flush.marks[i].end - bytes;
+            g_flush.marks[keep].ms = g_flush.marks[i].ms;
+            keep++;
+        }
+    }
+    g_flush.mark_count = keep;
+}
+
+static void update_estimate(uint32_t sectors, uint32_t elapsed_us) {
+    uint32_t per_sector = elapsed_us / (sectors ? sectors : 1u);
+    if (!g_flush.measured) {
+        g_flush.sector_us = per_sector;
+        g_flush.deviation_us = per_sector / 2u;
+        g_flush.measured = true;
+        return;
+    }
+    int32_t error = (int32_t)per_sector - (int32_t)g_flush.sector_us;
+    uint32_t abs_error = (uint32_t)(error < 0 ? -error : error);
+    g_flush.sector_us = (uint32_t)((int32_t)g_flush.sector_us + (error >> EMA_SHIFT));
+    g_flush.deviation_us += (uint32_t)(((int32_t)abs_error - (int32_t)g_flush.deviation_us) >> EMA_SHIFT);
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void gps_flush_reset(uint32_t max_at_risk_ms, uint32_t capacity) {
+    memset(&g_flush, 0, sizeof(g_flush));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_flush.max_at_risk_ms = max_at_risk_ms;
+    g_flush.capacity = capacity;
+    g_flush.sector_us = GPS_FLUSH_INITIAL_SECTOR_US;
+    g_flush.deviation_us = GPS_FLUSH_INITIAL_SECTOR_US / 2u;
+}
+
+void gps_flush_record(uint32_t bytes, uint32_t now_ms) {
+    if (bytes > g_flush.largest_record) {
+        g_flush.largest_record = bytes;
+    }
+    uint32_t end = pending_bytes() + bytes;
+    if (g_flush.mark_count < GPS_FLUSH_MAX_RECORDS) {
+        g_flush.marks[g_flush.mark_count].end = end;
+        g_flush.marks[g_flush.mark_count].ms = now_ms;
+        g_flush.mark_count++;
+    } else {
+        // 记录表满时并入最后一条，保留较早的时刻（风险窗口只会被高估）
+        g_flush.marks[GPS_FLUSH_MAX_RECORDS - 1].end = end;
+    }
+}
+
+uint32_t gps_flush_estimate_us(uint32_t file_size, uint32_t bytes) {
+    if (bytes == 0) {
+        return 0;
+    }
+    return sectors_touched(file_size, bytes) * g_flush.sector_us + 2u * g_flush.deviation_us;
+}
+
+uint32_t gps_flush_plan(uint32_t now_ms, uint32_t file_size, uint32_t slack_us, uint8_t *reason) {
+    return gps_flush_plan_split(now_ms, 0, 0, file_size, slack_us, reason);
+}
+
+uint32_t gps_flush_plan_split(uint32_t now_ms, uint32_t head_file_size, uint32_t head_bytes,
+                              uint32_t file_size, uint32_t slack_us, uint8_t *reason) {
+    uint8_t why = GPS_FLUSH_NONE;
+    uint32_t bytes = 0;
+    uint32_t pending = pending_bytes();
+    const flush_layout_t layout = {head_file_size, head_bytes < pending ? head_bytes : pending, file_size};
+
+    if (pending > 0) {
+        uint32_t age_ms = now_ms - g_flush.marks[0].ms;
+        uint32_t estimate_ms = (layout_estimate_us(&layout, pending) + 999u) / 1000u;
+        uint32_t aligned = layout_aligned(&layout, pending);
+
+        if (age_ms + estimate_ms >= g_flush.max_at_risk_ms) {
+            why = GPS_FLUSH_DEADLINE;
+            bytes = pending;
+        } else if (pending + g_flush.largest_record >= g_flush.capacity) {
+            why = GPS_FLUSH_FULL;
+            bytes = aligned ? aligned : pending;
+        } else if (slack_us > 0 && aligned > 0) {
+            // 目标批量：最大耗时内能写完的扇区数，至少一个扇区
+            uint32_t sector_cost = g_flush.sector_us + 2u * g_flush.deviation_us;
+            uint32_t target_sectors = GPS_FLUSH_MAX_LATENCY_US / (sector_cost ? sector_cost : 1u);
+            uint32_t target = layout_aligned(&layout, layout.head_bytes +
+                                             (target_sectors ? target_sectors : 1u) * GPS_FLUSH_SECTOR_SIZE);
+            if (aligned >= target && layout_estimate_us(&layout, aligned) <= slack_us) {
+                why = GPS_FLUSH_SLACK;
+                bytes = aligned;
+            }
+        }
+    }
+    if (reason) {
+        *reason = why;
+    }
+    return bytes;
+}
+
+void gps_flush_done(uint32_t now_ms, uint32_t file_size, uint32_t bytes, uint32_t elapsed_us, uint8_t reason) {
+    if (bytes == 0) {
+        return;
+    }
+    uint32_t pending = pending_bytes();
+    uint32_t at_risk_ms = g_flush.mark_count ? now_ms - g_flush.marks[0].ms : 0;
+
+    update_estimate(sectors_touched(file_size, bytes), elapsed_us);
+    drop_marks(bytes);
+
+    g_stats.flushes++;
+    g_stats.by_reason[reason < GPS_FLUSH_REASON_COUNT ? reason : GPS_FLUSH_FORCED]++;
+    g_stats.aligned += (file_size + bytes) % GPS_FLUSH_SECTOR_SIZE == 0 ? 1u : 0u;
+    g_stats.bytes += bytes;
+    if (elapsed_us > g_stats.flush_us_max) {
+        g_stats.flush_us_max = elapsed_us;
+    }
+    if (at_risk_ms > g_stats.at_risk_ms_max) {
+        g_stats.at_risk_ms_max = at_risk_ms;
+    }
+    if (pending > g_stats.at_risk_bytes_max) {
+        g_stats.at_risk_bytes_max = pending;
+    }
+    hist_add(g_stats.flush_us_hist, elapsed_us);
+    hist_add(g_stats.at_risk_ms_hist, at_risk_ms);
+    hist_add(g_stats.at_risk_bytes_hist, pending);
+}
+
+void gps_flush_failed(void) {
+    g_stats.failures++;
+}
+
+uint32_t gps_flush_pending(void) {
+    return pending_bytes();
+}
+
+void gps_flush_get_stats(gps_flush_stats_t *stats) {
+    if (stats) {
+        *stats = g_stats;
+        stats->sector_us = g_flush.sector_us;
+    }
+}
+
+uint32_t gps_flush_percentile(const uint32_t *hist, uint32_t permille) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < GPS_FLUSH_HIST_BUCKETS; i++) {
+        total += hist[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    // 第ceil(total * permille / 1000)个样本所在的桶
+    uint32_t rank = (uint32_t)(((uint64_t)total * permille + 999u) / 1000u);
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < GPS_FLUSH_HIST_BUCKETS; i++) {
+        seen += hist[i];
+        if (seen >= rank && hist[i]) {
+            return bucket_upper(i);
+        }
+    }
+    return bucket_upper(GPS_FLUSH_HIST_BUCKETS - 1);
+}
+
+void gps_flush_print_stats(void) {
+    const gps_flush_stats_t *s = &g_stats;
+    printf("[日志刷新] %lu 次 (", (unsigned long)s->flushes);
+    for (int i = GPS_FLUSH_DEADLINE; i < GPS_FLUSH_REASON_COUNT; i++) {
+        printf("%s%s %lu", i > GPS_FLUSH_DEADLINE ? ", " : "", kReasonNames[i], (unsigned long)s->by_reason[i]);
+    }
+    printf("), 失败 %lu, 扇区对齐 %lu, 共 %llu 字节, 每扇区约 %lu us\n", (unsigned long)s->failures,
+           (unsigned long)s->aligned, (unsigned long long)s->bytes, (unsigned long)g_flush.sector_us);
+    if (s->flushes == 0) {
+        return;
+    }
+    printf("[日志刷新] 耗时 p50 %lu us, p90 %lu us, p99 %lu us, 最大 %lu us\n",
+           bounded_percentile(s->flush_us_hist, 500, s->flush_us_max),
+           bounded_percentile(s->flush_us_hist, 900, s->flush_us_max),
+           bounded_percentile(s->flush_us_hist, 990, s->flush_us_max), (unsigned long)s->flush_us_max);
+    printf("[日志刷新] 风险窗口 p50 %lu ms, p90 %lu ms, p99 %lu ms, 最大 %lu ms (上限 %lu ms); "
+           "待写 p90 %lu 字节, 最大 %lu 字节\n",
+           bounded_percentile(s->at_risk_ms_hist, 500, s->at_risk_ms_max),
+           bounded_percentile(s->at_risk_ms_hist, 900, s->at_risk_ms_max),
+           bounded_percentile(s->at_risk_ms_hist, 990, s->at_risk_ms_max), (unsigned long)s->at_risk_ms_max,
+           (unsigned long)g_flush.max_at_risk_ms,
+           bounded_percentile(s->at_risk_bytes_hist, 900, s->at_risk_bytes_max),
+           (unsigned long)s->at_risk_bytes_max);
+}
@@ -0,0 +1,454 @@
+/**
+ * @file gps_geofence.c
+ * @brief 地理围栏实现
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "pico/stdlib.h"
+#include "ff.h"
+#include "gps/gps_geofence.h"
+
+_Static_assert(sizeof(gps_geofence_file_header_t) == 16, "文件头必须为16字节");
+_Static_assert(sizeof(gps_geofence_file_fence_t) == 24, "围栏记录头必须为24字节");
+_Static_assert(GPS_GEOFENCE_MAX_FENCES <= 65535 && GPS_GEOFENCE_MAX_CELL_ENTRIES <= 65535, "单元格索引为16位");
+
+#define M_PER_E7_LAT  0.011132f         // 1e-7度纬度对应的米数
+#define E7            10000000.0
+#define DEG_TO_RAD    0.017453292519943295f
+#define CELL_COUNT    (GPS_GEOFENCE_GRID * GPS_GEOFENCE_GRID)
+
+/**
+ * @brief 内存中的围栏，外包矩形已按迟滞距离外扩
+ */
+typedef struct {
+    uint32_t id;
+    char name[GPS_GEOFENCE_NAME_LEN];
+    int32_t min_lat, max_lat;
+    int32_t min_lon, max_lon;
+    uint16_t first_vertex;
+    uint16_t vertex_count;
+    float margin_m;
+} fence_t;
+
+_Static_assert(GPS_GEOFENCE_MAX_VERTICES <= 65535, "顶点索引为16位");
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static fence_t g_fences[GPS_GEOFENCE_MAX_FENCES];
+static int32_t g_vertices[GPS_GEOFENCE_MAX_VERTICES][2];   // [lat_e7, lon_e7]
+static uint32_t g_fence_count = 0;
+
+// 网格：单元格c的围栏为g_cell_fences[g_cell_start[c] .. g_cell_start[c+1])
+static uint16_t g_cell_start[CELL_COUNT + 1];
+static uint16_t g_cell_fences[GPS_GEOFENCE_MAX_CELL_ENTRIES];
+static uint16_t g_cell_fill[CELL_COUNT];
+static int32_t g_grid_min_lat, g_grid_min_lon;
+static int32_t g_cell_lat, g_cell_lon;          // 单元格边长 (1e-7度)
+
+// 当前处于内部的围栏
+static uint16_t g_active[GPS_GEOFENCE_MAX_ACTIVE];
+static uint32_t g_active_count = 0;
+static uint32_t g_inside_bits[(GPS_GEOFENCE_MAX_FENCES + 31) / 32];
+
+static gps_geofence_stats_t g_stats;
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline bool is_inside(uint32_t index) {
+    return (g_inside_bits[index >> 5] >> (index & 31)) & 1u;
+}
+
+static inline void set_inside(uint32_t index, bool inside) {
+    if (inside) {
+        g_inside_bits[index >> 5] |= 1u << (index & 31);
+    } else {
+        g_inside_bits[index >> 5] &= ~(1u << (index & 31));
+    }
+}
+
+static inline bool in_box(const fence_t *f, int32_t lat, int32_t lon) {
+    return lat >= f->min_lat && lat <= f->max_lat && lon >= f->min_lon && lon <= f->max_lon;
+}
+
+/**
+ * @brief 射线法判断点是否在多边形内（定点坐标，64位叉积）
+ */
+static bool point_in_polygon(const fence_t *f, int32_t lat, int32_t lon) {
+    const int32_t (*v)[2] = &g_vertices[f->first_vertex];
+    bool inside = false;
+    for (uint32_t i = 0, j = f->vertex_count - 1; i < f->vertex_count; j = i++) {
+        int32_t lat_i = v[i][0], lat_j = v[j][0];
+        if ((lat_i > lat) == (lat_j > lat)) {
+            continue;
+        }
+        // 交点在点的东侧时翻转：sign((lon_j-lon_i)*(lat-lat_i) - (lon-lon_i)*(lat_j-lat_i)) 与 sign(lat_j-lat_i) 相同
+        int64_t cross = ((int64_t)v[j][1] - v[i][1]) * ((int64_t)lat - lat_i) -
+                        ((int64_t)lon - v[i][1]) * ((int64_t)lat_j - lat_i);
+        if ((cross > 0) == (lat_j > lat_i)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * @brief 点到多边形边界的距离是否不小于limit_m（发现更近的边即提前返回）
+ */
+static bool boundary_farther_than(const fence_t *f, int32_t lat, int32_t lon, float m_per_e7_lon,
+                                  float limit_m, uint32_t *edges) {
+    const int32_t (*v)[2] = &g_vertices[f->first_vertex];
+    const float limit_sq = limit_m * limit_m;
+    for (uint32_t i = 0, j = f->vertex_count - 1; i < f->vertex_count; j = i++) {
+        (*edges)++;
+        // 以定位点为原点的局部平面 (米)
+        float ax = (float)((int64_t)v[j][1] - lon) * m_per_e7_lon;
+        float ay = (float)((int64_t)v[j][0] - lat) * M_PER_E7_LAT;
+        float bx = (float)((int64_t)v[i][1] - lon) * m_per_e7_lon;
+        float by = (float)((int64_t)v[i][0] - lat) * M_PER_E7_LAT;
+        float dx = bx - ax, dy = by - ay;
+        float len_sq = dx * dx + dy * dy;
+        float t = len_sq > 0.0f ? -(ax * dx + ay * dy) / len_sq : 0.0f;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        float px = ax + t * dx, py = ay + t * dy;
+        if (px * px + py * py < limit_sq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 判定一个围栏，越过边界超过迟滞距离时切换状态
+ * @return 状态是否切换
+ */
+static bool evaluate(uint32_t index, int32_t lat, int32_t lon, float m_per_e7_lon, uint32_t *edges) {
+    const fence_t *f = &g_fences[index];
+    bool was_inside = is_inside(index);
+
+    bool boxed = in_box(f, lat, lon);
+    bool inside = boxed && point_in_polygon(f, lat, lon);
+    if (boxed) {
+        *edges += f->vertex_count;
+    }
+    if (inside == was_inside) {
+        return false;
+    }
+    // 外扩矩形之外必然离边界超过迟滞距离
+    if (f->margin_m > 0.0f && boxed &&
+        !boundary_farther_than(f, lat, lon, m_per_e7_lon, f->margin_m, edges)) {
+        return false;
+    }
+    set_inside(index, inside);
+    return true;
+}
+
+static void emit(uint32_t index, bool entered, gps_geofence_event_t *events, int max_events, int *count) {
+    g_stats.events++;
+    if (!events || *count >= max_events) {
+        g_stats.dropped_events++;
+        return;
+    }
+    gps_geofence_event_t *e = &events[(*count)++];
+    e->id = g_fences[index].id;
+    memcpy(e->name, g_fences[index].name, GPS_GEOFENCE_NAME_LEN);
+    e->name[GPS_GEOFENCE_NAME_LEN] = '\0';
+    e->entered = entered;
+}
+
+static inline uint32_t cell_row(int32_t lat) {
+    return (uint32_t)(((int64_t)lat - g_grid_min_lat) / g_cell_lat);
+}
+
+static inline uint32_t cell_col(int32_t lon) {
+    return (uint32_t)(((int64_t)lon - g_grid_min_lon) / g_cell_lon);
+}
+
+/**
+ * @brief 在所有围栏的外包矩形上建立均匀网格
+ */
+static bool build_grid(void) {
+    int32_t min_lat = INT32_MAX, max_lat = INT32_MIN, min_lon = INT32_MAX, max_lon = INT32_MIN;
+    for (uint32_t i = 0; i < g_fence_count; i++) {
+        const fence_t *f = &g_fences[i];
+        if (f->min_lat < min_lat) min_lat = f->min_lat;
+        if (f->max_lat > max_lat) max_lat = f->max_lat;
+        if (f->min_lon < min_lon) min_lon = f->min_lon;
+        if (f->max_lon > max_lon) max_lon = f->max_lon;
+    }
+    g_grid_min_lat = min_lat;
+    g_grid_min_lon = min_lon;
+    g_cell_lat = (int32_t)(((int64_t)max_lat - min_lat) / GPS_GEOFENCE_GRID + 1);
+    g_cell_lon = (int32_t)(((int64_t)max_lon - min_lon) / GPS_GEOFENCE_GRID + 1);
+
+    // 第一遍统计每个单元格的围栏数
+    memset(g_cell_fill, 0, sizeof(g_cell_fill));
+    for (uint32_t i = 0; i < g_fence_count; i++) {
+        const fence_t *f = &g_fences[i];
+        for (uint32_t r = cell_row(f->min_lat); r <= cell_row(f->max_lat); r++) {
+            for (uint32_t c = cell_col(f->min_lon); c <= cell_col(f->max_lon); c++) {
+                g_cell_fill[r * GPS_GEOFENCE_GRID + c]++;
+            }
+        }
+    }
+
+    uint32_t total = 0;
+    for (uint32_t c = 0; c < CELL_COUNT; c++) {
+        uint32_t n = g_cell_fill[c];
+        if (n > g_stats.max_cell_fences) {
+            g_stats.max_cell_fences = n;
+        }
+        if (n > GPS_GEOFENCE_MAX_PER_CELL) {
+            g_stats.truncated_cells++;
+            n = GPS_GEOFENCE_MAX_PER_CELL;
+        }
+        g_cell_start[c] = (uint16_t)total;
+        total += n;
+        if (total > GPS_GEOFENCE_MAX_CELL_ENTRIES) {
+            printf("[地理围栏] 单元格引用超过上限 %d\n", GPS_GEOFENCE_MAX_CELL_ENTRIES);
+            return false;
+        }
+    }
+    g_cell_start[CELL_COUNT] = (uint16_t)total;
+    g_stats.cell_entries = total;
+
+    // 第二遍填入围栏序号，超出单元格上限的丢弃
+    memcpy(g_cell_fill, g_cell_start, sizeof(g_cell_fill));
+    for (uint32_t i = 0; i < g_fence_count; i++) {
+        const fence_t *f = &g_fences[i];
+        for (uint32_t r = cell_row(f->min_lat); r <= cell_row(f->max_lat); r++) {
+            for (uint32_t c = cell_col(f->min_lon); c <= cell_col(f->max_lon); c++) {
+                uint32_t cell = r * GPS_GEOFENCE_GRID + c;
+                if (g_cell_fill[cell] < g_cell_start[cell + 1]) {
+                    g_cell_fences[g_cell_fill[cell]++] = (uint16_t)i;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 读入一个围栏记录及其顶点
+ */
+static bool read_fence(FIL *file, uint32_t *vertex_total) {
+    gps_geofence_file_fence_t rec;
+    UINT got = 0;
+    if (f_read(file, &rec, sizeof(rec), &got) != FR_OK || got != sizeof(rec)) {
+        printf("[地理围栏] 文件截断 (围栏 %lu)\n", (unsigned long)g_fence_count);
+        return false;
+    }
+    if (rec.vertex_count < 3 || rec.vertex_count > GPS_GEOFENCE_MAX_FENCE_VERTICES ||
+        *vertex_total + rec.vertex_count > GPS_GEOFENCE_MAX_VERTICES) {
+        printf("[地理围栏] 围栏 %lu 顶点数无效或超过上限: %u\n", (unsigned long)rec.id, rec.vertex_count);
+        return false;
+    }
+
+    int32_t (*v)[2] = &g_vertices[*vertex_total];
+    UINT bytes = rec.vertex_count * sizeof(g_vertices[0]);
+    if (f_read(file, v, bytes, &got) != FR_OK || got != bytes) {
+        printf("[地理围栏] 文件截断 (围栏 %lu 顶点)\n", (unsigned long)rec.id);
+        return false;
+    }
+
+    fence_t *f = &g_fences[g_fence_count];
+    f->id = rec.id;
+    memcpy(f->name, rec.name, sizeof(f->name));
+    f->first_vertex = (uint16_t)*vertex_total;
+    f->vertex_count = rec.vertex_count;
+    f->margin_m = rec.margin_m;
+    f->min_lat = f->min_lon = INT32_MAX;
+    f->max_lat = f->max_lon = INT32_MIN;
+    for (uint32_t i = 0; i < rec.vertex_count; i++) {
+        if (v[i][0] < -900000000 || v[i][0] > 900000000 || v[i][1] < -1800000000 || v[i][1] > 1800000000) {
+            printf("[地理围栏] 围栏 %lu 坐标超出范围\n", (unsigned long)rec.id);
+            return false;
+        }
+        if (v[i][0] < f->min_lat) f->min_lat = v[i][0];
+        if (v[i][0] > f->max_lat) f->max_lat = v[i][0];
+        if (v[i][1] < f->min_lon) f->min_lon = v[i][1];
+        if (v[i][1] > f->max_lon) f->max_lon = v[i][1];
+    }
+
+    // 外包矩形按迟滞距离外扩，边界外margin以内的点也能找到该围栏
+    float center_lat = (float)(((int64_t)f->min_lat + f->max_lat) / 2) / (float)E7;
+    float m_per_e7_lon = M_PER_E7_LAT * fmaxf(cosf(center_lat * DEG_TO_RAD), 0.01f);
+    int64_t pad_lat = (int64_t)ceilf(f->margin_m / M_PER_E7_LAT);
+    int64_t pad_lon = (int64_t)ceilf(f->margin_m / m_per_e7_lon);
+    f->min_lat = (int32_t)((int64_t)f->min_lat - pad_lat);
+    f->max_lat = (int32_t)((int64_t)f->max_lat + pad_lat);
+    f->min_lon = (int32_t)((int64_t)f->min_lon - pad_lon);
+    f->max_lon = (int32_t)((int64_t)f->max_lon + pad_lon);
+
+    *vertex_total += rec.vertex_count;
+    g_fence_count++;
+    return true;
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void gps_geofence_clear(void) {
+    g_fence_count = 0;
+    g_active_count = 0;
+    memset(g_inside_bits, 0, sizeof(g_inside_bits));
+    memset(g_cell_start, 0, sizeof(g_cell_start));
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+bool gps_geofence_load_file(const char *path) {
+    gps_geofence_clear();
+    if (!path) {
+        return false;
+    }
+
+    FIL file;
+    FRESULT fr = f_open(&file, path, FA_READ);
+    if (fr != FR_OK) {
+        printf("[地理围栏] 无法打开围栏文件 %s: %d\n", path, fr);
+        return false;
+    }
+
+    gps_geofence_file_header_t header;
+    UINT got = 0;
+    bool ok = f_read(&file, &header, sizeof(header), &got) == FR_OK && got == sizeof(header);
+    if (!ok || header.magic != GPS_GEOFENCE_MAGIC || header.version != GPS_GEOFENCE_VERSION) {
+        printf("[地理围栏] 文件头无效: %s\n", path);
+        ok = false;
+    } else if (header.fence_count == 0 || header.fence_count > GPS_GEOFENCE_MAX_FENCES ||
+               header.vertex_count > GPS_GEOFENCE_MAX_VERTICES) {
+        printf("[地理围栏] 围栏数 %u / 顶点数 %lu 超过上限 (%d / %d)\n", header.fence_count,
+               (unsigned long)header.vertex_count, GPS_GEOFENCE_MAX_FENCES, GPS_GEOFENCE_MAX_VERTICES);
+        ok = false;
+    }
+
+    uint32_t vertex_total = 0;
+    for (uint32_t i = 0; ok && i < header.fence_count; i++) {
+        ok = read_fence(&file, &vertex_total);
+    }
+    f_close(&file);
+
+    if (ok && vertex_total != header.vertex_count) {
+        printf("[地理围栏] 顶点总数与文件头不符: %lu / %lu\n",
+               (unsigned long)vertex_total, (unsigned long)header.vertex_count);
+        ok = false;
+    }
+    if (ok) {
+        ok = build_grid();
+    }
+    if (!ok) {
+        gps_geofence_clear();
+        return false;
+    }
+
+    g_stats.fences = g_fence_count;
+    g_stats.vertices = vertex_total;
+    printf("[地理围栏] 已加载 %lu 个围栏, %lu 个顶点, 单元格引用 %lu (单元格最多 %lu 个围栏)\n",
+           (unsigned long)g_fence_count, (unsigned long)vertex_total,
+           (unsigned long)g_stats.cell_entries, (unsigned long)g_stats.max_cell_fences);
+    if (g_stats.truncated_cells) {
+        printf("[地理围栏] 警告: %lu 个单元格的围栏数超过 %d，多出的围栏在这些单元格中不判定进入\n",
+               (unsigned long)g_stats.truncated_cells, GPS_GEOFENCE_MAX_PER_CELL);
+    }
+    return true;
+}
+
+uint32_t gps_geofence_count(void) {
+    return g_fence_count;
+}
+
+int gps_geofence_update(const gps_fix_t *fix, gps_geofence_event_t *events, int max_events) {
+    if (!fix || !gps_fix_is_valid(fix) || g_fence_count == 0) {
+        return 0;
+    }
+
+    const int32_t lat = fix->lat_e7;
+    const int32_t lon = fix->lon_e7;
+    const float m_per_e7_lon = M_PER_E7_LAT * fmaxf(cosf(lat * 1e-7f * DEG_TO_RAD), 0.01f);
+    uint32_t candidates = 0, edges = 0;
+    int count = 0;
+
+    // 1. 处于内部的围栏逐个判定离开
+    for (uint32_t i = 0; i < g_active_count;) {
+        uint32_t index = g_active[i];
+        candidates++;
+        if (evaluate(index, lat, lon, m_per_e7_lon, &edges)) {
+            emit(index, false, events, max_events, &count);
+            g_active[i] = g_active[--g_active_count];
+        } else {
+            i++;
+        }
+    }
+
+    // 2. 所在单元格中处于外部的围栏判定进入
+    if (lat >= g_grid_min_lat && lon >= g_grid_min_lon) {
+        uint32_t row = cell_row(lat), col = cell_col(lon);
+        if (row < GPS_GEOFENCE_GRID && col < GPS_GEOFENCE_GRID) {
+            uint32_t cell = row * GPS_GEOFENCE_GRID + col;
+            for (uint32_t k = g_cell_start[cell]; k < g_cell_start[cell + 1]; k++) {
+                uint32_t index = g_cell_fences[k];
+                if (is_inside(index) || !in_box(&g_fences[index], lat, lon)) {
+                    continue;
+                }
+                candidates++;
+                if (!evaluate(index, lat, lon, m_per_e7_lon, &edges)) {
+                    continue;
+                }
+                if (g_active_count >= GPS_GEOFENCE_MAX_ACTIVE) {
+                    // 活动围栏已满：不进入，下次定位再判定
+                    set_inside(index, false);
+                    g_stats.dropped_events++;
+                    continue;
+                }
+                g_active[g_active_count++] = (uint16_t)index;
+                emit(index, true, events, max_events, &count);
+            }
+        }
+    }
+
+    g_stats.updates++;
+    g_stats.candidates += candidates;
+    g_stats.edge_tests += edges;
+    if (candidates > g_stats.max_candidates) {
+        g_stats.max_candidates = candidates;
+    }
+    if (edges > g_stats.max_edge_tests) {
+        g_stats.max_edge_tests = edges;
+    }
+    return count;
+}
+
+bool gps_geofence_is_inside(uint32_t id) {
+    for (uint32_t i = 0; i < g_active_count; i++) {
+        if (g_fences[g_active[i]].id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void gps_geofence_get_stats(gps_geofence_stats_t *stats) {
+    if (stats) {
+        *stats = g_stats;
+    }
+}
+
+void gps_geofence_print_stats(void) {
+    printf("[地理围栏] 围栏 %lu, 顶点 %lu, 单元格引用 %lu\n",
+           (unsigned long)g_stats.fences, (unsigned long)g_stats.vertices, (unsigned long)g_stats.cell_entries);
+    printf("[地理围栏] 判定 %lu 次, 平均检查 %.1f 个围栏 / %.1f 条边, 最多 %lu 个围栏 / %lu 条边\n",
+           (unsigned long)g_stats.updates,
+           g_stats.updates ? (float)g_stats.candidates / g_stats.updates : 0.0f,
+           g_stats.updates ? (float)g_stats.edge_tests / g_stats.updates : 0.0f,
+           (unsigned long)g_stats.max_candidates, (unsigned long)g_stats.max_edge_tests);
+    printf("[地理围栏] 事件 %lu (丢弃 %lu), 当前在 %lu 个围栏内\n",
+           (unsigned long)g_stats.events, (unsigned long)g_stats.dropped_events,
+           (unsigned long)g_active_count);
+}
@@ -0,0 +1,447 @@
+/**
+ * @file gps_log_transfer.c
+ * @brief 日志文件USB下载实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "ff.h"
+#include "gps/gps_log_transfer.h"
+
+#define HEADER_SIZE ((uint32_t)sizeof(gps_log_transfer_header_t))
+
+_Static_assert(sizeof(gps_log_transfer_header_t) == 16, "gps_log_transfer_header_t必须为16字节");
+_Static_assert(GPS_LOG_TRANSFER_READ_BYTES % GPS_LOG_TRANSFER_MAX_PAYLOAD == 0, "读缓冲必须为扇区整数倍");
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static const gps_log_transfer_transport_t *g_transport = NULL;
+static char g_log_dir[32];
+static gps_log_transfer_rx_t g_rx;
+static gps_log_transfer_stats_t g_stats;
+
+/**
+ * @brief 进行中的下载
+ */
+static struct {
+    bool active;
+    FIL file;
+    uint32_t size;
+    uint32_t start;             // GET请求的起始偏移
+    uint32_t next;              // 下一个要发送的偏移
+    uint32_t acked;             // 主机已确认的偏移
+    uint32_t window_bytes;
+    uint32_t crc;               // [start, crc_offset)的CRC32，只在首次发送时累计
+    uint32_t crc_offset;
+    uint32_t last_ack_ms;
+    uint32_t start_ms;
+    uint8_t timeouts;
+    uint32_t buffer_offset;     // 读缓冲对应的文件偏移
+    uint32_t buffer_length;
+} g_session;
+
+static uint8_t g_buffer[GPS_LOG_TRANSFER_READ_BYTES] __attribute__((aligned(4)));
+
+// 半字节查表CRC32 (反射多项式0xEDB88320)
+static const uint32_t kCrcTable[16] = {
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu, 0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu, 0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+};
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void send_frame(uint8_t type, uint8_t flags, uint32_t offset, uint16_t arg,
+                       const void *payload, uint16_t length) {
+    gps_log_transfer_header_t header;
+    gps_log_transfer_make_header(&header, type, flags, offset, arg, payload, length);
+    g_transport->write(g_transport->ctx, (const uint8_t *)&header, HEADER_SIZE);
+    if (length > 0) {
+        g_transport->write(g_transport->ctx, (const uint8_t *)payload, length);
+    }
+}
+
+static void send_error(uint16_t code, const char *message) {
+    send_frame(GPS_LOG_TRANSFER_ERROR, 0, 0, code, message, (uint16_t)strlen(message));
+    g_transport->flush(g_transport->ctx);
+}
+
+static void close_session(void) {
+    if (g_session.active) {
+        f_close(&g_session.file);
+        g_session.active = false;
+    }
+}
+
+/**
+ * @brief 只允许日志目录下的普通文件名
+ */
+static bool valid_name(const char *name, uint32_t length) {
+    if (length == 0 || length > GPS_LOG_TRANSFER_MAX_NAME || name[0] == '.') {
+        return false;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        char c = name[i];
+        if (c == '/' || c == '\\' || c == ':' || c == '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void handle_list(void) {
+    DIR dir;
+    if (f_opendir(&dir, g_log_dir) != FR_OK) {
+        send_error(GPS_LOG_TRANSFER_ERR_NOT_FOUND, "log directory not found");
+        return;
+    }
+
+    uint32_t count = 0;
+    FILINFO info;
+    while (f_readdir(&dir, &info) == FR_OK && info.fname[0] != '\0') {
+        if (info.fattrib & AM_DIR) {
+            continue;
+        }
+        send_frame(GPS_LOG_TRANSFER_ENTRY, 0, info.fsize, 0, info.fname, (uint16_t)strlen(info.fname));
+        count++;
+    }
+    f_closedir(&dir);
+    send_frame(GPS_LOG_TRANSFER_LIST_END, 0, count, 0, NULL, 0);
+    g_transport->flush(g_transport->ctx);
+}
+
+static void handle_get(const gps_log_transfer_header_t *header, const char *name) {
+    close_session();
+    if (!valid_name(name, header->length)) {
+        send_error(GPS_LOG_TRANSFER_ERR_BAD_NAME, "bad file name");
+        return;
+    }
+
+    char path[sizeof(g_log_dir) + GPS_LOG_TRANSFER_MAX_NAME + 2];
+    snprintf(path, sizeof(path), "%s/%.*s", g_log_dir, (int)header->length, name);
+    if (f_open(&g_session.file, path, FA_READ) != FR_OK) {
+        send_error(GPS_LOG_TRANSFER_ERR_NOT_FOUND, "file not found");
+        return;
+    }
+
+    uint16_t window = header->arg;
+    if (window == 0 || window > GPS_LOG_TRANSFER_MAX_WINDOW) {
+        window = GPS_LOG_TRANSFER_MAX_WINDOW;
+    }
+    g_session.active = true;
+    g_session.size = f_size(&g_session.file);
+    g_session.start = header->offset < g_session.size ? header->offset : g_session.size;
+    g_session.next = g_session.start;
+    g_session.acked = g_session.start;
+    g_session.window_bytes = (uint32_t)window * GPS_LOG_TRANSFER_MAX_PAYLOAD;
+    g_session.crc = 0;
+    g_session.crc_offset = g_session.start;
+    g_session.last_ack_ms = now_ms();
+    g_session.start_ms = g_session.last_ack_ms;
+    g_session.timeouts = 0;
+    g_session.buffer_offset = 0;
+    g_session.buffer_length = 0;
+    g_stats.sessions++;
+
+    send_frame(GPS_LOG_TRANSFER_INFO, 0, g_session.size, window, NULL, 0);
+    printf("[日志下载] 开始: %s (%lu字节，从%lu开始，窗口%u帧)\n", path,
+           (unsigned long)g_session.size, (unsigned long)g_session.start, window);
+}
+
+static void handle_ack(const gps_log_transfer_header_t *header) {
+    if (!g_session.active) {
+        return;     // 结束后迟到的确认
+    }
+    uint32_t ack = header->offset;
+    if (ack < g_session.acked || ack > g_session.next) {
+        return;
+    }
+    if (ack > g_session.acked) {
+        g_session.acked = ack;
+        g_session.timeouts = 0;
+    }
+    g_session.last_ack_ms = now_ms();
+    if (header->flags & GPS_LOG_TRANSFER_FLAG_NAK) {
+        g_session.next = ack;
+        g_stats.naks++;
+    }
+}
+
+static void handle_frame(const uint8_t *frame) {
+    gps_log_transfer_header_t header;
+    memcpy(&header, frame, HEADER_SIZE);
+    const char *payload = (const char *)frame + HEADER_SIZE;
+
+    switch (header.type) {
+    case GPS_LOG_TRANSFER_LIST:
+        handle_list();
+        break;
+    case GPS_LOG_TRANSFER_GET:
+        handle_get(&header, payload);
+        break;
+    case GPS_LOG_TRANSFER_ACK:
+        handle_ack(&header);
+        break;
+    case GPS_LOG_TRANSFER_ABORT:
+        if (g_session.active) {
+            printf("[日志下载] 主机中止\n");
+        }
+        close_session();
+        break;
+    default:
+        g_stats.bad_frames++;
+        break;
+    }
+}
+
+static void process_input(void) {
+    uint8_t data[64];
+    int n;
+    while ((n = g_transport->read(g_transport->ctx, data, sizeof(data))) > 0) {
+        uint32_t offset = 0;
+        while (offset < (uint32_t)n) {
+            uint32_t consumed = 0;
+            if (gps_log_transfer_rx_feed(&g_rx, data + offset, (uint32_t)n - offset, &consumed)) {
+                handle_frame(g_rx.data);
+                gps_log_transfer_rx_reset(&g_rx);
+            }
+            offset += consumed;
+        }
+    }
+}
+
+/**
+ * @brief 保证读缓冲包含next；读取结束于扇区边界，之后的读取都是整扇区
+ */
+static bool fill_buffer(void) {
+    uint32_t next = g_session.next;
+    if (next >= g_session.buffer_offset && next < g_session.buffer_offset + g_session.buffer_length) {
+        return true;
+    }
+    if (f_tell(&g_session.file) != next && f_lseek(&g_session.file, next) != FR_OK) {
+        return false;
+    }
+    uint32_t length = GPS_LOG_TRANSFER_READ_BYTES - next % GPS_LOG_TRANSFER_MAX_PAYLOAD;
+    if (length > g_session.size - next) {
+        length = g_session.size - next;
+    }
+    UINT read = 0;
+    if (f_read(&g_session.file, g_buffer, length, &read) != FR_OK || read == 0) {
+        return false;
+    }
+    g_session.buffer_offset = next;
+    g_session.buffer_length = read;
+    return true;
+}
+
+static bool send_data(void) {
+    if (!fill_buffer()) {
+        return false;
+    }
+    uint32_t next = g_session.next;
+    uint32_t length = GPS_LOG_TRANSFER_MAX_PAYLOAD - next % GPS_LOG_TRANSFER_MAX_PAYLOAD;
+    uint32_t available = g_session.buffer_offset + g_session.buffer_length - next;
+    if (length > available) {
+        length = available;
+    }
+    const uint8_t *payload = g_buffer + (next - g_session.buffer_offset);
+
+    if (next < g_session.crc_offset) {
+        uint32_t resent = g_session.crc_offset - next;
+        g_stats.bytes_resent += resent < length ? resent : length;
+    }
+    if (next + length > g_session.crc_offset) {
+        uint32_t skip = g_session.crc_offset - next;
+        g_session.crc = gps_log_transfer_crc32(g_session.crc, payload + skip, length - skip);
+        g_session.crc_offset = next + length;
+    }
+
+    send_frame(GPS_LOG_TRANSFER_DATA, 0, next, 0, payload, (uint16_t)length);
+    g_session.next = next + length;
+    g_stats.frames_sent++;
+    g_stats.bytes_sent += length;
+    return true;
+}
+
+static void finish_session(void) {
+    uint32_t crc = g_session.crc;
+    send_frame(GPS_LOG_TRANSFER_END, 0, g_session.size, 0, &crc, sizeof(crc));
+
+    uint32_t bytes = g_session.size - g_session.start;
+    uint32_t elapsed = now_ms() - g_session.start_ms;
+    g_stats.completed++;
+    g_stats.last_bytes = bytes;
+    g_stats.last_ms = elapsed;
+    printf("[日志下载] 完成: %lu字节，%lu ms，%.1f KB/s\n", (unsigned long)bytes, (unsigned long)elapsed,
+           elapsed ? bytes / 1.024 / elapsed : 0.0);
+    close_session();
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void gps_log_transfer_init(const gps_log_transfer_transport_t *transport, const char *log_dir) {
+    close_session();
+    g_transport = transport;
+    snprintf(g_log_dir, sizeof(g_log_dir), "%s", log_dir);
+    gps_log_transfer_rx_reset(&g_rx);
+    g_rx.dropped = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+bool gps_log_transfer_poll(uint32_t budget_ms) {
+    if (!g_transport) {
+        return false;
+    }
+    process_input();
+
+    const uint32_t begin = now_ms();
+    bool wrote = false;
+    while (g_session.active) {
+        uint32_t now = now_ms();
+        if (g_session.acked == g_session.size) {
+            finish_session();
+            wrote = true;
+            break;
+        }
+
+        if (now - g_session.last_ack_ms > GPS_LOG_TRANSFER_ACK_TIMEOUT_MS) {
+            if (++g_session.timeouts > GPS_LOG_TRANSFER_MAX_TIMEOUTS) {
+                printf("[日志下载] 主机无应答，放弃下载\n");
+                send_error(GPS_LOG_TRANSFER_ERR_TIMEOUT, "ack timeout");
+                close_session();
+                break;
+            }
+            g_session.next = g_session.acked;   // 回退到确认位置重发
+            g_session.last_ack_ms = now;
+            g_stats.timeouts++;
+        }
+
+        bool window_full = g_session.next - g_session.acked >= g_session.window_bytes;
+        if (window_full || g_session.next >= g_session.size || now - begin >= budget_ms) {
+            break;
+        }
+        if (!send_data()) {
+            send_error(GPS_LOG_TRANSFER_ERR_READ, "read error");
+            close_session();
+            break;
+        }
+        wrote = true;
+        process_input();
+    }
+
+    if (wrote) {
+        g_transport->flush(g_transport->ctx);
+    }
+    return g_session.active;
+}
+
+bool gps_log_transfer_active(void) {
+    return g_session.active;
+}
+
+void gps_log_transfer_get_stats(gps_log_transfer_stats_t *stats) {
+    if (stats) {
+        *stats = g_stats;
+        stats->bad_frames += g_rx.dropped;
+    }
+}
+
+void gps_log_transfer_print_stats(void) {
+    gps_log_transfer_stats_t s;
+    gps_log_transfer_get_stats(&s);
+    printf("[日志下载] 下载 %lu次 (完成%lu)，发送 %lu帧 %llu字节 (重发%llu)，NAK %lu，超时 %lu，坏帧 %lu\n",
+           (unsigned long)s.sessions, (unsigned long)s.completed,
+           (unsigned long)s.frames_sent, (unsigned long long)s.bytes_sent,
+           (unsigned long long)s.bytes_resent, (unsigned long)s.naks,
+           (unsigned long)s.timeouts, (unsigned long)s.bad_frames);
+    if (s.completed > 0 && s.last_ms > 0) {
+        printf("[日志下载] 最近一次: %lu字节，%lu ms，%.1f KB/s\n", (unsigned long)s.last_bytes,
+               (unsigned long)s.last_ms, s.last_bytes / 1.024 / s.last_ms);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// 帧编解码
+// -----------------------------------------------------------------------------
+
+uint32_t gps_log_transfer_crc32(uint32_t crc, const void *data, size_t length) {
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc >> 4) ^ kCrcTable[(crc ^ p[i]) & 0x0F];
+        crc = (crc >> 4) ^ kCrcTable[(crc ^ (p[i] >> 4)) & 0x0F];
+    }
+    return ~crc;
+}
+
+void gps_log_transfer_make_header(gps_log_transfer_header_t *header, uint8_t type, uint8_t flags,
+                                  uint32_t offset, uint16_t arg,
+                                  const void *payload, uint16_t length) {
+    header->magic[0] = GPS_LOG_TRANSFER_MAGIC0;
+    header->magic[1] = GPS_LOG_TRANSFER_MAGIC1;
+    header->type = type;
+    header->flags = flags;
+    header->offset = offset;
+    header->length = length;
+    header->arg = arg;
+    header->crc = 0;
+    uint32_t crc = gps_log_transfer_crc32(0, header, HEADER_SIZE);
+    header->crc = length > 0 ? gps_log_transfer_crc32(crc, payload, length) : crc;
+}
+
+bool gps_log_transfer_rx_feed(gps_log_transfer_rx_t *rx, const uint8_t *data, uint32_t length,
+                              uint32_t *consumed) {
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t b = data[i];
+        if (rx->length == 0 && b != GPS_LOG_TRANSFER_MAGIC0) {
+            continue;       // 帧之间的文本输出
+        }
+        if (rx->length == 1 && b != GPS_LOG_TRANSFER_MAGIC1) {
+            rx->length = (b == GPS_LOG_TRANSFER_MAGIC0) ? 1 : 0;
+            continue;
+        }
+        rx->data[rx->length++] = b;
+        if (rx->length < HEADER_SIZE) {
+            continue;
+        }
+
+        gps_log_transfer_header_t header;
+        memcpy(&header, rx->data, HEADER_SIZE);
+        if (header.length > GPS_LOG_TRANSFER_MAX_PAYLOAD) {
+            rx->length = 0;
+            rx->dropped++;
+            continue;
+        }
+        if (rx->length < HEADER_SIZE + header.length) {
+            continue;
+        }
+
+        uint32_t crc = header.crc;
+        memset(rx->data + 12, 0, 4);    // crc字段
+        uint32_t actual = gps_log_transfer_crc32(0, rx->data, rx->length);
+        memcpy(rx->data + 12, &crc, 4);
+        if (actual == crc) {
+            *consumed = i + 1;
+            return true;
+        }
+        rx->length = 0;
+        rx->dropped++;
+    }
+    *consumed = length;
+    return false;
+}
+
+void gps_log_transfer_rx_reset(gps_log_transfer_rx_t *rx) {
+    rx->length = 0;
+}
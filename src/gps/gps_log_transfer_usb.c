@@ -0,0 +1,50 @@
+/**
+ * @file gps_log_transfer_usb.c
+ * @brief 日志下载的USB CDC传输层
+ *
+ * 通过stdio_usb驱动读写，与printf使用同一个CDC接口和同一把互斥锁，
+ * 不会和后台的tud_task()并发访问TinyUSB。写入绕过stdio的换行转换，
+ * 二进制数据原样发送；发送FIFO满时out_chars等待主机取走数据。
+ */
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "pico/stdio/driver.h"
+#include "gps/gps_log_transfer.h"
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static int usb_read(void *ctx, uint8_t *data, uint32_t max) {
+    (void)ctx;
+    int n = stdio_usb.in_chars((char *)data, (int)max);
+    return n > 0 ? n : 0;
+}
+
+static void usb_write(void *ctx, const uint8_t *data, uint32_t length) {
+    (void)ctx;
+    stdio_usb.out_chars((const char *)data, (int)length);
+}
+
+static void usb_flush(void *ctx) {
+    (void)ctx;
+    if (stdio_usb.out_flush) {
+        stdio_usb.out_flush();
+    }
+}
+
+static const gps_log_transfer_transport_t kUsbTransport = {
+    .ctx = NULL,
+    .read = usb_read,
+    .write = usb_write,
+    .flush = usb_flush,
+};
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+const gps_log_transfer_transport_t *gps_log_transfer_usb_transport(void) {
+    return &kUsbTransport;
+}
@@ -5,6 +5,8 @@
  */
 
 #include "gps/gps_logger.hpp"
+#include "gps/gps_trip.h"
+#include "gps/gps_flush.h"
 #include "pico/stdlib.h"
 #include "pico/time.h"
 #include <stdio.h>
@@ -12,7 +14,6 @@
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
-#include <cmath>
 
 namespace GPS {
 
@@ -24,9 +25,20 @@ GPSLogger::GPSLogger(const SimpleSD::SPIConfig& sd_config, const LogConfig& log_
     : sd_card_(std::make_unique<SimpleSD::SimpleSDWriter>(sd_config))
     , config_(log_config)
     , current_file_size_(0)
+    , current_header_size_(0)
     , daily_file_counter_(0)
     , is_initialized_(false)
     , log_file_created_(false)
+    , file_day_end_(0)
+    , next_file_size_(0)
+    , next_file_counter_(0)
+    , next_file_day_end_(0)
+    , next_file_ready_(false)
+    , rotations_(0)
+    , sync_rotations_(0)
+    , rotation_swap_us_max_(0)
+    , previous_file_size_(0)
+    , previous_pending_bytes_(0)
     , buffer_used_(0)
     , pending_records_(0)
     , last_write_time_(0)
@@ -40,6 +52,9 @@ GPSLogger::~GPSLogger() {
     if (is_initialized_) {
         flush_buffer();  // 先刷新缓冲区
         sync();          // 再同步到SD卡
+        if (next_file_ready_) {
+            sd_card_->remove_file(next_log_file_);  // 预先创建但未使用的文件
+        }
     }
 }
 
@@ -48,15 +63,42 @@ GPSLogger::GPSLogger(GPSLogger&& other) noexcept
     , config_(other.config_)
     , current_log_file_(std::move(other.current_log_file_))
     , current_file_size_(other.current_file_size_)
+    , current_header_size_(other.current_header_size_)
     , daily_file_counter_(other.daily_file_counter_)
     , current_date_(std::move(other.current_date_))
-    , is_initialized_(other.is_initialized_) {
+    , is_initialized_(other.is_initialized_)
+    , log_file_created_(other.log_file_created_)
+    , file_day_end_(other.file_day_end_)
+    , clock_day_(other.clock_day_)
+    , next_log_file_(std::move(other.next_log_file_))
+    , next_date_(std::move(other.next_date_))
+    , next_file_size_(other.next_file_size_)
+    , next_file_counter_(other.next_file_counter_)
+    , next_file_day_end_(other.next_file_day_end_)
+    , next_file_ready_(other.next_file_ready_)
+    , rotations_(other.rotations_)
+    , sync_rotations_(other.sync_rotations_)
+    , rotation_swap_us_max_(other.rotation_swap_us_max_)
+    , previous_log_file_(std::move(other.previous_log_file_))
+    , previous_file_size_(other.previous_file_size_)
+    , previous_pending_bytes_(other.previous_pending_bytes_)
+    , write_buffer_(other.write_buffer_)
+    , buffer_used_(other.buffer_used_)
+    , pending_records_(other.pending_records_)
+    , last_write_time_(other.last_write_time_)
+    , gaode_coordinate_count_(0) {
+    // 缓冲中的记录（包括属于上一个文件的部分）随轮转状态一起转移
     other.is_initialized_ = false;
+    other.next_file_ready_ = false;
+    other.previous_pending_bytes_ = 0;
+    other.buffer_used_ = 0;
+    other.pending_records_ = 0;
 }
 
 GPSLogger& GPSLogger::operator=(GPSLogger&& other) noexcept {
     if (this != &other) {
         if (is_initialized_) {
+            flush_buffer();
             sync();
         }
         
@@ -64,11 +106,35 @@ GPSLogger& GPSLogger::operator=(GPSLogger&& other) noexcept {
         config_ = other.config_;
         current_log_file_ = std::move(other.current_log_file_);
         current_file_size_ = other.current_file_size_;
+        current_header_size_ = other.current_header_size_;
         daily_file_counter_ = other.daily_file_counter_;
         current_date_ = std::move(other.current_date_);
         is_initialized_ = other.is_initialized_;
+        log_file_created_ = other.log_file_created_;
+        file_day_end_ = other.file_day_end_;
+        clock_day_ = other.clock_day_;
+        next_log_file_ = std::move(other.next_log_file_);
+        next_date_ = std::move(other.next_date_);
+        next_file_size_ = other.next_file_size_;
+        next_file_counter_ = other.next_file_counter_;
+        next_file_day_end_ = other.next_file_day_end_;
+        next_file_ready_ = other.next_file_ready_;
+        rotations_ = other.rotations_;
+        sync_rotations_ = other.sync_rotations_;
+        rotation_swap_us_max_ = other.rotation_swap_us_max_;
+        previous_log_file_ = std::move(other.previous_log_file_);
+        previous_file_size_ = other.previous_file_size_;
+        previous_pending_bytes_ = other.previous_pending_bytes_;
+        write_buffer_ = other.write_buffer_;
+        buffer_used_ = other.buffer_used_;
+        pending_records_ = other.pending_records_;
+        last_write_time_ = other.last_write_time_;
         
         other.is_initialized_ = false;
+        other.next_file_ready_ = false;
+        other.previous_pending_bytes_ = 0;
+        other.buffer_used_ = 0;
+        other.pending_records_ = 0;
     }
     return *this;
 }
@@ -106,6 +172,9 @@ bool GPSLogger::initialize() {
         return false;
     }
 
+    // 刷新控制器按这张卡重新学习写入耗时
+    gps_flush_reset(config_.write_interval_ms, std::min(config_.buffer_size, write_buffer_.size()));
+
     is_initialized_ = true;
     printf("[GPS Logger] 初始化成功，当前日志文件: %s\n", current_log_file_.c_str());
     return true;
@@ -115,33 +184,39 @@ bool GPSLogger::initialize() {
 // 日志记录方法
 // =============================================================================
 
-bool GPSLogger::log_gps_data(const LC76G_GPS_Data& gps_data) {
+bool GPSLogger::log_fix(const gps_fix_t& fix) {
     if (!is_initialized_) {
         printf("[GPS Logger] 未初始化\n");
         return false;
     }
 
     // 检查GPS数据有效性
-    if (!gps_data.Status) {
+    if (!gps_fix_is_valid(&fix)) {
         printf("[GPS Logger] GPS数据无效，跳过记录\n");
         return false;
     }
 
     // 如果日志文件尚未创建，尝试基于GPS日期创建
     if (!log_file_created_) {
-        if (!create_log_file_from_gps_date(gps_data)) {
+        if (!create_log_file_from_gps_date(fix)) {
             printf("[GPS Logger] 无法创建日志文件，跳过记录\n");
             return false;
         }
     }
 
     // 创建坐标数据
-    CoordinateData coord_data = create_coordinate_data(gps_data);
+    CoordinateData coord_data = create_coordinate_data(fix);
     
     // 记录坐标数据
     return log_coordinate_data(coord_data);
 }
 
+bool GPSLogger::log_gps_data(const LC76G_GPS_Data& gps_data) {
+    gps_fix_t fix;
+    gps_fix_from_lc76g(&gps_data, &fix);
+    return log_fix(fix);
+}
+
 bool GPSLogger::log_coordinate_data(const CoordinateData& coord_data) {
     if (!is_initialized_) {
         printf("[GPS Logger] 未初始化\n");
@@ -154,11 +229,23 @@ bool GPSLogger::log_coordinate_data(const CoordinateData& coord_data) {
         return false;
     }
 
-    // 检查是否需要创建新文件
-    if (should_create_new_file()) {
-        if (!create_new_log_file()) {
-            printf("[GPS Logger] 创建新日志文件失败\n");
-            return false;
+    // 检查是否需要切换到新文件：只比较文件大小和当日结束时刻，
+    // 下一个文件由service_rotation()在空闲时预先创建，这里只交换文件名
+    time_t now = time(nullptr);
+    if (rotation_due(now, false)) {
+        bool ready = next_file_ready_ && next_file_day_end_ > now;
+        if (!ready && rotation_due(now, true)) {
+            // 调用方没有空闲时间（或不调用service_rotation），超出余量后同步创建
+            sync_rotations_++;
+            if (!prepare_next_log_file()) {
+                printf("[GPS Logger] 创建新日志文件失败\n");
+                return false;
+            }
+            ready = true;
+        }
+        // 上一次轮转留在缓冲中的记录写出之前不再轮转
+        if (ready && previous_pending_bytes_ == 0) {
+            swap_to_next_log_file();
         }
     }
 
@@ -199,12 +286,10 @@ bool GPSLogger::log_coordinate_data(const CoordinateData& coord_data) {
             }
         }
         
-        // 检查是否需要批量写入
-        if (should_batch_write()) {
-            if (!flush_buffer()) {
-                printf("[GPS Logger] 批量写入失败\n");
-                return false;
-            }
+        // 到达数据风险窗口或缓冲将满时写入，其余留给空闲时的service_flush
+        if (!service_flush(0)) {
+            printf("[GPS Logger] 批量写入失败\n");
+            return false;
         }
     }
     
@@ -216,25 +301,49 @@ bool GPSLogger::log_coordinate_data(const CoordinateData& coord_data) {
     return true;
 }
 
-GPSLogger::CoordinateData GPSLogger::create_coordinate_data(const LC76G_GPS_Data& gps_data) {
+bool GPSLogger::log_event(const std::string& event) {
+    if (!is_initialized_ || !log_file_created_) {
+        printf("[GPS Logger] 日志文件未创建，事件未记录: %s\n", event.c_str());
+        return false;
+    }
+
+    // 注释行不影响按坐标行解析的工具；事件较少，随坐标缓冲一起立即写入
+    std::string line = "# 事件," + get_current_timestamp() + "," + event + "\n";
+    if (!add_to_buffer(line)) {
+        if (!flush_buffer() || !add_to_buffer(line)) {
+            printf("[GPS Logger] 添加事件到缓冲区失败\n");
+            return false;
+        }
+    }
+    if (!flush_buffer()) {
+        printf("[GPS Logger] 事件写入失败\n");
+        return false;
+    }
+
+    printf("[GPS Logger] 记录事件: %s\n", event.c_str());
+    return true;
+}
+
+GPSLogger::CoordinateData GPSLogger::create_coordinate_data(const gps_fix_t& fix) {
     CoordinateData coord_data;
     
     // 基本坐标信息
-    coord_data.longitude = gps_data.Lon;
-    coord_data.latitude = gps_data.Lat;
-    coord_data.altitude = gps_data.Altitude;      // 海拔高度
-    coord_data.course = gps_data.Course;          // 航向
-    coord_data.satellites = gps_data.Satellites;
-    coord_data.hdop = gps_data.HDOP;
-    coord_data.is_valid = gps_data.Status != 0;
+    coord_data.longitude = fix.lon_e7 * 1e-7;
+    coord_data.latitude = fix.lat_e7 * 1e-7;
+    coord_data.altitude = fix.alt_cm * 0.01;      // 海拔高度
+    coord_data.course = fix.course_cdeg * 0.01;   // 航向
+    coord_data.satellites = fix.satellites;
+    coord_data.hdop = fix.hdop_c * 0.01;
+    coord_data.is_valid = gps_fix_is_valid(&fix);
     
     // 生成时间戳
     coord_data.timestamp = get_current_timestamp();
     
     // 坐标转换 (WGS84 -> GCJ02)
     if (config_.enable_coordinate_transform) {
-        wgs84_to_gcj02(coord_data.longitude, coord_data.latitude, 
-                       coord_data.longitude_gcj02, coord_data.latitude_gcj02);
+        Coordinates gcj = gps_fix_to_gcj02(&fix);
+        coord_data.longitude_gcj02 = gcj.Lon;
+        coord_data.latitude_gcj02 = gcj.Lat;
     } else {
         coord_data.longitude_gcj02 = coord_data.longitude;
         coord_data.latitude_gcj02 = coord_data.latitude;
@@ -297,6 +406,9 @@ std::string GPSLogger::get_log_statistics() const {
     oss << "当前日志文件: " << current_log_file_ << "\n";
     oss << "当前文件大小: " << current_file_size_ << " 字节\n";
     oss << "日志文件总数: " << log_files.size() << "\n";
+    oss << "下一个日志文件: " << (next_file_ready_ ? next_log_file_ : std::string("未创建")) << "\n";
+    oss << "日志轮转: " << rotations_ << " 次 (同步创建 " << sync_rotations_ << " 次), 交换最长 "
+        << rotation_swap_us_max_ << " us\n";
     oss << "坐标转换: " << (config_.enable_coordinate_transform ? "启用" : "禁用") << "\n";
     oss << "SD卡状态: 已连接\n";
     
@@ -377,45 +489,71 @@ bool GPSLogger::flush_buffer() {
     if (!is_initialized_ || buffer_used_ == 0) {
         return true;
     }
-    
-    // 将缓冲区数据写入SD卡
-    std::string buffer_data(write_buffer_.data(), buffer_used_);
-    if (!sd_card_->append_text_file(current_log_file_, buffer_data)) {
-        printf("[GPS Logger] 刷新缓冲区失败\n");
+    return write_buffer_prefix(buffer_used_, GPS_FLUSH_FORCED);
+}
+
+bool GPSLogger::should_batch_write(uint32_t slack_us) {
+    if (!is_initialized_ || buffer_used_ == 0) {
         return false;
     }
-    
-    // 更新文件大小和统计
-    current_file_size_ += buffer_used_;
-    printf("[GPS Logger] 批量写入 %zu 条记录 (%zu 字节)\n", pending_records_, buffer_used_);
-    
-    // 清空缓冲区
-    buffer_used_ = 0;
-    pending_records_ = 0;
-    last_write_time_ = get_current_timestamp_ms();
-    write_buffer_.fill(0);
-    
-    return true;
+    if (previous_tail_fits(slack_us)) {
+        return true;
+    }
+    uint32_t now_ms = (uint32_t)get_current_timestamp_ms();
+    return plan_flush(now_ms, slack_us, nullptr) > 0;
 }
 
-bool GPSLogger::should_batch_write() {
-    // 检查记录数量
-    if (pending_records_ >= config_.batch_write_count) {
+bool GPSLogger::service_flush(uint32_t slack_us) {
+    if (!is_initialized_ || buffer_used_ == 0) {
         return true;
     }
-    
-    // 检查时间间隔
-    uint64_t current_time = get_current_timestamp_ms();
-    if (current_time - last_write_time_ >= config_.write_interval_ms) {
+    // 轮转前缓冲的记录在空闲时先写入上一个文件，不等待整扇区批量
+    if (previous_tail_fits(slack_us)) {
+        return write_buffer_prefix(previous_pending_bytes_, GPS_FLUSH_SLACK);
+    }
+    uint8_t reason;
+    uint32_t now_ms = (uint32_t)get_current_timestamp_ms();
+    uint32_t bytes = plan_flush(now_ms, slack_us, &reason);
+    if (bytes == 0) {
         return true;
     }
-    
-    // 检查缓冲区使用率
-    if (buffer_used_ >= config_.buffer_size * 0.8) {  // 80%使用率时写入
+    return write_buffer_prefix(std::min<size_t>(bytes, buffer_used_), reason);
+}
+
+uint32_t GPSLogger::plan_flush(uint32_t now_ms, uint32_t slack_us, uint8_t* reason) const {
+    // 缓冲开头还有轮转前的记录时，这一段按上一个文件计算扇区边界和耗时
+    return gps_flush_plan_split(now_ms, (uint32_t)previous_file_size_, (uint32_t)previous_pending_bytes_,
+                                (uint32_t)current_file_size_, slack_us, reason);
+}
+
+bool GPSLogger::previous_tail_fits(uint32_t slack_us) const {
+    return previous_pending_bytes_ > 0 && slack_us > 0 &&
+           slack_us >= gps_flush_estimate_us((uint32_t)previous_file_size_, (uint32_t)previous_pending_bytes_);
+}
+
+bool GPSLogger::needs_next_log_file() const {
+    if (!is_initialized_) {
+        return false;
+    }
+    time_t now = time(nullptr);
+    bool day_ending = now + ROTATE_PREPARE_SECONDS >= file_day_end_;
+    if (next_file_ready_) {
+        // 已预先创建的文件属于即将结束的日期时按次日重新创建
+        return day_ending && next_file_day_end_ <= file_day_end_;
+    }
+    return day_ending || (daily_file_counter_ < config_.max_files_per_day &&
+                          current_file_size_ >= config_.max_file_size * ROTATE_PREPARE_PERCENT / 100);
+}
+
+bool GPSLogger::service_rotation(uint32_t slack_us) {
+    if (!needs_next_log_file()) {
         return true;
     }
-    
-    return false;
+    // 创建文件约为目录项、FAT和文件头三个扇区的写入
+    if (slack_us < gps_flush_estimate_us(0, 3 * GPS_FLUSH_SECTOR_SIZE)) {
+        return true;
+    }
+    return prepare_next_log_file();
 }
 
 std::string GPSLogger::get_memory_usage() const {
@@ -445,64 +583,79 @@ std::string GPSLogger::generate_log_filename(const std::string& date, uint32_t c
 }
 
 std::string GPSLogger::get_current_date_string() {
-    time_t now = time(nullptr);
-    struct tm* timeinfo = localtime(&now);
-    
-    std::ostringstream oss;
-    oss << std::setfill('0') 
-        << std::setw(4) << (timeinfo->tm_year + 1900)
-        << std::setw(2) << (timeinfo->tm_mon + 1)
-        << std::setw(2) << timeinfo->tm_mday;
-    
-    return oss.str();
+    update_clock_day(time(nullptr));
+    return std::string(clock_day_.date);
 }
 
 std::string GPSLogger::get_current_timestamp() {
     time_t now = time(nullptr);
-    struct tm* timeinfo = localtime(&now);
-    
-    std::ostringstream oss;
-    oss << std::setfill('0')
-        << std::setw(4) << (timeinfo->tm_year + 1900) << "-"
-        << std::setw(2) << (timeinfo->tm_mon + 1) << "-"
-        << std::setw(2) << timeinfo->tm_mday << "T"
-        << std::setw(2) << timeinfo->tm_hour << ":"
-        << std::setw(2) << timeinfo->tm_min << ":"
-        << std::setw(2) << timeinfo->tm_sec << "Z";
+    update_clock_day(now);
     
-    return oss.str();
+    unsigned seconds = (unsigned)(now - clock_day_.start);
+    char timestamp[32];
+    snprintf(timestamp, sizeof(timestamp), "%s%02u:%02u:%02uZ", clock_day_.prefix,
+             seconds / 3600, seconds / 60 % 60, seconds % 60);
+    return std::string(timestamp);
 }
 
-bool GPSLogger::should_create_new_file() {
-    // 检查日期是否变化
-    std::string today = get_current_date_string();
-    if (today != current_date_) {
-        current_date_ = today;
-        daily_file_counter_ = 0;
-        return true;
+void GPSLogger::update_clock_day(time_t now) {
+    if (now >= clock_day_.start && now < clock_day_.end) {
+        return;
     }
+    fill_day_cache(clock_day_, now);
+}
+
+void GPSLogger::fill_day_cache(DayCache& day, time_t t) {
+    struct tm* timeinfo = localtime(&t);
     
-    // 检查文件大小是否超限
-    if (current_file_size_ >= config_.max_file_size) {
-        return true;
+    // 设备上没有夏令时，日长按86400秒
+    day.start = t - (timeinfo->tm_hour * 3600 + timeinfo->tm_min * 60 + timeinfo->tm_sec);
+    day.end = day.start + 24 * 60 * 60;
+    unsigned year = (unsigned)(timeinfo->tm_year + 1900) % 10000;
+    unsigned month = (unsigned)(timeinfo->tm_mon + 1) % 100;
+    unsigned mday = (unsigned)timeinfo->tm_mday % 100;
+    snprintf(day.date, sizeof(day.date), "%04u%02u%02u", year, month, mday);
+    snprintf(day.prefix, sizeof(day.prefix), "%04u-%02u-%02uT", year, month, mday);
+}
+
+bool GPSLogger::rotation_due(time_t now, bool overdue) const {
+    size_t size_limit = config_.max_file_size;
+    time_t day_end = file_day_end_;
+    if (overdue) {
+        size_limit += config_.max_file_size / 4;
+        day_end += ROTATE_PREPARE_SECONDS;
     }
     
-    // 检查每日文件数量是否超限
-    if (daily_file_counter_ >= config_.max_files_per_day) {
+    // 检查日期是否变化
+    if (now >= day_end) {
         return true;
     }
     
-    return false;
+    // 检查文件大小是否超限（每日文件数量已满时继续写当前文件）
+    return daily_file_counter_ < config_.max_files_per_day && current_file_size_ >= size_limit;
 }
 
 bool GPSLogger::create_new_log_file() {
-    // 获取下一个可用的文件计数器
+    // 获取当前日期和下一个可用的文件计数器
+    current_date_ = get_current_date_string();
     daily_file_counter_ = get_next_file_counter(current_date_);
     
     // 生成新的文件名
     current_log_file_ = generate_log_filename(current_date_, daily_file_counter_);
     
     // 创建文件并写入头部信息
+    if (!write_log_header(current_log_file_, current_file_size_)) {
+        return false;
+    }
+    current_header_size_ = current_file_size_;
+    file_day_end_ = clock_day_.end;
+    next_file_ready_ = false;
+    printf("[GPS Logger] 创建新日志文件: %s\n", current_log_file_.c_str());
+    
+    return true;
+}
+
+bool GPSLogger::write_log_header(const std::string& path, size_t& header_size) {
     std::ostringstream header;
     header << "# GPS轨迹日志文件\n";
     header << "# 创建时间: " << get_current_timestamp() << "\n";
@@ -510,18 +663,75 @@ bool GPSLogger::create_new_log_file() {
     header << "# 坐标系: WGS84 -> GCJ02 (高德地图)\n";
     header << "# 高德API格式: [[经度,纬度],[经度,纬度],...]\n";
     header << "# 注意: 高德API使用GCJ02坐标系\n";
+
+    char trip_summary[256];
+    gps_trip_format_summary(trip_summary, sizeof(trip_summary));
+    header << "# 行程统计: " << trip_summary << "\n";
     
-    if (!sd_card_->write_text_file(current_log_file_, header.str())) {
+    std::string text = header.str();
+    if (!sd_card_->write_text_file(path, text)) {
         printf("[GPS Logger] 创建日志文件失败\n");
         return false;
     }
     
-    current_file_size_ = header.str().length();
-    printf("[GPS Logger] 创建新日志文件: %s\n", current_log_file_.c_str());
+    header_size = text.length();
+    return true;
+}
+
+bool GPSLogger::prepare_next_log_file() {
+    time_t now = time(nullptr);
+    
+    // 日期即将变化时按次日命名，否则为当天的下一个编号
+    DayCache day;
+    fill_day_cache(day, now + ROTATE_PREPARE_SECONDS >= file_day_end_ ? std::max(now, file_day_end_) : now);
+    std::string date(day.date);
+    uint32_t counter = get_next_file_counter(date, date == current_date_ ? daily_file_counter_ + 1 : 1);
+    std::string path = generate_log_filename(date, counter);
+    
+    // 已预先创建的文件属于即将结束的日期，删除后按次日重新创建
+    if (next_file_ready_ && next_log_file_ != path) {
+        sd_card_->remove_file(next_log_file_);
+    }
+    next_file_ready_ = false;
+    
+    size_t header_size = 0;
+    if (!write_log_header(path, header_size)) {
+        return false;
+    }
+    
+    next_log_file_ = path;
+    next_date_ = date;
+    next_file_size_ = header_size;
+    next_file_counter_ = counter;
+    next_file_day_end_ = day.end;
+    next_file_ready_ = true;
+    printf("[GPS Logger] 预先创建日志文件: %s\n", next_log_file_.c_str());
     
     return true;
 }
 
+void GPSLogger::swap_to_next_log_file() {
+    uint64_t start_us = to_us_since_boot(get_absolute_time());
+    
+    // 缓冲中尚未写出的记录属于原文件，刷新时先写入原文件
+    previous_log_file_.swap(current_log_file_);
+    previous_file_size_ = current_file_size_;
+    previous_pending_bytes_ = buffer_used_;
+    current_log_file_.swap(next_log_file_);
+    current_date_.swap(next_date_);
+    current_file_size_ = next_file_size_;
+    current_header_size_ = next_file_size_;
+    daily_file_counter_ = next_file_counter_;
+    file_day_end_ = next_file_day_end_;
+    next_file_ready_ = false;
+    rotations_++;
+    
+    uint32_t elapsed_us = (uint32_t)(to_us_since_boot(get_absolute_time()) - start_us);
+    if (elapsed_us > rotation_swap_us_max_) {
+        rotation_swap_us_max_ = elapsed_us;
+    }
+}
+
 std::string GPSLogger::format_log_line(const CoordinateData& coord_data) {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(6)
@@ -539,35 +749,6 @@ std::string GPSLogger::format_log_line(const CoordinateData& coord_data) {
     return oss.str();
 }
 
-void GPSLogger::wgs84_to_gcj02(double wgs_lon, double wgs_lat, double& gcj_lon, double& gcj_lat) {
-    double dLat = transform_lat(wgs_lon - 105.0, wgs_lat - 35.0);
-    double dLon = transform_lon(wgs_lon - 105.0, wgs_lat - 35.0);
-    double radLat = wgs_lat / 180.0 * PI;
-    double magic = sin(radLat);
-    magic = 1 - EE * magic * magic;
-    double sqrtMagic = sqrt(magic);
-    dLat = (dLat * 180.0) / ((A * (1 - EE)) / (magic * sqrtMagic) * PI);
-    dLon = (dLon * 180.0) / (A / sqrtMagic * cos(radLat) * PI);
-    gcj_lat = wgs_lat + dLat;
-    gcj_lon = wgs_lon + dLon;
-}
-
-double GPSLogger::transform_lat(double x, double y) {
-    double ret = -100.0 + 2.0 * x + 3.0 * y + 0.2 * y * y + 0.1 * x * y + 0.2 * sqrt(fabs(x));
-    ret += (20.0 * sin(6.0 * x * PI) + 20.0 * sin(2.0 * x * PI)) * 2.0 / 3.0;
-    ret += (20.0 * sin(y * PI) + 40.0 * sin(y / 3.0 * PI)) * 2.0 / 3.0;
-    ret += (160.0 * sin(y / 12.0 * PI) + 320 * sin(y * PI / 30.0)) * 2.0 / 3.0;
-    return ret;
-}
-
-double GPSLogger::transform_lon(double x, double y) {
-    double ret = 300.0 + x + 2.0 * y + 0.1 * x * x + 0.1 * x * y + 0.1 * sqrt(fabs(x));
-    ret += (20.0 * sin(6.0 * x * PI) + 20.0 * sin(2.0 * x * PI)) * 2.0 / 3.0;
-    ret += (20.0 * sin(x * PI) + 40.0 * sin(x / 3.0 * PI)) * 2.0 / 3.0;
-    ret += (150.0 * sin(x / 12.0 * PI) + 300.0 * sin(x / 30.0 * PI)) * 2.0 / 3.0;
-    return ret;
-}
-
 bool GPSLogger::ensure_log_directory() {
     if (!config_.auto_create_directory) {
         return true;
@@ -581,7 +762,7 @@ bool GPSLogger::ensure_log_directory() {
     return true;
 }
 
-uint32_t GPSLogger::get_next_file_counter(const std::string& date) {
+uint32_t GPSLogger::get_next_file_counter(const std::string& date, uint32_t first) {
     auto log_files = get_log_files();
     uint32_t max_counter = 0;
     
@@ -608,7 +789,12 @@ uint32_t GPSLogger::get_next_file_counter(const std::string& date) {
         }
     }
     
-    return max_counter + 1;
+    // 目录列表不完整时逐个检查编号，已存在的文件不会被FA_CREATE_ALWAYS截断
+    uint32_t counter = std::max(max_counter + 1, first);
+    while (counter < 999 && sd_card_->file_exists(generate_log_filename(date, counter))) {
+        counter++;
+    }
+    return counter;
 }
 
 bool GPSLogger::add_to_buffer(const std::string& data) {
@@ -623,6 +809,50 @@ bool GPSLogger::add_to_buffer(const std::string& data) {
     memcpy(write_buffer_.data() + buffer_used_, data.c_str(), data_len);
     buffer_used_ += data_len;
     pending_records_++;
+    gps_flush_record((uint32_t)data_len, (uint32_t)get_current_timestamp_ms());
+    
+    return true;
+}
+
+bool GPSLogger::write_buffer_prefix(size_t bytes, uint8_t reason) {
+    if (previous_pending_bytes_ > 0) {
+        size_t previous_bytes = std::min(bytes, previous_pending_bytes_);
+        if (!append_buffer_prefix(previous_log_file_, previous_file_size_, previous_bytes, reason)) {
+            return false;
+        }
+        previous_pending_bytes_ -= previous_bytes;
+        bytes -= previous_bytes;
+        if (bytes == 0) {
+            return true;
+        }
+    }
+    return append_buffer_prefix(current_log_file_, current_file_size_, bytes, reason);
+}
+
+bool GPSLogger::append_buffer_prefix(const std::string& path, size_t& file_size, size_t bytes, uint8_t reason) {
+    // 将缓冲区开头的数据写入SD卡
+    uint64_t start_us = to_us_since_boot(get_absolute_time());
+    std::string buffer_data(write_buffer_.data(), bytes);
+    if (!sd_card_->append_text_file(path, buffer_data)) {
+        gps_flush_failed();
+        printf("[GPS Logger] 刷新缓冲区失败\n");
+        return false;
+    }
+    uint32_t elapsed_us = (uint32_t)(to_us_since_boot(get_absolute_time()) - start_us);
+    gps_flush_done((uint32_t)get_current_timestamp_ms(), (uint32_t)file_size, (uint32_t)bytes,
+                   elapsed_us, reason);
+    
+    // 更新文件大小，剩余数据（不足一个扇区的部分记录）移到缓冲区开头
+    file_size += bytes;
+    size_t remaining = buffer_used_ - bytes;
+    memmove(write_buffer_.data(), write_buffer_.data() + bytes, remaining);
+    size_t written_records = pending_records_;
+    pending_records_ = std::count(write_buffer_.data(), write_buffer_.data() + remaining, '\n');
+    written_records -= pending_records_;
+    buffer_used_ = remaining;
+    last_write_time_ = get_current_timestamp_ms();
+    printf("[GPS Logger] 批量写入 %zu 条记录 (%zu 字节, %lu us)\n", written_records, bytes,
+           (unsigned long)elapsed_us);
     
     return true;
 }
@@ -631,40 +861,46 @@ uint64_t GPSLogger::get_current_timestamp_ms() {
     return to_ms_since_boot(get_absolute_time());
 }
 
-std::string GPSLogger::extract_datetime_from_gps(const LC76G_GPS_Data& gps_data) {
+std::string GPSLogger::extract_datetime_from_gps(const gps_fix_t& fix) {
     // 从GPS数据中提取日期和时间，格式：YYYY-MM-DD_HH:MM:SS
-    std::string gps_date = gps_data.Date;
-    
-    if (gps_date.length() >= 10 && gps_date[4] == '-' && gps_date[7] == '-') {
-        // 格式：YYYY-MM-DD，添加时间部分
+    uint16_t year;
+    uint8_t month, day;
+    if (gps_fix_date(&fix, &year, &month, &day)) {
+        // 日期为UTC，时间与显示一致为北京时间
+        uint8_t hour = 0, minute = 0, second = 0;
+        if (fix.flags & GPS_FIX_HAS_TIME) {
+            gps_fix_local_hms(&fix, &hour, &minute, &second);
+        }
         char datetime[32];
-        snprintf(datetime, sizeof(datetime), "%s_%02d:%02d:%02d", 
-                 gps_date.c_str(), gps_data.Time_H, gps_data.Time_M, gps_data.Time_S);
+        snprintf(datetime, sizeof(datetime), "%04u-%02u-%02u_%02u:%02u:%02u",
+                 year, month, day, hour, minute, second);
         return std::string(datetime);
     }
     
-    return "";  // 日期格式无效
+    return "";  // 日期无效
 }
 
-bool GPSLogger::create_log_file_from_gps_date(const LC76G_GPS_Data& gps_data) {
+bool GPSLogger::create_log_file_from_gps_date(const gps_fix_t& fix) {
     if (log_file_created_) {
         return true;  // 文件已创建
     }
     
     // 从GPS数据中提取日期时间
-    std::string gps_datetime = extract_datetime_from_gps(gps_data);
+    std::string gps_datetime = extract_datetime_from_gps(fix);
     if (gps_datetime.empty()) {
         printf("[GPS Logger] 无法从GPS数据中提取有效日期时间\n");
         return false;
     }
     
-    // 生成文件名：YYYY-MM-DD_HH:MM:SS.log
-    std::string filename = gps_datetime + config_.file_extension;
-    current_log_file_ = config_.log_directory + "/" + filename;
-    current_file_size_ = 0;
-    
-    // 创建日志文件
-    if (!create_new_log_file()) {
+    // initialize()创建的文件还没有记录时沿用该文件，只重写文件头，
+    // 避免每次启动留下一个只有文件头的文件
+    if (!current_log_file_.empty() && current_file_size_ == current_header_size_ && buffer_used_ == 0) {
+        if (!write_log_header(current_log_file_, current_file_size_)) {
+            printf("[GPS Logger] 创建日志文件失败: %s\n", current_log_file_.c_str());
+            return false;
+        }
+        current_header_size_ = current_file_size_;
+    } else if (!create_new_log_file()) {
         printf("[GPS Logger] 创建日志文件失败: %s\n", current_log_file_.c_str());
         return false;
     }
@@ -0,0 +1,619 @@
+/**
+ * @file gps_nmea.c
+ * @brief 表驱动的NMEA解析引擎：语句表、字段描述表和字段解析
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "pico/platform.h"
+#include "gps/gps_nmea.h"
+
+static const uint32_t kPow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+// =============================================================================
+// 字段描述表
+// =============================================================================
+
+enum FIELD_TYPE {
+    FIELD_TIME = 1,     // hhmmss.sss -> uint32_t 当日毫秒
+    FIELD_DATE,         // ddmmyy -> uint16_t FAT日期
+    FIELD_DATE_SPLIT,   // dd,mm,yyyy三个字段 -> uint16_t FAT日期
+    FIELD_POSITION,     // 纬度,N/S,经度,E/W四个字段 -> lat_e7, lon_e7
+    FIELD_STATUS,       // 'A'有效，其他（含空）无效 -> GPS_FIX_VALID
+    FIELD_QUALITY,      // 质量指示 -> uint8_t，非0时GPS_FIX_VALID
+    FIELD_COUNT,        // 整数 -> uint8_t
+    FIELD_DOP,          // x.xx -> uint16_t (0.01)
+    FIELD_CENTI,        // x.xx -> int32_t (0.01)
+    FIELD_KNOTS,        // 节 -> uint16_t 厘米/秒
+    FIELD_COURSE,       // 度 -> uint16_t 0.01度
+    FIELD_CHAR          // 首字符 -> char
+};
+
+typedef struct {
+    uint8_t index;      // 字段序号（地址字段为0），表内按升序排列
+    uint8_t type;       // FIELD_*
+    uint8_t offset;     // 在gps_fix_t中的偏移
+} field_desc_t;
+
+#define FIELD(index, type, member)  { (index), (type), (uint8_t)offsetof(gps_fix_t, member) }
+#define FIELDS_OF(table)            (table), (uint8_t)(sizeof(table) / sizeof((table)[0]))
+#define NO_FIELDS                   NULL, 0
+
+_Static_assert(offsetof(gps_fix_t, lon_e7) == offsetof(gps_fix_t, lat_e7) + sizeof(int32_t),
+               "FIELD_POSITION要求lon_e7紧跟lat_e7");
+
+// $--RMC,hhmmss.sss,A,ddmm.mmmm,N,dddmm.mmmm,E,节,航向,ddmmyy,磁偏角,E,模式*hh
+static const field_desc_t kRmcFields[] = {
+    FIELD(1, FIELD_TIME, utc_ms),
+    FIELD(2, FIELD_STATUS, flags),
+    FIELD(3, FIELD_POSITION, lat_e7),
+    FIELD(7, FIELD_KNOTS, speed_cms),
+    FIELD(8, FIELD_COURSE, course_cdeg),
+    FIELD(9, FIELD_DATE, utc_date),
+    FIELD(12, FIELD_CHAR, mode),            // NMEA 2.3起
+};
+
+// $--GGA,hhmmss.sss,ddmm.mmmm,N,dddmm.mmmm,E,质量,卫星数,HDOP,海拔,M,大地水准面,M,,*hh
+static const field_desc_t kGgaFields[] = {
+    FIELD(1, FIELD_TIME, utc_ms),
+    FIELD(2, FIELD_POSITION, lat_e7),
+    FIELD(6, FIELD_QUALITY, quality),
+    FIELD(7, FIELD_COUNT, satellites),
+    FIELD(8, FIELD_DOP, hdop_c),
+    FIELD(9, FIELD_CENTI, alt_cm),
+};
+
+// $--GSA,模式,定位类型,12个PRN,PDOP,HDOP,VDOP(,系统ID)*hh
+static const field_desc_t kGsaFields[] = {
+    FIELD(15, FIELD_DOP, pdop_c),
+    FIELD(16, FIELD_DOP, hdop_c),
+    FIELD(17, FIELD_DOP, vdop_c),
+};
+
+// $--VTG,真航向,T,磁航向,M,节,N,公里/时,K,模式*hh
+static const field_desc_t kVtgFields[] = {
+    FIELD(1, FIELD_COURSE, course_cdeg),
+    FIELD(5, FIELD_KNOTS, speed_cms),
+    FIELD(9, FIELD_CHAR, mode),
+};
+
+// $--ZDA,hhmmss.ss,dd,mm,yyyy,时区时,时区分*hh
+static const field_desc_t kZdaFields[] = {
+    FIELD(1, FIELD_TIME, utc_ms),
+    FIELD(2, FIELD_DATE_SPLIT, utc_date),
+};
+
+// =============================================================================
+// 语句表
+// =============================================================================
+
+/**
+ * 语句类型、最少字段数（含地址字段）、字段描述表。GSV不写入gps_fix_t，
+ * 由前端在回调中处理（天空图、可见卫星数）。
+ */
+#define SENTENCE_LIST(X)                                            \
+    X('R', 'M', 'C', GPS_NMEA_RMC, 10, FIELDS_OF(kRmcFields))       \
+    X('G', 'G', 'A', GPS_NMEA_GGA, 10, FIELDS_OF(kGgaFields))       \
+    X('G', 'S', 'A', GPS_NMEA_GSA, 18, FIELDS_OF(kGsaFields))       \
+    X('G', 'S', 'V', GPS_NMEA_GSV, 4, NO_FIELDS)                    \
+    X('V', 'T', 'G', GPS_NMEA_VTG, 9, FIELDS_OF(kVtgFields))        \
+    X('Z', 'D', 'A', GPS_NMEA_ZDA, 5, FIELDS_OF(kZdaFields))
+
+/**
+ * 语句类型3个字符的完美哈希。常数由离线搜索得到，对上表以及GLL/GNS/GST/TXT
+ * 都不冲突；新增语句冲突时下面的_Static_assert报错，需重新选择常数。
+ */
+#define SENTENCE_SLOTS          16
+#define SENTENCE_HASH(a, b, c)  ((((unsigned)(a) + (unsigned)(b) * 40u + (unsigned)(c)) >> 2) & (SENTENCE_SLOTS - 1))
+
+#define SLOT_OR(a, b, c, ...)   | (1u << SENTENCE_HASH(a, b, c))
+#define SLOT_ADD(a, b, c, ...)  + (1u << SENTENCE_HASH(a, b, c))
+_Static_assert((0u SENTENCE_LIST(SLOT_OR)) == (0u SENTENCE_LIST(SLOT_ADD)), "语句类型哈希冲突");
+
+typedef struct {
+    char id[3];
+    uint8_t type;
+} sentence_slot_t;
+
+typedef struct {
+    uint8_t min_fields;
+    const field_desc_t *fields;
+    uint8_t field_count;
+} sentence_desc_t;
+
+#define SLOT_ENTRY(a, b, c, type, ...)  [SENTENCE_HASH(a, b, c)] = { {a, b, c}, type },
+#define DESC_ENTRY(a, b, c, type, min_fields, ...)  [type] = { min_fields, __VA_ARGS__ },
+
+static const sentence_slot_t kSlots[SENTENCE_SLOTS] = { SENTENCE_LIST(SLOT_ENTRY) };
+static const sentence_desc_t kSentences[GPS_NMEA_SENTENCE_COUNT] = { SENTENCE_LIST(DESC_ENTRY) };
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline bool is_field_end(char c) {
+    return c == ',' || c == '*' || c == '\r' || c == '\n' || c == '\0';
+}
+
+static inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool is_upper(char c) {
+    return c >= 'A' && c <= 'Z';
+}
+
+static inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief 解析无符号小数，整数部分和小数部分分开返回
+ * @param frac_digits 小数位数 (0-7)，多余的位四舍五入（进位计入整数部分）
+ * @param int_digits 返回整数部分的位数
+ */
+static bool parse_unsigned(const char *p, uint8_t frac_digits, uint32_t *int_part, uint32_t *frac_part,
+                           uint8_t *int_digits) {
+    uint32_t value = 0;
+    uint8_t digits = 0;
+    while (is_digit(*p)) {
+        if (value > 429496728u) {       // 再乘10会溢出
+            return false;
+        }
+        value = value * 10u + (uint32_t)(*p++ - '0');
+        digits++;
+    }
+
+    uint32_t frac = 0;
+    uint8_t kept = 0;
+    bool round_up = false;
+    if (*p == '.') {
+        p++;
+        while (is_digit(*p)) {
+            if (kept < frac_digits) {
+                frac = frac * 10u + (uint32_t)(*p - '0');
+                kept++;
+            } else if (kept == frac_digits) {
+                round_up = *p >= '5';
+                kept++;                 // 只看第一位多余的数字
+            }
+            p++;
+        }
+    }
+    if ((digits == 0 && kept == 0) || !is_field_end(*p)) {
+        return false;
+    }
+
+    while (kept < frac_digits) {
+        frac *= 10u;
+        kept++;
+    }
+    if (round_up && ++frac == kPow10[frac_digits]) {
+        frac = 0;
+        value++;
+    }
+    *int_part = value;
+    *frac_part = frac;
+    if (int_digits) {
+        *int_digits = digits;
+    }
+    return true;
+}
+
+static inline uint16_t clamp_u16(int32_t value) {
+    return value < 0 ? 0 : (value > 65535 ? 65535 : (uint16_t)value);
+}
+
+/**
+ * @brief 0.001节 -> 厘米/秒 (1节 = 1852/3600 米/秒)
+ */
+static uint16_t knots_milli_to_cms(int32_t knots_milli) {
+    if (knots_milli <= 0) {
+        return 0;
+    }
+    if (knots_milli > 1273900) {
+        return 65535;
+    }
+    return (uint16_t)(((uint32_t)knots_milli * 463u + 4500u) / 9000u);
+}
+
+static inline void set_valid(gps_fix_t *fix, bool valid) {
+    if (valid) {
+        fix->flags |= GPS_FIX_VALID;
+    } else {
+        fix->flags &= (uint8_t)~GPS_FIX_VALID;
+    }
+}
+
+/**
+ * @brief ZDA的日、月、四位年份
+ */
+static bool parse_date_split(const char *const *field, uint16_t *fat_date) {
+    int32_t day;
+    int32_t month;
+    int32_t year;
+    if (!gps_nmea_parse_decimal(field[0], 0, &day) || !gps_nmea_parse_decimal(field[1], 0, &month) ||
+        !gps_nmea_parse_decimal(field[2], 0, &year) || day < 1 || day > 31 || month < 1 || month > 12 ||
+        year < 1980 || year > 2107) {
+        return false;
+    }
+    *fat_date = (uint16_t)(((year - 1980) << 9) | (month << 5) | day);
+    return true;
+}
+
+/**
+ * @brief 按描述写入一个字段
+ * @param field 从描述的字段序号开始的字段
+ * @param available field中可用的字段数
+ * @return GPS_NMEA_UPD_*，字段为空或格式错误时返回0
+ */
+static uint16_t apply_field(const field_desc_t *desc, const char *const *field, int available, gps_fix_t *fix) {
+    void *dst = (uint8_t *)fix + desc->offset;
+    int32_t value;
+
+    switch (desc->type) {
+        case FIELD_TIME: {
+            uint32_t utc_ms;
+            if (!gps_nmea_parse_time(field[0], &utc_ms)) {
+                return 0;
+            }
+            *(uint32_t *)dst = utc_ms;
+            fix->flags |= GPS_FIX_HAS_TIME;
+            return GPS_NMEA_UPD_TIME;
+        }
+        case FIELD_DATE:
+        case FIELD_DATE_SPLIT: {
+            uint16_t date;
+            bool ok = desc->type == FIELD_DATE ? gps_nmea_parse_date(field[0], &date)
+                                               : available >= 3 && parse_date_split(field, &date);
+            if (!ok) {
+                return 0;
+            }
+            *(uint16_t *)dst = date;
+            return GPS_NMEA_UPD_DATE;
+        }
+        case FIELD_POSITION: {
+            // 坐标和方向字段都能解析时才更新，无定位时的空字段保留上一次的位置
+            int32_t lat_e7;
+            int32_t lon_e7;
+            if (available < 4 || !gps_nmea_parse_coord(field[0], field[1][0], &lat_e7) ||
+                !gps_nmea_parse_coord(field[2], field[3][0], &lon_e7)) {
+                return 0;
+            }
+            ((int32_t *)dst)[0] = lat_e7;
+            ((int32_t *)dst)[1] = lon_e7;
+            fix->flags |= GPS_FIX_HAS_POSITION;
+            return GPS_NMEA_UPD_POSITION;
+        }
+        case FIELD_STATUS:
+            set_valid(fix, field[0][0] == 'A');
+            return GPS_NMEA_UPD_STATUS;
+        case FIELD_QUALITY:
+            if (!is_digit(field[0][0])) {
+                return 0;
+            }
+            *(uint8_t *)dst = (uint8_t)(field[0][0] - '0');
+            set_valid(fix, field[0][0] != '0');
+            return GPS_NMEA_UPD_STATUS;
+        case FIELD_COUNT:
+            if (!gps_nmea_parse_decimal(field[0], 0, &value) || value < 0 || value > 255) {
+                return 0;
+            }
+            *(uint8_t *)dst = (uint8_t)value;
+            return GPS_NMEA_UPD_SATELLITES;
+        case FIELD_DOP:
+            if (!gps_nmea_parse_decimal(field[0], 2, &value)) {
+                return 0;
+            }
+            *(uint16_t *)dst = clamp_u16(value);
+            return GPS_NMEA_UPD_DOP;
+        case FIELD_CENTI:
+            if (!gps_nmea_parse_decimal(field[0], 2, &value)) {
+                return 0;
+            }
+            *(int32_t *)dst = value;
+            return GPS_NMEA_UPD_ALTITUDE;
+        case FIELD_KNOTS:
+            if (!gps_nmea_parse_decimal(field[0], 3, &value)) {
+                return 0;
+            }
+            *(uint16_t *)dst = knots_milli_to_cms(value);
+            return GPS_NMEA_UPD_MOTION;
+        case FIELD_COURSE:
+            if (!gps_nmea_parse_decimal(field[0], 2, &value)) {
+                return 0;
+            }
+            *(uint16_t *)dst = (uint16_t)((value % 36000 + 36000) % 36000);
+            return GPS_NMEA_UPD_MOTION;
+        case FIELD_CHAR:
+            if (gps_nmea_field_empty(field[0])) {
+                return 0;
+            }
+            *(char *)dst = field[0][0];
+            return GPS_NMEA_UPD_MODE;
+        default:
+            return 0;
+    }
+}
+
+// =============================================================================
+// 按字校验和与分帧
+// =============================================================================
+
+/**
+ * 对齐后每次读取4字节：校验和直接对整字异或，最后把4个字节折叠成1个；
+ * 分隔符用SWAR零字节技巧检测，字中没有'*' '$'和控制字符时整字跳过，
+ * 有时退回逐字节处理这一字。Cortex-M0+不支持非对齐访问，对齐前后的
+ * 零头逐字节处理。
+ *
+ * gps_nmea_xor/gps_nmea_scan放在SRAM中，辅助函数强制内联，扫描时不经过XIP缓存。
+ */
+#define WORD_ONES   0x01010101u
+#define WORD_HIGHS  0x80808080u
+
+static __force_inline uint32_t load_word(const char *p) {
+    uint32_t w;
+    memcpy(&w, __builtin_assume_aligned(p, 4), sizeof(w));
+    return w;
+}
+
+/**
+ * @brief 字中有等于某字节的字节时非0
+ * @param repeated 该字节重复4次
+ */
+static __force_inline uint32_t word_has_byte(uint32_t w, uint32_t repeated) {
+    uint32_t x = w ^ repeated;
+    return (x - WORD_ONES) & ~x & WORD_HIGHS;
+}
+
+/**
+ * @brief 字中有小于0x20的字节（'\r' '\n' NUL等控制字符）时非0
+ */
+static __force_inline uint32_t word_has_control(uint32_t w) {
+    return (w - 0x20u * WORD_ONES) & ~w & WORD_HIGHS;
+}
+
+static __force_inline uint8_t fold_word(uint32_t x) {
+    x ^= x >> 16;
+    x ^= x >> 8;
+    return (uint8_t)x;
+}
+
+static __force_inline bool is_frame_end(char c) {
+    return c == '*' || c == '$' || (uint8_t)c < 0x20u;
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+uint8_t __not_in_flash_func(gps_nmea_xor)(const char *data, int len) {
+    const char *p = data;
+    const char *end = data + (len > 0 ? len : 0);
+    uint8_t sum = 0;
+    while (p < end && ((uintptr_t)p & 3u)) {
+        sum ^= (uint8_t)*p++;
+    }
+    uint32_t acc = 0;
+    while (end - p >= 4) {
+        acc ^= load_word(p);
+        p += 4;
+    }
+    sum ^= fold_word(acc);
+    while (p < end) {
+        sum ^= (uint8_t)*p++;
+    }
+    return sum;
+}
+
+const char *__not_in_flash_func(gps_nmea_scan)(const char *p, const char *end, uint8_t *checksum) {
+    uint8_t sum = 0;
+    while (p < end && ((uintptr_t)p & 3u)) {
+        if (is_frame_end(*p)) {
+            *checksum = sum;
+            return p;
+        }
+        sum ^= (uint8_t)*p++;
+    }
+
+    uint32_t acc = 0;
+    while (end - p >= 4) {
+        uint32_t w = load_word(p);
+        if (word_has_byte(w, '*' * WORD_ONES) | word_has_byte(w, '$' * WORD_ONES) | word_has_control(w)) {
+            break;
+        }
+        acc ^= w;
+        p += 4;
+    }
+    sum ^= fold_word(acc);
+
+    while (p < end && !is_frame_end(*p)) {
+        sum ^= (uint8_t)*p++;
+    }
+    *checksum = sum;
+    return p;
+}
+
+uint8_t gps_nmea_sentence_type(const char *address) {
+    // 2个字符的发送方 + 3个字符的语句类型；'P'开头为专有语句
+    for (int i = 0; i < 5; i++) {
+        if (!is_upper(address[i])) {
+            return GPS_NMEA_UNKNOWN;
+        }
+    }
+    if (address[0] == 'P' || (address[5] != ',' && address[5] != '*')) {
+        return GPS_NMEA_UNKNOWN;
+    }
+    const sentence_slot_t *slot = &kSlots[SENTENCE_HASH(address[2], address[3], address[4])];
+    if (slot->id[0] != address[2] || slot->id[1] != address[3] || slot->id[2] != address[4]) {
+        return GPS_NMEA_UNKNOWN;
+    }
+    return slot->type;
+}
+
+uint16_t gps_nmea_apply(uint8_t type, const char *const *fields, int field_count, gps_fix_t *fix) {
+    if (type == GPS_NMEA_UNKNOWN || type >= GPS_NMEA_SENTENCE_COUNT || !fields || !fix) {
+        return 0;
+    }
+    const sentence_desc_t *sentence = &kSentences[type];
+    if (field_count < sentence->min_fields) {
+        return 0;
+    }
+
+    uint16_t updated = 0;
+    for (uint8_t i = 0; i < sentence->field_count; i++) {
+        const field_desc_t *desc = &sentence->fields[i];
+        if (desc->index >= field_count) {
+            break;
+        }
+        updated |= apply_field(desc, fields + desc->index, field_count - desc->index, fix);
+    }
+    return updated;
+}
+
+uint32_t gps_nmea_parse_buffer(const char *data, int data_len, gps_fix_t *fix,
+                               gps_nmea_sentence_cb_t callback, void *ctx, gps_nmea_stats_t *stats) {
+    if (!data || data_len <= 0 || !fix) {
+        return 0;
+    }
+
+    const char *end = data + data_len;
+    const char *p = memchr(data, '$', (size_t)data_len);
+    uint32_t seen = 0;
+    gps_nmea_sentence_t sentence;
+
+    // 分帧和校验和在同一遍扫描中完成：从'$'之后累计到分隔符，
+    // 是'*'时比较校验和，是'$'时说明上一句不完整，从这里重新开始
+    while (p) {
+        uint8_t sum;
+        const char *stop = gps_nmea_scan(p + 1, end, &sum);
+        int high = end - stop >= 3 && *stop == '*' ? hex_value(stop[1]) : -1;
+        int low = high >= 0 ? hex_value(stop[2]) : -1;
+        if (low < 0 || (uint8_t)((high << 4) | low) != sum) {
+            if (stats) {
+                stats->checksum_errors++;
+            }
+            p = stop < end && *stop == '$' ? stop : memchr(stop, '$', (size_t)(end - stop));
+            continue;
+        }
+
+        uint8_t type = gps_nmea_sentence_type(p + 1);
+        if (stats) {
+            stats->sentences++;
+            if (type == GPS_NMEA_UNKNOWN) {
+                stats->unknown++;
+            } else {
+                stats->by_type[type]++;
+            }
+        }
+        if (type != GPS_NMEA_UNKNOWN) {
+            sentence.type = type;
+            sentence.text = p;
+            sentence.field_count = gps_nmea_split(p, sentence.fields, GPS_NMEA_MAX_FIELDS);
+            sentence.updated = gps_nmea_apply(type, sentence.fields, sentence.field_count, fix);
+            seen |= GPS_NMEA_MASK(type);
+            if (callback) {
+                callback(&sentence, ctx);
+            }
+        }
+        p = memchr(stop + 3, '$', (size_t)(end - stop - 3));
+    }
+    return seen;
+}
+
+int gps_nmea_split(const char *sentence, const char **fields, int max_fields) {
+    const char *p = sentence[0] == '$' ? sentence + 1 : sentence;
+    int count = 0;
+    while (count < max_fields) {
+        fields[count++] = p;
+        while (!is_field_end(*p)) {
+            p++;
+        }
+        if (*p != ',') {
+            break;
+        }
+        p++;
+    }
+    return count;
+}
+
+bool gps_nmea_parse_decimal(const char *field, uint8_t frac_digits, int32_t *value) {
+    bool negative = *field == '-';
+    if (*field == '-' || *field == '+') {
+        field++;
+    }
+    uint32_t int_part;
+    uint32_t frac;
+    if (frac_digits > 7 || !parse_unsigned(field, frac_digits, &int_part, &frac, NULL) ||
+        int_part > (0x7FFFFFFFu - frac) / kPow10[frac_digits]) {
+        return false;
+    }
+    int32_t v = (int32_t)(int_part * kPow10[frac_digits] + frac);
+    *value = negative ? -v : v;
+    return true;
+}
+
+bool gps_nmea_parse_coord(const char *field, char hemisphere, int32_t *e7) {
+    uint32_t int_part;
+    uint32_t frac;
+    uint8_t digits;
+    if (!parse_unsigned(field, 7, &int_part, &frac, &digits) || digits < 3) {
+        return false;
+    }
+    uint32_t degrees = int_part / 100u;
+    uint32_t minutes = int_part % 100u;
+    if (degrees > 180u || minutes >= 60u) {
+        return false;
+    }
+    // 1e-7分 -> 1e-7度
+    uint32_t minutes_e7 = minutes * 10000000u + frac;
+    int32_t value = (int32_t)(degrees * 10000000u + (minutes_e7 + 30u) / 60u);
+    *e7 = (hemisphere == 'S' || hemisphere == 'W') ? -value : value;
+    return true;
+}
+
+bool gps_nmea_parse_time(const char *field, uint32_t *utc_ms) {
+    uint32_t int_part;
+    uint32_t frac;
+    uint8_t digits;
+    if (!parse_unsigned(field, 3, &int_part, &frac, &digits) || digits != 6) {
+        return false;
+    }
+    uint32_t hour = int_part / 10000u;
+    uint32_t minute = int_part / 100u % 100u;
+    uint32_t second = int_part % 100u;
+    if (hour > 23u || minute > 59u || second > 60u) {
+        return false;
+    }
+    *utc_ms = ((hour * 60u + minute) * 60u + second) * 1000u + frac;
+    return true;
+}
+
+bool gps_nmea_parse_date(const char *field, uint16_t *fat_date) {
+    for (int i = 0; i < 6; i++) {
+        if (!is_digit(field[i])) {
+            return false;
+        }
+    }
+    if (!is_field_end(field[6])) {
+        return false;
+    }
+    uint32_t day = (uint32_t)(field[0] - '0') * 10u + (uint32_t)(field[1] - '0');
+    uint32_t month = (uint32_t)(field[2] - '0') * 10u + (uint32_t)(field[3] - '0');
+    uint32_t year = (uint32_t)(field[4] - '0') * 10u + (uint32_t)(field[5] - '0');
+    if (month < 1u || month > 12u || day < 1u || day > 31u) {
+        return false;
+    }
+    // 两位年份按20xx处理
+    *fat_date = (uint16_t)(((year + 20u) << 9) | (month << 5) | day);
+    return true;
+}
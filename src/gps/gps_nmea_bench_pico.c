@@ -0,0 +1,188 @@
+/**
+ * @file gps_nmea_bench_pico.c
+ * @brief 目标板上的校验和/分帧周期数测量
+ *
+ * Cortex-M0+没有DWT周期计数器，用SysTick（处理器时钟，24位递减）计时。
+ * 测量时关中断，每项取若干次中的最小值，与逐字节的旧实现对比。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+#include "gps/gps_nmea.h"
+
+#define SYSTICK_MAX         0x00FFFFFFu
+#define SYSTICK_ENABLE      0x1u
+#define SYSTICK_CLK_CPU     0x4u
+#define BENCH_RUNS          8
+
+// 10Hz下一个历元的典型输出
+static const char *const kBodies[] = {
+    "GNRMC,081836.000,A,3114.5678,N,12128.1234,E,12.5,87.3,181026,,,A",
+    "GNGGA,081836.000,3114.5678,N,12128.1234,E,1,12,0.9,45.6,M,8.1,M,,",
+    "GNGSA,A,3,01,03,07,08,11,13,17,19,22,28,30,,1.6,0.9,1.3,1",
+    "GPGSV,3,1,12,01,45,120,42,03,30,045,38,07,60,300,45,08,15,200,30",
+    "GPGSV,3,2,12,11,20,080,33,13,55,150,44,17,10,330,25,19,35,270,40",
+    "GPGSV,3,3,12,22,65,010,46,28,05,190,20,30,40,230,41,32,12,100,28",
+    "GNVTG,87.3,T,,M,12.5,N,23.2,K,A",
+};
+
+static char g_epoch[768] __attribute__((aligned(4)));
+static int g_epoch_len = 0;
+
+// =============================================================================
+// 逐字节的旧实现（对照）
+// =============================================================================
+
+static uint8_t xor_bytewise(const char *data, int len) {
+    uint8_t sum = 0;
+    for (int i = 0; i < len; i++) {
+        sum ^= (uint8_t)data[i];
+    }
+    return sum;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief 先用memchr找下一个'$'，再逐字节校验（引擎改为单遍扫描之前的做法）
+ */
+static int frame_bytewise(const char *data, int len) {
+    const char *end = data + len;
+    const char *p = memchr(data, '$', (size_t)len);
+    int valid = 0;
+    while (p) {
+        const char *next = p + 1 < end ? memchr(p + 1, '$', (size_t)(end - p - 1)) : NULL;
+        const char *limit = next ? next : end;
+        const char *q = p + 1;
+        uint8_t sum = 0;
+        while (q < limit && *q != '*' && *q != '\r' && *q != '\n' && *q != '\0') {
+            sum ^= (uint8_t)*q++;
+        }
+        if (limit - q >= 3 && *q == '*' && hex_value(q[1]) >= 0 && hex_value(q[2]) >= 0 &&
+            (uint8_t)((hex_value(q[1]) << 4) | hex_value(q[2])) == sum) {
+            valid++;
+        }
+        p = next;
+    }
+    return valid;
+}
+
+/**
+ * @brief 与gps_nmea_parse_buffer相同的单遍分帧，不解析字段
+ */
+static int frame_swar(const char *data, int len) {
+    const char *end = data + len;
+    const char *p = memchr(data, '$', (size_t)len);
+    int valid = 0;
+    while (p) {
+        uint8_t sum;
+        const char *stop = gps_nmea_scan(p + 1, end, &sum);
+        if (end - stop >= 3 && *stop == '*' && hex_value(stop[1]) >= 0 && hex_value(stop[2]) >= 0 &&
+            (uint8_t)((hex_value(stop[1]) << 4) | hex_value(stop[2])) == sum) {
+            valid++;
+            p = memchr(stop + 3, '$', (size_t)(end - stop - 3));
+        } else {
+            p = stop < end && *stop == '$' ? stop : memchr(stop, '$', (size_t)(end - stop));
+        }
+    }
+    return valid;
+}
+
+// =============================================================================
+// 计时
+// =============================================================================
+
+static volatile uint32_t g_sink;
+
+typedef uint32_t (*bench_fn_t)(void);
+
+static uint32_t run_xor_bytewise(void) {
+    return xor_bytewise(g_epoch + 1, g_epoch_len - 1);
+}
+
+static uint32_t run_xor_swar(void) {
+    return gps_nmea_xor(g_epoch + 1, g_epoch_len - 1);
+}
+
+static uint32_t run_frame_bytewise(void) {
+    return (uint32_t)frame_bytewise(g_epoch, g_epoch_len);
+}
+
+static uint32_t run_frame_swar(void) {
+    return (uint32_t)frame_swar(g_epoch, g_epoch_len);
+}
+
+static uint32_t run_parse_buffer(void) {
+    static gps_fix_t fix;
+    return gps_nmea_parse_buffer(g_epoch, g_epoch_len, &fix, NULL, NULL, NULL);
+}
+
+/**
+ * @brief 最少周期数（含约几个周期的SysTick读取开销）
+ */
+static uint32_t measure(bench_fn_t fn) {
+    uint32_t best = SYSTICK_MAX;
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        uint32_t irq = save_and_disable_interrupts();
+        uint32_t start = systick_hw->cvr;
+        g_sink = fn();
+        uint32_t cycles = (start - systick_hw->cvr) & SYSTICK_MAX;
+        restore_interrupts(irq);
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+static void build_epoch(void) {
+    g_epoch_len = 0;
+    for (size_t i = 0; i < sizeof(kBodies) / sizeof(kBodies[0]); i++) {
+        g_epoch_len += snprintf(g_epoch + g_epoch_len, sizeof(g_epoch) - (size_t)g_epoch_len, "$%s*%02X\r\n",
+                                kBodies[i], gps_nmea_xor(kBodies[i], (int)strlen(kBodies[i])));
+    }
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void gps_nmea_bench_run(void) {
+    build_epoch();
+
+    systick_hw->rvr = SYSTICK_MAX;
+    systick_hw->cvr = 0;
+    systick_hw->csr = SYSTICK_ENABLE | SYSTICK_CLK_CPU;
+
+    static const struct {
+        const char *name;
+        bench_fn_t fn;
+    } kCases[] = {
+        {"校验和 逐字节", run_xor_bytewise},
+        {"校验和 按字", run_xor_swar},
+        {"分帧+校验 逐字节", run_frame_bytewise},
+        {"分帧+校验 按字", run_frame_swar},
+        {"gps_nmea_parse_buffer", run_parse_buffer},
+    };
+
+    printf("[NMEA基准] 历元 %d 字节，%lu MHz\n", g_epoch_len, (unsigned long)(clock_get_hz(clk_sys) / 1000000u));
+    for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); i++) {
+        uint32_t cycles = measure(kCases[i].fn);
+        uint32_t per_byte_x100 = cycles * 100u / (uint32_t)g_epoch_len;
+        printf("[NMEA基准] %-22s %6lu 周期  %lu.%02lu 周期/字节\n", kCases[i].name, (unsigned long)cycles,
+               (unsigned long)(per_byte_x100 / 100u), (unsigned long)(per_byte_x100 % 100u));
+    }
+    systick_hw->csr = 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file gps_predictor.c
+ * @brief GPS显示预测器实现
+ */
+
+#include <string.h>
+#include <math.h>
+#include "gps/gps_predictor.h"
+
+#define METERS_PER_DEG_LAT 111320.0f
+#define DEG_TO_RAD         0.017453292519943295f
+#define ERROR_EWMA_SHIFT   3            // 偏差滑动平均权重 1/8
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static struct {
+    bool have_fix;
+    uint32_t fix_ms;
+    double fix_lat;
+    double fix_lon;
+    float fix_alt;
+    float speed_kmh;
+    float course_deg;
+    float ve;                   // 东向速度 (m/s)
+    float vn;                   // 北向速度 (m/s)
+    float m_per_deg_lon;
+
+    // 新定位时显示值与实测值之差，随时间衰减
+    float corr_e;
+    float corr_n;
+    float corr_speed;
+    float corr_course;
+
+    float last_error_m;
+} g_pred;
+
+static gps_predictor_stats_t g_stats;
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+// 角度差归一化到(-180, 180]
+static float wrap_180(float deg) {
+    while (deg > 180.0f) deg -= 360.0f;
+    while (deg <= -180.0f) deg += 360.0f;
+    return deg;
+}
+
+static float wrap_360(float deg) {
+    while (deg >= 360.0f) deg -= 360.0f;
+    while (deg < 0.0f) deg += 360.0f;
+    return deg;
+}
+
+static inline float ewma(float avg, float sample, uint32_t count) {
+    if (count <= 1) {
+        return sample;
+    }
+    return avg + (sample - avg) / (float)(1u << ERROR_EWMA_SHIFT);
+}
+
+/**
+ * @brief 相对最近定位的显示偏移（米）及修正衰减系数
+ */
+static void predict_offset(uint32_t now_ms, float *east, float *north, float *decay) {
+    uint32_t age = now_ms - g_pred.fix_ms;
+    uint32_t horizon = age < GPS_PREDICTOR_MAX_EXTRAPOLATE_MS ? age : GPS_PREDICTOR_MAX_EXTRAPOLATE_MS;
+    float dt = horizon / 1000.0f;
+    float k = expf(-(float)age / (float)GPS_PREDICTOR_BLEND_MS);
+
+    *east = g_pred.ve * dt + g_pred.corr_e * k;
+    *north = g_pred.vn * dt + g_pred.corr_n * k;
+    *decay = k;
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void gps_predictor_reset(void) {
+    memset(&g_pred, 0, sizeof(g_pred));
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+void gps_predictor_update(const gps_fix_t *fix, uint32_t fix_ms) {
+    if (!fix || !gps_fix_is_valid(fix)) {
+        return;
+    }
+
+    const double lat = fix->lat_e7 * 1e-7;
+    const double lon = fix->lon_e7 * 1e-7;
+    const float m_per_deg_lon = METERS_PER_DEG_LAT * cosf((float)lat * DEG_TO_RAD);
+    float speed = gps_fix_speed_kmh(fix);
+    float course = fix->course_cdeg * 0.01f;
+
+    float corr_e = 0, corr_n = 0, corr_speed = 0, corr_course = 0;
+    if (g_pred.have_fix && fix_ms - g_pred.fix_ms < GPS_PREDICTOR_STALE_MS) {
+        // 旧预测在新定位时刻的位置，换算到以新定位为原点的局部平面
+        float east, north, decay;
+        predict_offset(fix_ms, &east, &north, &decay);
+        float base_e = (float)(g_pred.fix_lon - lon) * m_per_deg_lon;
+        float base_n = (float)(g_pred.fix_lat - lat) * METERS_PER_DEG_LAT;
+
+        // 统计只看纯外推（不含显示修正），对照保持不动的偏差
+        float raw_e = base_e + east - g_pred.corr_e * decay;
+        float raw_n = base_n + north - g_pred.corr_n * decay;
+        g_pred.last_error_m = sqrtf(raw_e * raw_e + raw_n * raw_n);
+        float hold_error = sqrtf(base_e * base_e + base_n * base_n);
+
+        g_stats.fixes++;
+        g_stats.mean_error_m = ewma(g_stats.mean_error_m, g_pred.last_error_m, g_stats.fixes);
+        g_stats.mean_hold_error_m = ewma(g_stats.mean_hold_error_m, hold_error, g_stats.fixes);
+
+        corr_e = base_e + east;
+        corr_n = base_n + north;
+        if (sqrtf(corr_e * corr_e + corr_n * corr_n) > GPS_PREDICTOR_SNAP_M) {
+            g_stats.snaps++;
+            corr_e = corr_n = 0;
+        } else {
+            corr_speed = g_pred.speed_kmh + g_pred.corr_speed * decay - speed;
+            corr_course = wrap_180(g_pred.course_deg + g_pred.corr_course * decay - course);
+        }
+    } else {
+        g_pred.last_error_m = 0;
+    }
+
+    g_pred.have_fix = true;
+    g_pred.fix_ms = fix_ms;
+    g_pred.fix_lat = lat;
+    g_pred.fix_lon = lon;
+    g_pred.fix_alt = fix->alt_cm * 0.01f;
+    g_pred.speed_kmh = speed;
+    g_pred.course_deg = course;
+    g_pred.m_per_deg_lon = m_per_deg_lon;
+    g_pred.corr_e = corr_e;
+    g_pred.corr_n = corr_n;
+    g_pred.corr_speed = corr_speed;
+    g_pred.corr_course = corr_course;
+
+    // 静止时不外推，避免速度噪声让位置漂移
+    if (speed >= GPS_PREDICTOR_MIN_SPEED_KMH) {
+        float v = speed / 3.6f;
+        g_pred.ve = v * sinf(course * DEG_TO_RAD);
+        g_pred.vn = v * cosf(course * DEG_TO_RAD);
+    } else {
+        g_pred.ve = 0;
+        g_pred.vn = 0;
+    }
+}
+
+bool gps_predictor_sample(uint32_t now_ms, gps_predictor_state_t *state) {
+    if (!state) {
+        return false;
+    }
+    memset(state, 0, sizeof(*state));
+    if (!g_pred.have_fix) {
+        return false;
+    }
+
+    uint32_t age = now_ms - g_pred.fix_ms;
+    float east, north, decay;
+    predict_offset(now_ms, &east, &north, &decay);
+
+    state->lat = g_pred.fix_lat + north / METERS_PER_DEG_LAT;
+    state->lon = g_pred.fix_lon + (g_pred.m_per_deg_lon > 1.0f ? east / g_pred.m_per_deg_lon : 0.0f);
+    state->altitude_m = g_pred.fix_alt;
+    state->speed_kmh = fmaxf(0.0f, g_pred.speed_kmh + g_pred.corr_speed * decay);
+    state->course_deg = wrap_360(g_pred.course_deg + g_pred.corr_course * decay);
+    state->fix_age_ms = age;
+    state->prediction_error_m = g_pred.last_error_m;
+    state->correction_m = sqrtf(g_pred.corr_e * g_pred.corr_e + g_pred.corr_n * g_pred.corr_n) * decay;
+    state->valid = age < GPS_PREDICTOR_STALE_MS;
+    state->extrapolating = state->valid && age < GPS_PREDICTOR_MAX_EXTRAPOLATE_MS &&
+                           (g_pred.ve != 0.0f || g_pred.vn != 0.0f);
+    return state->valid;
+}
+
+void gps_predictor_get_stats(gps_predictor_stats_t *stats) {
+    if (stats) {
+        *stats = g_stats;
+    }
+}
@@ -0,0 +1,186 @@
+/**
+ * @file gps_quality.c
+ * @brief 定位质量门限实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "gps/gps_quality.h"
+
+#define M_PER_E7_LAT    0.0111319f      // 1e-7度纬度对应的米数
+#define DEG_TO_RAD      0.017453292519943295f
+#define E7_HALF_TURN    1800000000LL
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static struct {
+    bool have_base;
+    uint32_t base_ms;
+    int32_t base_lat_e7;
+    int32_t base_lon_e7;
+    float base_cos_lat;
+    uint8_t jump_rejects;       // 连续因位移被拒绝的次数
+} g_quality;
+
+static gps_quality_stats_t g_stats;
+
+static const char *const kClassNames[GPS_QUALITY_CLASS_COUNT] = {"拒绝", "降级", "良好"};
+static const char *const kReasonNames[GPS_QUALITY_REASON_COUNT] = {
+    "未定位", "卫星数", "HDOP", "PDOP", "速度", "位移"
+};
+static const char *const kWorkNames[GPS_QUALITY_WORK_COUNT] = {"日志", "地图", "围栏"};
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static void set_base(const gps_fix_t *fix, uint32_t fix_ms) {
+    g_quality.have_base = true;
+    g_quality.base_ms = fix_ms;
+    g_quality.base_lat_e7 = fix->lat_e7;
+    g_quality.base_lon_e7 = fix->lon_e7;
+    g_quality.base_cos_lat = cosf(fix->lat_e7 * 1e-7f * DEG_TO_RAD);
+    g_quality.jump_rejects = 0;
+}
+
+/**
+ * @brief 相对基准的位移是否超过上限速度加HDOP余量可达的距离
+ */
+static bool is_jump(const gps_fix_t *fix, uint32_t fix_ms) {
+    if (!g_quality.have_base) {
+        return false;
+    }
+    int64_t dlon = (int64_t)fix->lon_e7 - g_quality.base_lon_e7;
+    if (dlon > E7_HALF_TURN) {
+        dlon -= 2 * E7_HALF_TURN;
+    } else if (dlon < -E7_HALF_TURN) {
+        dlon += 2 * E7_HALF_TURN;
+    }
+    float north = (float)((int64_t)fix->lat_e7 - g_quality.base_lat_e7) * M_PER_E7_LAT;
+    float east = (float)dlon * M_PER_E7_LAT * g_quality.base_cos_lat;
+
+    uint16_t hdop_c = fix->hdop_c ? fix->hdop_c : 100;
+    float limit = (fix_ms - g_quality.base_ms) * (GPS_QUALITY_MAX_SPEED_KMH / 3600.0f) +
+                  hdop_c * (GPS_QUALITY_JUMP_M_PER_HDOP / 100.0f);
+    return north * north + east * east > limit * limit;
+}
+
+static void count_reasons(uint8_t reasons) {
+    for (int i = 0; i < GPS_QUALITY_REASON_COUNT; i++) {
+        if (reasons & (1u << i)) {
+            g_stats.by_reason[i]++;
+        }
+    }
+}
+
+static inline float percent(uint32_t part, uint32_t total) {
+    return total ? part * 100.0f / total : 0.0f;
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void gps_quality_reset(void) {
+    memset(&g_quality, 0, sizeof(g_quality));
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+uint8_t gps_quality_classify(const gps_fix_t *fix, uint32_t fix_ms, uint8_t *reasons) {
+    uint8_t reject = 0;
+    uint8_t degrade = 0;
+
+    if (!gps_fix_is_valid(fix) || !(fix->flags & GPS_FIX_HAS_POSITION)) {
+        reject |= GPS_QUALITY_NO_FIX;
+    }
+    if (fix->satellites == 0) {
+        // 未知（没有GGA）
+    } else if (fix->satellites < GPS_QUALITY_MIN_SATELLITES) {
+        reject |= GPS_QUALITY_FEW_SATELLITES;
+    } else if (fix->satellites < GPS_QUALITY_GOOD_SATELLITES) {
+        degrade |= GPS_QUALITY_FEW_SATELLITES;
+    }
+    if (fix->hdop_c > GPS_QUALITY_MAX_HDOP_C) {
+        reject |= GPS_QUALITY_HIGH_HDOP;
+    } else if (fix->hdop_c > GPS_QUALITY_GOOD_HDOP_C) {
+        degrade |= GPS_QUALITY_HIGH_HDOP;
+    }
+    if (fix->pdop_c > GPS_QUALITY_MAX_PDOP_C) {
+        reject |= GPS_QUALITY_HIGH_PDOP;
+    } else if (fix->pdop_c > GPS_QUALITY_GOOD_PDOP_C) {
+        degrade |= GPS_QUALITY_HIGH_PDOP;
+    }
+    if (fix->speed_cms > GPS_QUALITY_MAX_SPEED_KMH * 100000u / 3600u) {
+        reject |= GPS_QUALITY_SPEED;
+    }
+
+    if (!reject && is_jump(fix, fix_ms)) {
+        if (++g_quality.jump_rejects < GPS_QUALITY_MAX_JUMP_REJECTS) {
+            reject |= GPS_QUALITY_JUMP;
+        } else {
+            degrade |= GPS_QUALITY_JUMP;
+        }
+    }
+
+    uint8_t cls;
+    if (reject) {
+        cls = GPS_QUALITY_REJECT;
+    } else {
+        cls = degrade ? GPS_QUALITY_DEGRADED : GPS_QUALITY_GOOD;
+        set_base(fix, fix_ms);
+    }
+
+    uint8_t all = reject ? reject : degrade;
+    g_stats.epochs++;
+    g_stats.by_class[cls]++;
+    count_reasons(all);
+    if (reasons) {
+        *reasons = all;
+    }
+    return cls;
+}
+
+void gps_quality_work_done(uint8_t work, uint32_t elapsed_us) {
+    if (work < GPS_QUALITY_WORK_COUNT) {
+        g_stats.work_done[work]++;
+        g_stats.work_us[work] += elapsed_us;
+    }
+}
+
+void gps_quality_work_skipped(uint8_t work) {
+    if (work < GPS_QUALITY_WORK_COUNT) {
+        g_stats.work_skipped[work]++;
+    }
+}
+
+void gps_quality_get_stats(gps_quality_stats_t *stats) {
+    if (stats) {
+        *stats = g_stats;
+    }
+}
+
+void gps_quality_print_stats(void) {
+    const gps_quality_stats_t *s = &g_stats;
+    printf("[定位质量] 历元 %lu:", (unsigned long)s->epochs);
+    for (int i = GPS_QUALITY_CLASS_COUNT - 1; i >= 0; i--) {
+        printf(" %s %lu (%.1f%%)", kClassNames[i], (unsigned long)s->by_class[i],
+               percent(s->by_class[i], s->epochs));
+    }
+    printf("\n[定位质量] 原因:");
+    for (int i = 0; i < GPS_QUALITY_REASON_COUNT; i++) {
+        printf(" %s %lu", kReasonNames[i], (unsigned long)s->by_reason[i]);
+    }
+    printf("\n");
+    for (int i = 0; i < GPS_QUALITY_WORK_COUNT; i++) {
+        if (s->work_done[i] == 0 && s->work_skipped[i] == 0) {
+            continue;
+        }
+        uint32_t mean_us = s->work_done[i] ? (uint32_t)(s->work_us[i] / s->work_done[i]) : 0;
+        printf("[定位质量] %s: 执行 %lu 次 (平均 %lu us), 跳过 %lu 次, 约节省 %.1f ms\n", kWorkNames[i],
+               (unsigned long)s->work_done[i], (unsigned long)mean_us, (unsigned long)s->work_skipped[i],
+               (double)mean_us * s->work_skipped[i] / 1000.0);
+    }
+}
@@ -0,0 +1,352 @@
+/**
+ * @file gps_sky.c
+ * @brief 可见卫星表实现
+ */
+
+#include <string.h>
+#include "gps/gps_sky.h"
+#include "gps/gps_nmea.h"
+
+#define NO_SIGNAL_ID 0xFF
+#define PRN_WORDS 8                     // 每个星座256位
+
+#define GSA_FIELD_FIRST_PRN  3          // fields[0]为地址字段
+#define GSA_FIELD_SYSTEM_ID  18
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static gps_sky_sat_t g_sats[GPS_SKY_MAX_SATS];
+static uint8_t g_count = 0;
+static uint32_t g_generation = 0;
+
+/**
+ * @brief 每个星座的GSV分组状态
+ */
+static struct {
+    uint8_t cycle;              // 当前轮次
+    bool in_cycle;              // 已收到本轮第1条，还没收到最后一条
+    bool signal_known;
+    uint8_t signal_id;          // 只处理该信号的分组（多频接收机每个信号各发一组）
+} g_systems[GPS_SKY_SYSTEM_COUNT];
+
+/**
+ * @brief 参与定位的卫星PRN位图：pending在一组GSA内累计，提交后成为used
+ */
+static struct {
+    uint32_t used[GPS_SKY_SYSTEM_COUNT][PRN_WORDS];
+    uint32_t pending[GPS_SKY_SYSTEM_COUNT][PRN_WORDS];
+    bool open;                  // 已收到本组GSA，尚未提交
+    bool known;                 // 提交过至少一组
+} g_gsa;
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static int talker_system(const char *talker) {
+    static const struct {
+        char id[3];
+        uint8_t system;
+    } kTalkers[] = {
+        {"GP", GPS_SKY_GPS}, {"GL", GPS_SKY_GLONASS}, {"GA", GPS_SKY_GALILEO},
+        {"GB", GPS_SKY_BEIDOU}, {"BD", GPS_SKY_BEIDOU}, {"GQ", GPS_SKY_QZSS}, {"QZ", GPS_SKY_QZSS},
+    };
+    for (size_t i = 0; i < sizeof(kTalkers) / sizeof(kTalkers[0]); i++) {
+        if (talker[0] == kTalkers[i].id[0] && talker[1] == kTalkers[i].id[1]) {
+            return kTalkers[i].system;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief NMEA 4.10 GSA系统ID -> 星座
+ */
+static int gsa_system_id(int id) {
+    switch (id) {
+        case 1: return GPS_SKY_GPS;
+        case 2: return GPS_SKY_GLONASS;
+        case 3: return GPS_SKY_GALILEO;
+        case 4: return GPS_SKY_BEIDOU;
+        case 5: return GPS_SKY_QZSS;
+        default: return -1;
+    }
+}
+
+/**
+ * @brief GN讲话者且没有系统ID时按PRN范围区分星座
+ */
+static int prn_system(int prn) {
+    if (prn >= 1 && prn <= 32) {
+        return GPS_SKY_GPS;
+    }
+    if (prn >= 65 && prn <= 96) {
+        return GPS_SKY_GLONASS;
+    }
+    return -1;
+}
+
+static inline bool prn_bit(const uint32_t *bits, uint8_t prn) {
+    return (bits[prn >> 5] >> (prn & 31u)) & 1u;
+}
+
+static inline uint8_t popcount32(uint32_t v) {
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return (uint8_t)((((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+/**
+ * @brief 读取一个整数字段（引擎已切分）
+ * @param value 空字段或格式错误时不修改
+ */
+static bool field_int(const gps_nmea_sentence_t *sentence, int index, int *value) {
+    int32_t v;
+    if (index >= sentence->field_count || !gps_nmea_parse_decimal(sentence->fields[index], 0, &v)) {
+        return false;
+    }
+    *value = (int)v;
+    return true;
+}
+
+static gps_sky_sat_t *find_sat(uint8_t system, uint8_t prn) {
+    for (uint8_t i = 0; i < g_count; i++) {
+        if (g_sats[i].system == system && g_sats[i].prn == prn) {
+            return &g_sats[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 删除某星座本轮未出现的卫星
+ * @return 是否删除了卫星
+ */
+static bool prune_system(uint8_t system) {
+    bool removed = false;
+    for (uint8_t i = 0; i < g_count;) {
+        if (g_sats[i].system == system && g_sats[i].cycle != g_systems[system].cycle) {
+            g_sats[i] = g_sats[--g_count];
+            removed = true;
+        } else {
+            i++;
+        }
+    }
+    return removed;
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void gps_sky_clear(void) {
+    g_count = 0;
+    memset(g_systems, 0, sizeof(g_systems));
+    memset(&g_gsa, 0, sizeof(g_gsa));
+    g_generation++;
+}
+
+bool gps_sky_parse_gsv(const gps_nmea_sentence_t *sentence) {
+    if (!sentence || sentence->type != GPS_NMEA_GSV) {
+        return false;
+    }
+    int system = talker_system(sentence->fields[0]);
+    if (system < 0) {
+        return false;
+    }
+
+    // 总条数,序号,可见数，之后卫星字段每4个一组；多出1个字段时为NMEA 4.10的信号ID
+    int total = 0, number = 0;
+    if (!field_int(sentence, 1, &total) || !field_int(sentence, 2, &number) || number < 1 || number > total) {
+        return false;
+    }
+    int fields = sentence->field_count > 4 ? sentence->field_count - 4 : 0;
+    uint8_t signal_id = NO_SIGNAL_ID;
+    if (fields % 4 == 1) {
+        char c = sentence->fields[sentence->field_count - 1][0];
+        if (c >= '0' && c <= '9') {
+            signal_id = (uint8_t)(c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            signal_id = (uint8_t)(c - 'A' + 10);
+        }
+        fields--;
+    }
+
+    if (!g_systems[system].signal_known) {
+        g_systems[system].signal_known = true;
+        g_systems[system].signal_id = signal_id;
+    } else if (signal_id != g_systems[system].signal_id) {
+        return true;
+    }
+
+    if (number == 1) {
+        g_systems[system].cycle++;
+        g_systems[system].in_cycle = true;
+    }
+    const uint8_t cycle = g_systems[system].cycle;
+
+    bool changed = false;
+    for (int group = 0; group < fields / 4; group++) {
+        int base = 4 + group * 4;
+        int prn = 0, elevation = -1, azimuth = 0, snr = 0;
+        bool has_prn = field_int(sentence, base, &prn);
+        bool has_elevation = field_int(sentence, base + 1, &elevation);
+        bool has_azimuth = field_int(sentence, base + 2, &azimuth);
+        field_int(sentence, base + 3, &snr);
+        if (!has_prn || prn <= 0 || prn > 255) {
+            continue;
+        }
+        if (!has_elevation || elevation < 0 || elevation > 90 || !has_azimuth || azimuth < 0 || azimuth > 359) {
+            elevation = -1;
+            azimuth = 0;
+        }
+        if (snr < 0) {
+            snr = 0;
+        } else if (snr > 99) {
+            snr = 99;
+        }
+
+        gps_sky_sat_t *sat = find_sat((uint8_t)system, (uint8_t)prn);
+        if (!sat) {
+            if (g_count >= GPS_SKY_MAX_SATS) {
+                continue;
+            }
+            sat = &g_sats[g_count++];
+            memset(sat, 0, sizeof(*sat));
+            sat->system = (uint8_t)system;
+            sat->prn = (uint8_t)prn;
+            sat->elevation = -2;        // 保证首次出现时计为变化
+            sat->used = prn_bit(g_gsa.used[system], (uint8_t)prn);
+        }
+        if (sat->elevation != elevation || sat->azimuth != azimuth || sat->snr != snr) {
+            sat->elevation = (int8_t)elevation;
+            sat->azimuth = (uint16_t)azimuth;
+            sat->snr = (uint8_t)snr;
+            changed = true;
+        }
+        sat->cycle = cycle;
+    }
+
+    if (number == total && g_systems[system].in_cycle) {
+        g_systems[system].in_cycle = false;
+        changed = prune_system((uint8_t)system) || changed;
+    }
+    if (changed) {
+        g_generation++;
+    }
+    return true;
+}
+
+bool gps_sky_parse_gsa(const gps_nmea_sentence_t *sentence) {
+    // 模式,定位类型,12个PRN,PDOP,HDOP,VDOP(,系统ID)
+    if (!sentence || sentence->type != GPS_NMEA_GSA || sentence->field_count < 3) {
+        return false;
+    }
+
+    const char *talker = sentence->fields[0];
+    int system = -1;
+    int id = 0;
+    bool by_prn = false;
+    if (field_int(sentence, GSA_FIELD_SYSTEM_ID, &id)) {
+        system = gsa_system_id(id);
+    } else if (talker[0] == 'G' && talker[1] == 'N') {
+        by_prn = true;
+    } else {
+        system = talker_system(talker);
+    }
+
+    if (!g_gsa.open) {
+        memset(g_gsa.pending, 0, sizeof(g_gsa.pending));
+        g_gsa.open = true;
+    }
+
+    for (int i = GSA_FIELD_FIRST_PRN; i < GSA_FIELD_FIRST_PRN + 12; i++) {
+        int prn = 0;
+        if (!field_int(sentence, i, &prn) || prn <= 0 || prn > 255) {
+            continue;
+        }
+        int s = by_prn ? prn_system(prn) : system;
+        if (s >= 0) {
+            g_gsa.pending[s][prn >> 5] |= 1u << (prn & 31);
+        }
+    }
+    return true;
+}
+
+void gps_sky_commit_gsa(void) {
+    if (!g_gsa.open) {
+        return;
+    }
+    g_gsa.open = false;
+    g_gsa.known = true;
+    if (memcmp(g_gsa.used, g_gsa.pending, sizeof(g_gsa.used)) == 0) {
+        return;
+    }
+    memcpy(g_gsa.used, g_gsa.pending, sizeof(g_gsa.used));
+
+    bool changed = false;
+    for (uint8_t i = 0; i < g_count; i++) {
+        uint8_t used = prn_bit(g_gsa.used[g_sats[i].system], g_sats[i].prn);
+        if (g_sats[i].used != used) {
+            g_sats[i].used = used;
+            changed = true;
+        }
+    }
+    if (changed) {
+        g_generation++;
+    }
+}
+
+bool gps_sky_has_used(void) {
+    return g_gsa.known;
+}
+
+uint8_t gps_sky_used_count(uint8_t system) {
+    uint8_t first = system < GPS_SKY_SYSTEM_COUNT ? system : 0;
+    uint8_t last = system < GPS_SKY_SYSTEM_COUNT ? system : GPS_SKY_SYSTEM_COUNT - 1;
+    uint8_t count = 0;
+    for (uint8_t s = first; s <= last; s++) {
+        for (int w = 0; w < PRN_WORDS; w++) {
+            count += popcount32(g_gsa.used[s][w]);
+        }
+    }
+    return count;
+}
+
+bool gps_sky_is_used(uint8_t system, uint8_t prn) {
+    return system < GPS_SKY_SYSTEM_COUNT && prn_bit(g_gsa.used[system], prn);
+}
+
+uint8_t gps_sky_count(void) {
+    return g_count;
+}
+
+const gps_sky_sat_t *gps_sky_sats(void) {
+    return g_sats;
+}
+
+uint8_t gps_sky_tracked(void) {
+    uint8_t tracked = 0;
+    for (uint8_t i = 0; i < g_count; i++) {
+        tracked += g_sats[i].snr > 0 ? 1 : 0;
+    }
+    return tracked;
+}
+
+float gps_sky_mean_snr(void) {
+    uint32_t sum = 0;
+    uint8_t tracked = 0;
+    for (uint8_t i = 0; i < g_count; i++) {
+        if (g_sats[i].snr > 0) {
+            sum += g_sats[i].snr;
+            tracked++;
+        }
+    }
+    return tracked ? (float)sum / tracked : 0.0f;
+}
+
+uint32_t gps_sky_generation(void) {
+    return g_generation;
+}
@@ -0,0 +1,295 @@
+/**
+ * @file gps_telemetry.c
+ * @brief 实时定位遥测实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "gps/gps_telemetry.h"
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static gps_telemetry_write_t g_write = NULL;
+static void *g_write_ctx = NULL;
+static uint16_t g_seq = 0;
+static gps_telemetry_stats_t g_stats;
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline uint32_t now_us(void) {
+    return (uint32_t)to_us_since_boot(get_absolute_time());
+}
+
+static inline void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void serialize_fix(const gps_telemetry_fix_t *record, uint8_t *p) {
+    const gps_fix_t *fix = &record->fix;
+    put_u32(p + 0, (uint32_t)fix->lat_e7);
+    put_u32(p + 4, (uint32_t)fix->lon_e7);
+    put_u32(p + 8, (uint32_t)fix->alt_cm);
+    put_u16(p + 12, fix->speed_cms);
+    put_u16(p + 14, fix->course_cdeg);
+    put_u32(p + 16, fix->utc_ms);
+    put_u16(p + 20, fix->utc_date);
+    p[22] = fix->flags;
+    p[23] = fix->quality;
+    p[24] = fix->satellites;
+    p[25] = (uint8_t)fix->mode;
+    put_u16(p + 26, fix->hdop_c);
+    put_u16(p + 28, fix->pdop_c);
+    put_u16(p + 30, fix->vdop_c);
+    put_u32(p + 32, record->device_time_us);
+    put_u32(p + 36, record->latency_us);
+}
+
+static void deserialize_fix(const uint8_t *p, gps_telemetry_fix_t *record) {
+    gps_fix_t *fix = &record->fix;
+    fix->lat_e7 = (int32_t)get_u32(p + 0);
+    fix->lon_e7 = (int32_t)get_u32(p + 4);
+    fix->alt_cm = (int32_t)get_u32(p + 8);
+    fix->speed_cms = get_u16(p + 12);
+    fix->course_cdeg = get_u16(p + 14);
+    fix->utc_ms = get_u32(p + 16);
+    fix->utc_date = get_u16(p + 20);
+    fix->flags = p[22];
+    fix->quality = p[23];
+    fix->satellites = p[24];
+    fix->mode = (char)p[25];
+    fix->hdop_c = get_u16(p + 26);
+    fix->pdop_c = get_u16(p + 28);
+    fix->vdop_c = get_u16(p + 30);
+    record->device_time_us = get_u32(p + 32);
+    record->latency_us = get_u32(p + 36);
+}
+
+/**
+ * @brief COBS编码，输出不含0x00
+ * @return 编码后的字节数
+ */
+static uint32_t cobs_encode(const uint8_t *in, uint32_t length, uint8_t *out) {
+    uint32_t code_index = 0;
+    uint32_t out_index = 1;
+    uint8_t code = 1;
+
+    for (uint32_t i = 0; i < length; i++) {
+        if (in[i] == 0) {
+            out[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+            continue;
+        }
+        out[out_index++] = in[i];
+        if (++code == 0xFF) {
+            out[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+        }
+    }
+    out[code_index] = code;
+    return out_index;
+}
+
+/**
+ * @brief COBS解码
+ * @return 解码后的字节数，格式错误或超过max时返回0
+ */
+static uint32_t cobs_decode(const uint8_t *in, uint32_t length, uint8_t *out, uint32_t max) {
+    uint32_t i = 0;
+    uint32_t o = 0;
+
+    while (i < length) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > length || o + code - 1 > max) {
+            return 0;
+        }
+        memcpy(out + o, in + i, code - 1);
+        o += code - 1;
+        i += code - 1;
+        if (code < 0xFF && i < length) {
+            if (o >= max) {
+                return 0;
+            }
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+static bool decode_frame(gps_telemetry_decoder_t *decoder, gps_telemetry_fix_t *fix, uint16_t *seq) {
+    uint8_t raw[GPS_TELEMETRY_FRAME_SIZE + 1];
+    uint32_t length = cobs_decode(decoder->buffer, decoder->length, raw, sizeof(raw));
+    if (length != GPS_TELEMETRY_FRAME_SIZE) {
+        // 帧间的调试文本或截断的帧
+        decoder->junk_bytes += decoder->length;
+        return false;
+    }
+    if (raw[0] != GPS_TELEMETRY_FIX ||
+        gps_telemetry_crc16(raw, GPS_TELEMETRY_FRAME_SIZE - 2) != get_u16(raw + GPS_TELEMETRY_FRAME_SIZE - 2)) {
+        decoder->bad_frames++;
+        return false;
+    }
+
+    uint16_t frame_seq = get_u16(raw + 1);
+    if (decoder->have_seq) {
+        uint16_t gap = (uint16_t)(frame_seq - decoder->last_seq - 1);
+        // 序号回退视为设备重启，不计丢帧
+        if (gap < 0x8000) {
+            decoder->lost += gap;
+        }
+    }
+    decoder->have_seq = true;
+    decoder->last_seq = frame_seq;
+    decoder->frames++;
+
+    deserialize_fix(raw + 3, fix);
+    if (seq) {
+        *seq = frame_seq;
+    }
+    return true;
+}
+
+// =============================================================================
+// 设备端接口
+// =============================================================================
+
+void gps_telemetry_init(gps_telemetry_write_t write, void *ctx) {
+    g_write = write;
+    g_write_ctx = ctx;
+    g_seq = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+void gps_telemetry_send_fix(const gps_fix_t *fix, uint32_t since_us) {
+    if (!g_write || !fix) {
+        return;
+    }
+
+    gps_telemetry_fix_t record;
+    record.fix = *fix;
+
+    uint8_t frame[GPS_TELEMETRY_MAX_ENCODED];
+    uint32_t start = now_us();
+    record.device_time_us = start;
+    record.latency_us = since_us != 0 ? start - since_us : 0;
+    uint32_t length = gps_telemetry_encode_fix(&record, g_seq++, frame);
+    g_write(g_write_ctx, frame, length);
+    uint32_t write_us = now_us() - start;
+
+    g_stats.frames++;
+    g_stats.bytes += length;
+    g_stats.latency_sum_us += record.latency_us;
+    if (record.latency_us > g_stats.latency_max_us) {
+        g_stats.latency_max_us = record.latency_us;
+    }
+    if (write_us > g_stats.write_max_us) {
+        g_stats.write_max_us = write_us;
+    }
+}
+
+void gps_telemetry_get_stats(gps_telemetry_stats_t *stats) {
+    if (stats) {
+        *stats = g_stats;
+    }
+}
+
+void gps_telemetry_print_stats(void) {
+    gps_telemetry_stats_t s;
+    gps_telemetry_get_stats(&s);
+    printf("[遥测] 发送 %lu帧 %lu字节，设备内延迟 平均%lu us 最大%lu us，写入最长 %lu us\n",
+           (unsigned long)s.frames, (unsigned long)s.bytes,
+           (unsigned long)(s.frames > 0 ? s.latency_sum_us / s.frames : 0),
+           (unsigned long)s.latency_max_us, (unsigned long)s.write_max_us);
+}
+
+// =============================================================================
+// 编解码
+// =============================================================================
+
+uint32_t gps_telemetry_encode_fix(const gps_telemetry_fix_t *fix, uint16_t seq, uint8_t *out) {
+    uint8_t raw[GPS_TELEMETRY_FRAME_SIZE];
+    raw[0] = GPS_TELEMETRY_FIX;
+    put_u16(raw + 1, seq);
+    serialize_fix(fix, raw + 3);
+    put_u16(raw + GPS_TELEMETRY_FRAME_SIZE - 2, gps_telemetry_crc16(raw, GPS_TELEMETRY_FRAME_SIZE - 2));
+
+    // 前导分隔符结束帧前可能残留的调试文本
+    out[0] = 0;
+    uint32_t length = 1 + cobs_encode(raw, sizeof(raw), out + 1);
+    out[length++] = 0;
+    return length;
+}
+
+void gps_telemetry_decoder_reset(gps_telemetry_decoder_t *decoder) {
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+bool gps_telemetry_decoder_feed(gps_telemetry_decoder_t *decoder, const uint8_t *data, uint32_t length,
+                                uint32_t *consumed, gps_telemetry_fix_t *fix, uint16_t *seq) {
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t byte = data[i];
+        if (byte != 0) {
+            if (decoder->length < sizeof(decoder->buffer)) {
+                decoder->buffer[decoder->length++] = byte;
+            } else {
+                decoder->overflow = true;
+                decoder->junk_bytes++;
+            }
+            continue;
+        }
+
+        bool decoded = false;
+        if (decoder->overflow) {
+            decoder->junk_bytes += decoder->length;
+        } else if (decoder->length > 0) {
+            decoded = decode_frame(decoder, fix, seq);
+        }
+        decoder->length = 0;
+        decoder->overflow = false;
+        if (decoded) {
+            if (consumed) {
+                *consumed = i + 1;
+            }
+            return true;
+        }
+    }
+
+    if (consumed) {
+        *consumed = length;
+    }
+    return false;
+}
+
+uint16_t gps_telemetry_crc16(const uint8_t *data, uint32_t length) {
+    uint16_t crc = 0xFFFF;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,20 @@
+/**
+ * @file gps_telemetry_usb.c
+ * @brief 定位遥测的USB CDC写函数
+ *
+ * 与printf使用同一个stdio_usb驱动和互斥锁。写完立即flush，不等下一次
+ * tud_task把不满一包的数据发出，帧在本次调用内交给USB控制器。
+ */
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "pico/stdio/driver.h"
+#include "gps/gps_telemetry.h"
+
+void gps_telemetry_usb_write(void *ctx, const uint8_t *data, uint32_t length) {
+    (void)ctx;
+    stdio_usb.out_chars((const char *)data, (int)length);
+    if (stdio_usb.out_flush) {
+        stdio_usb.out_flush();
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * @file gps_track.c
+ * @brief 轨迹存储实现
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "gps/gps_track.h"
+
+#define DM_PER_DEG_LAT 1113200.0
+#define DEG_TO_RAD     0.017453292519943295
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static gps_track_point_t g_points[GPS_TRACK_MAX_POINTS];
+static uint32_t g_count = 0;
+static uint32_t g_appended = 0;
+static uint32_t g_step_dm = GPS_TRACK_MIN_STEP_DM;
+
+static struct {
+    bool valid;
+    double lat;
+    double lon;
+    double dm_per_deg_lon;
+} g_origin;
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+/**
+ * @brief 隔点删除，保留起点和最新点
+ */
+static void decimate(void) {
+    uint32_t last = g_count - 1;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < last; i += 2) {
+        g_points[kept++] = g_points[i];
+    }
+    g_points[kept++] = g_points[last];
+    g_count = kept;
+    g_step_dm *= 2;
+    printf("[轨迹] 抽稀至%lu点，步长%.1fm\n", (unsigned long)g_count, g_step_dm / 10.0);
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void gps_track_clear(void) {
+    g_count = 0;
+    g_appended = 0;
+    g_step_dm = GPS_TRACK_MIN_STEP_DM;
+    memset(&g_origin, 0, sizeof(g_origin));
+}
+
+bool gps_track_update(const gps_fix_t *fix) {
+    if (!fix || !gps_fix_is_valid(fix)) {
+        return false;
+    }
+
+    const double lat = fix->lat_e7 * 1e-7;
+    const double lon = fix->lon_e7 * 1e-7;
+    if (!g_origin.valid) {
+        g_origin.valid = true;
+        g_origin.lat = lat;
+        g_origin.lon = lon;
+        g_origin.dm_per_deg_lon = DM_PER_DEG_LAT * cos(lat * DEG_TO_RAD);
+    }
+
+    gps_track_point_t point;
+    gps_track_project(lat, lon, &point);
+
+    if (g_count > 0) {
+        const gps_track_point_t *last = &g_points[g_count - 1];
+        int64_t de = (int64_t)point.e_dm - last->e_dm;
+        int64_t dn = (int64_t)point.n_dm - last->n_dm;
+        if (de * de + dn * dn < (int64_t)g_step_dm * g_step_dm) {
+            return false;
+        }
+    }
+
+    if (g_count == GPS_TRACK_MAX_POINTS) {
+        decimate();
+    }
+    g_points[g_count++] = point;
+    g_appended++;
+    return true;
+}
+
+uint32_t gps_track_count(void) {
+    return g_count;
+}
+
+const gps_track_point_t *gps_track_points(void) {
+    return g_points;
+}
+
+uint32_t gps_track_appended(void) {
+    return g_appended;
+}
+
+uint32_t gps_track_step_dm(void) {
+    return g_step_dm;
+}
+
+bool gps_track_project(double lat, double lon, gps_track_point_t *point) {
+    if (!g_origin.valid || !point) {
+        return false;
+    }
+    point->e_dm = (int32_t)lround((lon - g_origin.lon) * g_origin.dm_per_deg_lon);
+    point->n_dm = (int32_t)lround((lat - g_origin.lat) * DM_PER_DEG_LAT);
+    return true;
+}
@@ -0,0 +1,238 @@
+/**
+ * @file gps_trip.c
+ * @brief 行程统计实现
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "gps/gps_flash_log.h"
+#include "gps/gps_trip.h"
+
+_Static_assert(sizeof(gps_trip_record_t) == 64, "gps_trip_record_t必须为64字节");
+_Static_assert(FLASH_PAGE_SIZE % sizeof(gps_trip_record_t) == 0, "记录不能跨页");
+_Static_assert(offsetof(gps_trip_record_t, seq) == offsetof(gps_flash_log_header_t, seq), "记录头须与gps_flash_log_header_t一致");
+_Static_assert(offsetof(gps_trip_record_t, crc) == sizeof(gps_trip_record_t) - 4, "CRC须位于记录末尾");
+_Static_assert(GPS_TRIP_FLASH_OFFSET + GPS_TRIP_SECTORS * FLASH_SECTOR_SIZE <= GPS_WARM_START_FLASH_OFFSET ||
+               GPS_TRIP_FLASH_OFFSET >= GPS_WARM_START_FLASH_OFFSET + GPS_WARM_START_SECTORS * FLASH_SECTOR_SIZE,
+               "行程区与启动状态区重叠");
+
+#define METERS_PER_DEG_LAT 111320.0
+#define DEG_TO_RAD         0.017453292519943295
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static gps_trip_t g_odometer;
+static gps_trip_t g_trips[GPS_TRIP_COUNT];
+
+static struct {
+    bool have_fix;              // 连续段内有上一个定位
+    uint32_t fix_ms;
+    bool have_anchor;           // 有上一个累计点
+    double anchor_lat;
+    double anchor_lon;
+} g_track;
+
+static gps_trip_record_t g_record;
+static gps_flash_log_t g_log = {
+    .flash_offset = GPS_TRIP_FLASH_OFFSET,
+    .sectors = GPS_TRIP_SECTORS,
+    .record_size = sizeof(gps_trip_record_t),
+    .magic = GPS_TRIP_MAGIC,
+    .version = GPS_TRIP_VERSION,
+    .latest_slot = -1,
+    .next_slot = 0
+};
+static bool g_dirty = false;
+static uint32_t g_last_save_ms = 0;
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+/**
+ * @brief 两点距离（米），等距圆柱投影
+ */
+static double segment_m(double lat1, double lon1, double lat2, double lon2) {
+    double dn = (lat2 - lat1) * METERS_PER_DEG_LAT;
+    double de = (lon2 - lon1) * METERS_PER_DEG_LAT * cos((lat1 + lat2) * 0.5 * DEG_TO_RAD);
+    return sqrt(dn * dn + de * de);
+}
+
+static void accumulate(gps_trip_t *trip, double distance_m, uint32_t dt_ms, bool moving,
+                       float speed_kmh, bool speed_trusted) {
+    trip->distance_m += distance_m;
+    trip->elapsed_ms += dt_ms;
+    if (moving) {
+        trip->moving_ms += dt_ms;
+    }
+    if (speed_trusted && speed_kmh > trip->max_speed_kmh) {
+        trip->max_speed_kmh = speed_kmh;
+    }
+}
+
+static void record_from_state(void) {
+    g_record.odometer_dm = (uint32_t)(g_odometer.distance_m * 10.0);
+    g_record.odometer_moving_s = (uint32_t)(g_odometer.moving_ms / 1000u);
+    for (int i = 0; i < GPS_TRIP_COUNT; i++) {
+        g_record.trips[i].distance_dm = (uint32_t)(g_trips[i].distance_m * 10.0);
+        g_record.trips[i].moving_s = (uint32_t)(g_trips[i].moving_ms / 1000u);
+        g_record.trips[i].elapsed_s = (uint32_t)(g_trips[i].elapsed_ms / 1000u);
+        g_record.trips[i].max_speed_dkmh = (uint16_t)fminf(g_trips[i].max_speed_kmh * 10.0f, 65535.0f);
+        g_record.trips[i].start_utc = g_trips[i].start_utc;
+    }
+}
+
+static void state_from_record(void) {
+    memset(&g_odometer, 0, sizeof(g_odometer));
+    g_odometer.distance_m = g_record.odometer_dm / 10.0;
+    g_odometer.moving_ms = (uint64_t)g_record.odometer_moving_s * 1000u;
+    for (int i = 0; i < GPS_TRIP_COUNT; i++) {
+        g_trips[i].distance_m = g_record.trips[i].distance_dm / 10.0;
+        g_trips[i].moving_ms = (uint64_t)g_record.trips[i].moving_s * 1000u;
+        g_trips[i].elapsed_ms = (uint64_t)g_record.trips[i].elapsed_s * 1000u;
+        g_trips[i].max_speed_kmh = g_record.trips[i].max_speed_dkmh / 10.0f;
+        g_trips[i].start_utc = g_record.trips[i].start_utc;
+    }
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+bool gps_trip_init(void) {
+    memset(&g_odometer, 0, sizeof(g_odometer));
+    memset(g_trips, 0, sizeof(g_trips));
+    memset(&g_track, 0, sizeof(g_track));
+    memset(&g_record, 0, sizeof(g_record));
+    g_dirty = false;
+    g_last_save_ms = to_ms_since_boot(get_absolute_time());
+
+    if (!gps_flash_log_load(&g_log, &g_record)) {
+        memset(&g_record, 0, sizeof(g_record));
+        printf("[行程] 无保存的里程记录\n");
+        return false;
+    }
+    state_from_record();
+
+    char summary[256];
+    gps_trip_format_summary(summary, sizeof(summary));
+    printf("[行程] 载入: %s\n", summary);
+    return true;
+}
+
+void gps_trip_update(const gps_fix_t *fix, uint32_t fix_ms) {
+    if (!fix || !gps_fix_is_valid(fix)) {
+        // 失锁：失锁期间不计时间；保留累计点，恢复后按直线距离补上失锁段
+        g_track.have_fix = false;
+        return;
+    }
+
+    float speed = gps_fix_speed_kmh(fix);
+    float hdop = fix->hdop_c * 0.01f;                   // 0表示未收到GGA
+    const double lat = fix->lat_e7 * 1e-7;
+    const double lon = fix->lon_e7 * 1e-7;
+    bool hdop_ok = hdop <= GPS_TRIP_MAX_HDOP;
+    bool moving = speed >= GPS_TRIP_MIN_SPEED_KMH;
+
+    uint32_t dt = 0;
+    if (g_track.have_fix) {
+        dt = fix_ms - g_track.fix_ms;
+        if (dt > GPS_TRIP_MAX_GAP_MS) {
+            dt = 0;
+        }
+    }
+    g_track.have_fix = true;
+    g_track.fix_ms = fix_ms;
+
+    double distance = 0;
+    if (!g_track.have_anchor) {
+        g_track.have_anchor = hdop_ok;
+        g_track.anchor_lat = lat;
+        g_track.anchor_lon = lon;
+    } else if (hdop_ok) {
+        double d = segment_m(g_track.anchor_lat, g_track.anchor_lon, lat, lon);
+        float jitter_m = (hdop > 1.0f ? hdop : 1.0f) * GPS_TRIP_JITTER_M_PER_HDOP;
+        if (moving || d > jitter_m) {
+            // 只在确认移动时推进累计点，静止漂移留在门限内不计入
+            distance = d;
+            g_track.anchor_lat = lat;
+            g_track.anchor_lon = lon;
+        }
+    }
+
+    if (dt == 0 && distance == 0) {
+        return;
+    }
+    accumulate(&g_odometer, distance, dt, moving, speed, hdop_ok);
+    for (int i = 0; i < GPS_TRIP_COUNT; i++) {
+        accumulate(&g_trips[i], distance, dt, moving, speed, hdop_ok);
+    }
+    if (distance > 0) {
+        g_dirty = true;
+    }
+
+    if (g_dirty && fix_ms - g_last_save_ms >= GPS_TRIP_SAVE_INTERVAL_MS) {
+        gps_trip_save();
+    }
+}
+
+const gps_trip_t *gps_trip_get(int index) {
+    if (index < 0 || index >= GPS_TRIP_COUNT) {
+        return NULL;
+    }
+    return &g_trips[index];
+}
+
+const gps_trip_t *gps_trip_odometer(void) {
+    return &g_odometer;
+}
+
+float gps_trip_avg_speed_kmh(const gps_trip_t *trip) {
+    if (!trip || trip->moving_ms == 0) {
+        return 0.0f;
+    }
+    return (float)(trip->distance_m * 3600.0 / (double)trip->moving_ms);
+}
+
+void gps_trip_reset(int index, uint32_t utc_now) {
+    if (index < 0 || index >= GPS_TRIP_COUNT) {
+        return;
+    }
+    memset(&g_trips[index], 0, sizeof(g_trips[index]));
+    g_trips[index].start_utc = utc_now;
+    g_dirty = true;
+    printf("[行程] 行程%c已清零\n", 'A' + index);
+}
+
+bool gps_trip_save(void) {
+    g_last_save_ms = to_ms_since_boot(get_absolute_time());
+    record_from_state();
+    if (!gps_flash_log_append(&g_log, &g_record)) {
+        printf("[行程] 里程写入校验失败\n");
+        return false;
+    }
+    g_dirty = false;
+    return true;
+}
+
+int gps_trip_format_summary(char *buf, size_t len) {
+    if (!buf || len == 0) {
+        return 0;
+    }
+    int n = snprintf(buf, len, "总里程 %.1fkm", g_odometer.distance_m / 1000.0);
+    for (int i = 0; i < GPS_TRIP_COUNT && n > 0 && (size_t)n < len; i++) {
+        const gps_trip_t *trip = &g_trips[i];
+        n += snprintf(buf + n, len - (size_t)n, " 行程%c %.2fkm 运动%lu:%02lu 平均%.1f 最高%.1fkm/h",
+                      'A' + i, trip->distance_m / 1000.0,
+                      (unsigned long)(trip->moving_ms / 3600000u),
+                      (unsigned long)(trip->moving_ms / 60000u % 60u),
+                      gps_trip_avg_speed_kmh(trip), trip->max_speed_kmh);
+    }
+    return (n > 0 && (size_t)n < len) ? n : (int)strlen(buf);
+}
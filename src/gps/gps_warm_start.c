@@ -0,0 +1,321 @@
+/**
+ * @file gps_warm_start.c
+ * @brief GPS热/温启动状态持久化实现
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "hardware/flash.h"
+#include "gps/gps_flash_log.h"
+#include "gps/gps_warm_start.h"
+
+_Static_assert(sizeof(gps_warm_start_record_t) == 64, "gps_warm_start_record_t必须为64字节");
+_Static_assert(FLASH_PAGE_SIZE % sizeof(gps_warm_start_record_t) == 0, "记录不能跨页");
+_Static_assert(GPS_WARM_START_SECTORS >= 2, "至少需要两个扇区轮换");
+_Static_assert(offsetof(gps_warm_start_record_t, seq) == offsetof(gps_flash_log_header_t, seq), "记录头须与gps_flash_log_header_t一致");
+_Static_assert(offsetof(gps_warm_start_record_t, crc) == sizeof(gps_warm_start_record_t) - 4, "CRC须位于记录末尾");
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static gps_warm_start_record_t g_record;
+static bool g_have_record = false;       // g_record内容有效（来自Flash或本次运行）
+static gps_flash_log_t g_log = {
+    .flash_offset = GPS_WARM_START_FLASH_OFFSET,
+    .sectors = GPS_WARM_START_SECTORS,
+    .record_size = sizeof(gps_warm_start_record_t),
+    .magic = GPS_WARM_START_MAGIC,
+    .version = GPS_WARM_START_VERSION,
+    .latest_slot = -1,
+    .next_slot = 0
+};
+
+static gps_start_type_t g_boot_type = GPS_START_COLD;
+static uint32_t g_boot_ms = 0;
+static bool g_boot_pending = false;      // 已发送启动命令，等待首次定位
+static uint32_t g_last_save_ms = 0;
+
+static const char *const g_type_names[GPS_START_TYPE_COUNT] = {"热启动", "温启动", "冷启动", "辅助冷启动"};
+static const char g_pair_ids[GPS_START_TYPE_COUNT][4] = {"004", "005", "007", "007"};
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static inline uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void default_config(gps_receiver_config_t *config) {
+    memset(config, 0, sizeof(*config));
+    config->fix_interval_ms = 1000;
+    config->nmea_rates[1] = 1;  // RMC
+    config->nmea_rates[3] = 1;  // GGA
+}
+
+/**
+ * @brief 发送带校验和的NMEA命令，expect_rsp非NULL时等待应答
+ */
+static bool send_sentence(const char *body, const char *expect_rsp, const char *expect_id) {
+    char command[96];
+    int len = snprintf(command, sizeof(command), "$%s*%02X\r\n",
+                       body, (unsigned)lc76g_get_command_checksum(body, (int32_t)strlen(body)));
+    if (len <= 0 || len >= (int)sizeof(command)) {
+        return false;
+    }
+    if (!expect_rsp) {
+        return lc76g_send_command(command, len);
+    }
+
+    Ql_gnss_command_contx_TypeDef info;
+    memset(&info, 0, sizeof(info));
+    if (!lc76g_send_command_and_get_response(command, expect_rsp, 1000, &info)) {
+        return false;
+    }
+    // $PAIR001,<命令ID>,<结果>
+    return info.param_num >= 3 && strcmp(info.param[1], expect_id) == 0 && atoi(info.param[2]) == 0;
+}
+
+static bool send_pair(const char *id, const char *params) {
+    char body[64];
+    if (params) {
+        snprintf(body, sizeof(body), "PAIR%s,%s", id, params);
+    } else {
+        snprintf(body, sizeof(body), "PAIR%s", id);
+    }
+    return send_sentence(body, "$PAIR001", id);
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+bool gps_warm_start_init(void) {
+    g_boot_pending = false;
+    memset(&g_record, 0, sizeof(g_record));
+    g_have_record = gps_flash_log_load(&g_log, &g_record);
+
+    if (!g_have_record) {
+        memset(&g_record, 0, sizeof(g_record));
+        printf("[GPS启动] Flash中没有启动状态记录\n");
+        return false;
+    }
+
+    printf("[GPS启动] 载入启动状态记录 #%lu (槽位 %ld)%s\n",
+           (unsigned long)g_record.seq, (long)gps_flash_log_latest_slot(&g_log),
+           (g_record.flags & GPS_WARM_START_FLAG_SHUTDOWN) ? "，上次正常关机" : "");
+    if (g_record.flags & GPS_WARM_START_FLAG_FIX) {
+        printf("[GPS启动] 最后定位: %.6f, %.6f, 海拔 %.1fm, UTC %lu\n",
+               g_record.lat_e7 / 1e7, g_record.lon_e7 / 1e7, g_record.alt_dm / 10.0,
+               (unsigned long)g_record.fix_utc);
+    }
+    return true;
+}
+
+const gps_warm_start_record_t *gps_warm_start_record(void) {
+    return g_have_record ? &g_record : NULL;
+}
+
+gps_start_type_t gps_warm_start_select(uint32_t utc_now, uint32_t *off_seconds) {
+    if (off_seconds) {
+        *off_seconds = 0;
+    }
+    // 接收机RTC和备份数据由同一备用电源维持，时间未知说明星历/历书也已丢失
+    if (!g_have_record || !(g_record.flags & GPS_WARM_START_FLAG_FIX) || utc_now == 0 ||
+        utc_now < g_record.fix_utc) {
+        return GPS_START_COLD;
+    }
+
+    uint32_t off = utc_now - g_record.fix_utc;
+    if (off_seconds) {
+        *off_seconds = off;
+    }
+    if (off < GPS_WARM_START_HOT_MAX_S) {
+        return GPS_START_HOT;
+    }
+    if (off < GPS_WARM_START_WARM_MAX_S) {
+        return GPS_START_WARM;
+    }
+    return GPS_START_COLD;
+}
+
+bool gps_warm_start_boot(uint32_t utc_now) {
+    uint32_t off = 0;
+    gps_start_type_t type = gps_warm_start_select(utc_now, &off);
+
+    if (utc_now == 0) {
+        printf("[GPS启动] 当前时间未知\n");
+    } else if (g_have_record && (g_record.flags & GPS_WARM_START_FLAG_FIX)) {
+        printf("[GPS启动] 距最后定位: %lu秒 (%.1f小时)\n", (unsigned long)off, off / 3600.0f);
+    }
+
+    // 热/温启动依赖接收机时间，先把本次判断所用的UTC写回RTC
+    if (type != GPS_START_COLD) {
+        char params[16];
+        snprintf(params, sizeof(params), "%lu", (unsigned long)utc_now);
+        if (!send_pair("009", params)) {
+            printf("[GPS启动] RTC时间回写无应答\n");
+        }
+    }
+
+    printf("[GPS启动] 执行%s\n", g_type_names[type]);
+    bool ok = send_pair(g_pair_ids[type], NULL);
+    if (!ok) {
+        printf("[GPS启动] %s命令无应答\n", g_type_names[type]);
+    }
+
+    g_boot_type = type;
+    g_boot_ms = now_ms();
+    g_boot_pending = true;
+    return ok;
+}
+
+gps_start_type_t gps_warm_start_boot_type(void) {
+    return g_boot_type;
+}
+
+void gps_warm_start_mark_assisted(void) {
+    if (g_boot_type == GPS_START_COLD) {
+        g_boot_type = GPS_START_COLD_ASSISTED;
+    }
+}
+
+bool gps_warm_start_apply_config(const gps_receiver_config_t *config) {
+    if (!config) {
+        return false;
+    }
+
+    char body[80];
+    const uint8_t *r = config->nmea_rates;
+    snprintf(body, sizeof(body), "PMTK314,%u,%u,%u,%u,%u,%u,0,0,0,0,0,0,0,0,0,0,0,0,0",
+             r[0], r[1], r[2], r[3], r[4], r[5]);
+    bool ok = send_sentence(body, NULL, NULL);
+    sleep_ms(100);
+
+    snprintf(body, sizeof(body), "PMTK220,%u", config->fix_interval_ms);
+    ok = send_sentence(body, NULL, NULL) && ok;
+
+    if (!g_have_record) {
+        memset(&g_record, 0, sizeof(g_record));
+        g_have_record = true;
+    }
+    g_record.config = *config;
+    g_record.flags |= GPS_WARM_START_FLAG_CONFIG;
+    return ok;
+}
+
+bool gps_warm_start_get_config(gps_receiver_config_t *config) {
+    if (!config) {
+        return false;
+    }
+    if (g_have_record && (g_record.flags & GPS_WARM_START_FLAG_CONFIG)) {
+        *config = g_record.config;
+        return true;
+    }
+    default_config(config);
+    return false;
+}
+
+void gps_warm_start_update(const gps_fix_t *fix) {
+    if (!fix || !gps_fix_is_valid(fix) || (abs(fix->lat_e7) < 1000 && abs(fix->lon_e7) < 1000)) {
+        return;
+    }
+
+    uint32_t utc = 0;
+    if (!lc76g_get_utc_time(&utc)) {
+        return;
+    }
+
+    if (!g_have_record) {
+        memset(&g_record, 0, sizeof(g_record));
+        g_have_record = true;
+    }
+    g_record.fix_utc = utc;
+    g_record.lat_e7 = fix->lat_e7;
+    g_record.lon_e7 = fix->lon_e7;
+    g_record.alt_dm = (fix->alt_cm + (fix->alt_cm < 0 ? -5 : 5)) / 10;
+    g_record.flags |= GPS_WARM_START_FLAG_FIX;
+
+    uint32_t now = now_ms();
+    if (g_boot_pending) {
+        g_boot_pending = false;
+        uint32_t ttff_ms = now - g_boot_ms;
+        uint32_t ttff_ds = (ttff_ms + 50) / 100;
+        if (ttff_ds > UINT16_MAX) {
+            ttff_ds = UINT16_MAX;
+        }
+        g_record.ttff_last_ds[g_boot_type] = (uint16_t)ttff_ds;
+        if (g_record.ttff_count[g_boot_type] < UINT16_MAX) {
+            g_record.ttff_count[g_boot_type]++;
+        }
+        // 前16次为算术平均，之后为1/16权重的滑动平均
+        int32_t weight = g_record.ttff_count[g_boot_type] < 16 ? g_record.ttff_count[g_boot_type] : 16;
+        int32_t avg = g_record.ttff_avg_ds[g_boot_type];
+        g_record.ttff_avg_ds[g_boot_type] = (uint16_t)(avg + ((int32_t)ttff_ds - avg) / weight);
+        printf("[GPS启动] %s首次定位: %.1f秒\n", g_type_names[g_boot_type], ttff_ms / 1000.0f);
+        gps_warm_start_save(false);
+        return;
+    }
+
+    if (now - g_last_save_ms >= GPS_WARM_START_SAVE_INTERVAL_MS) {
+        gps_warm_start_save(false);
+    }
+}
+
+bool gps_warm_start_save(bool shutdown) {
+    if (!g_have_record) {
+        return false;
+    }
+
+    if (shutdown) {
+        g_record.flags |= GPS_WARM_START_FLAG_SHUTDOWN;
+    } else {
+        g_record.flags &= (uint16_t)~GPS_WARM_START_FLAG_SHUTDOWN;
+    }
+
+    bool ok = gps_flash_log_append(&g_log, &g_record);
+    g_last_save_ms = now_ms();
+    if (!ok) {
+        printf("[GPS启动] 启动状态写入校验失败\n");
+    }
+    return ok;
+}
+
+bool gps_warm_start_get_ttff(gps_start_type_t type, uint32_t *last_ms, uint32_t *avg_ms, uint32_t *count) {
+    if (type >= GPS_START_TYPE_COUNT || !g_have_record || g_record.ttff_count[type] == 0) {
+        return false;
+    }
+    if (last_ms) {
+        *last_ms = g_record.ttff_last_ds[type] * 100u;
+    }
+    if (avg_ms) {
+        *avg_ms = g_record.ttff_avg_ds[type] * 100u;
+    }
+    if (count) {
+        *count = g_record.ttff_count[type];
+    }
+    return true;
+}
+
+void gps_warm_start_print_stats(void) {
+    printf("[GPS启动] TTFF统计:\n");
+    for (int type = 0; type < GPS_START_TYPE_COUNT; type++) {
+        uint32_t last_ms = 0, avg_ms = 0, count = 0;
+        if (gps_warm_start_get_ttff((gps_start_type_t)type, &last_ms, &avg_ms, &count)) {
+            printf("  %s: 最近 %.1f秒, 平均 %.1f秒 (%lu次)\n", g_type_names[type],
+                   last_ms / 1000.0f, avg_ms / 1000.0f, (unsigned long)count);
+        } else {
+            printf("  %s: 无记录\n", g_type_names[type]);
+        }
+    }
+}
+
+const char *gps_warm_start_type_name(gps_start_type_t type) {
+    return type < GPS_START_TYPE_COUNT ? g_type_names[type] : "未知";
+}
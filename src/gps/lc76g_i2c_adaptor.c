@@ -6,13 +6,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
 #include "pico/stdlib.h"
+#include "pico/platform.h"
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
 #include "pico/time.h"
 #include "pico/mutex.h"
 #include "gps/lc76g_i2c_adaptor.h"
+#include "gps/lc76g_i2c_xfer.h"
+#include "gps/gps_sky.h"
+#include "gps/gps_nmea.h"
 
 // =============================================================================
 // 全局变量
@@ -36,14 +39,54 @@ static Ql_GNSS_Command_TypeDef g_command_deal = {0};
 static mutex_t g_i2c_mutex;
 static mutex_t g_write_cmd_mutex;
 
-// GPS数据
-static LC76G_GPS_Data g_gps_data = {0};
+// 模块接收缓冲持续无空闲空间时放弃写入的时间
+#define WRITE_STALL_TIMEOUT_MS 2000
 
-// 坐标转换常量
-static const double pi = 3.14159265358979324;
-static const double a = 6378245.0;
-static const double ee = 0.00669342162296594323;
-static const double x_pi = 3.14159265358979324 * 3000.0 / 180.0;
+// 一次读取中最多排队的历元数（遥测轮询时每次读取通常只有1-2个），超出的不调用钩子
+#define EPOCH_QUEUE_LEN 8
+
+// 最近一次解析的定位（各语句只更新自己带有的字段）
+static gps_fix_t g_fix = {0};
+static gps_nmea_stats_t g_nmea_stats = {0};
+
+// 最近一次RMC中的UTC时间（无定位时模块RTC有效也会输出）
+static uint32_t g_utc_seconds = 0;
+static uint32_t g_utc_update_ms = 0;
+
+// 最近一次收到NMEA数据的时刻
+static uint32_t g_rx_time_us = 0;
+
+// 读空模块缓冲时读取长度寄存器的时刻：之后才输出的语句留在缓冲中，
+// 下一次读取到的历元不早于这一时刻可用（遥测延迟的起点）
+static uint32_t g_length_time_us = 0;
+static uint32_t g_drained_us = 0;
+static uint32_t g_epoch_since_us = 0;
+
+// 历元钩子：同一历元的RMC和GGA都解析完成时调用
+static lc76g_epoch_hook_t g_epoch_hook = NULL;
+static void *g_epoch_ctx = NULL;
+static uint8_t g_epoch_seen = 0;        // 当前历元已解析的RMC/GGA (GPS_NMEA_MASK)
+static uint32_t g_epoch_utc_ms = 0;
+
+// 解析中凑齐的历元先排队，释放I2C互斥锁后再调用钩子
+typedef struct {
+    gps_fix_t fix;
+    uint32_t since_us;
+} epoch_entry_t;
+
+typedef struct {
+    epoch_entry_t entries[EPOCH_QUEUE_LEN];
+    int count;
+    lc76g_epoch_hook_t hook;
+    void *ctx;
+} epoch_batch_t;
+
+static epoch_entry_t g_epoch_queue[EPOCH_QUEUE_LEN];
+static int g_epoch_count = 0;
+
+// 总线空闲钩子：LC76G各段传输之间的等待期间使用同一I2C总线的其他设备
+static lc76g_bus_gap_hook_t g_bus_gap_hook = NULL;
+static void *g_bus_gap_ctx = NULL;
 
 // =============================================================================
 // 内部函数声明
@@ -55,30 +98,29 @@ static bool read_rd_data(int read_len, uint8_t *read_buffer);
 static bool write_cw_data(int reg, int cfg_len, uint8_t *write_buffer);
 static bool write_wr_data(int write_len, uint8_t *write_buffer);
 static int recovery_i2c(void);
+static void bus_gap(uint32_t us);
+static void mark_drained(void);
+static bool wait_response(const char *expect_rsp, uint32_t timeout_ms, Ql_gnss_command_contx_TypeDef *info);
 static void num2buf_small(int num, uint8_t *buf);
 static int buf2num_small(uint8_t *buf);
 static bool data_interception(uint8_t *src_string, const char *interception_string, uint8_t *des_string);
-static double convert_nmea_to_decimal(double nmea_coord);
-static double transform_lat(double x, double y);
-static double transform_lon(double x, double y);
-static Coordinates bd_encrypt(Coordinates gg);
-static Coordinates transform(Coordinates gps);
 static void parse_nmea_data(const char *nmea_data, int data_len);
-static void parse_rmc_sentence(const char *rmc_line);
-static void parse_gga_sentence(const char *gga_line);
-static void parse_gsv_sentence(const char *gsv_line);
+static void update_rmc_utc(uint32_t utc_ms, uint16_t fat_date);
+static void track_epoch(uint8_t type);
+static void take_epochs(epoch_batch_t *batch);
+static void emit_epochs(const epoch_batch_t *batch);
 
 // =============================================================================
 // 工具函数实现
 // =============================================================================
 
-static void num2buf_small(int num, uint8_t *buf) {
+static void __not_in_flash_func(num2buf_small)(int num, uint8_t *buf) {
     for(int i = 0; i < 4; i++) {
         buf[i] = (num >> (8 * i)) & 0xff;
     }
 }
 
-static int buf2num_small(uint8_t *buf) {
+static int __not_in_flash_func(buf2num_small)(uint8_t *buf) {
     return buf[0] | (buf[1] << 8) | (buf[2] << 16) | (buf[3] << 24);
 }
 
@@ -93,61 +135,13 @@ static bool data_interception(uint8_t *src_string, const char *interception_stri
     return true;
 }
 
-static double convert_nmea_to_decimal(double nmea_coord) {
-    int degrees = (int)(nmea_coord / 100.0);
-    double minutes = nmea_coord - (degrees * 100.0);
-    return degrees + (minutes / 60.0);
-}
-
-// 坐标转换函数 (WGS84 -> GCJ02)
-static double transform_lat(double x, double y) {
-    double ret = -100.0 + 2.0 * x + 3.0 * y + 0.2 * y * y + 0.1 * x * y + 0.2 * sqrt(fabs(x));
-    ret += (20.0 * sin(6.0 * x * pi) + 20.0 * sin(2.0 * x * pi)) * 2.0 / 3.0;
-    ret += (20.0 * sin(y * pi) + 40.0 * sin(y / 3.0 * pi)) * 2.0 / 3.0;
-    ret += (160.0 * sin(y / 12.0 * pi) + 320 * sin(y * pi / 30.0)) * 2.0 / 3.0;
-    return ret;
-}
-
-static double transform_lon(double x, double y) {
-    double ret = 300.0 + x + 2.0 * y + 0.1 * x * x + 0.1 * x * y + 0.1 * sqrt(fabs(x));
-    ret += (20.0 * sin(6.0 * x * pi) + 20.0 * sin(2.0 * x * pi)) * 2.0 / 3.0;
-    ret += (20.0 * sin(x * pi) + 40.0 * sin(x / 3.0 * pi)) * 2.0 / 3.0;
-    ret += (150.0 * sin(x / 12.0 * pi) + 300.0 * sin(x / 30.0 * pi)) * 2.0 / 3.0;
-    return ret;
-}
-
-static Coordinates bd_encrypt(Coordinates gg) {
-    Coordinates bd;
-    double x = gg.Lon, y = gg.Lat;
-    double z = sqrt(x * x + y * y) + 0.00002 * sin(y * x_pi);
-    double theta = atan2(y, x) + 0.000003 * cos(x * x_pi);
-    bd.Lon = z * cos(theta) + 0.0065;
-    bd.Lat = z * sin(theta) + 0.006;
-    return bd;
-}
-
-static Coordinates transform(Coordinates gps) {
-    Coordinates gg;
-    double dLat = transform_lat(gps.Lon - 105.0, gps.Lat - 35.0);
-    double dLon = transform_lon(gps.Lon - 105.0, gps.Lat - 35.0);
-    double radLat = gps.Lat / 180.0 * pi;
-    double magic = sin(radLat);
-    magic = 1 - ee * magic * magic;
-    double sqrtMagic = sqrt(magic);
-    dLat = (dLat * 180.0) / ((a * (1 - ee)) / (magic * sqrtMagic) * pi);
-    dLon = (dLon * 180.0) / (a / sqrtMagic * cos(radLat) * pi);
-    gg.Lat = gps.Lat + dLat;
-    gg.Lon = gps.Lon + dLon;
-    return gg;
-}
-
 // =============================================================================
 // I2C通信函数实现
 // =============================================================================
 
-static bool write_dummy_addr(uint8_t i2c_addr) {
+static bool __not_in_flash_func(write_dummy_addr)(uint8_t i2c_addr) {
     uint8_t dummy_data = 0;
-    int result = i2c_write_blocking(g_i2c_inst, i2c_addr, &dummy_data, 1, false);
+    int result = lc76g_i2c_xfer_write(g_i2c_inst, i2c_addr, &dummy_data, 1);
     
     if(g_debug_enabled) {
         printf("[I2C调试] write_dummy_addr(0x%02X) 结果: %d\n", i2c_addr, result);
@@ -156,17 +150,17 @@ static bool write_dummy_addr(uint8_t i2c_addr) {
     return result == 1;  // 成功写入1个字节
 }
 
-static bool write_cr_data(int reg, int cfg_len, uint8_t *write_buffer) {
+static bool __not_in_flash_func(write_cr_data)(int reg, int cfg_len, uint8_t *write_buffer) {
     uint8_t data[8] = {0};
     num2buf_small(reg, data);
     num2buf_small(cfg_len, &data[4]);
     
-    int result = i2c_write_blocking(g_i2c_inst, QL_CRCW_ADDR, data, 8, false);
+    int result = lc76g_i2c_xfer_write(g_i2c_inst, QL_CRCW_ADDR, data, 8);
     return result == 8;  // 成功写入8个字节
 }
 
-static bool read_rd_data(int read_len, uint8_t *read_buffer) {
-    int result = i2c_read_blocking(g_i2c_inst, QL_RD_ADDR, read_buffer, read_len, false);
+static bool __not_in_flash_func(read_rd_data)(int read_len, uint8_t *read_buffer) {
+    int result = lc76g_i2c_xfer_read(g_i2c_inst, QL_RD_ADDR, read_buffer, read_len);
     return result == read_len;  // 成功读取指定长度的字节
 }
 
@@ -175,12 +169,12 @@ static bool write_cw_data(int reg, int cfg_len, uint8_t *write_buffer) {
     num2buf_small(reg, data);
     num2buf_small(cfg_len, &data[4]);
     
-    int result = i2c_write_blocking(g_i2c_inst, QL_CRCW_ADDR, data, 8, false);
+    int result = lc76g_i2c_xfer_write(g_i2c_inst, QL_CRCW_ADDR, data, 8);
     return result == 8;  // 成功写入8个字节
 }
 
 static bool write_wr_data(int write_len, uint8_t *write_buffer) {
-    int result = i2c_write_blocking(g_i2c_inst, QL_WR_ADDR, write_buffer, write_len, false);
+    int result = lc76g_i2c_xfer_write(g_i2c_inst, QL_WR_ADDR, write_buffer, write_len);
     return result == write_len;  // 成功写入指定长度的字节
 }
 
@@ -205,11 +199,57 @@ static int recovery_i2c(void) {
     }
 }
 
+/**
+ * @brief LC76G两段传输之间的等待，期间运行总线空闲钩子，总等待时间不变
+ */
+static void __not_in_flash_func(bus_gap)(uint32_t us) {
+    uint32_t start = lc76g_i2c_xfer_time_us();
+    if(g_bus_gap_hook) {
+        g_bus_gap_hook(g_bus_gap_ctx);
+    }
+    lc76g_i2c_xfer_wait_until(start, us);
+}
+
 // =============================================================================
 // 主要I2C通信函数
 // =============================================================================
 
-static bool read_data_from_lc76g(uint8_t *data_buf) {
+// 读取状态机及其调用的传输函数放在SRAM中（__not_in_flash_func），
+// 字库读取和printf换出XIP缓存时不影响两段传输之间的时序。
+// I2C字节循环和等待在lc76g_i2c_xfer_pico.c中，同样在SRAM；仍在Flash中的
+// 只有出错/调试分支的printf、recovery_i2c和总线空闲钩子（在等待计时之内）
+
+/**
+ * @brief 调试模式下打印读到的原始数据（Flash中，不在读取状态机内展开）
+ */
+static void dump_raw_data(const uint8_t *data_buf, int total_length) {
+    printf("[原始数据] 内容 (%d字节): ", total_length);
+    // 限制打印长度，避免输出过长
+    int print_len = (total_length > 200) ? 200 : total_length;
+    for(int i = 0; i < print_len; i++) {
+        if(data_buf[i] >= 32 && data_buf[i] <= 126) {
+            printf("%c", data_buf[i]);
+        } else {
+            printf("\\x%02X", data_buf[i]);
+        }
+    }
+    if(total_length > 200) {
+        printf("...(截断)");
+    }
+    printf("\n");
+}
+
+/**
+ * @brief 本次读取取完了长度寄存器报告的全部数据：其中的历元在上一次读空之后才可用
+ *
+ * 数据超过一次读取上限时不调用，剩余数据在这一时刻之前已经可用。
+ */
+static inline void __not_in_flash_func(mark_drained)(void) {
+    g_epoch_since_us = g_drained_us;
+    g_drained_us = g_length_time_us;
+}
+
+static bool __not_in_flash_func(read_data_from_lc76g)(uint8_t *data_buf) {
     uint8_t write_data[8] = {0};
     uint8_t read_data[4096] = {0};
     int data_length = 0;
@@ -221,7 +261,7 @@ static bool read_data_from_lc76g(uint8_t *data_buf) {
 RESTART:
     // 检查0x50地址是否活跃
     for(int i = 0; i < RETRY_TIME; i++) {
-        sleep_us(10000);
+        bus_gap(10000);
         if(write_dummy_addr(QL_CRCW_ADDR)) {
             break;
         } else if(i == RETRY_TIME - 1) {
@@ -236,7 +276,7 @@ RESTART:
     
     // 配置数据长度寄存器
     for(int i = 0; i < RETRY_TIME; i++) {
-        sleep_us(10000);
+        bus_gap(10000);
         if(write_cr_data(QL_CR_REG, QL_CR_LEN, write_data)) {
             memset(write_data, 0, sizeof(write_data));
             break;
@@ -251,9 +291,10 @@ RESTART:
     
     // 读取数据长度
     for(int i = 0; i < RETRY_TIME; i++) {
-        sleep_us(10000);
+        bus_gap(10000);
         if(read_rd_data(QL_RW_DATA_LENGTH_SIZE, data_buf)) {
             data_length = buf2num_small(data_buf);
+            g_length_time_us = lc76g_i2c_xfer_time_us();
             break;
         } else if(i == RETRY_TIME - 1) {
             if(g_debug_enabled) {
@@ -267,6 +308,7 @@ RESTART:
         if(g_debug_enabled) {
             printf("[原始数据] 数据长度: 0 (无新数据)\n");
         }
+        mark_drained();
         return true; // 没有数据，但不是错误
     } else if(data_length >= 35*1024) {
         if(g_debug_enabled) {
@@ -292,7 +334,7 @@ RESTART:
         
         // 配置读数据寄存器
         for(int i = 0; i < RETRY_TIME; i++) {
-            sleep_us(10000);
+            bus_gap(10000);
             if(write_cr_data(QL_RD_REG, data_length, write_data)) {
                 memset(write_data, 0, sizeof(write_data));
                 break;
@@ -306,7 +348,7 @@ RESTART:
         
         // 读取数据
         for(int i = 0; i < RETRY_TIME; i++) {
-            sleep_us(10000);
+            bus_gap(10000);
             if(read_rd_data(data_length, read_data)) {
                 memcpy(&data_buf[total_length], read_data, data_length);
                 total_length += data_length;
@@ -325,38 +367,26 @@ RESTART:
     
     // 打印原始数据内容
     if(g_debug_enabled && total_length > 0) {
-        printf("[原始数据] 内容 (%d字节): ", total_length);
-        // 限制打印长度，避免输出过长
-        int print_len = (total_length > 200) ? 200 : total_length;
-        for(int i = 0; i < print_len; i++) {
-            if(data_buf[i] >= 32 && data_buf[i] <= 126) {
-                printf("%c", data_buf[i]);
-            } else {
-                printf("\\x%02X", data_buf[i]);
-            }
-        }
-        if(total_length > 200) {
-            printf("...(截断)");
-        }
-        printf("\n");
+        dump_raw_data(data_buf, total_length);
     }
     
+    mark_drained();
     return true;
 }
 
 static bool write_data_to_lc76g(const uint8_t *data_buf, int data_length) {
-    int free_length = 0;
-    int data_length_temp = data_length;
+    int offset = 0;
     uint8_t cw_buf[8] = {0};
     uint8_t free_length_temp[4] = {0};
-    bool remain_flag = false;
+    absolute_time_t stall_deadline = make_timeout_time_ms(WRITE_STALL_TIMEOUT_MS);
     
-    do {
+    while(offset < data_length) {
+        int free_length = 0;
         g_i2c_addr = QL_CRCW_ADDR;
         
         // 检查0x50地址是否活跃
         for(int i = 0; i < RETRY_TIME; i++) {
-            sleep_us(10000);
+            bus_gap(10000);
             if(write_dummy_addr(QL_CRCW_ADDR)) {
                 break;
             } else {
@@ -368,7 +398,7 @@ static bool write_data_to_lc76g(const uint8_t *data_buf, int data_length) {
         
         // 配置读以获取空闲长度
         for(int i = 0; i < RETRY_TIME; i++) {
-            sleep_us(10000);
+            bus_gap(10000);
             if(write_cw_data(QL_CW_REG, QL_CW_LEN, cw_buf)) {
                 break;
             }
@@ -377,55 +407,92 @@ static bool write_data_to_lc76g(const uint8_t *data_buf, int data_length) {
         
         g_i2c_addr = QL_RD_ADDR;
         for(int i = 0; i < RETRY_TIME; i++) {
-            sleep_us(10000);
+            bus_gap(10000);
             if(read_rd_data(QL_CW_LEN, free_length_temp)) {
                 free_length = buf2num_small(free_length_temp);
                 break;
             }
         }
         
-        if(free_length < data_length) {
-            remain_flag = true;
-            data_length_temp -= free_length;
-        } else {
-            remain_flag = false;
+        // 模块接收缓冲已满：等待模块处理，长时间无空间则放弃
+        if(free_length <= 0) {
+            if(time_reached(stall_deadline)) {
+                if(g_debug_enabled) {
+                    printf("LC76G接收缓冲无空闲空间，已写入 %d/%d 字节\n", offset, data_length);
+                }
+                return false;
+            }
+            continue;
         }
         
-        g_i2c_addr = QL_CRCW_ADDR;
-        if(remain_flag) {
-            for(int i = 0; i < RETRY_TIME; i++) {
-                sleep_us(10000);
-                if(write_cw_data(QL_WR_REG, free_length, cw_buf)) {
-                    break;
-                }
+        // 每次最多写入模块报告的空闲长度。单字节写与地址探测无法区分，
+        // 分块时不留下只有1字节的块
+        int remaining = data_length - offset;
+        int chunk_length = remaining;
+        if(chunk_length > free_length) {
+            chunk_length = free_length;
+        }
+        if(remaining - chunk_length == 1) {
+            chunk_length--;
+        }
+        if(chunk_length <= 0 || (chunk_length == 1 && remaining > 1)) {
+            if(time_reached(stall_deadline)) {
+                return false;
             }
-            g_i2c_addr = QL_WR_ADDR;
-            sleep_us(10000);
-            for(int i = 0; i < RETRY_TIME; i++) {
-                if(write_wr_data(free_length, (uint8_t*)data_buf)) {
-                    break;
-                }
+            continue;
+        }
+        
+        g_i2c_addr = QL_CRCW_ADDR;
+        for(int i = 0; i < RETRY_TIME; i++) {
+            bus_gap(10000);
+            if(write_cw_data(QL_WR_REG, chunk_length, cw_buf)) {
+                break;
             }
-        } else {
-            for(int i = 0; i < RETRY_TIME; i++) {
-                sleep_us(10000);
-                if(write_cw_data(QL_WR_REG, data_length_temp, cw_buf)) {
-                    break;
-                }
+        }
+        g_i2c_addr = QL_WR_ADDR;
+        bus_gap(10000);
+        bool written = false;
+        for(int i = 0; i < RETRY_TIME; i++) {
+            if(write_wr_data(chunk_length, (uint8_t*)&data_buf[offset])) {
+                written = true;
+                break;
             }
-            g_i2c_addr = QL_WR_ADDR;
-            sleep_us(10000);
-            for(int i = 0; i < RETRY_TIME; i++) {
-                if(write_wr_data(data_length_temp, (uint8_t*)&data_buf[data_length - data_length_temp])) {
-                    break;
-                }
+        }
+        if(!written) {
+            if(g_debug_enabled) {
+                printf("0x58 write data failed, 已写入 %d/%d 字节\n", offset, data_length);
             }
+            return false;
         }
-    } while(remain_flag);
+        
+        offset += chunk_length;
+        stall_deadline = make_timeout_time_ms(WRITE_STALL_TIMEOUT_MS);
+    }
     
     return true;
 }
 
+static bool wait_response(const char *expect_rsp, uint32_t timeout_ms, Ql_gnss_command_contx_TypeDef *info) {
+    absolute_time_t timeout = make_timeout_time_ms(timeout_ms);
+    
+    while(!time_reached(timeout)) {
+        uint8_t data_buf[4096] = {0};
+        if(read_data_from_lc76g(data_buf)) {
+            char *response = strstr((char*)data_buf, expect_rsp);
+            if(response) {
+                char line[256] = {0};
+                if(data_interception((uint8_t*)response, "\n", (uint8_t*)line)) {
+                    if(lc76g_command_get_param(line, strlen(line), info) == No_Error) {
+                        return true;
+                    }
+                }
+            }
+        }
+        sleep_ms(10);
+    }
+    return false;
+}
+
 // =============================================================================
 // 公共API实现
 // =============================================================================
@@ -457,7 +524,7 @@ bool lc76g_i2c_init(i2c_inst_t *i2c_inst, uint sda_pin, uint scl_pin, uint i2c_s
     }
     
     // 初始化GPS数据
-    memset(&g_gps_data, 0, sizeof(g_gps_data));
+    memset(&g_fix, 0, sizeof(g_fix));
     
     // 测试I2C连接
     printf("LC76G I2C适配器初始化成功: I2C%d, SDA: %d, SCL: %d, 速度: %d Hz\n", 
@@ -517,32 +584,25 @@ bool lc76g_send_command_and_get_response(const char *cmd_buf, const char *expect
     }
     
     // 等待响应
-    absolute_time_t timeout = make_timeout_time_ms(timeout_ms);
-    bool found = false;
+    bool found = wait_response(expect_rsp, timeout_ms, info);
     
-    while(!time_reached(timeout)) {
-        uint8_t data_buf[4096] = {0};
-        if(read_data_from_lc76g(data_buf)) {
-            char *response = strstr((char*)data_buf, expect_rsp);
-            if(response) {
-                char line[256] = {0};
-                if(data_interception((uint8_t*)response, "\n", (uint8_t*)line)) {
-                    if(lc76g_command_get_param(line, strlen(line), info) == No_Error) {
-                        found = true;
-                        break;
-                    }
-                }
-            }
-        }
-        sleep_ms(10);
+    mutex_exit(&g_write_cmd_mutex);
+    return found;
+}
+
+bool lc76g_wait_response(const char *expect_rsp, uint32_t timeout_ms, Ql_gnss_command_contx_TypeDef *info) {
+    if(!expect_rsp || !info) {
+        return false;
     }
     
+    mutex_enter_blocking(&g_write_cmd_mutex);
+    bool found = wait_response(expect_rsp, timeout_ms, info);
     mutex_exit(&g_write_cmd_mutex);
     return found;
 }
 
-bool lc76g_read_gps_data(LC76G_GPS_Data *gps_data) {
-    if(!gps_data) {
+bool lc76g_read_fix(gps_fix_t *fix) {
+    if(!fix) {
         return false;
     }
     
@@ -552,13 +612,58 @@ bool lc76g_read_gps_data(LC76G_GPS_Data *gps_data) {
     bool success = read_data_from_lc76g(data_buf);
     
     if(success && data_buf[0] != 0) {
+        g_rx_time_us = (uint32_t)to_us_since_boot(get_absolute_time());
         parse_nmea_data((char*)data_buf, strlen((char*)data_buf));
-        memcpy(gps_data, &g_gps_data, sizeof(LC76G_GPS_Data));
+    }
+    *fix = g_fix;
+    
+    epoch_batch_t epochs;
+    take_epochs(&epochs);
+    mutex_exit(&g_i2c_mutex);
+    emit_epochs(&epochs);
+    
+    return success && gps_fix_is_valid(fix);
+}
+
+bool lc76g_read_gps_data(LC76G_GPS_Data *gps_data) {
+    if(!gps_data) {
+        return false;
+    }
+    
+    gps_fix_t fix;
+    bool valid = lc76g_read_fix(&fix);
+    gps_fix_to_lc76g(&fix, gps_data);
+    return valid;
+}
+
+bool lc76g_parse_nmea_fix(const char *nmea_data, int data_len, gps_fix_t *fix) {
+    if(!nmea_data || data_len <= 0) {
+        return false;
     }
     
+    mutex_enter_blocking(&g_i2c_mutex);
+    g_rx_time_us = (uint32_t)to_us_since_boot(get_absolute_time());
+    g_epoch_since_us = g_rx_time_us;
+    parse_nmea_data(nmea_data, data_len);
+    if(fix) {
+        *fix = g_fix;
+    }
+    bool valid = gps_fix_is_valid(&g_fix);
+    epoch_batch_t epochs;
+    take_epochs(&epochs);
     mutex_exit(&g_i2c_mutex);
+    emit_epochs(&epochs);
     
-    return success && gps_data->Status;
+    return valid;
+}
+
+bool lc76g_parse_nmea(const char *nmea_data, int data_len, LC76G_GPS_Data *gps_data) {
+    gps_fix_t fix;
+    bool valid = lc76g_parse_nmea_fix(nmea_data, data_len, &fix);
+    if(gps_data && nmea_data && data_len > 0) {
+        gps_fix_to_lc76g(&fix, gps_data);
+    }
+    return valid;
 }
 
 void lc76g_set_debug(bool enable) {
@@ -583,20 +688,7 @@ void lc76g_reset_module(void) {
 // =============================================================================
 
 int32_t lc76g_get_command_checksum(const char *buffer, int32_t buffer_len) {
-    const char *ind = buffer;
-    uint8_t checkSumL = 0, checkSumR;
-    int32_t checksum = 0;
-    
-    while(ind - buffer < buffer_len) {
-        checkSumL ^= *ind;
-        ind++;
-    }
-    
-    checkSumR = checkSumL & 0x0F;
-    checkSumL = (checkSumL >> 4) & 0x0F;
-    checksum = checkSumL * 16;
-    checksum = checksum + checkSumR;
-    return checksum;
+    return gps_nmea_xor(buffer, buffer_len);
 }
 
 uint8_t lc76g_command_get_param(const char *command, int32_t length, Ql_gnss_command_contx_TypeDef *contx) {
@@ -647,313 +739,139 @@ uint8_t lc76g_command_get_param(const char *command, int32_t length, Ql_gnss_com
 // NMEA数据解析函数实现
 // =============================================================================
 
-static void parse_nmea_data(const char *nmea_data, int data_len) {
-    if(!nmea_data || data_len <= 0) {
+/**
+ * @brief 语句回调：GSA/GSV交给gps_sky（参与定位的卫星、天空图），同一语句带时间和日期时更新UTC，
+ *        RMC/GGA凑齐一个历元时调用历元钩子
+ */
+static void on_sentence(const gps_nmea_sentence_t *sentence, void *ctx) {
+    (void)ctx;
+    if(sentence->type == GPS_NMEA_GSA) {
+        gps_sky_parse_gsa(sentence);
         return;
     }
-    
-    // 查找RMC句子
-    char *rmc_start = strstr(nmea_data, "$GNRMC");
-    if(!rmc_start) {
-        rmc_start = strstr(nmea_data, "$GPRMC");
-    }
-    
-    if(rmc_start) {
-        char rmc_line[128] = {0};
-        int i = 0;
-        while(rmc_start[i] && rmc_start[i] != '\r' && rmc_start[i] != '\n' && i < 127) {
-            rmc_line[i] = rmc_start[i];
-            i++;
-        }
-        rmc_line[i] = '\0';
-        parse_rmc_sentence(rmc_line);
+    gps_sky_commit_gsa();
+    if(sentence->type == GPS_NMEA_GSV) {
+        gps_sky_parse_gsv(sentence);
+        return;
     }
-    
-    // 查找GGA句子
-    char *gga_start = strstr(nmea_data, "$GNGGA");
-    if(!gga_start) {
-        gga_start = strstr(nmea_data, "$GPGGA");
+    if((sentence->updated & (GPS_NMEA_UPD_TIME | GPS_NMEA_UPD_DATE)) == (GPS_NMEA_UPD_TIME | GPS_NMEA_UPD_DATE)) {
+        update_rmc_utc(g_fix.utc_ms, g_fix.utc_date);
     }
-    
-    if(gga_start) {
-        char gga_line[128] = {0};
-        int i = 0;
-        while(gga_start[i] && gga_start[i] != '\r' && gga_start[i] != '\n' && i < 127) {
-            gga_line[i] = gga_start[i];
-            i++;
-        }
-        gga_line[i] = '\0';
-        parse_gga_sentence(gga_line);
+    if(sentence->type == GPS_NMEA_RMC || sentence->type == GPS_NMEA_GGA) {
+        track_epoch(sentence->type);
     }
-    
-    // 查找GSV句子
-    char *gsv_start = strstr(nmea_data, "$GPGSV");
-    if(!gsv_start) {
-        gsv_start = strstr(nmea_data, "$GLGSV");
+}
+
+/**
+ * @brief 记录本历元已解析的RMC/GGA，两者都到齐时调用历元钩子
+ */
+static void track_epoch(uint8_t type) {
+    uint8_t bit = (uint8_t)GPS_NMEA_MASK(type);
+    // 时间变化或同类语句再次出现时为新的历元（未定位且没有时间时只能按后者判断）
+    if(g_fix.utc_ms != g_epoch_utc_ms || (g_epoch_seen & bit)) {
+        g_epoch_seen = 0;
+        g_epoch_utc_ms = g_fix.utc_ms;
+    }
+    g_epoch_seen |= bit;
+    if(g_epoch_seen == (GPS_NMEA_MASK(GPS_NMEA_RMC) | GPS_NMEA_MASK(GPS_NMEA_GGA)) && g_epoch_hook &&
+       g_epoch_count < EPOCH_QUEUE_LEN) {
+        g_epoch_queue[g_epoch_count].fix = g_fix;
+        g_epoch_queue[g_epoch_count].since_us = g_epoch_since_us;
+        g_epoch_count++;
     }
-    
-    if(gsv_start) {
-        char gsv_line[256] = {0};
-        int i = 0;
-        while(gsv_start[i] && gsv_start[i] != '\r' && gsv_start[i] != '\n' && i < 255) {
-            gsv_line[i] = gsv_start[i];
-            i++;
-        }
-        gsv_line[i] = '\0';
-        parse_gsv_sentence(gsv_line);
+}
+
+/**
+ * @brief 取出排队的历元和当前钩子（持有I2C互斥锁时调用）
+ */
+static void take_epochs(epoch_batch_t *batch) {
+    batch->count = g_epoch_count;
+    batch->hook = g_epoch_hook;
+    batch->ctx = g_epoch_ctx;
+    if(g_epoch_count > 0) {
+        memcpy(batch->entries, g_epoch_queue, (size_t)g_epoch_count * sizeof(epoch_entry_t));
+        g_epoch_count = 0;
     }
 }
 
-static void parse_rmc_sentence(const char *rmc_line) {
-    if(!rmc_line || strlen(rmc_line) < 10) {
+/**
+ * @brief 调用钩子发出取出的历元（释放I2C互斥锁之后调用，USB写阻塞时不占用总线）
+ */
+static void emit_epochs(const epoch_batch_t *batch) {
+    if(!batch->hook) {
         return;
     }
-    
-    char *token;
-    char *line_copy = strdup(rmc_line);
-    token = strtok(line_copy, ",");
-    int field = 0;
-    
-    while(token != NULL) {
-        switch(field) {
-            case 0: // RMC标识符
-                break;
-                
-            case 1: // UTC时间
-                if(strlen(token) >= 6) {
-                    int time = atoi(token);
-                    g_gps_data.Time_H = (time / 10000) + 8; // UTC+8时区
-                    g_gps_data.Time_M = (time / 100) % 100;
-                    g_gps_data.Time_S = time % 100;
-                    
-                    if(g_gps_data.Time_H >= 24) {
-                        g_gps_data.Time_H -= 24;
-                    }
-                }
-                break;
-                
-            case 2: // 定位状态
-                g_gps_data.Status = (token[0] == 'A') ? 1 : 0;
-                break;
-                
-            case 3: // 纬度 (ddmm.mmmm格式)
-                if(strlen(token) > 0) {
-                    g_gps_data.Lat_Raw = atof(token);
-                    g_gps_data.Lat = convert_nmea_to_decimal(g_gps_data.Lat_Raw);
-                }
-                break;
-                
-            case 4: // 纬度方向
-                if(strlen(token) > 0) {
-                    g_gps_data.Lat_area = token[0];
-                    if(g_gps_data.Lat_area == 'S') {
-                        g_gps_data.Lat = -g_gps_data.Lat;
-                    }
-                }
-                break;
-                
-            case 5: // 经度 (dddmm.mmmm格式)
-                if(strlen(token) > 0) {
-                    g_gps_data.Lon_Raw = atof(token);
-                    g_gps_data.Lon = convert_nmea_to_decimal(g_gps_data.Lon_Raw);
-                }
-                break;
-                
-            case 6: // 经度方向
-                if(strlen(token) > 0) {
-                    g_gps_data.Lon_area = token[0];
-                    if(g_gps_data.Lon_area == 'W') {
-                        g_gps_data.Lon = -g_gps_data.Lon;
-                    }
-                }
-                break;
-                
-            case 7: // 地面速度 (节)
-                if(strlen(token) > 0) {
-                    g_gps_data.Speed = atof(token) * 1.852; // 转换为公里/小时
-                }
-                break;
-                
-            case 8: // 地面航向 (度)
-                if(strlen(token) > 0) {
-                    g_gps_data.Course = atof(token);
-                }
-                break;
-                
-            case 9: // 日期 (ddmmyy)
-                if(strlen(token) >= 6) {
-                    int day = (token[0] - '0') * 10 + (token[1] - '0');
-                    int month = (token[2] - '0') * 10 + (token[3] - '0');
-                    int year = 2000 + (token[4] - '0') * 10 + (token[5] - '0');
-                    sprintf(g_gps_data.Date, "%04d-%02d-%02d", year, month, day);
-                }
-                break;
-        }
-        
-        token = strtok(NULL, ",");
-        field++;
+    for(int i = 0; i < batch->count; i++) {
+        batch->hook(&batch->entries[i].fix, batch->entries[i].since_us, batch->ctx);
     }
-    
-    free(line_copy);
 }
 
-static void parse_gga_sentence(const char *gga_line) {
-    if(!gga_line || strlen(gga_line) < 10) {
-        return;
-    }
-    
-    char *token;
-    char *line_copy = strdup(gga_line);
-    token = strtok(line_copy, ",");
-    int field = 0;
-    
-    while(token != NULL) {
-        switch(field) {
-            case 0: // GGA标识符
-                break;
-                
-            case 1: // UTC时间
-                if(strlen(token) >= 6) {
-                    int time = atoi(token);
-                    g_gps_data.Time_H = (time / 10000) + 8; // UTC+8时区
-                    g_gps_data.Time_M = (time / 100) % 100;
-                    g_gps_data.Time_S = time % 100;
-                    
-                    if(g_gps_data.Time_H >= 24) {
-                        g_gps_data.Time_H -= 24;
-                    }
-                }
-                break;
-                
-            case 2: // 纬度 (ddmm.mmmm格式)
-                if(strlen(token) > 0) {
-                    g_gps_data.Lat_Raw = atof(token);
-                    g_gps_data.Lat = convert_nmea_to_decimal(g_gps_data.Lat_Raw);
-                }
-                break;
-                
-            case 3: // 纬度方向
-                if(strlen(token) > 0) {
-                    g_gps_data.Lat_area = token[0];
-                    if(g_gps_data.Lat_area == 'S') {
-                        g_gps_data.Lat = -g_gps_data.Lat;
-                    }
-                }
-                break;
-                
-            case 4: // 经度 (dddmm.mmmm格式)
-                if(strlen(token) > 0) {
-                    g_gps_data.Lon_Raw = atof(token);
-                    g_gps_data.Lon = convert_nmea_to_decimal(g_gps_data.Lon_Raw);
-                }
-                break;
-                
-            case 5: // 经度方向
-                if(strlen(token) > 0) {
-                    g_gps_data.Lon_area = token[0];
-                    if(g_gps_data.Lon_area == 'W') {
-                        g_gps_data.Lon = -g_gps_data.Lon;
-                    }
-                }
-                break;
-                
-            case 6: // 定位质量指示器
-                if(strlen(token) > 0 && token[0] >= '0' && token[0] <= '9') {
-                    g_gps_data.Status = (token[0] == '0') ? 0 : 1;
-                    g_gps_data.Quality = token[0] - '0';
-                }
-                break;
-                
-            case 7: // 使用的卫星数量
-                if(strlen(token) > 0) {
-                    g_gps_data.Satellites = atoi(token);
-                }
-                break;
-                
-            case 8: // HDOP
-                if(strlen(token) > 0) {
-                    g_gps_data.HDOP = atof(token);
-                }
-                break;
-                
-            case 9: // 海拔
-                if(strlen(token) > 0) {
-                    g_gps_data.Altitude = atof(token);
-                }
-                break;
-        }
-        
-        token = strtok(NULL, ",");
-        field++;
+static void parse_nmea_data(const char *nmea_data, int data_len) {
+    gps_nmea_parse_buffer(nmea_data, data_len, &g_fix, on_sentence, NULL, &g_nmea_stats);
+}
+
+/**
+ * @brief 由RMC的时间和日期计算UTC秒数
+ */
+static void update_rmc_utc(uint32_t utc_ms, uint16_t fat_date) {
+    int year = 1980 + (fat_date >> 9);
+    int month = (fat_date >> 5) & 0x0F;
+    int day = fat_date & 0x1F;
+
+    // 公历日期转1970-01-01起的天数
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int32_t days = era * 146097 + doe - 719468;
+
+    g_utc_seconds = (uint32_t)days * 86400u + utc_ms / 1000u;
+    g_utc_update_ms = to_ms_since_boot(get_absolute_time());
+}
+
+bool lc76g_get_utc_time(uint32_t *utc_seconds) {
+    if(!utc_seconds || g_utc_seconds == 0) {
+        return false;
     }
-    
-    free(line_copy);
+    uint32_t elapsed_ms = to_ms_since_boot(get_absolute_time()) - g_utc_update_ms;
+    *utc_seconds = g_utc_seconds + elapsed_ms / 1000;
+    return true;
+}
+
+uint32_t lc76g_get_rx_time_us(void) {
+    return g_rx_time_us;
 }
 
-static void parse_gsv_sentence(const char *gsv_line) {
-    if(!gsv_line || strlen(gsv_line) < 10) {
+void lc76g_get_nmea_stats(gps_nmea_stats_t *stats) {
+    if(!stats) {
         return;
     }
-    
-    char *token;
-    char *line_copy = strdup(gsv_line);
-    token = strtok(line_copy, ",");
-    int field = 0;
-    uint8_t total_satellites = 0;
-    uint8_t total_snr = 0;
-    uint8_t snr_count = 0;
-    
-    while(token != NULL) {
-        switch(field) {
-            case 3: // 总卫星数
-                total_satellites = atoi(token);
-                break;
-            case 7: // 第一个卫星SNR
-                if(strlen(token) > 0) {
-                    uint8_t snr = atoi(token);
-                    if(snr > 0) {
-                        total_snr += snr;
-                        snr_count++;
-                    }
-                }
-                break;
-            case 11: // 第二个卫星SNR
-                if(strlen(token) > 0) {
-                    uint8_t snr = atoi(token);
-                    if(snr > 0) {
-                        total_snr += snr;
-                        snr_count++;
-                    }
-                }
-                break;
-            case 15: // 第三个卫星SNR
-                if(strlen(token) > 0) {
-                    uint8_t snr = atoi(token);
-                    if(snr > 0) {
-                        total_snr += snr;
-                        snr_count++;
-                    }
-                }
-                break;
-            case 19: // 第四个卫星SNR
-                if(strlen(token) > 0) {
-                    uint8_t snr = atoi(token);
-                    if(snr > 0) {
-                        total_snr += snr;
-                        snr_count++;
-                    }
-                }
-                break;
-        }
-        
-        token = strtok(NULL, ",");
-        field++;
+    mutex_enter_blocking(&g_i2c_mutex);
+    *stats = g_nmea_stats;
+    mutex_exit(&g_i2c_mutex);
+}
+
+void lc76g_set_epoch_hook(lc76g_epoch_hook_t hook, void *ctx) {
+    mutex_enter_blocking(&g_i2c_mutex);
+    g_epoch_hook = hook;
+    g_epoch_ctx = ctx;
+    mutex_exit(&g_i2c_mutex);
+}
+
+void lc76g_set_bus_gap_hook(lc76g_bus_gap_hook_t hook, void *ctx) {
+    mutex_enter_blocking(&g_i2c_mutex);
+    g_bus_gap_hook = hook;
+    g_bus_gap_ctx = ctx;
+    mutex_exit(&g_i2c_mutex);
+}
+
+void lc76g_run_bus_gap_hook(void) {
+    if(!g_bus_gap_hook || !mutex_try_enter(&g_i2c_mutex, NULL)) {
+        return;
     }
-    
-    // 更新卫星数据
-    g_gps_data.Satellites = total_satellites;
-    
-    free(line_copy);
+    g_bus_gap_hook(g_bus_gap_ctx);
+    mutex_exit(&g_i2c_mutex);
 }
 
 // =============================================================================
@@ -961,22 +879,9 @@ static void parse_gsv_sentence(const char *gsv_line) {
 // =============================================================================
 
 Coordinates lc76g_get_baidu_coordinates(void) {
-    Coordinates temp;
-    temp.Lat = g_gps_data.Lat;
-    temp.Lon = g_gps_data.Lon;
-    
-    // 地图坐标系转换
-    temp = transform(temp);
-    temp = bd_encrypt(temp);
-    return temp;
+    return gps_fix_to_bd09(&g_fix);
 }
 
 Coordinates lc76g_get_google_coordinates(void) {
-    Coordinates temp;
-    temp.Lat = g_gps_data.Lat;
-    temp.Lon = g_gps_data.Lon;
-    
-    // 地图坐标系转换
-    temp = transform(temp);
-    return temp;
+    return gps_fix_to_gcj02(&g_fix);
 }
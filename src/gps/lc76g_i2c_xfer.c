@@ -0,0 +1,30 @@
+/**
+ * @file lc76g_i2c_xfer.c
+ * @brief LC76G传输原语的通用实现（转调SDK，主机构建使用）
+ *
+ * 固件使用lc76g_i2c_xfer_pico.c中的寄存器实现。
+ */
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "hardware/i2c.h"
+#include "gps/lc76g_i2c_xfer.h"
+
+int lc76g_i2c_xfer_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len) {
+    return i2c_write_blocking(i2c, addr, src, len, false);
+}
+
+int lc76g_i2c_xfer_read(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len) {
+    return i2c_read_blocking(i2c, addr, dst, len, false);
+}
+
+uint32_t lc76g_i2c_xfer_time_us(void) {
+    return (uint32_t)to_us_since_boot(get_absolute_time());
+}
+
+void lc76g_i2c_xfer_wait_until(uint32_t start, uint32_t us) {
+    uint32_t elapsed = lc76g_i2c_xfer_time_us() - start;
+    if(elapsed < us) {
+        sleep_us(us - elapsed);
+    }
+}
@@ -0,0 +1,118 @@
+/**
+ * @file lc76g_i2c_xfer_pico.c
+ * @brief LC76G传输原语的固件实现：寄存器级I2C传输和定时器忙等，全部在SRAM中
+ *
+ * 传输流程与SDK的i2c_write_blocking_internal/i2c_read_blocking_internal相同
+ * （无超时分支），并维护restart_on_next，与同一总线上使用SDK函数的设备
+ * （摇杆）保持一致。等待用TIMERAWL忙等，不经过sleep_us的alarm池。
+ */
+
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/i2c.h"
+#include "hardware/structs/timer.h"
+#include "gps/lc76g_i2c_xfer.h"
+
+#define I2C_TX_FIFO_DEPTH 16
+
+int __not_in_flash_func(lc76g_i2c_xfer_write)(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len) {
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    int ilen = (int)len;
+    int byte_ctr;
+    bool abort = false;
+    uint32_t abort_reason = 0;
+
+    hw->enable = 0;
+    hw->tar = addr;
+    hw->enable = 1;
+
+    for(byte_ctr = 0; byte_ctr < ilen; ++byte_ctr) {
+        bool first = byte_ctr == 0;
+        bool last = byte_ctr == ilen - 1;
+
+        hw->data_cmd = (uint32_t)(first && i2c->restart_on_next) << I2C_IC_DATA_CMD_RESTART_LSB |
+                       (uint32_t)last << I2C_IC_DATA_CMD_STOP_LSB |
+                       *src++;
+
+        // 等待发送FIFO排空（地址无应答时也会置TX_EMPTY）
+        while(!(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_EMPTY_BITS)) {
+            tight_loop_contents();
+        }
+
+        abort_reason = hw->tx_abrt_source;
+        if(abort_reason) {
+            (void)hw->clr_tx_abrt;
+            abort = true;
+        }
+
+        if(abort || last) {
+            while(!(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)) {
+                tight_loop_contents();
+            }
+            (void)hw->clr_stop_det;
+        }
+
+        if(abort) {
+            break;
+        }
+    }
+
+    i2c->restart_on_next = false;
+
+    if(abort && (abort_reason & I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS)) {
+        return PICO_ERROR_GENERIC;
+    }
+    return byte_ctr;
+}
+
+int __not_in_flash_func(lc76g_i2c_xfer_read)(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len) {
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    int ilen = (int)len;
+    int byte_ctr;
+    bool abort = false;
+
+    hw->enable = 0;
+    hw->tar = addr;
+    hw->enable = 1;
+
+    for(byte_ctr = 0; byte_ctr < ilen; ++byte_ctr) {
+        bool first = byte_ctr == 0;
+        bool last = byte_ctr == ilen - 1;
+
+        while(hw->txflr >= I2C_TX_FIFO_DEPTH) {
+            tight_loop_contents();
+        }
+
+        hw->data_cmd = (uint32_t)(first && i2c->restart_on_next) << I2C_IC_DATA_CMD_RESTART_LSB |
+                       (uint32_t)last << I2C_IC_DATA_CMD_STOP_LSB |
+                       I2C_IC_DATA_CMD_CMD_BITS;
+
+        // 读CLR_TX_ABRT同时清除并返回中止状态
+        do {
+            abort = (bool)hw->clr_tx_abrt;
+        } while(!abort && !hw->rxflr);
+
+        if(abort) {
+            break;
+        }
+        *dst++ = (uint8_t)hw->data_cmd;
+    }
+
+    i2c->restart_on_next = false;
+
+    // 与SDK相同，读取中止一律返回PICO_ERROR_GENERIC
+    if(abort) {
+        return PICO_ERROR_GENERIC;
+    }
+    return byte_ctr;
+}
+
+uint32_t __not_in_flash_func(lc76g_i2c_xfer_time_us)(void) {
+    return timer_hw->timerawl;
+}
+
+void __not_in_flash_func(lc76g_i2c_xfer_wait_until)(uint32_t start, uint32_t us) {
+    while(timer_hw->timerawl - start < us) {
+        tight_loop_contents();
+    }
+}
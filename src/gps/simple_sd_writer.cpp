@@ -124,6 +124,20 @@ bool SimpleSDWriter::file_exists(const std::string& filepath) {
     return res == FR_OK;
 }
 
+bool SimpleSDWriter::remove_file(const std::string& filepath) {
+    if (!initialized_) {
+        return false;
+    }
+    
+    FRESULT res = f_unlink(filepath.c_str());
+    if (res != FR_OK) {
+        printf("[SimpleSD] 删除文件失败: %s (错误: %d)\n", filepath.c_str(), res);
+        return false;
+    }
+    
+    return true;
+}
+
 uint32_t SimpleSDWriter::get_file_size(const std::string& filepath) {
     if (!initialized_) {
         return 0;
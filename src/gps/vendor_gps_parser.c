@@ -6,11 +6,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
 #include "gps/vendor_gps_parser.h"
+#include "gps/gps_nmea.h"
 
 // Use vendor-defined constants
 #define BUFFSIZE 800
@@ -18,12 +18,6 @@
 // Lookup table used by vendor code
 static const char Temp[16] = {'0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'};
 
-// Coordinate conversion constants
-static const double pi = 3.14159265358979324;
-static const double a = 6378245.0;
-static const double ee = 0.00669342162296594323;
-static const double x_pi = 3.14159265358979324 * 3000.0 / 180.0;
-
 // GPS I2C configuration
 static i2c_inst_t *gps_i2c = NULL;
 static uint8_t gps_i2c_addr = 0x42;
@@ -35,96 +29,46 @@ static int gps_force_pin = -1;
 // Data buffer
 static char buff_t[BUFFSIZE] = {0};
 
-// Global GPS data
+// Global GPS data (fix is updated by the shared NMEA engine, GPS is its GNRMC view)
+static gps_fix_t gps_fix = {0};
 static GNRMC GPS = {0};
 
 // Whether to display detailed debug logs
 static bool debug_output = false;
 
-// Last valid speed and course
-static double last_valid_speed = 0.0;
-static double last_valid_course = 0.0;
-
 // LC76G satellite data
 static uint8_t gps_satellites_count = 0;
 static uint8_t gps_signal_strength = 0;
 
-// Forward declarations
-static void parse_gsv_message(const char* gsv_data);
-
-/******************************************************************************
-function:	
-	Latitude conversion
-******************************************************************************/
-static double transformLat(double x, double y)
-{
-	double ret = -100.0 + 2.0 * x + 3.0 * y + 0.2 * y * y + 0.1 * x * y + 0.2 * sqrt(fabs(x));
-    ret += (20.0 * sin(6.0 * x * pi) + 20.0 * sin(2.0 * x * pi)) * 2.0 / 3.0;
-    ret += (20.0 * sin(y * pi) + 40.0 * sin(y / 3.0 * pi)) * 2.0 / 3.0;
-    ret += (160.0 * sin(y / 12.0 * pi) + 320 * sin(y * pi / 30.0)) * 2.0 / 3.0;
-    return ret;
-}
-
-/******************************************************************************
-function:	
-	Longitude conversion
-******************************************************************************/
-static double transformLon(double x, double y)
-{
-	double ret = 300.0 + x + 2.0 * y + 0.1 * x * x + 0.1 * x * y + 0.1 * sqrt(fabs(x));
-    ret += (20.0 * sin(6.0 * x * pi) + 20.0 * sin(2.0 * x * pi)) * 2.0 / 3.0;
-    ret += (20.0 * sin(x * pi) + 40.0 * sin(x / 3.0 * pi)) * 2.0 / 3.0;
-    ret += (150.0 * sin(x / 12.0 * pi) + 300.0 * sin(x / 30.0 * pi)) * 2.0 / 3.0;
-    return ret;
-}
-
-/******************************************************************************
-function:	
-	GCJ-02 international standard converted to Baidu map BD-09 standard
-******************************************************************************/
-static Coordinates bd_encrypt(Coordinates gg)
-{
-	Coordinates bd;
-    double x = gg.Lon, y = gg.Lat;
-	double z = sqrt(x * x + y * y) + 0.00002 * sin(y * x_pi);
-	double theta = atan2(y, x) + 0.000003 * cos(x * x_pi);
-	bd.Lon = z * cos(theta) + 0.0065;
-	bd.Lat = z * sin(theta) + 0.006;
-	return bd;
-}
-
-/******************************************************************************
-function:	
-	GPS's WGS-84 standard is converted into GCJ-02 international standard
-******************************************************************************/
-static Coordinates transform(Coordinates gps)
-{
-	Coordinates gg;
-    double dLat = transformLat(gps.Lon - 105.0, gps.Lat - 35.0);
-    double dLon = transformLon(gps.Lon - 105.0, gps.Lat - 35.0);
-    double radLat = gps.Lat / 180.0 * pi;
-    double magic = sin(radLat);
-    magic = 1 - ee * magic * magic;
-    double sqrtMagic = sqrt(magic);
-    dLat = (dLat * 180.0) / ((a * (1 - ee)) / (magic * sqrtMagic) * pi);
-    dLon = (dLon * 180.0) / (a / sqrtMagic * cos(radLat) * pi);
-    gg.Lat = gps.Lat + dLat;
-    gg.Lon = gps.Lon + dLon;
-	return gg;
-}
+// GSV summary of the buffer being parsed
+typedef struct {
+    uint16_t in_view;
+    uint32_t snr_sum;
+    uint16_t snr_count;
+} gsv_summary_t;
 
 /**
- * @brief Convert NMEA format latitude/longitude to decimal degrees format
- * 
- * Example: 3113.313760 -> 31.221896 degrees
- * 
- * @param nmea_coord Coordinate value in NMEA format
- * @return Coordinate value in decimal degrees format
+ * @brief Collect satellites in view and SNR from GSV sentences
+ *
+ * The first GSV of each constellation carries that constellation's in-view
+ * count (field 3); SNR is the last field of each 4-field satellite group.
  */
-static double convert_nmea_to_decimal(double nmea_coord) {
-    int degrees = (int)(nmea_coord / 100.0);
-    double minutes = nmea_coord - (degrees * 100.0);
-    return degrees + (minutes / 60.0);
+static void on_sentence(const gps_nmea_sentence_t *sentence, void *ctx) {
+    gsv_summary_t *gsv = (gsv_summary_t *)ctx;
+    if (sentence->type != GPS_NMEA_GSV) {
+        return;
+    }
+    int32_t value;
+    if (gps_nmea_parse_decimal(sentence->fields[2], 0, &value) && value == 1 &&
+        gps_nmea_parse_decimal(sentence->fields[3], 0, &value) && value > 0) {
+        gsv->in_view += (uint16_t)value;
+    }
+    for (int i = 7; i < sentence->field_count; i += 4) {
+        if (gps_nmea_parse_decimal(sentence->fields[i], 0, &value) && value > 0) {
+            gsv->snr_sum += (uint32_t)value;
+            gsv->snr_count++;
+        }
+    }
 }
 
 /**
@@ -177,15 +121,13 @@ bool vendor_gps_init(i2c_inst_t *i2c_inst, uint8_t i2c_addr, uint sda_pin, uint
  * @param data Command string, no need to add checksum
  */
 void vendor_gps_send_command(const char *data) {
-    char Check = data[1], Check_char[3]={0};
+    char Check_char[3]={0};
     uint8_t i = 0;
     char command[256];
     int cmd_len = 0;
     
-    // Calculate checksum
-    for(i=2; data[i] != '\0'; i++){
-        Check ^= data[i];
-    }
+    // Calculate checksum (skip '$')
+    uint8_t Check = gps_nmea_xor(data + 1, (int)strlen(data + 1));
     
     Check_char[0] = Temp[Check/16%16];
     Check_char[1] = Temp[Check%16];
@@ -327,477 +269,74 @@ function:
     - XX 是校验和
 ******************************************************************************/
 GNRMC vendor_gps_get_gnrmc() {
-    char *token;
-    char *rmc_start = NULL;
-    char *gga_start = NULL;
-    char rmc_line[128] = {0};
-    bool using_gga = false;
-    
-    // Reset GPS status
-    GPS.Status = 0;
-    
-    // Save previous time information to avoid flashing when resetting
-    uint8_t prev_time_h = GPS.Time_H;
-    uint8_t prev_time_m = GPS.Time_M;
-    uint8_t prev_time_s = GPS.Time_S;
-    char prev_date[11];
-    strncpy(prev_date, GPS.Date, sizeof(prev_date)-1);
-    prev_date[sizeof(prev_date)-1] = '\0';
-    
-    // Save previous location and speed information
-    double prev_lat = GPS.Lat;
-    double prev_lon = GPS.Lon;
-    double prev_speed = GPS.Speed;
-    double prev_course = GPS.Course;
-    double prev_altitude = GPS.Altitude;
-    
-    // Temporarily reset other values except time, waiting for new data to update
-    GPS.Lat = 0.0;
-    GPS.Lon = 0.0;
-    GPS.Speed = prev_speed;  // Keep previous speed to avoid flashing speed display
-    GPS.Course = prev_course;  // Keep previous course to avoid flashing course
-    GPS.Altitude = prev_altitude;  // Keep previous altitude value
-    
     // Use vendor's original code to receive NMEA data stream
     vendor_i2c_receive_string(buff_t, BUFFSIZE);
+    return vendor_gps_parse_nmea(buff_t);
+}
+
+/******************************************************************************
+function:	
+	Parse a received NMEA buffer into the GNRMC state
+    vendor_gps_get_gnrmc() passes the internal receive buffer directly;
+    other callers' data is copied into it first
+******************************************************************************/
+GNRMC vendor_gps_parse_nmea(const char *nmea_data) {
+    if (nmea_data != buff_t) {
+        strncpy(buff_t, nmea_data, BUFFSIZE - 1);
+        buff_t[BUFFSIZE - 1] = '\0';
+    }
+    int len = (int)strlen(buff_t);
     
     // Print original RAW data before any processing
     if (debug_output) {
-        printf("[GPS原始数据] 接收到的原始数据 (长度: %d):\n", (int)strlen(buff_t));
+        printf("[GPS原始数据] 接收到的原始数据 (长度: %d):\n", len);
         printf("--- ORIGINAL RAW DATA START ---\n");
         printf("%s", buff_t);
         printf("\n--- ORIGINAL RAW DATA END ---\n");
     }
     
-    // Clean up corrupted data - keep all NMEA standard characters
-    char cleaned_buffer[BUFFSIZE] = {0};
-    int clean_index = 0;
-    for (int i = 0; i < BUFFSIZE && buff_t[i] != '\0'; i++) {
-        char c = buff_t[i];
-        // Keep all NMEA standard characters: $, *, comma, digits, letters, CR, LF
-        // This includes all printable characters plus NMEA control characters
-        if (c >= 32 && c <= 126) {
-            cleaned_buffer[clean_index++] = c;
-        } else if (c == '\r' || c == '\n' || c == '\t') {
-            cleaned_buffer[clean_index++] = c;
-        }
-        // Skip only truly problematic characters (null, control chars except CR/LF)
-    }
-    cleaned_buffer[clean_index] = '\0';
-    
-    // Print cleaned data after character filtering
-    if (debug_output) {
-        printf("[GPS清理数据] 字符过滤后的数据 (长度: %d):\n", (int)strlen(cleaned_buffer));
-        printf("--- CLEANED DATA START ---\n");
-        printf("%s", cleaned_buffer);
-        printf("\n--- CLEANED DATA END ---\n");
-    }
-    
-    // NMEA standard compliant cleanup: preserve all valid NMEA data
-    // Only remove clearly corrupted data, keep ERROR strings as they might be valid GPS output
-    char* src = cleaned_buffer;
-    char* dst = buff_t;
-    
-    while (*src && (dst - buff_t) < BUFFSIZE - 1) {
-        // Keep all data that could be part of NMEA sentences
-        // ERROR strings are kept as they might be valid GPS module output
-        *dst++ = *src++;
-    }
-    *dst = '\0';
+    // Sentences with a bad or missing checksum (including corrupted characters
+    // and truncated sentences) are dropped by the engine; empty fields keep the
+    // previous value so time, speed and course do not flash
+    gsv_summary_t gsv = {0};
+    gps_nmea_stats_t stats = {0};
+    uint32_t seen = gps_nmea_parse_buffer(buff_t, len, &gps_fix, on_sentence, &gsv, &stats);
     
-    // Print final processed data
     if (debug_output) {
-        printf("[GPS最终数据] 垃圾清理后的最终数据 (长度: %d):\n", (int)strlen(buff_t));
-        printf("--- FINAL DATA START ---\n");
-        printf("%s", buff_t);
-        printf("\n--- FINAL DATA END ---\n");
-    }
-    
-    // If debugging, print received data
-    if (debug_output) {
-        // Print first 100 characters for quick overview
-        char preview[101] = {0};
-        strncpy(preview, buff_t, 100);
-        printf("First 100 characters of GPS data: %s\n", preview);
-        
-        // Print complete RAW data for detailed analysis
-        printf("[GPS RAW数据] 完整数据流 (长度: %d):\n", (int)strlen(buff_t));
-        printf("--- RAW DATA START ---\n");
-        printf("%s", buff_t);
-        printf("\n--- RAW DATA END ---\n");
-        
-        // Additional debug: check for NMEA sentence patterns
-        if (strstr(buff_t, "$GNGGA") || strstr(buff_t, "$GPRMC") || strstr(buff_t, "$GNRMC")) {
-            printf("[GPS调试] 检测到NMEA句子模式\n");
-        } else {
-            printf("[GPS调试] 未检测到NMEA句子模式\n");
-        }
-        
-        // Count different sentence types with checksum validation
-        int gga_count = 0, rmc_count = 0, gsv_count = 0, gsa_count = 0;
-        int valid_checksum_count = 0, invalid_checksum_count = 0;
-        char* ptr = buff_t;
-        
-        // Count sentences and validate checksums
-        while ((ptr = strstr(ptr, "$")) != NULL) {
-            char* end_ptr = strchr(ptr, '\n');
-            if (!end_ptr) end_ptr = strchr(ptr, '\r');
-            if (!end_ptr) end_ptr = ptr + strlen(ptr);
-            
-            // Check if this looks like a complete NMEA sentence
-            char* checksum_pos = strchr(ptr, '*');
-            if (checksum_pos && checksum_pos < end_ptr) {
-                // Validate checksum
-                uint8_t calculated_checksum = 0;
-                for (char* p = ptr + 1; p < checksum_pos; p++) {
-                    calculated_checksum ^= *p;
-                }
-                
-                // Parse provided checksum
-                uint8_t provided_checksum = 0;
-                if (sscanf(checksum_pos + 1, "%2hhx", &provided_checksum) == 1) {
-                    if (calculated_checksum == provided_checksum) {
-                        valid_checksum_count++;
-                    } else {
-                        invalid_checksum_count++;
-                    }
-                }
-            }
-            
-            // Count sentence types
-            if (strncmp(ptr, "$GNGGA", 6) == 0 || strncmp(ptr, "$GPGGA", 6) == 0) gga_count++;
-            else if (strncmp(ptr, "$GNRMC", 6) == 0 || strncmp(ptr, "$GPRMC", 6) == 0) rmc_count++;
-            else if (strncmp(ptr, "$GPGSV", 6) == 0 || strncmp(ptr, "$GLGSV", 6) == 0) gsv_count++;
-            else if (strncmp(ptr, "$GNGSA", 6) == 0 || strncmp(ptr, "$GPGSA", 6) == 0) gsa_count++;
-            
-            ptr++;
-        }
-        
-        printf("[GPS统计] GGA: %d, RMC: %d, GSV: %d, GSA: %d\n", gga_count, rmc_count, gsv_count, gsa_count);
-        printf("[GPS校验] 有效校验和: %d, 无效校验和: %d\n", valid_checksum_count, invalid_checksum_count);
-    }
-    
-    // Parse GSV messages for satellite information
-    char* gsv_start = strstr(buff_t, "$GPGSV");
-    if (!gsv_start) {
-        gsv_start = strstr(buff_t, "$GLGSV");
-    }
-    if (!gsv_start) {
-        gsv_start = strstr(buff_t, "$GAGSV");
-    }
-    if (!gsv_start) {
-        gsv_start = strstr(buff_t, "$GBGSV");
-    }
-    if (!gsv_start) {
-        gsv_start = strstr(buff_t, "$GQGSV");
-    }
-    
-    if (gsv_start) {
-        // Extract complete GSV sentence
-        char gsv_line[256] = {0};
-        int i = 0;
-        while (gsv_start[i] && gsv_start[i] != '\r' && gsv_start[i] != '\n' && i < 255) {
-            gsv_line[i] = gsv_start[i];
-            i++;
-        }
-        gsv_line[i] = '\0';
-        
-        // Validate GSV sentence format - be more lenient for partial sentences
-        if (strlen(gsv_line) > 10) {
-            if (debug_output) {
-                printf("Parsing GSV sentence: %s\n", gsv_line);
-            }
-            parse_gsv_message(gsv_line);
-        } else if (debug_output) {
-            printf("Invalid GSV sentence format: %s\n", gsv_line);
-        }
-    }
-    
-    // Find GNRMC or GPRMC sentence
-    rmc_start = strstr(buff_t, "$GNRMC");
-    if (!rmc_start) {
-        rmc_start = strstr(buff_t, "$GPRMC"); // Try to find GPRMC
-    }
-    
-    // If no RMC sentence is found, try GGA sentence
-    if (!rmc_start) {
-        gga_start = strstr(buff_t, "$GNGGA");
-        if (!gga_start) {
-            gga_start = strstr(buff_t, "$GPGGA"); // Try to find GPGGA
-        }
-        
-        if (gga_start) {
-            rmc_start = gga_start;
-            using_gga = true;
-        } else {
-            if (debug_output) {
-                printf("No RMC or GGA sentence found\n");
-            }
-            
-            // If no valid sentence is found, keep previous time information to avoid flashing
-            GPS.Time_H = prev_time_h;
-            GPS.Time_M = prev_time_m;
-            GPS.Time_S = prev_time_s;
-            strncpy(GPS.Date, prev_date, sizeof(GPS.Date)-1);
-            GPS.Date[sizeof(GPS.Date)-1] = '\0';
-            
-            return GPS; // No valid sentence found, return previous data
-        }
-    }
-    
-    // Extract complete sentence
-    int i = 0;
-    while (rmc_start[i] && rmc_start[i] != '\r' && rmc_start[i] != '\n' && i < 127) {
-        rmc_line[i] = rmc_start[i];
-        i++;
+        printf("[GPS统计] GGA: %lu, RMC: %lu, GSV: %lu, GSA: %lu\n",
+               (unsigned long)stats.by_type[GPS_NMEA_GGA], (unsigned long)stats.by_type[GPS_NMEA_RMC],
+               (unsigned long)stats.by_type[GPS_NMEA_GSV], (unsigned long)stats.by_type[GPS_NMEA_GSA]);
+        printf("[GPS校验] 有效校验和: %lu, 无效校验和: %lu\n",
+               (unsigned long)stats.sentences, (unsigned long)stats.checksum_errors);
     }
-    rmc_line[i] = '\0';
     
-    // Validate sentence format
-    if (strlen(rmc_line) < 10 || strchr(rmc_line, '*') == NULL) {
+    // Positioning status only reflects this buffer
+    if (!(seen & (GPS_NMEA_MASK(GPS_NMEA_RMC) | GPS_NMEA_MASK(GPS_NMEA_GGA)))) {
+        gps_fix.flags &= (uint8_t)~GPS_FIX_VALID;
         if (debug_output) {
-            printf("Invalid %s sentence format: %s\n", using_gga ? "GGA" : "RMC", rmc_line);
+            printf("No RMC or GGA sentence found\n");
         }
-        
-        // If no valid sentence is found, keep previous time information to avoid flashing
-        GPS.Time_H = prev_time_h;
-        GPS.Time_M = prev_time_m;
-        GPS.Time_S = prev_time_s;
-        strncpy(GPS.Date, prev_date, sizeof(GPS.Date)-1);
-        GPS.Date[sizeof(GPS.Date)-1] = '\0';
-        
-        return GPS; // Invalid sentence format, return previous data
     }
     
-    if (debug_output) {
-        if (using_gga) {
-            printf("Parsing GGA sentence: %s\n", rmc_line);
-        } else {
-            printf("Parsing RMC sentence: %s\n", rmc_line);
-        }
+    if (gsv.in_view > 0) {
+        gps_satellites_count = gsv.in_view > 255 ? 255 : (uint8_t)gsv.in_view;
     }
-    
-    // Use strtok to parse the various fields of the NMEA sentence
-    token = strtok(rmc_line, ",");
-    int field = 0;
-    
-    if (using_gga) {
-        // Parse GGA sentence
-        // $GNGGA,hhmmss.sss,ddmm.mmmm,N,dddmm.mmmm,E,q,ss,y.y,a.a,M,b.b,M,c.c,rrrr*hh
-        // Where:
-        // - hhmmss.sss  is UTC time
-        // - ddmm.mmmm  is latitude, format ddmm.mmmm (degree minute format)
-        // - N  is latitude direction, N=North, S=South
-        // - dddmm.mmmm  is longitude, format dddmm.mmmm (degree minute format)
-        // - E  is longitude direction, E=East, W=West
-        // - q  is positioning quality indicator (0=invalid, 1=GPS positioning, 2=DGPS positioning)
-        // - ss  is number of satellites being used
-        // - y.y  is HDOP horizontal precision factor
-        // - a.a  is altitude
-        // - M  is altitude unit, M represents meters
-        // - b.b  is geoid separation
-        // - M  is geoid separation unit, M represents meters
-        // - c.c  is DGPS data age
-        // - rrrr  is DGPS reference station ID
-        
-        while (token != NULL) {
-            switch (field) {
-                case 0: // GGA identifier
-                    break;
-                    
-                case 1: // UTC time
-                    if (strlen(token) >= 6) {
-                        // Extract time directly from string
-                        int time = atoi(token);
-                        GPS.Time_H = (time / 10000) + 8; // UTC+8 timezone
-                        GPS.Time_M = (time / 100) % 100;
-                        GPS.Time_S = time % 100;
-                        
-                        // Handle cross-day situation
-                        if (GPS.Time_H >= 24) {
-                            GPS.Time_H -= 24;
-                        }
-                    }
-                    break;
-                    
-                case 2: // Latitude (ddmm.mmmm format)
-                    if (strlen(token) > 0) {
-                        // Save original format for reference
-                        GPS.Lat_Raw = atof(token);
-                        // Convert to decimal degree format
-                        GPS.Lat = convert_nmea_to_decimal(GPS.Lat_Raw);
-                    }
-                    break;
-                    
-                case 3: // Latitude direction
-                    if (strlen(token) > 0) {
-                        GPS.Lat_area = token[0];
-                        // If it's south latitude, latitude is negative
-                        if (GPS.Lat_area == 'S') {
-                            GPS.Lat = -GPS.Lat;
-                        }
-                    }
-                    break;
-                    
-                case 4: // Longitude (dddmm.mmmm format)
-                    if (strlen(token) > 0) {
-                        // Save original format for reference
-                        GPS.Lon_Raw = atof(token);
-                        // Convert to decimal degree format
-                        GPS.Lon = convert_nmea_to_decimal(GPS.Lon_Raw);
-                    }
-                    break;
-                    
-                case 5: // Longitude direction
-                    if (strlen(token) > 0) {
-                        GPS.Lon_area = token[0];
-                        // If it's west longitude, longitude is negative
-                        if (GPS.Lon_area == 'W') {
-                            GPS.Lon = -GPS.Lon;
-                        }
-                    }
-                    break;
-                    
-                case 6: // Positioning quality indicator
-                    if (strlen(token) > 0 && token[0] >= '0' && token[0] <= '9') {
-                        GPS.Status = (token[0] == '0') ? 0 : 1;
-                        if (debug_output) {
-                            printf("GGA positioning quality: %c -> Status=%d\n", token[0], GPS.Status);
-                        }
-                    } else {
-                        // Invalid or empty quality indicator
-                        GPS.Status = 0;
-                        if (debug_output) {
-                            printf("GGA positioning quality: invalid/empty -> Status=0\n");
-                        }
-                    }
-                    break;
-                    
-                case 9: // Altitude
-                    if (strlen(token) > 0) {
-                        GPS.Altitude = atof(token);
-                        if (debug_output) {
-                            printf("Extracted altitude: %.3f meters\n", GPS.Altitude);
-                        }
-                    }
-                    break;
-            }
-            
-            token = strtok(NULL, ",");
-            field++;
-        }
-        
-        // Use previously saved speed and course information because GGA sentence does not contain these
-        GPS.Speed = prev_speed;
-        GPS.Course = prev_course;
-    } else {
-        // Original RMC parsing logic
-        while (token != NULL) {
-            switch (field) {
-                case 0: // RMC identifier
-                    break;
-                    
-                case 1: // UTC time
-                    if (strlen(token) >= 6) {
-                        // Extract time directly from string
-                        int time = atoi(token);
-                        GPS.Time_H = (time / 10000) + 8; // UTC+8 timezone
-                        GPS.Time_M = (time / 100) % 100;
-                        GPS.Time_S = time % 100;
-                        
-                        // Handle cross-day situation
-                        if (GPS.Time_H >= 24) {
-                            GPS.Time_H -= 24;
-                        }
-                    }
-                    break;
-                    
-                case 2: // Positioning status
-                    GPS.Status = (token[0] == 'A') ? 1 : 0;
-                    break;
-                    
-                case 3: // Latitude (ddmm.mmmm format)
-                    if (strlen(token) > 0) {
-                        // Save original format for reference
-                        GPS.Lat_Raw = atof(token);
-                        // Convert to decimal degree format
-                        GPS.Lat = convert_nmea_to_decimal(GPS.Lat_Raw);
-                    }
-                    break;
-                    
-                case 4: // Latitude direction
-                    if (strlen(token) > 0) {
-                        GPS.Lat_area = token[0];
-                        // If it's south latitude, latitude is negative
-                        if (GPS.Lat_area == 'S') {
-                            GPS.Lat = -GPS.Lat;
-                        }
-                    }
-                    break;
-                    
-                case 5: // Longitude (dddmm.mmmm format)
-                    if (strlen(token) > 0) {
-                        // Save original format for reference
-                        GPS.Lon_Raw = atof(token);
-                        // Convert to decimal degree format
-                        GPS.Lon = convert_nmea_to_decimal(GPS.Lon_Raw);
-                    }
-                    break;
-                    
-                case 6: // Longitude direction
-                    if (strlen(token) > 0) {
-                        GPS.Lon_area = token[0];
-                        // If it's west longitude, longitude is negative
-                        if (GPS.Lon_area == 'W') {
-                            GPS.Lon = -GPS.Lon;
-                        }
-                    }
-                    break;
-                    
-                case 7: // Ground speed (knots)
-                    if (strlen(token) > 0) {
-                        GPS.Speed = atof(token) * 1.852; // Convert to kilometers/hour
-                        // Save valid speed value for subsequent use
-                        last_valid_speed = GPS.Speed;
-                    }
-                    break;
-                    
-                case 8: // Ground course (degrees)
-                    if (strlen(token) > 0) {
-                        GPS.Course = atof(token);
-                        // Save valid course value for subsequent use
-                        last_valid_course = GPS.Course;
-                    }
-                    break;
-                    
-                case 9: // Date (ddmmyy)
-                    if (strlen(token) >= 6) {
-                        // Save original date, format DDMMYY
-                        int day = (token[0] - '0') * 10 + (token[1] - '0');
-                        int month = (token[2] - '0') * 10 + (token[3] - '0');
-                        int year = 2000 + (token[4] - '0') * 10 + (token[5] - '0');
-                        
-                        // Format date string
-                        sprintf(GPS.Date, "%04d-%02d-%02d", year, month, day);
-                    }
-                    break;
-            }
-            
-            token = strtok(NULL, ",");
-            field++;
-        }
+    if (gsv.snr_count > 0) {
+        // Convert SNR (0-99 dB-Hz) to signal strength (0-100)
+        uint32_t strength = gsv.snr_sum / gsv.snr_count * 100u / 99u;
+        gps_signal_strength = strength > 100 ? 100 : (uint8_t)strength;
     }
     
+    gps_fix_to_gnrmc(&gps_fix, &GPS);
+    
     if (debug_output && GPS.Status) {
         printf("GPS positioning successful: Latitude=%.6f%c(%.6f°), Longitude=%.6f%c(%.6f°)\n", 
               GPS.Lat_Raw, GPS.Lat_area, GPS.Lat,
               GPS.Lon_Raw, GPS.Lon_area, GPS.Lon);
     }
-    
-    // Output additional debug information
     if (debug_output) {
-        printf("GPS data status: Positioning status=%d, Latitude=%.6f, Longitude=%.6f, Data type=%s\n", 
-               GPS.Status, GPS.Lat, GPS.Lon, using_gga ? "GGA" : "RMC");
+        printf("GPS data status: Positioning status=%d, Latitude=%.6f, Longitude=%.6f\n", 
+               GPS.Status, GPS.Lat, GPS.Lon);
     }
     
     return GPS;
@@ -806,36 +345,17 @@ GNRMC vendor_gps_get_gnrmc() {
 /******************************************************************************
 function:	
 	Convert GPS latitude and longitude into Baidu map coordinates
-    直接使用已转换的十进制度格式坐标
 ******************************************************************************/
 Coordinates vendor_gps_get_baidu_coordinates() {
-    Coordinates temp;
-    
-    // Directly use converted decimal degree coordinate
-    temp.Lat = GPS.Lat;
-    temp.Lon = GPS.Lon;
-    
-    // Map coordinate system conversion
-    temp = transform(temp);
-    temp = bd_encrypt(temp);
-    return temp;
+    return gps_fix_to_bd09(&gps_fix);
 }
 
 /******************************************************************************
 function:	
 	Convert GPS latitude and longitude into Google Maps coordinates
-    直接使用已转换的十进制度格式坐标
 ******************************************************************************/
 Coordinates vendor_gps_get_google_coordinates() {
-    Coordinates temp;
-    
-    // Directly use converted decimal degree coordinate
-    temp.Lat = GPS.Lat;
-    temp.Lon = GPS.Lon;
-    
-    // Map coordinate system conversion
-    temp = transform(temp);
-    return temp;
+    return gps_fix_to_gcj02(&gps_fix);
 }
 
 // =============================================================================
@@ -848,11 +368,7 @@ Coordinates vendor_gps_get_google_coordinates() {
  * @return Calculated checksum
  */
 static uint8_t calculate_nmea_checksum(const char* data) {
-    uint8_t checksum = 0;
-    for (int i = 0; data[i] != '\0'; i++) {
-        checksum ^= data[i];
-    }
-    return checksum;
+    return gps_nmea_xor(data, (int)strlen(data));
 }
 
 /**
@@ -1129,81 +645,6 @@ bool vendor_gps_set_satellite_systems(uint8_t gps, uint8_t glonass, uint8_t gali
     return response.Valid && response.Result == 0;
 }
 
-/**
- * @brief Parse GSV message to extract satellite information
- * @param gsv_data GSV message data
- */
-static void parse_gsv_message(const char* gsv_data) {
-    char* token;
-    char* gsv_copy = strdup(gsv_data);
-    int field = 0;
-    uint8_t total_satellites = 0;
-    uint8_t satellites_in_message = 0;
-    uint8_t total_snr = 0;
-    uint8_t snr_count = 0;
-    
-    token = strtok(gsv_copy, ",");
-    
-    while (token != NULL) {
-        switch (field) {
-            case 3: // Total number of satellites
-                total_satellites = atoi(token);
-                break;
-            case 7: // First satellite SNR
-                if (strlen(token) > 0) {
-                    uint8_t snr = atoi(token);
-                    if (snr > 0) {
-                        total_snr += snr;
-                        snr_count++;
-                    }
-                }
-                break;
-            case 11: // Second satellite SNR
-                if (strlen(token) > 0) {
-                    uint8_t snr = atoi(token);
-                    if (snr > 0) {
-                        total_snr += snr;
-                        snr_count++;
-                    }
-                }
-                break;
-            case 15: // Third satellite SNR
-                if (strlen(token) > 0) {
-                    uint8_t snr = atoi(token);
-                    if (snr > 0) {
-                        total_snr += snr;
-                        snr_count++;
-                    }
-                }
-                break;
-            case 19: // Fourth satellite SNR
-                if (strlen(token) > 0) {
-                    uint8_t snr = atoi(token);
-                    if (snr > 0) {
-                        total_snr += snr;
-                        snr_count++;
-                    }
-                }
-                break;
-        }
-        
-        token = strtok(NULL, ",");
-        field++;
-    }
-    
-    // Update global satellite data
-    gps_satellites_count = total_satellites;
-    
-    if (snr_count > 0) {
-        uint8_t avg_snr = total_snr / snr_count;
-        // Convert SNR (0-99 dB-Hz) to signal strength (0-100)
-        gps_signal_strength = (avg_snr * 100) / 99;
-        if (gps_signal_strength > 100) gps_signal_strength = 100;
-    }
-    
-    free(gsv_copy);
-}
-
 /**
  * @brief Get LC76G satellite count from GSV messages
  * @return Number of satellites in view
@@ -0,0 +1,263 @@
+/**
+ * @file input_events.c
+ * @brief 输入事件队列和按键/摇杆判定
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "hardware/sync.h"
+#include "pin_config.hpp"
+#include "input/input_events.h"
+
+_Static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0, "INPUT_QUEUE_SIZE必须为2的幂");
+
+#define DEBOUNCE_US     ((uint32_t)BUTTON_DEBOUNCE_MS * 1000u)
+#define LONG_PRESS_US   ((uint32_t)BUTTON_LONG_PRESS_MS * 1000u)
+
+/**
+ * @brief 单生产者单消费者环形队列，统计只由生产者写
+ */
+typedef struct {
+    input_event_t slots[INPUT_QUEUE_SIZE];
+    volatile uint32_t head;     // 生产者写
+    volatile uint32_t tail;     // 消费者写
+    uint32_t pushed;
+    uint32_t dropped;
+} event_queue_t;
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static event_queue_t g_button_queue;    // 中断写
+static event_queue_t g_joystick_queue;  // 主循环上下文写
+
+// 按键状态（只在中断中访问）
+static struct {
+    bool stable;                // 消抖后的电平
+    bool changed;               // 是否接受过边沿
+    bool long_fired;
+    uint32_t change_us;         // 最近一次接受边沿的时刻
+    uint32_t press_us;
+    uint32_t bounces;
+} g_button;
+
+// 摇杆状态（只在主循环上下文中访问）
+static struct {
+    uint8_t direction;          // 0或INPUT_JOY_UP..RIGHT
+    bool pressed;
+    uint32_t samples;
+    uint32_t errors;
+    uint32_t read_max_us;
+} g_joystick;
+
+// 延迟统计（只由消费者写）
+static struct {
+    uint32_t handled;
+    uint64_t sum_us;
+    uint32_t max_us;
+    uint32_t buckets[INPUT_LATENCY_BUCKETS];
+} g_latency;
+
+static const uint32_t kBucketLimitsUs[INPUT_LATENCY_BUCKETS - 1] = {1000, 5000, 20000, 50000, 100000};
+
+// =============================================================================
+// 内部函数
+// =============================================================================
+
+static void queue_push(event_queue_t *queue, uint8_t type, uint16_t duration_ms, uint32_t time_us) {
+    uint32_t head = queue->head;
+    if (head - queue->tail >= INPUT_QUEUE_SIZE) {
+        queue->dropped++;
+        return;
+    }
+    input_event_t *slot = &queue->slots[head & (INPUT_QUEUE_SIZE - 1)];
+    slot->type = type;
+    slot->duration_ms = duration_ms;
+    slot->time_us = time_us;
+    // 事件内容先于head对消费者可见
+    __dmb();
+    queue->head = head + 1;
+    queue->pushed++;
+}
+
+static bool queue_peek(const event_queue_t *queue, input_event_t *event) {
+    uint32_t tail = queue->tail;
+    if (tail == queue->head) {
+        return false;
+    }
+    __dmb();
+    *event = queue->slots[tail & (INPUT_QUEUE_SIZE - 1)];
+    return true;
+}
+
+static void queue_drop_head(event_queue_t *queue) {
+    __dmb();
+    queue->tail = queue->tail + 1;
+}
+
+static inline uint32_t min_delay(uint32_t a, uint32_t b) {
+    if (a == 0) {
+        return b;
+    }
+    return (b == 0 || a < b) ? a : b;
+}
+
+// =============================================================================
+// 判定逻辑
+// =============================================================================
+
+void input_events_reset(void) {
+    memset(&g_button_queue, 0, sizeof(g_button_queue));
+    memset(&g_joystick_queue, 0, sizeof(g_joystick_queue));
+    memset(&g_button, 0, sizeof(g_button));
+    memset(&g_joystick, 0, sizeof(g_joystick));
+    memset(&g_latency, 0, sizeof(g_latency));
+}
+
+uint32_t input_button_update(bool pressed, uint32_t now_us) {
+    uint32_t since_change = now_us - g_button.change_us;
+    bool in_window = g_button.changed && since_change < DEBOUNCE_US;
+
+    if (pressed != g_button.stable) {
+        if (in_window) {
+            // 窗口结束时重新读取电平，抖动停在相反电平时不会丢掉这次变化
+            g_button.bounces++;
+            return DEBOUNCE_US - since_change;
+        }
+        // 首个边沿立即生效，之后的抖动在窗口内忽略
+        g_button.stable = pressed;
+        g_button.changed = true;
+        g_button.change_us = now_us;
+        since_change = 0;
+        in_window = true;
+        if (pressed) {
+            g_button.press_us = now_us;
+            g_button.long_fired = false;
+        } else if (!g_button.long_fired) {
+            uint32_t held_ms = (now_us - g_button.press_us) / 1000u;
+            queue_push(&g_button_queue, INPUT_BUTTON_SHORT, held_ms > 0xFFFF ? 0xFFFF : (uint16_t)held_ms, now_us);
+        }
+    }
+
+    uint32_t delay = in_window ? DEBOUNCE_US - since_change : 0;
+    if (g_button.stable && !g_button.long_fired) {
+        uint32_t held = now_us - g_button.press_us;
+        if (held >= LONG_PRESS_US) {
+            g_button.long_fired = true;
+            // 以达到长按阈值的时刻为事件时刻，定时器延迟计入输入延迟
+            queue_push(&g_button_queue, INPUT_BUTTON_LONG, BUTTON_LONG_PRESS_MS, g_button.press_us + LONG_PRESS_US);
+        } else {
+            delay = min_delay(delay, LONG_PRESS_US - held);
+        }
+    }
+    return delay;
+}
+
+void input_joystick_sample(int32_t dx, int32_t dy, bool pressed, uint32_t now_us) {
+    g_joystick.samples++;
+
+    int32_t ax = abs(dx);
+    int32_t ay = abs(dy);
+    int32_t magnitude = ax > ay ? ax : ay;
+    uint8_t direction = g_joystick.direction;
+    if (magnitude > JOYSTICK_THRESHOLD) {
+        if (ax > ay) {
+            direction = dx > 0 ? INPUT_JOY_RIGHT : INPUT_JOY_LEFT;
+        } else {
+            direction = dy > 0 ? INPUT_JOY_DOWN : INPUT_JOY_UP;
+        }
+    } else if (magnitude < JOYSTICK_THRESHOLD / 2) {
+        // 回滞：回到阈值一半以内才算回中，阈值附近不反复触发
+        direction = 0;
+    }
+
+    if (direction != g_joystick.direction) {
+        g_joystick.direction = direction;
+        queue_push(&g_joystick_queue, direction ? direction : INPUT_JOY_CENTER, 0, now_us);
+    }
+    if (pressed != g_joystick.pressed) {
+        g_joystick.pressed = pressed;
+        queue_push(&g_joystick_queue, pressed ? INPUT_JOY_PRESS : INPUT_JOY_RELEASE, 0, now_us);
+    }
+}
+
+void input_joystick_read_result(bool ok, uint32_t read_us) {
+    if (!ok) {
+        g_joystick.errors++;
+    }
+    if (read_us > g_joystick.read_max_us) {
+        g_joystick.read_max_us = read_us;
+    }
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+bool input_events_pop(input_event_t *event) {
+    input_event_t button;
+    input_event_t joystick;
+    bool has_button = queue_peek(&g_button_queue, &button);
+    bool has_joystick = queue_peek(&g_joystick_queue, &joystick);
+
+    if (has_button && (!has_joystick || (int32_t)(button.time_us - joystick.time_us) <= 0)) {
+        queue_drop_head(&g_button_queue);
+        *event = button;
+        return true;
+    }
+    if (has_joystick) {
+        queue_drop_head(&g_joystick_queue);
+        *event = joystick;
+        return true;
+    }
+    return false;
+}
+
+void input_events_record_latency(const input_event_t *event, uint32_t done_us) {
+    uint32_t latency = done_us - event->time_us;
+    g_latency.handled++;
+    g_latency.sum_us += latency;
+    if (latency > g_latency.max_us) {
+        g_latency.max_us = latency;
+    }
+    int bucket = 0;
+    while (bucket < INPUT_LATENCY_BUCKETS - 1 && latency >= kBucketLimitsUs[bucket]) {
+        bucket++;
+    }
+    g_latency.buckets[bucket]++;
+}
+
+void input_events_get_stats(input_events_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    stats->events = g_button_queue.pushed + g_joystick_queue.pushed;
+    stats->dropped = g_button_queue.dropped + g_joystick_queue.dropped;
+    stats->bounces = g_button.bounces;
+    stats->joystick_samples = g_joystick.samples;
+    stats->joystick_errors = g_joystick.errors;
+    stats->joystick_read_max_us = g_joystick.read_max_us;
+    stats->handled = g_latency.handled;
+    stats->latency_sum_us = g_latency.sum_us;
+    stats->latency_max_us = g_latency.max_us;
+    memcpy(stats->latency_buckets, g_latency.buckets, sizeof(stats->latency_buckets));
+}
+
+void input_events_print_stats(void) {
+    input_events_stats_t s;
+    input_events_get_stats(&s);
+    printf("[输入] 事件 %lu (丢弃%lu)，消抖忽略 %lu，摇杆采样 %lu (失败%lu，最长%lu us)\n",
+           (unsigned long)s.events, (unsigned long)s.dropped, (unsigned long)s.bounces,
+           (unsigned long)s.joystick_samples, (unsigned long)s.joystick_errors,
+           (unsigned long)s.joystick_read_max_us);
+    if (s.handled > 0) {
+        printf("[输入] 输入到屏幕延迟: 平均 %lu us，最大 %lu us，分布 <1ms:%lu <5ms:%lu <20ms:%lu <50ms:%lu <100ms:%lu 更长:%lu\n",
+               (unsigned long)(s.latency_sum_us / s.handled), (unsigned long)s.latency_max_us,
+               (unsigned long)s.latency_buckets[0], (unsigned long)s.latency_buckets[1],
+               (unsigned long)s.latency_buckets[2], (unsigned long)s.latency_buckets[3],
+               (unsigned long)s.latency_buckets[4], (unsigned long)s.latency_buckets[5]);
+    }
+}
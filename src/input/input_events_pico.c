@@ -0,0 +1,126 @@
+/**
+ * @file input_events_pico.c
+ * @brief 输入事件的硬件部分：按键GPIO中断、消抖/长按定时器、摇杆I2C采样
+ *
+ * 摇杆为I2C地址JOYSTICK_I2C_ADDR的摇杆单元：寄存器0x00为X/Y两路12位ADC
+ * (各2字节，小端)，0x20为按键状态(0表示按下)。与LC76G共用I2C1，只在持有
+ * 适配器的I2C互斥锁时访问（总线空闲钩子）。
+ */
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "pin_config.hpp"
+#include "gps/lc76g_i2c_adaptor.h"
+#include "input/input_events.h"
+
+#define JOYSTICK_REG_ADC        0x00
+#define JOYSTICK_REG_BUTTON     0x20
+#define JOYSTICK_ADC_CENTER     2048
+#define JOYSTICK_TIMEOUT_US     2000        // 单次传输超时，摇杆未连接时不阻塞GPS
+#define JOYSTICK_MAX_ERRORS     5           // 连续失败后降低采样频率
+#define JOYSTICK_RETRY_MS       2000
+
+// =============================================================================
+// 全局变量
+// =============================================================================
+
+static volatile alarm_id_t g_button_alarm = 0;
+static uint32_t g_joystick_last_us = 0;
+static uint32_t g_joystick_failures = 0;
+
+// =============================================================================
+// 按键
+// =============================================================================
+
+static int64_t button_alarm_callback(alarm_id_t id, void *user_data);
+
+/**
+ * @brief 读取电平交给判定逻辑，按返回的延时重新设置定时器（中断上下文）
+ */
+static void button_service(void) {
+    uint32_t delay = input_button_update(!gpio_get(BUTTON_PIN), time_us_32());
+    if (g_button_alarm > 0) {
+        cancel_alarm(g_button_alarm);
+        g_button_alarm = 0;
+    }
+    if (delay > 0) {
+        g_button_alarm = add_alarm_in_us(delay, button_alarm_callback, NULL, true);
+    }
+}
+
+static int64_t button_alarm_callback(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    g_button_alarm = 0;
+    button_service();
+    return 0;
+}
+
+static void button_irq_callback(uint gpio, uint32_t events) {
+    (void)events;
+    if (gpio == BUTTON_PIN) {
+        button_service();
+    }
+}
+
+// =============================================================================
+// 摇杆
+// =============================================================================
+
+static bool joystick_read_reg(uint8_t reg, uint8_t *data, size_t length) {
+    if (i2c_write_timeout_us(JOYSTICK_I2C_INST, JOYSTICK_I2C_ADDR, &reg, 1, true, JOYSTICK_TIMEOUT_US) != 1) {
+        return false;
+    }
+    return i2c_read_timeout_us(JOYSTICK_I2C_INST, JOYSTICK_I2C_ADDR, data, length, false,
+                               JOYSTICK_TIMEOUT_US) == (int)length;
+}
+
+/**
+ * @brief 总线空闲钩子：到采样间隔时读取一次摇杆
+ */
+static void joystick_bus_gap_hook(void *ctx) {
+    (void)ctx;
+    uint32_t now = time_us_32();
+    uint32_t interval_ms = g_joystick_failures >= JOYSTICK_MAX_ERRORS ? JOYSTICK_RETRY_MS : JOYSTICK_LOOP_DELAY_MS;
+    if (now - g_joystick_last_us < interval_ms * 1000u) {
+        return;
+    }
+    g_joystick_last_us = now;
+
+    uint8_t adc[4];
+    uint8_t button = 1;
+    bool ok = joystick_read_reg(JOYSTICK_REG_ADC, adc, sizeof(adc)) &&
+              joystick_read_reg(JOYSTICK_REG_BUTTON, &button, 1);
+    input_joystick_read_result(ok, time_us_32() - now);
+    if (!ok) {
+        g_joystick_failures++;
+        return;
+    }
+    g_joystick_failures = 0;
+
+    int32_t x = adc[0] | (adc[1] << 8);
+    int32_t y = adc[2] | (adc[3] << 8);
+    input_joystick_sample(x - JOYSTICK_ADC_CENTER, y - JOYSTICK_ADC_CENTER, button == 0, now);
+}
+
+// =============================================================================
+// 公共API实现
+// =============================================================================
+
+void input_events_init(void) {
+    input_events_reset();
+
+    gpio_init(BUTTON_PIN);
+    gpio_set_dir(BUTTON_PIN, GPIO_IN);
+    gpio_pull_up(BUTTON_PIN);
+    gpio_set_irq_enabled_with_callback(BUTTON_PIN, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true,
+                                       button_irq_callback);
+
+    lc76g_set_bus_gap_hook(joystick_bus_gap_hook, NULL);
+}
+
+void input_events_poll(void) {
+    lc76g_run_bus_gap_hook();
+}